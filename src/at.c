@@ -1,8 +1,13 @@
 #include "at.h"
+#include "game_event.h"
 #include "lottery.h"
+#include "rng.h"
+#include "weighted_table.h"
+#include "spec.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 
 // --- 内部ヘルパー関数 ---
 
@@ -15,46 +20,332 @@ static int get_st_games_from_level(HiyokuLevel level) {
     return 2;
 }
 
-static void Hiyoku_Init(GameData* data, bool is_from_ep_bonus) {
+// =================================================================
+// 抽選レート (千分率、値はスペックの [AT] / [AT.*])
+// =================================================================
+#define RATE_DENOMINATOR SPEC_RATE_DENOMINATOR
+#define BB_EX_RATE_DENOMINATOR SPEC_BB_EX_RATE_DENOMINATOR
+
+static WeightedTable g_hiyoku_init_level_table;
+static WeightedTable g_bb_ex_rate_table;
+static WeightedTable g_gcount_tables[YAKU_COUNT];
+static WeightedTable g_payout_tables[YAKU_COUNT];
+
+// =================================================================
+// 抽選カーネル
+// -----------------------------------------------------------------
+// 1ゲーム中に連鎖する抽選 (契機→振り分け、連れ出し→初期レベル、
+// 比翼の上乗せ→ボーナス→EX振り分け→レベルアップ) を、
+// 種類×成立役ごとの同時分布にまとめておき 1 回の抽選で引く。
+// 結果は AtDelta としてまとめて GameData に反映する。
+// =================================================================
+#define AT_KERNEL_MAX_OUTCOMES 24
+
+#define AT_DELTA_BONUS_STOCK 0x01 // ボーナスストック +1
+#define AT_DELTA_EX_STOCK    0x02 // BB EX ストック (BB_EX_Init)
+#define AT_DELTA_TSUREDASHI  0x04 // 連れ出し (比翼BEATS ホールド開始)
+#define AT_DELTA_TO_BB_EX    0x08 // 連れ出し + BB EX へ即遷移
+#define AT_DELTA_LEVEL_UP    0x10 // 比翼BEATS レベル昇格
+
+typedef struct {
+    short added_games;        // G数上乗せ
+    short added_payout;       // 差枚数上乗せ
+    unsigned char flags;      // AT_DELTA_*
+    unsigned char hiyoku_level; // 連れ出し時の比翼BEATS 初期レベル
+} AtDelta;
+
+typedef enum {
+    AT_KERNEL_GCOUNT_ADDON,   // BB系: G数上乗せ
+    AT_KERNEL_PAYOUT_ADDON,   // BB系: 差枚数上乗せ (残り30G以上)
+    AT_KERNEL_FRANXX_BONUS,   // フランクスボーナス: 連れ出し + G数上乗せ
+    AT_KERNEL_HIYOKU_LV1,     // 比翼BEATS (レベル別)
+    AT_KERNEL_HIYOKU_LV2,
+    AT_KERNEL_HIYOKU_MAXX,
+    AT_KERNEL_COUNT
+} AtKernelKind;
+
+// 結果番号を重み付き抽選し、番号から AtDelta を引く
+typedef struct {
+    WeightedTable table;
+    AtDelta delta[AT_KERNEL_MAX_OUTCOMES];
+} AtKernel;
+
+static AtKernel g_at_kernels[AT_KERNEL_COUNT][YAKU_COUNT];
+static bool g_quiet_yaku[YAKU_COUNT]; // ボーナス中に差枚以外何も起こさない役
+
+// 構築用: 共通分母 (RATE_DENOMINATOR の累乗) 上の重み
+#define KERNEL_DENOMINATOR(stages) ((uint64_t)pow_rate(stages))
+typedef struct {
+    int count;
+    uint64_t weight[AT_KERNEL_MAX_OUTCOMES];
+    AtDelta delta[AT_KERNEL_MAX_OUTCOMES];
+} KernelBuilder;
+
+static void builder_add(KernelBuilder* b, uint64_t weight, AtDelta delta) {
+    if (weight == 0) return;
+    for (int i = 0; i < b->count; i++) {
+        if (memcmp(&b->delta[i], &delta, sizeof(AtDelta)) == 0) {
+            b->weight[i] += weight;
+            return;
+        }
+    }
+    if (b->count >= AT_KERNEL_MAX_OUTCOMES) {
+        fprintf(stderr, "AT kernel: outcome overflow\n");
+        return;
+    }
+    b->weight[b->count] = weight;
+    b->delta[b->count] = delta;
+    b->count++;
+}
+
+static uint64_t pow_rate(int stages) {
+    uint64_t d = 1;
+    for (int i = 0; i < stages; i++) d *= RATE_DENOMINATOR;
+    return d;
+}
+
+static uint64_t gcd_u64(uint64_t a, uint64_t b) {
+    while (b != 0) {
+        uint64_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// expected: 共通分母 (各段の分母の積)。重みの合計と一致しなければ定義の誤り
+static bool builder_finish(const KernelBuilder* b, AtKernel* k, const char* name, uint64_t expected) {
+    uint64_t total = 0;
+    for (int i = 0; i < b->count; i++) total += b->weight[i];
+    if (total != expected) {
+        fprintf(stderr, "AT kernel[%s]: 重みの合計 %llu が分母 %llu と一致しません\n",
+                name, (unsigned long long)total, (unsigned long long)expected);
+        return false;
+    }
+
+    uint64_t g = 0;
+    for (int i = 0; i < b->count; i++) g = gcd_u64(g, b->weight[i]);
+    if (g == 0) g = 1;
+
+    WeightedEntry entries[AT_KERNEL_MAX_OUTCOMES];
+    for (int i = 0; i < b->count; i++) {
+        entries[i].value = i;
+        entries[i].weight = b->weight[i] / g;
+        k->delta[i] = b->delta[i];
+    }
+    WeightedTable_Free(&k->table);
+    return WeightedTable_Init(&k->table, name, entries, b->count, 0);
+}
+
+// 上乗せG数振り分け (契機込み) を重み scale で展開
+static void expand_gcount(KernelBuilder* b, uint64_t scale, YakuType yaku, AtDelta base) {
+    const MachineSpec* spec = Spec_Get();
+    if (spec->ex_stock[yaku]) {
+        base.flags |= AT_DELTA_EX_STOCK;
+        builder_add(b, scale * RATE_DENOMINATOR * RATE_DENOMINATOR, base);
+        return;
+    }
+    int trigger = spec->gcount_trigger[yaku];
+    const SpecRateList* counts = &spec->gcount[yaku];
+    builder_add(b, scale * (uint64_t)(RATE_DENOMINATOR - trigger) * RATE_DENOMINATOR, base);
+    for (int i = 0; i < counts->count; i++) {
+        AtDelta d = base;
+        d.added_games = (short)counts->entries[i].value;
+        builder_add(b, scale * (uint64_t)trigger * counts->entries[i].weight, d);
+    }
+}
+
+static bool build_gcount_kernel(AtKernel* k, YakuType yaku, const char* name) {
+    KernelBuilder b = {0};
+    expand_gcount(&b, 1, yaku, (AtDelta){0});
+    return builder_finish(&b, k, name, KERNEL_DENOMINATOR(2));
+}
+
+static bool build_payout_kernel(AtKernel* k, YakuType yaku, const char* name) {
+    KernelBuilder b = {0};
+    const SpecRateList* payouts = &Spec_Get()->payout_addon[yaku];
+    for (int i = 0; i < payouts->count; i++) {
+        AtDelta d = {0};
+        d.added_payout = (short)payouts->entries[i].value;
+        builder_add(&b, payouts->entries[i].weight, d);
+    }
+    return builder_finish(&b, k, name, KERNEL_DENOMINATOR(1));
+}
+
+static bool build_franxx_kernel(AtKernel* k, YakuType yaku, const char* name) {
+    KernelBuilder b = {0};
+    const MachineSpec* spec = Spec_Get();
+    int tsuredashi = spec->tsuredashi[yaku];
+    const uint64_t level_den = RATE_DENOMINATOR;
+
+    // 連れ出しなし
+    expand_gcount(&b, (uint64_t)(RATE_DENOMINATOR - tsuredashi) * level_den, yaku, (AtDelta){0});
+
+    // 連れ出しあり (比翼BEATS 初期レベル込み)
+    const SpecRateList* levels = &spec->hiyoku_init_level;
+    for (int i = 0; i < levels->count; i++) {
+        AtDelta d = {0};
+        d.flags = AT_DELTA_TSUREDASHI;
+        if (spec->ex_stock[yaku]) d.flags |= AT_DELTA_TO_BB_EX;
+        d.hiyoku_level = (unsigned char)levels->entries[i].value;
+        expand_gcount(&b, (uint64_t)tsuredashi * levels->entries[i].weight, yaku, d);
+    }
+    return builder_finish(&b, k, name, KERNEL_DENOMINATOR(4));
+}
+
+static bool build_hiyoku_kernel(AtKernel* k, YakuType yaku, HiyokuLevel level, const char* name) {
+    KernelBuilder b = {0};
+    const uint64_t D = RATE_DENOMINATOR;
+    const MachineSpec* spec = Spec_Get();
+    int add = spec->hiyoku_add[yaku];
+    int bonus = spec->hiyoku_bonus[yaku];
+    int ex = spec->hiyoku_ex[yaku];
+    int up = spec->hiyoku_levelup[level];
+
+    for (int a = 0; a < 2; a++) {
+        uint64_t wa = a ? (uint64_t)add : (uint64_t)(RATE_DENOMINATOR - add);
+        AtDelta base = {0};
+        base.added_games = (short)a;
+
+        // ボーナス非当選
+        builder_add(&b, wa * (uint64_t)(RATE_DENOMINATOR - bonus) * D * D, base);
+
+        // ボーナス当選 → ストック/EX 振り分け → レベルアップ
+        for (int e = 0; e < 2; e++) {
+            uint64_t we = e ? (uint64_t)ex : (uint64_t)(RATE_DENOMINATOR - ex);
+            for (int u = 0; u < 2; u++) {
+                uint64_t wu = u ? (uint64_t)up : (uint64_t)(RATE_DENOMINATOR - up);
+                AtDelta d = base;
+                d.flags = e ? AT_DELTA_EX_STOCK : AT_DELTA_BONUS_STOCK;
+                if (u) d.flags |= AT_DELTA_LEVEL_UP;
+                builder_add(&b, wa * (uint64_t)bonus * we * wu, d);
+            }
+        }
+    }
+    return builder_finish(&b, k, name, KERNEL_DENOMINATOR(4));
+}
+
+// 常に「何も起きない」結果を返すカーネルか
+static bool is_identity_kernel(const AtKernel* k) {
+    static const AtDelta none = {0};
+    return k->table.count == 1 && memcmp(&k->delta[0], &none, sizeof(AtDelta)) == 0;
+}
+
+static AtDelta draw_kernel(AtKernelKind kind, YakuType yaku) {
+    const AtKernel* k = &g_at_kernels[kind][yaku];
+    return k->delta[WeightedTable_Sample(&k->table)];
+}
+
+static AtKernelKind hiyoku_kernel_for_level(HiyokuLevel level) {
+    switch (level) {
+        case HIYOKU_LV2:  return AT_KERNEL_HIYOKU_LV2;
+        case HIYOKU_MAXX: return AT_KERNEL_HIYOKU_MAXX;
+        default:          return AT_KERNEL_HIYOKU_LV1;
+    }
+}
+
+static void Hiyoku_Start(GameData* data, HiyokuLevel level) {
     data->hiyoku_is_active = true;
     data->hiyoku_is_frozen = false; 
+    data->hiyoku_level = level;
+    data->hiyoku_st_games = get_st_games_from_level(data->hiyoku_level);
+}
 
+static void Hiyoku_Init(GameData* data, bool is_from_ep_bonus) {
     if (is_from_ep_bonus) {
-        data->hiyoku_level = HIYOKU_MAXX;
+        Hiyoku_Start(data, HIYOKU_MAXX);
     } else {
-        int r = rand() % 1000; 
-        if (r < 1) { 
-            data->hiyoku_level = HIYOKU_MAXX;
-        } else if (r < 216) { 
-            data->hiyoku_level = HIYOKU_LV2;
-        } else { 
-            data->hiyoku_level = HIYOKU_LV1;
-        }
+        Hiyoku_Start(data, (HiyokuLevel)WeightedTable_Sample(&g_hiyoku_init_level_table));
     }
-    data->hiyoku_st_games = get_st_games_from_level(data->hiyoku_level);
 }
 
-static void BB_EX_Init(GameData* data) {
-    int continue_rate_percent = 50; 
-    if ((rand() % 100) < 5) { 
-        continue_rate_percent = 80;
+// =================================================================
+// BB EX 獲得枚数
+// -----------------------------------------------------------------
+// 200枚から継続するたびに +100 (1000枚到達後は +1000)。
+// 継続回数は幾何分布なので、継続率ごとに「継続回数 0〜K-1 と K 回以上」の
+// 分布表を作り 1 回の抽選で引く。K 回以上を引いた場合は無記憶性により
+// K 回を加えて同じ表を引き直す (打ち切り誤差なし)。
+// =================================================================
+#define BB_EX_INITIAL_PAYOUT 200
+#define BB_EX_SMALL_STEP 100
+#define BB_EX_LARGE_STEP 1000
+#define BB_EX_LARGE_FROM 1000
+#define BB_EX_TABLE_MAX_CONTINUES 40
+#define BB_EX_TAIL (-1)  // 分布表の「K 回以上」
+
+typedef struct {
+    int rate_percent;
+    int continues;       // 表に載せる継続回数 K
+    WeightedTable table; // 値 = 継続回数 (BB_EX_TAIL は K 回以上)
+} BbExPayoutTable;
+
+static BbExPayoutTable g_bb_ex_payout_tables[SPEC_MAX_CHOICES];
+static int g_bb_ex_rate_count = 0;
+
+static long long bb_ex_payout_for_continues(long long continues) {
+    long long small_steps = (BB_EX_LARGE_FROM - BB_EX_INITIAL_PAYOUT) / BB_EX_SMALL_STEP;
+    if (continues <= small_steps) {
+        return BB_EX_INITIAL_PAYOUT + continues * BB_EX_SMALL_STEP;
     }
+    return BB_EX_LARGE_FROM + (continues - small_steps) * BB_EX_LARGE_STEP;
+}
 
-    // (★修正) 初期枚数を 200枚 に設定
-    int payout = 200; 
-    bool is_over_1000 = false; 
+static const BbExPayoutTable* find_bb_ex_table(int rate_percent) {
+    for (int i = 0; i < g_bb_ex_rate_count; i++) {
+        if (g_bb_ex_payout_tables[i].rate_percent == rate_percent) return &g_bb_ex_payout_tables[i];
+    }
+    return NULL;
+}
 
-    while ((rand() % 100) < continue_rate_percent) {
-        if (is_over_1000) {
-            payout += 1000;
-        } else {
-            payout += 100;
-            if (payout >= 1000) {
-                is_over_1000 = true;
-            }
-        }
+// 継続率 num/den (既約) に対し P(k) = num^k (den-num) den^(K-1-k) / den^K
+static bool build_bb_ex_table(BbExPayoutTable* t, int rate_percent) {
+    uint64_t g = gcd_u64((uint64_t)rate_percent, BB_EX_RATE_DENOMINATOR);
+    uint64_t num = (uint64_t)rate_percent / g;
+    uint64_t den = BB_EX_RATE_DENOMINATOR / g;
+
+    // den^K × (K+1) が 64bit に収まる最大の K
+    int k_max = 0;
+    uint64_t den_pow = 1;
+    while (k_max < BB_EX_TABLE_MAX_CONTINUES && den_pow <= UINT64_MAX / den / (uint64_t)(k_max + 3)) {
+        den_pow *= den;
+        k_max++;
+    }
+
+    WeightedEntry entries[BB_EX_TABLE_MAX_CONTINUES + 1];
+    uint64_t num_pow = 1;   // num^k
+    uint64_t rest = den_pow; // den^(K-k)
+    for (int k = 0; k < k_max; k++) {
+        rest /= den;
+        entries[k].value = k;
+        entries[k].weight = num_pow * (den - num) * rest;
+        num_pow *= num;
+    }
+    entries[k_max].value = BB_EX_TAIL;
+    entries[k_max].weight = num_pow;
+
+    char name[WEIGHTED_NAME_LEN];
+    snprintf(name, sizeof(name), "AT/BB EX 継続回数/継続率%d%%", rate_percent);
+    t->rate_percent = rate_percent;
+    t->continues = k_max;
+    WeightedTable_Free(&t->table);
+    return WeightedTable_Init(&t->table, name, entries, k_max + 1, den_pow);
+}
+
+static long long sample_bb_ex_continues(const BbExPayoutTable* t) {
+    long long continues = 0;
+    for (;;) {
+        int k = WeightedTable_Sample(&t->table);
+        if (k != BB_EX_TAIL) return continues + k;
+        continues += t->continues;
     }
-    data->queued_bb_ex_payout += payout; 
+}
+
+static void BB_EX_Init(GameData* data) {
+    int continue_rate_percent = WeightedTable_Sample(&g_bb_ex_rate_table);
+    const BbExPayoutTable* t = find_bb_ex_table(continue_rate_percent);
+    long long payout = bb_ex_payout_for_continues(sample_bb_ex_continues(t));
+    data->queued_bb_ex_payout += (int)payout; 
 }
 
 static bool is_payout_reset_yaku(YakuType yaku) {
@@ -70,117 +361,37 @@ static bool is_payout_reset_yaku(YakuType yaku) {
     }
 }
 
-static int get_gcount_for_addon(YakuType yaku) {
-    int r = rand() % 1000; 
-
-    switch (yaku) {
-        case YAKU_COMMON_BELL: 
-            if (r < 967) return 1; 
-            else if (r < 1000) return 3; 
-            return 1; 
-        case YAKU_CHERRY: 
-            if (r < 997) return 1; 
-            else if (r < 999) return 3; 
-            else return 5; 
-        case YAKU_CHANCE_ME: 
-            if (r < 750) return 1; 
-            else if (r < 982) return 2; 
-            else if (r < 998) return 3; 
-            else return 5; 
-        case YAKU_FRANXX_ME: 
-            if (r < 875) return 1; 
-            else if (r < 996) return 2; 
-            else if (r < 998) return 3; 
-            else return 5; 
-    }
-    return 0;
+// G数上乗せ / EXストック の反映
+static void apply_game_count_delta(GameData* data, YakuType yaku, AtDelta delta) {
+    if (delta.flags & AT_DELTA_EX_STOCK) {
+        GameEvent_Record(data, GAME_EVENT_EX_STOCK, yaku, 0);
+        BB_EX_Init(data); 
+    }
+    if (delta.added_games > 0) {
+        data->bonus_high_prob_games += delta.added_games;
+        GameEvent_Record(data, GAME_EVENT_GAME_ADDON, yaku, delta.added_games);
+    }
 }
 
 static void perform_game_count_addon(GameData* data, YakuType yaku) {
-    int added_games = 0;
-
-    switch (yaku) {
-        case YAKU_COMMON_BELL: 
-            if ((rand() % 1000) < 61) { 
-                added_games = get_gcount_for_addon(yaku);
-            }
-            break;
-        case YAKU_CHERRY:
-        case YAKU_CHANCE_ME:
-        case YAKU_FRANXX_ME:
-            added_games = get_gcount_for_addon(yaku); 
-            break;
-        case YAKU_HP_REVERSE_STRONG_FRANXX: 
-            snprintf(data->info_message, sizeof(data->info_message), "最強フランクス目! EXストック+1");
-            BB_EX_Init(data); 
-            break;
-        case YAKU_STRELITZIA_ME:
-        case YAKU_HP_REVERSE_STRELITZIA: 
-            snprintf(data->info_message, sizeof(data->info_message), "ストレリチア目! EXストック+1");
-            BB_EX_Init(data); 
-            break;
-        default:
-            break;
-    }
-
-    if (added_games > 0) {
-        data->bonus_high_prob_games += added_games;
-        snprintf(data->info_message, sizeof(data->info_message), "G数上乗せ +%dG！", added_games);
-    }
+    apply_game_count_delta(data, yaku, draw_kernel(AT_KERNEL_GCOUNT_ADDON, yaku));
 }
 
 static void perform_payout_addon(GameData* data, YakuType yaku) {
-    int added_payout = 0;
-    int r = rand() % 1000; 
-
-    switch (yaku) {
-        case YAKU_COMMON_BELL:
-            if (r < 8) added_payout = 30;    
-            else if (r < 12) added_payout = 50;   
-            else if (r < 16) added_payout = 100;  
-            break;
-        case YAKU_CHERRY:
-            if (r < 750) added_payout = 10;   
-            else if (r < 992) added_payout = 30;   
-            else if (r < 996) added_payout = 50;   
-            else if (r < 1000) added_payout = 100;  
-            break;
-        case YAKU_CHANCE_ME:
-            if (r < 750) added_payout = 30;   
-            else if (r < 914) added_payout = 50;   
-            else if (r < 992) added_payout = 100;  
-            else if (r < 996) added_payout = 500;  
-            else if (r < 1000) added_payout = 1000; 
-            break;
-        case YAKU_FRANXX_ME:
-            if (r < 871) added_payout = 30;   
-            else if (r < 996) added_payout = 50;   
-            else if (r < 998) added_payout = 100;  
-            else if (r < 999) added_payout = 500;  
-            else if (r < 1000) added_payout = 1000; 
-            break;
-        case YAKU_HP_REVERSE_STRONG_FRANXX:
-        case YAKU_STRELITZIA_ME:
-        case YAKU_HP_REVERSE_STRELITZIA:
-            if (r < 844) added_payout = 100;  
-            else if (r < 922) added_payout = 500;  
-            else if (r < 1000) added_payout = 1000; 
-            break;
-        default:
-            break;
-    }
+    AtDelta delta = draw_kernel(AT_KERNEL_PAYOUT_ADDON, yaku);
 
-    if (added_payout > 0) {
-        data->target_bonus_payout += added_payout;
-        snprintf(data->info_message, sizeof(data->info_message), "差枚数上乗せ +%d枚！", added_payout);
+    if (delta.added_payout > 0) {
+        data->target_bonus_payout += delta.added_payout;
+        GameEvent_Record(data, GAME_EVENT_PAYOUT_ADDON, yaku, delta.added_payout);
     }
 }
 
 static void transition_to_state(GameData* data, AT_State new_state) {
-    
+    const MachineSpec* spec = Spec_Get();
+
     data->current_state = new_state; 
     data->current_bonus_payout = 0; 
-    snprintf(data->info_message, sizeof(data->info_message), "%s へ遷移", AT_GetStateName(new_state));
+    GameEvent_Record(data, GAME_EVENT_STATE_CHANGE, YAKU_HAZURE, new_state);
 
     if (new_state != STATE_BB_EX && new_state != STATE_HIYOKU_BEATS) {
         data->hiyoku_is_active = false;
@@ -195,36 +406,36 @@ static void transition_to_state(GameData* data, AT_State new_state) {
     
     switch (new_state) {
         case STATE_BB_INITIAL:
-            data->target_bonus_payout = PAYOUT_TARGET_BB_INITIAL;
+            data->target_bonus_payout = spec->target_bb_initial;
             break;
         case STATE_BONUS_HIGH_PROB:
             data->target_bonus_payout = 0; 
             if (data->bonus_high_prob_games <= 0) { 
-                 data->bonus_high_prob_games = GAMES_ON_BB_INITIAL_END;
+                 data->bonus_high_prob_games = spec->games_on_bb_initial_end;
             }
             break;
         case STATE_BB_HIGH_PROB:
-            data->target_bonus_payout = PAYOUT_TARGET_BB_HIGH_PROB;
+            data->target_bonus_payout = spec->target_bb_high_prob;
             break;
         case STATE_FRANXX_BONUS:
-            data->target_bonus_payout = PAYOUT_TARGET_FRANXX_BONUS;
+            data->target_bonus_payout = spec->target_franxx_bonus;
             break;
         case STATE_BB_EX:
-            data->target_bonus_payout = data->queued_bb_ex_payout > 0 ? data->queued_bb_ex_payout : PAYOUT_TARGET_BB_EX;
+            data->target_bonus_payout = data->queued_bb_ex_payout > 0 ? data->queued_bb_ex_payout : spec->target_bb_ex;
             data->queued_bb_ex_payout = 0; 
             break;
         case STATE_HIYOKU_BEATS:
             data->target_bonus_payout = 0; 
             break;
         case STATE_EPISODE_BONUS:
-            data->target_bonus_payout = PAYOUT_TARGET_EP_BONUS;
+            data->target_bonus_payout = spec->target_ep_bonus;
             break;
         case STATE_TSUREDASHI:
-            data->target_bonus_payout = PAYOUT_TARGET_TSUREDASHI;
+            data->target_bonus_payout = spec->target_tsuredashi;
             break;
         case STATE_AT_END:
             data->target_bonus_payout = 0;
-            snprintf(data->info_message, sizeof(data->info_message), "AT終了。 総獲得: %lld枚", data->total_payout_diff);
+            GameEvent_Record(data, GAME_EVENT_AT_END, YAKU_HAZURE, data->total_payout_diff);
             break;
         default:
              data->target_bonus_payout = 0;
@@ -232,45 +443,6 @@ static void transition_to_state(GameData* data, AT_State new_state) {
     }
 }
 
-static bool Hiyoku_PerformBonusAllocation(GameData* data, YakuType yaku) {
-    int r = rand() % 1000;
-    
-    switch (yaku) {
-        case YAKU_CHANCE_ME: 
-            if (r < 336) { data->bonus_stock_count++; return false; } 
-            else if (r < 867) { data->bonus_stock_count++; return false; } 
-            else { BB_EX_Init(data); return true; } 
-        case YAKU_CHERRY: 
-            if (r < 250) { data->bonus_stock_count++; return false; } 
-            else if (r < 845) { data->bonus_stock_count++; return false; } 
-            else { BB_EX_Init(data); return true; } 
-        case YAKU_FRANXX_ME: 
-            if (r < 336) { data->bonus_stock_count++; return false; } 
-            else if (r < 859) { data->bonus_stock_count++; return false; } 
-            else { BB_EX_Init(data); return true; } 
-        case YAKU_STRELITZIA_ME: 
-        case YAKU_HP_REVERSE_STRONG_FRANXX:
-            BB_EX_Init(data);
-            return true;
-        default:
-            break;
-    }
-    return false;
-}
-
-static void Hiyoku_PerformLevelUp(GameData* data) {
-    int r = rand() % 1000;
-    
-    if (data->hiyoku_level == HIYOKU_LV1 && r < 215) { 
-        data->hiyoku_level = HIYOKU_LV2;
-        snprintf(data->info_message, sizeof(data->info_message), "レベル2へ昇格！");
-    } 
-    else if (data->hiyoku_level == HIYOKU_LV2 && r < 31) { 
-        data->hiyoku_level = HIYOKU_MAXX;
-        snprintf(data->info_message, sizeof(data->info_message), "レベルMAXXへ昇格！");
-    }
-}
-
 static void Hiyoku_MainLogic(GameData* data, YakuType yaku) {
     if (!data->hiyoku_is_active) return;
     
@@ -278,50 +450,34 @@ static void Hiyoku_MainLogic(GameData* data, YakuType yaku) {
         data->hiyoku_st_games--;
     }
     
+    // 上乗せ → ボーナス当否 → EX振り分け → レベルアップ を1回で抽選
+    AtDelta delta = draw_kernel(hiyoku_kernel_for_level(data->hiyoku_level), yaku);
+
     bool reset_st = false;
-    int added_games = 0;
-    switch (yaku) {
-        case YAKU_OSHIJUN_BELL_LMR: case YAKU_OSHIJUN_BELL_LRM:
-        case YAKU_OSHIJUN_BELL_MLR: case YAKU_OSHIJUN_BELL_MRL:
-        case YAKU_OSHIJUN_BELL_RLM: case YAKU_OSHIJUN_BELL_RML:
-            if ((rand() % 100) < 35) added_games = 1;
-            break;
-        case YAKU_COMMON_BELL: 
-        case YAKU_REPLAY:
-            added_games = 1;
-            break;
-        default:
-            if (IsRareYaku(yaku)) {
-                added_games = 1;
-            }
-            break;
-    }
-    if (added_games > 0) {
-        data->bonus_high_prob_games += added_games;
-        snprintf(data->info_message, sizeof(data->info_message), "G数上乗せ +%dG！", added_games);
+    if (delta.added_games > 0) {
+        data->bonus_high_prob_games += delta.added_games;
+        GameEvent_Record(data, GAME_EVENT_GAME_ADDON, yaku, delta.added_games);
         reset_st = true;
     }
-    bool bonus_won = false;
-    switch (yaku) {
-        case YAKU_CHANCE_ME:
-        case YAKU_STRELITZIA_ME:
-        case YAKU_HP_REVERSE_STRONG_FRANXX: 
-            bonus_won = true;
-            break;
-        case YAKU_FRANXX_ME:
-            if (rand() % 2 == 0) bonus_won = true;
-            break;
-        case YAKU_CHERRY:
-            if ((rand() % 1000) < 125) bonus_won = true;
-            break;
-        default:
-            break;
-    }
-    if (bonus_won) {
+    if (delta.flags & (AT_DELTA_BONUS_STOCK | AT_DELTA_EX_STOCK)) {
         reset_st = true;
-        bool is_ex_stock = Hiyoku_PerformBonusAllocation(data, yaku);
-        snprintf(data->info_message, sizeof(data->info_message), "%s ストック！", is_ex_stock ? "BB EX" : "ボーナス");
-        Hiyoku_PerformLevelUp(data);
+        bool is_ex_stock = (delta.flags & AT_DELTA_EX_STOCK) != 0;
+        if (is_ex_stock) {
+            BB_EX_Init(data);
+        } else {
+            data->bonus_stock_count++;
+        }
+        GameEvent_Record(data, GAME_EVENT_BONUS_STOCK, yaku, is_ex_stock);
+
+        if (delta.flags & AT_DELTA_LEVEL_UP) {
+            if (data->hiyoku_level == HIYOKU_LV1) {
+                data->hiyoku_level = HIYOKU_LV2;
+                GameEvent_Record(data, GAME_EVENT_HIYOKU_LEVEL_UP, yaku, HIYOKU_LV2);
+            } else if (data->hiyoku_level == HIYOKU_LV2) {
+                data->hiyoku_level = HIYOKU_MAXX;
+                GameEvent_Record(data, GAME_EVENT_HIYOKU_LEVEL_UP, yaku, HIYOKU_MAXX);
+            }
+        }
     }
     if (reset_st) {
         data->hiyoku_st_games = get_st_games_from_level(data->hiyoku_level);
@@ -332,7 +488,7 @@ static void Hiyoku_MainLogic(GameData* data, YakuType yaku) {
         if (data->current_state == STATE_HIYOKU_BEATS) {
             transition_to_state(data, STATE_BONUS_HIGH_PROB);
         } else {
-            snprintf(data->info_message, sizeof(data->info_message), "比翼BEATS (並行) 終了");
+            GameEvent_Record(data, GAME_EVENT_HIYOKU_END, yaku, 0);
         }
     }
 }
@@ -353,8 +509,9 @@ static void handle_payout_bonus(GameData* data, YakuType yaku, int diff) {
     if (data->hiyoku_is_frozen && data->franxx_bonus_part_remaining > 0) {
         data->franxx_bonus_part_remaining -= progress;
         if (data->franxx_bonus_part_remaining <= 0) {
+            data->franxx_bonus_part_remaining = 0;
             data->hiyoku_is_frozen = false; 
-            snprintf(data->info_message, sizeof(data->info_message), "フランクスボーナス部 終了！ 比翼BEATS再開！");
+            GameEvent_Record(data, GAME_EVENT_FRANXX_PART_END, yaku, 0);
         }
     }
 
@@ -371,51 +528,29 @@ static void handle_payout_bonus(GameData* data, YakuType yaku, int diff) {
         case STATE_FRANXX_BONUS: 
             if (is_payout_reset_yaku(yaku)) {
                 data->current_bonus_payout = 0; 
-                snprintf(data->info_message, sizeof(data->info_message), "差枚リセット！");
+                GameEvent_Record(data, GAME_EVENT_PAYOUT_RESET, yaku, 0);
             }
-            switch (yaku) {
-                case YAKU_CHERRY: 
-                    if ((rand() % 1000) < 78) {
-                        snprintf(data->info_message, sizeof(data->info_message), "連れ出し！比翼BEATS (ホールド)");
-                        Hiyoku_Init(data, false); 
-                        data->hiyoku_is_frozen = true;
-                        data->franxx_bonus_part_remaining = PAYOUT_TARGET_FRANXX_BONUS - data->current_bonus_payout;
-                        if (data->franxx_bonus_part_remaining < 0) data->franxx_bonus_part_remaining = 0;
-                    }
-                    break;
-                case YAKU_CHANCE_ME:
-                    if (rand() % 2 == 0) {
-                        snprintf(data->info_message, sizeof(data->info_message), "連れ出し！比翼BEATS (ホールド)");
-                        Hiyoku_Init(data, false); 
-                        data->hiyoku_is_frozen = true;
-                        data->franxx_bonus_part_remaining = PAYOUT_TARGET_FRANXX_BONUS - data->current_bonus_payout;
-                        if (data->franxx_bonus_part_remaining < 0) data->franxx_bonus_part_remaining = 0;
-                    }
-                    break;
-                case YAKU_FRANXX_ME:
-                    if (rand() % 4 == 0) {
-                        snprintf(data->info_message, sizeof(data->info_message), "連れ出し！比翼BEATS (ホールド)");
-                        Hiyoku_Init(data, false); 
-                        data->hiyoku_is_frozen = true;
-                        data->franxx_bonus_part_remaining = PAYOUT_TARGET_FRANXX_BONUS - data->current_bonus_payout;
-                        if (data->franxx_bonus_part_remaining < 0) data->franxx_bonus_part_remaining = 0;
-                    }
-                    break;
-                case YAKU_STRELITZIA_ME:
-                case YAKU_HP_REVERSE_STRELITZIA:
-                case YAKU_HP_REVERSE_STRONG_FRANXX:
-                    snprintf(data->info_message, sizeof(data->info_message), "連れ出し + BB EXへ！");
+        {
+            // 連れ出し (初期レベル込み) と G数上乗せ を1回で抽選
+            AtDelta delta = draw_kernel(AT_KERNEL_FRANXX_BONUS, yaku);
+            if (delta.flags & AT_DELTA_TSUREDASHI) {
+                if (delta.flags & AT_DELTA_TO_BB_EX) {
+                    GameEvent_Record(data, GAME_EVENT_TSUREDASHI, yaku, 1);
                     BB_EX_Init(data); 
-                    Hiyoku_Init(data, false);
-                    data->hiyoku_is_frozen = true;
-                    data->franxx_bonus_part_remaining = PAYOUT_TARGET_FRANXX_BONUS - data->current_bonus_payout;
-                    if (data->franxx_bonus_part_remaining < 0) data->franxx_bonus_part_remaining = 0;
+                } else {
+                    GameEvent_Record(data, GAME_EVENT_TSUREDASHI, yaku, 0);
+                }
+                Hiyoku_Start(data, (HiyokuLevel)delta.hiyoku_level);
+                data->hiyoku_is_frozen = true;
+                data->franxx_bonus_part_remaining = Spec_Get()->target_franxx_bonus - data->current_bonus_payout;
+                if (data->franxx_bonus_part_remaining < 0) data->franxx_bonus_part_remaining = 0;
+                if (delta.flags & AT_DELTA_TO_BB_EX) {
                     transition_to_state(data, STATE_BB_EX); 
                     did_transition = true;
-                    break;
-                default: break;
+                }
             }
-            perform_game_count_addon(data, yaku);
+            apply_game_count_delta(data, yaku, delta);
+        }
             break;
         case STATE_BB_EX: 
             if (data->bonus_high_prob_games >= 30) {
@@ -427,7 +562,7 @@ static void handle_payout_bonus(GameData* data, YakuType yaku, int diff) {
         case STATE_TSUREDASHI: 
             if (is_payout_reset_yaku(yaku)) {
                 data->current_bonus_payout = 0;
-                snprintf(data->info_message, sizeof(data->info_message), "差枚リセット！");
+                GameEvent_Record(data, GAME_EVENT_PAYOUT_RESET, yaku, 0);
             }
             break;
         default: break;
@@ -451,7 +586,7 @@ static void handle_payout_bonus(GameData* data, YakuType yaku, int diff) {
         }
         else 
         {
-            data->bonus_high_prob_games += GAMES_ON_BB_INITIAL_END;
+            data->bonus_high_prob_games += Spec_Get()->games_on_bb_initial_end;
             transition_to_state(data, STATE_BONUS_HIGH_PROB); 
         }
     }
@@ -460,10 +595,144 @@ static void handle_payout_bonus(GameData* data, YakuType yaku, int diff) {
 
 // --- 公開関数 ---
 
+// 宣言的なレート配列を検証し、表示用に登録する
+static bool validate_rates(WeightedTable* t, const char* category, YakuType yaku, const SpecRateList* rates) {
+    WeightedTable_Free(t);
+    if (rates->count == 0) return true;
+    char name[WEIGHTED_NAME_LEN];
+    snprintf(name, sizeof(name), "%s/%s", category, GetYakuName(yaku));
+    return WeightedTable_Init(t, name, rates->entries, rates->count, RATE_DENOMINATOR);
+}
+
+bool AT_InitTables(void) {
+    static const char* kernel_names[AT_KERNEL_COUNT] = {
+        "AT/G数上乗せ", "AT/差枚数上乗せ", "AT/フランクスボーナス",
+        "AT/比翼BEATS Lv1", "AT/比翼BEATS Lv2", "AT/比翼BEATS MAXX"
+    };
+    const MachineSpec* spec = Spec_Get();
+    const SpecRateList* levels = &spec->hiyoku_init_level;
+    const SpecRateList* ex_rates = &spec->bb_ex_continue_rate;
+
+    WeightedTable_Free(&g_hiyoku_init_level_table);
+    WeightedTable_Free(&g_bb_ex_rate_table);
+    bool ok = WeightedTable_Init(&g_hiyoku_init_level_table, "AT/比翼BEATS 初期レベル",
+                                 levels->entries, levels->count, RATE_DENOMINATOR);
+    ok &= WeightedTable_Init(&g_bb_ex_rate_table, "AT/BB EX 継続率",
+                             ex_rates->entries, ex_rates->count, BB_EX_RATE_DENOMINATOR);
+    for (int i = 0; i < g_bb_ex_rate_count; i++) {
+        WeightedTable_Free(&g_bb_ex_payout_tables[i].table);
+    }
+    g_bb_ex_rate_count = ex_rates->count;
+    for (int i = 0; i < ex_rates->count; i++) {
+        ok &= build_bb_ex_table(&g_bb_ex_payout_tables[i], ex_rates->entries[i].value);
+    }
+
+    for (int y = 0; y < YAKU_COUNT; y++) {
+        YakuType yaku = (YakuType)y;
+        bool has_gcount = spec->gcount_trigger[y] > 0 && !spec->ex_stock[y];
+        SpecRateList no_rates = {0};
+        ok &= validate_rates(&g_gcount_tables[y], "G数上乗せ振り分け", yaku, has_gcount ? &spec->gcount[y] : &no_rates);
+        ok &= validate_rates(&g_payout_tables[y], "差枚数上乗せ振り分け", yaku, &spec->payout_addon[y]);
+
+        char names[AT_KERNEL_COUNT][WEIGHTED_NAME_LEN];
+        for (int k = 0; k < AT_KERNEL_COUNT; k++) {
+            snprintf(names[k], sizeof(names[k]), "%s/%s", kernel_names[k], GetYakuName(yaku));
+        }
+        ok &= build_gcount_kernel(&g_at_kernels[AT_KERNEL_GCOUNT_ADDON][y], yaku, names[AT_KERNEL_GCOUNT_ADDON]);
+        ok &= build_payout_kernel(&g_at_kernels[AT_KERNEL_PAYOUT_ADDON][y], yaku, names[AT_KERNEL_PAYOUT_ADDON]);
+        ok &= build_franxx_kernel(&g_at_kernels[AT_KERNEL_FRANXX_BONUS][y], yaku, names[AT_KERNEL_FRANXX_BONUS]);
+        ok &= build_hiyoku_kernel(&g_at_kernels[AT_KERNEL_HIYOKU_LV1][y], yaku, HIYOKU_LV1, names[AT_KERNEL_HIYOKU_LV1]);
+        ok &= build_hiyoku_kernel(&g_at_kernels[AT_KERNEL_HIYOKU_LV2][y], yaku, HIYOKU_LV2, names[AT_KERNEL_HIYOKU_LV2]);
+        ok &= build_hiyoku_kernel(&g_at_kernels[AT_KERNEL_HIYOKU_MAXX][y], yaku, HIYOKU_MAXX, names[AT_KERNEL_HIYOKU_MAXX]);
+
+        // ボーナス中の抽選 (上乗せ・連れ出し・差枚リセット) がすべて空振りの役
+        g_quiet_yaku[y] = !is_payout_reset_yaku(yaku) &&
+                          is_identity_kernel(&g_at_kernels[AT_KERNEL_GCOUNT_ADDON][y]) &&
+                          is_identity_kernel(&g_at_kernels[AT_KERNEL_PAYOUT_ADDON][y]) &&
+                          is_identity_kernel(&g_at_kernels[AT_KERNEL_FRANXX_BONUS][y]);
+    }
+    return ok;
+}
+
 void AT_Init(GameData* data) {
     transition_to_state(data, STATE_BB_INITIAL);
 }
 
+void AT_StartBonus(GameData* data, AT_BonusResultType result) {
+    switch (result) {
+        case BONUS_DARLING:
+            transition_to_state(data, STATE_BB_HIGH_PROB);
+            break;
+        case BONUS_FRANXX:
+            transition_to_state(data, STATE_FRANXX_BONUS);
+            break;
+        case BONUS_BB_EX:
+            if (data->queued_bb_ex_payout <= 0) {
+                BB_EX_Init(data);
+            }
+            transition_to_state(data, STATE_BB_EX);
+            break;
+        case BONUS_EPISODE:
+            transition_to_state(data, STATE_EPISODE_BONUS);
+            break;
+        default:
+            break;
+    }
+}
+
+int AT_GetBBExPayoutDistribution(int continue_rate_percent, int* payouts, double* probs, int max_count, double* tail_prob) {
+    double tail = 1.0;
+    int count = 0;
+    const SpecRateList* rates = &Spec_Get()->bb_ex_continue_rate;
+    for (int i = 0; i < rates->count; i++) {
+        int rate = rates->entries[i].value;
+        if (continue_rate_percent != 0 && rate != continue_rate_percent) continue;
+        double weight = (continue_rate_percent != 0)
+            ? 1.0 : (double)rates->entries[i].weight / BB_EX_RATE_DENOMINATOR;
+        double p = rate / (double)BB_EX_RATE_DENOMINATOR;
+
+        // 継続回数 k の確率 p^k (1-p)。枚数は k について単調増加
+        double pk = 1.0;
+        for (int k = 0; k < max_count; k++) {
+            double mass = weight * pk * (1.0 - p);
+            if (k >= count) {
+                payouts[k] = (int)bb_ex_payout_for_continues(k);
+                probs[k] = 0.0;
+                count = k + 1;
+            }
+            probs[k] += mass;
+            pk *= p;
+        }
+    }
+    for (int k = 0; k < count; k++) tail -= probs[k];
+    if (count == 0) tail = 0.0;
+    if (tail_prob) *tail_prob = (tail > 0.0) ? tail : 0.0;
+    return count;
+}
+
+bool AT_IsQuietGame(const GameData* data, YakuType yaku) {
+    // 並行比翼BEATS中は全役でSTG数が動くため対象外
+    if (data->hiyoku_is_active) return false;
+
+    switch (data->current_state) {
+        case STATE_BB_INITIAL:
+        case STATE_BB_HIGH_PROB:
+        case STATE_FRANXX_BONUS:
+        case STATE_BB_EX:
+        case STATE_EPISODE_BONUS:
+            break;
+        default:
+            return false;
+    }
+
+    // 上乗せ・リセット・連れ出しのいずれの抽選にも関わらない役
+    return g_quiet_yaku[yaku];
+}
+
+int AT_GetHiyokuStGames(HiyokuLevel level) {
+    return get_st_games_from_level(level);
+}
+
 void AT_Update(GameData* data, YakuType yaku, int diff, bool lever_on, bool all_reels_stopped) {
 
     if (lever_on) {
@@ -4,7 +4,7 @@
 #include "game_data.h" 
 #include <SDL2/SDL.h> 
 
-// --- 定義 (AT内部でのみ使う定数) ---
+// --- 定義 (既定スペックの値。実際の値は spec.h の MachineSpec) ---
 #define BET_COUNT 3
 #define PAYOUT_TARGET_BB_INITIAL 100      // 1. BB[初当り]
 #define PAYOUT_TARGET_BB_HIGH_PROB 100    // 3. BB[高確中]
@@ -16,11 +16,46 @@
 
 // --- 公開関数プロトタイプ ---
 
+/**
+ * @brief 現在のスペック (Spec_Get) から AT内の抽選カーネル (連鎖抽選の同時分布) を構築します。
+ * 抽選を行う前に呼び出してください (スペックを変更した場合は再度呼び出す)。
+ * @return レート定義の重みが分母と一致しないなど、不正な定義があれば false
+ */
+bool AT_InitTables(void);
+
 /**
  * @brief AT突入時の初期化処理
  */
 void AT_Init(GameData* data);
 
+/**
+ * @brief AT高確率状態でのボーナス当選を反映し、該当ボーナスへ遷移します。
+ * @param result Lottery_CheckBonus_AT の当選結果 (当選以外は何もしない)
+ */
+void AT_StartBonus(GameData* data, AT_BonusResultType result);
+
+/**
+ * @brief BB EX の最終獲得枚数の分布 (厳密値) を返します。
+ * @param continue_rate_percent 継続率 (50 / 80)。0 の場合は継続率振り分けを含めた全体の分布
+ * @param payouts 獲得枚数 (昇順) の出力先
+ * @param probs 各獲得枚数の確率の出力先
+ * @param max_count 出力する最大個数
+ * @param tail_prob 出力しきれなかった残りの確率 (NULL 可)
+ * @return 出力した個数 (該当する継続率がない場合は 0)
+ */
+int AT_GetBBExPayoutDistribution(int continue_rate_percent, int* payouts, double* probs, int max_count, double* tail_prob);
+
+/**
+ * @brief 現在の状態で、その役が差枚の進行以外に何も起こさないかを判定します。
+ * (ボーナス中の押順ベル/リプレイ/ハズレなど。一括消化の判定に使用)
+ */
+bool AT_IsQuietGame(const GameData* data, YakuType yaku);
+
+/**
+ * @brief 比翼BEATS のレベルごとの ST G数 (開始時・上乗せ時に戻る値) を返します。
+ */
+int AT_GetHiyokuStGames(HiyokuLevel level);
+
 /**
  * @brief AT中のメイン更新処理 (毎フレーム呼び出す)
  *
@@ -0,0 +1,887 @@
+#include "at_value.h"
+#include "at.h"
+#include "lottery.h"
+#include "parallel.h"
+#include "rng.h"
+#include "sim.h"
+#include "spec.h"
+#include "weighted_table.h"
+#include <SDL2/SDL.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#define AT_VALUE_MAGIC "FXATVAL"
+#define AT_VALUE_VERSION 1
+#define AT_VALUE_SEED 0x41545641ULL     // ブロック b の抽選は Rng_SeedStream(seed, b)
+#define AT_VALUE_BRANCH_EPS 1e-4        // 成立役込みでこれより低い確率の分岐は列挙せず、乱数で 1 本辿る
+#define AT_VALUE_MAX_DEPTH 64           // 1 ゲーム内の抽選回数の上限
+#define AT_VALUE_BLOCK 256              // 1 タスクで列挙する格子点数
+#define AT_VALUE_MERGE_SLOTS 16384      // 1 格子点の遷移先の集約用 (2 の累乗)
+#define AT_VALUE_TOLERANCE 1e-8         // 連立方程式の収束判定 (右辺の最大値に対する残差の比)
+#define AT_VALUE_MAX_ITERATIONS 2000
+
+// 格子 (補間する軸)
+static const int k_games_grid[] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 12, 14, 16, 20, 24, 29, 30, 32, 40, 48, 64, 96, 128, 192, 256, 384, 512
+};
+static const int k_remain_grid[] = {
+    1, 2, 4, 8, 16, 24, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048, 3072, 4096, 6144, 8192, 12288
+};
+static const int k_queue_grid[] = { 0, 200, 300, 500, 700, 1000, 1500, 2000, 3000, 5000, 8000, 12000 };
+static const int k_part_grid[] = { 0, 1, 8, 16, 32, 48, 64 };
+
+#define GRID_COUNT(a) (int)(sizeof(a) / sizeof((a)[0]))
+#define GAMES_COUNT GRID_COUNT(k_games_grid)
+#define REMAIN_COUNT GRID_COUNT(k_remain_grid)
+#define QUEUE_COUNT GRID_COUNT(k_queue_grid)
+#define PART_COUNT GRID_COUNT(k_part_grid)
+
+// ボーナス高確率の G数はこの値まで 1G 刻みで持つ
+// (毎ゲームの減算を補間で丸めると、残りG数の消化が確率的になり分散が膨らむため)
+#define COUNTDOWN_EXACT_GAMES 320
+#define COUNTDOWN_MAX_COUNT (COUNTDOWN_EXACT_GAMES + 1 + GAMES_COUNT)
+
+// 表に持つ状態 (連れ出しは遷移しないため持たない)
+static const AT_State k_value_states[] = {
+    STATE_BB_INITIAL, STATE_BONUS_HIGH_PROB, STATE_BB_HIGH_PROB, STATE_FRANXX_BONUS,
+    STATE_BB_EX, STATE_HIYOKU_BEATS, STATE_EPISODE_BONUS
+};
+#define VALUE_STATE_COUNT GRID_COUNT(k_value_states)
+
+// 状態ごとの格子点の並び: [比翼BEATS][G数][残り枚数][EX待機]
+typedef struct {
+    int base;            // 先頭の格子点番号
+    int hiyoku_count;
+    int games_count;
+    int remain_count;    // 残り枚数を持たない状態は 1
+} SlotLayout;
+
+// 比翼BEATS の格子 (フランクスボーナス・BB EX): 0 = なし / 並行作動 (レベル × 残りST) /
+// 停止中 (レベル × フランクスボーナス部の残り枚数、残りST は常に満タン)。比翼BEATS 状態は並行作動の分だけ
+typedef struct {
+    SlotLayout slots[VALUE_STATE_COUNT];
+    int parallel_base[HIYOKU_MAXX + 1]; // レベルごとの並行作動の先頭 (残りST 1 の位置)
+    int parallel_count;
+    int hiyoku_count;
+    int franxx_remain_count;            // フランクスボーナスで使う残り枚数の格子点数
+    int countdown_games[COUNTDOWN_MAX_COUNT];
+    int countdown_count;
+    int cell_count;
+} ValueLayout;
+
+// ファイル形式: ヘッダ + 格子点ごとの AtValueCell
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t cell_count;
+    uint32_t dims[8];       // 状態, 比翼BEATS, G数, 高確率の G数, 残り枚数, フランクスボーナスの残り枚数, EX待機, 部の残り枚数
+    uint64_t spec_hash;
+} AtValueHeader;
+
+typedef struct {
+    float mean;
+    float variance;
+} AtValueCell;
+
+struct AtValueTable {
+    ValueLayout layout;
+    const AtValueCell* cells;
+    void* view;
+    size_t size;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+};
+
+// 1 軸の線形補間 (下側・上側の格子点と重み)
+typedef struct {
+    int count;
+    int index[2];
+    double weight[2];
+} AxisSplit;
+
+// 遷移 (同じ遷移先の分は合算する)
+typedef struct {
+    uint32_t next;
+    float prob;
+    float prob_diff;    // 遷移確率 × そのゲームの差枚
+} ValueEdge;
+
+typedef struct {
+    int cell;
+    uint32_t first_edge;
+    uint32_t edge_count;
+    double mean_diff;     // 1 ゲームの差枚の期待値
+    double mean_sq_diff;  // その二乗の期待値
+    double self_prob;     // 自分自身への遷移 (反復せずに解く)
+    double self_prob_diff;
+} ValueNode;
+
+typedef struct {
+    ValueNode* nodes;
+    int node_count;
+    ValueEdge* edges;
+    size_t edge_count;
+    size_t edge_capacity;
+    long long replays;
+    bool failed;
+} ValueBlock;
+
+typedef struct {
+    const ValueLayout* layout;
+    ValueBlock* blocks;
+} BuildJob;
+
+// 1 ゲームの抽選分岐の列挙 (WeightedTable_Sample の差し替え)
+typedef struct {
+    int depth;                                  // このゲームで何回目の抽選か
+    int length;                                 // 列挙中の分岐の深さ
+    int choice[AT_VALUE_MAX_DEPTH];
+    const WeightedTable* table[AT_VALUE_MAX_DEPTH];
+    double prob[AT_VALUE_MAX_DEPTH + 1];        // 先頭から d 回目までの分岐の確率 (成立役込み)
+} Enumerator;
+
+// 遷移先の集約
+typedef struct {
+    uint32_t key[AT_VALUE_MERGE_SLOTS];
+    uint32_t stamp[AT_VALUE_MERGE_SLOTS];
+    double prob[AT_VALUE_MERGE_SLOTS];
+    double prob_diff[AT_VALUE_MERGE_SLOTS];
+    int used[AT_VALUE_MERGE_SLOTS / 2];
+    int used_count;
+    uint32_t generation;
+} MergeMap;
+
+// --- 内部ヘルパー関数 ---
+
+static void get_layout(ValueLayout* layout) {
+    memset(layout, 0, sizeof(*layout));
+    for (int level = HIYOKU_LV1; level <= HIYOKU_MAXX; level++) {
+        layout->parallel_base[level] = layout->parallel_count;
+        layout->parallel_count += AT_GetHiyokuStGames((HiyokuLevel)level);
+    }
+    layout->hiyoku_count = 1 + layout->parallel_count + (HIYOKU_MAXX - HIYOKU_LV1 + 1) * PART_COUNT;
+
+    // フランクスボーナスは上乗せがないので、目標の 2 倍までで足りる
+    int limit = 2 * Spec_Get()->target_franxx_bonus;
+    layout->franxx_remain_count = REMAIN_COUNT;
+    for (int i = 0; i < REMAIN_COUNT; i++) {
+        if (k_remain_grid[i] >= limit) {
+            layout->franxx_remain_count = i + 1;
+            break;
+        }
+    }
+
+    for (int g = 0; g <= COUNTDOWN_EXACT_GAMES; g++) {
+        layout->countdown_games[layout->countdown_count++] = g;
+    }
+    for (int i = 0; i < GAMES_COUNT; i++) {
+        if (k_games_grid[i] > COUNTDOWN_EXACT_GAMES) layout->countdown_games[layout->countdown_count++] = k_games_grid[i];
+    }
+
+    int base = 0;
+    for (int slot = 0; slot < VALUE_STATE_COUNT; slot++) {
+        SlotLayout* sl = &layout->slots[slot];
+        sl->base = base;
+        sl->hiyoku_count = 1;
+        sl->games_count = GAMES_COUNT;
+        sl->remain_count = REMAIN_COUNT;
+        switch (k_value_states[slot]) {
+            case STATE_BONUS_HIGH_PROB:
+                sl->games_count = layout->countdown_count;
+                sl->remain_count = 1;
+                break;
+            case STATE_HIYOKU_BEATS:
+                sl->hiyoku_count = layout->parallel_count;
+                sl->remain_count = 1;
+                break;
+            case STATE_FRANXX_BONUS:
+                sl->hiyoku_count = layout->hiyoku_count;
+                sl->remain_count = layout->franxx_remain_count;
+                break;
+            case STATE_BB_EX:
+                sl->hiyoku_count = layout->hiyoku_count;
+                break;
+            default:
+                break;
+        }
+        base += sl->hiyoku_count * sl->games_count * sl->remain_count * QUEUE_COUNT;
+    }
+    layout->cell_count = base;
+}
+
+static int state_slot(AT_State state) {
+    for (int i = 0; i < VALUE_STATE_COUNT; i++) {
+        if (k_value_states[i] == state) return i;
+    }
+    return -1;
+}
+
+static const int* games_grid(const ValueLayout* layout, int slot) {
+    return (k_value_states[slot] == STATE_BONUS_HIGH_PROB) ? layout->countdown_games : k_games_grid;
+}
+
+static int cell_index(const ValueLayout* layout, int slot, int hiyoku, int games, int remain, int queue) {
+    const SlotLayout* sl = &layout->slots[slot];
+    return sl->base + ((hiyoku * sl->games_count + games) * sl->remain_count + remain) * QUEUE_COUNT + queue;
+}
+
+static void split_axis(const int* grid, int count, long long x, AxisSplit* s) {
+    s->count = 1;
+    s->weight[0] = 1.0;
+    if (x <= grid[0]) {
+        s->index[0] = 0;
+        return;
+    }
+    if (x >= grid[count - 1]) {
+        s->index[0] = count - 1;
+        return;
+    }
+    int i = 0;
+    while (grid[i + 1] <= x) i++;
+    s->index[0] = i;
+    if (grid[i] == x) return;
+    double w = (double)(x - grid[i]) / (grid[i + 1] - grid[i]);
+    s->count = 2;
+    s->index[1] = i + 1;
+    s->weight[0] = 1.0 - w;
+    s->weight[1] = w;
+}
+
+static void single_axis(int index, AxisSplit* s) {
+    s->count = 1;
+    s->index[0] = index;
+    s->weight[0] = 1.0;
+}
+
+// 状態を補間する格子点 (高々 16 点) と重みに分解する。表にない状態は 0 を返す
+static int encode_state(const ValueLayout* layout, const GameData* data, int* cells, double* weights) {
+    AT_State state = data->current_state;
+    int slot = state_slot(state);
+    if (slot < 0) return 0;
+    const SlotLayout* sl = &layout->slots[slot];
+
+    int hiyoku_base = 0;
+    AxisSplit hs, gs, rs, qs;
+    single_axis(0, &hs);
+    if (sl->hiyoku_count > 1 && data->hiyoku_is_active) {
+        int level = data->hiyoku_level;
+        if (level < HIYOKU_LV1) level = HIYOKU_LV1;
+        if (level > HIYOKU_MAXX) level = HIYOKU_MAXX;
+        if (data->hiyoku_is_frozen && state != STATE_HIYOKU_BEATS) {
+            hiyoku_base = 1 + layout->parallel_count + (level - HIYOKU_LV1) * PART_COUNT;
+            split_axis(k_part_grid, PART_COUNT, data->franxx_bonus_part_remaining, &hs);
+        } else {
+            int st_games = data->hiyoku_st_games;
+            int st_max = AT_GetHiyokuStGames((HiyokuLevel)level);
+            if (st_games < 1) st_games = 1;
+            if (st_games > st_max) st_games = st_max;
+            hiyoku_base = layout->parallel_base[level] + st_games - 1;
+            if (state != STATE_HIYOKU_BEATS) hiyoku_base++; // 先頭は「なし」
+        }
+    } else if (state == STATE_HIYOKU_BEATS) {
+        return 0; // 作動していない比翼BEATS はない
+    }
+
+    split_axis(games_grid(layout, slot), sl->games_count, data->bonus_high_prob_games, &gs);
+    if (sl->remain_count > 1) {
+        split_axis(k_remain_grid, sl->remain_count, (long long)data->target_bonus_payout - data->current_bonus_payout, &rs);
+    } else {
+        single_axis(0, &rs);
+    }
+    split_axis(k_queue_grid, QUEUE_COUNT, data->queued_bb_ex_payout, &qs);
+
+    int n = 0;
+    for (int h = 0; h < hs.count; h++)
+    for (int g = 0; g < gs.count; g++)
+    for (int r = 0; r < rs.count; r++)
+    for (int q = 0; q < qs.count; q++) {
+        cells[n] = cell_index(layout, slot, hiyoku_base + hs.index[h], gs.index[g], rs.index[r], qs.index[q]);
+        weights[n] = hs.weight[h] * gs.weight[g] * rs.weight[r] * qs.weight[q];
+        n++;
+    }
+    return n;
+}
+
+// 格子点の代表状態 (ゲームの区切り) を作る
+static void decode_cell(const ValueLayout* layout, int cell, GameData* data) {
+    int slot = VALUE_STATE_COUNT - 1;
+    while (layout->slots[slot].base > cell) slot--;
+    const SlotLayout* sl = &layout->slots[slot];
+    int local = cell - sl->base;
+    int queue = local % QUEUE_COUNT;
+    local /= QUEUE_COUNT;
+    int remain = local % sl->remain_count;
+    local /= sl->remain_count;
+    int games = local % sl->games_count;
+    int hiyoku = local / sl->games_count;
+
+    memset(data, 0, sizeof(*data));
+    data->current_state = k_value_states[slot];
+    data->bonus_high_prob_games = games_grid(layout, slot)[games];
+    data->queued_bb_ex_payout = k_queue_grid[queue];
+    if (data->current_state == STATE_BONUS_HIGH_PROB) {
+        data->at_step = AT_STEP_WAIT_LEVER1;
+    }
+    if (sl->remain_count > 1) {
+        if (data->current_state == STATE_FRANXX_BONUS) {
+            data->target_bonus_payout = Spec_Get()->target_franxx_bonus;
+            data->current_bonus_payout = data->target_bonus_payout - k_remain_grid[remain];
+        } else {
+            data->target_bonus_payout = k_remain_grid[remain];
+        }
+    }
+
+    if (data->current_state != STATE_HIYOKU_BEATS) {
+        if (hiyoku == 0) return;
+        hiyoku--;
+    }
+    if (hiyoku >= layout->parallel_count) {
+        int frozen = hiyoku - layout->parallel_count;
+        int level = HIYOKU_LV1 + frozen / PART_COUNT;
+        data->hiyoku_is_active = true;
+        data->hiyoku_is_frozen = true;
+        data->hiyoku_level = (HiyokuLevel)level;
+        data->hiyoku_st_games = AT_GetHiyokuStGames((HiyokuLevel)level);
+        data->franxx_bonus_part_remaining = k_part_grid[frozen % PART_COUNT];
+    } else {
+        int level = HIYOKU_MAXX;
+        while (layout->parallel_base[level] > hiyoku) level--;
+        data->hiyoku_is_active = true;
+        data->hiyoku_level = (HiyokuLevel)level;
+        data->hiyoku_st_games = hiyoku - layout->parallel_base[level] + 1;
+    }
+}
+
+static int sample_entry(const WeightedTable* t) {
+    uint64_t r = Rng_BelowU64(t->denominator);
+    int i = 0;
+    while (i < t->count - 1 && r >= t->entries[i].weight) {
+        r -= t->entries[i].weight;
+        i++;
+    }
+    return i;
+}
+
+// 列挙中の分岐はその選択を返し、新しい抽選は先頭の分岐から始める。
+// 確率が AT_VALUE_BRANCH_EPS を下回った先は列挙せず、乱数で 1 本だけ辿る (期待値は偏らない)
+static int enumerate_hook(const WeightedTable* t, void* user) {
+    Enumerator* e = user;
+    int d = e->depth++;
+    if (d < e->length) return e->choice[d];
+    if (d != e->length || d >= AT_VALUE_MAX_DEPTH || e->prob[d] < AT_VALUE_BRANCH_EPS) {
+        return sample_entry(t);
+    }
+
+    int i = 0;
+    while (t->entries[i].weight == 0) i++;
+    e->table[d] = t;
+    e->choice[d] = i;
+    e->prob[d + 1] = e->prob[d] * (double)t->entries[i].weight / (double)t->denominator;
+    e->length = d + 1;
+    return i;
+}
+
+// 次の分岐へ進める (末尾の抽選から桁上がり)
+static bool enumerate_next(Enumerator* e) {
+    for (int d = e->length - 1; d >= 0; d--) {
+        const WeightedTable* t = e->table[d];
+        for (int i = e->choice[d] + 1; i < t->count; i++) {
+            if (t->entries[i].weight == 0) continue;
+            e->choice[d] = i;
+            e->prob[d + 1] = e->prob[d] * (double)t->entries[i].weight / (double)t->denominator;
+            e->length = d + 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void merge_reset(MergeMap* m) {
+    m->used_count = 0;
+    m->generation++;
+}
+
+static bool merge_add(MergeMap* m, uint32_t key, double prob, double prob_diff) {
+    uint32_t i = (key * 2654435761u) & (AT_VALUE_MERGE_SLOTS - 1);
+    while (m->stamp[i] == m->generation) {
+        if (m->key[i] == key) {
+            m->prob[i] += prob;
+            m->prob_diff[i] += prob_diff;
+            return true;
+        }
+        i = (i + 1) & (AT_VALUE_MERGE_SLOTS - 1);
+    }
+    if (m->used_count >= AT_VALUE_MERGE_SLOTS / 2) return false;
+    m->stamp[i] = m->generation;
+    m->key[i] = key;
+    m->prob[i] = prob;
+    m->prob_diff[i] = prob_diff;
+    m->used[m->used_count++] = (int)i;
+    return true;
+}
+
+static bool push_edge(ValueBlock* b, uint32_t next, double prob, double prob_diff) {
+    if (b->edge_count == b->edge_capacity) {
+        size_t capacity = b->edge_capacity ? b->edge_capacity * 2 : 4096;
+        ValueEdge* edges = realloc(b->edges, capacity * sizeof(ValueEdge));
+        if (!edges) return false;
+        b->edges = edges;
+        b->edge_capacity = capacity;
+    }
+    ValueEdge* e = &b->edges[b->edge_count++];
+    e->next = next;
+    e->prob = (float)prob;
+    e->prob_diff = (float)prob_diff;
+    return true;
+}
+
+// 格子点 1 つの 1 ゲーム分の遷移を列挙する
+static bool build_node(const ValueLayout* layout, int cell, ValueBlock* b, MergeMap* merge, Enumerator* e) {
+    ValueNode* node = &b->nodes[b->node_count++];
+    memset(node, 0, sizeof(*node));
+    node->cell = cell;
+    node->first_edge = (uint32_t)b->edge_count;
+
+    GameData base;
+    decode_cell(layout, cell, &base);
+    LotteryTableId table = (base.current_state == STATE_FRANXX_BONUS) ? LOTTERY_TABLE_FRANXX_HIGH_PROB : LOTTERY_TABLE_NORMAL;
+
+    merge_reset(merge);
+    SimContext ctx;
+    int next_cells[16];
+    double next_weights[16];
+    for (int y = 0; y < YAKU_COUNT; y++) {
+        int w = Lottery_GetWeight(table, (YakuType)y);
+        if (w <= 0) continue;
+
+        e->length = 0;
+        e->prob[0] = (double)w / LOTTERY_DENOMINATOR;
+        do {
+            e->depth = 0;
+            Sim_Init(&ctx, NULL);
+            ctx.data = base;
+            Sim_PlayYaku(&ctx, (YakuType)y);
+            b->replays++;
+
+            double p = e->prob[e->length];
+            double diff = (double)(ctx.data.total_payout_diff - base.total_payout_diff);
+            node->mean_diff += p * diff;
+            node->mean_sq_diff += p * diff * diff;
+            if (ctx.data.current_state == STATE_AT_END) continue;
+
+            int n = encode_state(layout, &ctx.data, next_cells, next_weights);
+            if (n == 0) {
+                fprintf(stderr, "AtValue: %s から表にない状態 (%s) に遷移しました\n",
+                        AT_GetStateName(base.current_state), AT_GetStateName(ctx.data.current_state));
+                return false;
+            }
+            for (int i = 0; i < n; i++) {
+                if (!merge_add(merge, (uint32_t)next_cells[i], p * next_weights[i], p * next_weights[i] * diff)) {
+                    fprintf(stderr, "AtValue: 遷移先が多すぎます (%s)\n", AT_GetStateName(base.current_state));
+                    return false;
+                }
+            }
+        } while (enumerate_next(e));
+    }
+
+    for (int u = 0; u < merge->used_count; u++) {
+        int i = merge->used[u];
+        if ((int)merge->key[i] == cell) {
+            node->self_prob = merge->prob[i];
+            node->self_prob_diff = merge->prob_diff[i];
+        } else if (!push_edge(b, merge->key[i], merge->prob[i], merge->prob_diff[i])) {
+            fprintf(stderr, "AtValue: 遷移表のメモリを確保できません\n");
+            return false;
+        }
+    }
+    node->edge_count = (uint32_t)(b->edge_count - node->first_edge);
+    return true;
+}
+
+static void build_task(int task_index, void* user) {
+    BuildJob* job = user;
+    ValueBlock* b = &job->blocks[task_index];
+    int begin = task_index * AT_VALUE_BLOCK;
+    int end = begin + AT_VALUE_BLOCK;
+    if (end > job->layout->cell_count) end = job->layout->cell_count;
+
+    MergeMap* merge = calloc(1, sizeof(MergeMap));
+    Enumerator* e = calloc(1, sizeof(Enumerator));
+    b->nodes = malloc((size_t)(end - begin) * sizeof(ValueNode));
+    if (!merge || !e || !b->nodes) {
+        fprintf(stderr, "AtValue: メモリを確保できません\n");
+        b->failed = true;
+    }
+
+    Rng_SeedStream(AT_VALUE_SEED, (uint64_t)task_index);
+    WeightedTable_SetSampleHook(enumerate_hook, e);
+    for (int i = begin; i < end && !b->failed; i++) {
+        if (!build_node(job->layout, i, b, merge, e)) b->failed = true;
+    }
+    WeightedTable_SetSampleHook(NULL, NULL);
+    free(merge);
+    free(e);
+}
+
+// 連立方程式 (I - P) x = b の行列の掛け算 (P は格子点間の遷移確率。自己遷移は対角に含める)
+typedef struct {
+    const BuildJob* build;
+    const double* in;
+    double* out;
+} MatVecJob;
+
+static void matvec_task(int task_index, void* user) {
+    MatVecJob* mv = user;
+    const ValueBlock* b = &mv->build->blocks[task_index];
+    int base = task_index * AT_VALUE_BLOCK;
+    for (int ni = 0; ni < b->node_count; ni++) {
+        const ValueNode* node = &b->nodes[ni];
+        const ValueEdge* edge = &b->edges[node->first_edge];
+        double y = (1.0 - node->self_prob) * mv->in[base + ni];
+        for (uint32_t k = 0; k < node->edge_count; k++) {
+            y -= edge[k].prob * mv->in[edge[k].next];
+        }
+        mv->out[base + ni] = y;
+    }
+}
+
+static void apply_matrix(const BuildJob* job, int threads, const double* in, double* out) {
+    MatVecJob mv = { job, in, out };
+    int block_count = (job->layout->cell_count + AT_VALUE_BLOCK - 1) / AT_VALUE_BLOCK;
+    Parallel_Run(block_count, threads, matvec_task, &mv);
+}
+
+static double dot(const double* a, const double* b, int n) {
+    double sum = 0.0;
+    for (int i = 0; i < n; i++) sum += a[i] * b[i];
+    return sum;
+}
+
+static double max_abs(const double* a, int n) {
+    double m = 0.0;
+    for (int i = 0; i < n; i++) {
+        double v = fabs(a[i]);
+        if (!(v <= m)) m = v; // NaN も拾う
+    }
+    return m;
+}
+
+// 前処理: 下三角部分 (番号の小さい遷移先) によるガウス・ザイデル法の前進代入 1 回
+static void precondition(const BuildJob* job, const double* diag, const double* in, double* out) {
+    int block_count = (job->layout->cell_count + AT_VALUE_BLOCK - 1) / AT_VALUE_BLOCK;
+    for (int bi = 0; bi < block_count; bi++) {
+        const ValueBlock* b = &job->blocks[bi];
+        int base = bi * AT_VALUE_BLOCK;
+        for (int ni = 0; ni < b->node_count; ni++) {
+            const ValueNode* node = &b->nodes[ni];
+            const ValueEdge* edge = &b->edges[node->first_edge];
+            int i = base + ni;
+            double y = in[i];
+            for (uint32_t k = 0; k < node->edge_count; k++) {
+                if ((int)edge[k].next < i) y += edge[k].prob * out[edge[k].next];
+            }
+            out[i] = y / diag[i];
+        }
+    }
+}
+
+// ガウス・ザイデル前処理付き BiCGSTAB。戻り値は収束したか (最終的な残差の最大値を residual に返す)
+static bool solve_system(const BuildJob* job, int threads, const double* diag, const double* rhs,
+                         double* x, int* iterations, double* residual) {
+    int n = job->layout->cell_count;
+    double* work = malloc((size_t)n * 6 * sizeof(double));
+    if (!work) {
+        fprintf(stderr, "AtValue: メモリを確保できません\n");
+        return false;
+    }
+    double* r = work;
+    double* r0 = r + n;
+    double* p = r0 + n;
+    double* v = p + n;
+    double* t = v + n;
+    double* z = t + n;
+
+    double scale = max_abs(rhs, n);
+    double limit = AT_VALUE_TOLERANCE * (scale > 1.0 ? scale : 1.0);
+    memset(x, 0, (size_t)n * sizeof(double));
+    memcpy(r, rhs, (size_t)n * sizeof(double));
+    memcpy(r0, rhs, (size_t)n * sizeof(double));
+    memset(p, 0, (size_t)n * sizeof(double));
+    memset(v, 0, (size_t)n * sizeof(double));
+
+    double rho = 1.0, alpha = 1.0, omega = 1.0;
+    int it = 0;
+    while (it < AT_VALUE_MAX_ITERATIONS && max_abs(r, n) > limit) {
+        it++;
+        double rho_next = dot(r0, r, n);
+        if (rho_next == 0.0 || omega == 0.0) break;
+        double beta = (rho_next / rho) * (alpha / omega);
+        for (int i = 0; i < n; i++) p[i] = r[i] + beta * (p[i] - omega * v[i]);
+
+        precondition(job, diag, p, z);
+        apply_matrix(job, threads, z, v);
+        alpha = rho_next / dot(r0, v, n);
+        for (int i = 0; i < n; i++) {
+            x[i] += alpha * z[i];
+            r[i] -= alpha * v[i];
+        }
+        if (max_abs(r, n) <= limit) break;
+
+        precondition(job, diag, r, z);
+        apply_matrix(job, threads, z, t);
+        double tt = dot(t, t, n);
+        omega = (tt > 0.0) ? dot(t, r, n) / tt : 0.0;
+        for (int i = 0; i < n; i++) {
+            x[i] += omega * z[i];
+            r[i] -= omega * t[i];
+        }
+        rho = rho_next;
+    }
+
+    // 漸化式の残差ではなく、実際の残差で判定する
+    apply_matrix(job, threads, x, t);
+    for (int i = 0; i < n; i++) r[i] = rhs[i] - t[i];
+    *residual = max_abs(r, n);
+    *iterations += it;
+    free(work);
+    return *residual <= limit * 10.0;
+}
+
+// 期待値 V と二次モーメント M を解く (d は 1 ゲームの差枚、' は遷移先)
+//   V = E[d] + E[V']
+//   M = E[d^2] + 2 E[d V'] + E[M']
+static bool solve_values(const BuildJob* job, int threads, double* mean, double* second, AtValueBuildStats* stats) {
+    int n = job->layout->cell_count;
+    double* diag = calloc((size_t)n, sizeof(double));
+    double* rhs = malloc((size_t)n * sizeof(double));
+    bool ok = diag && rhs;
+    if (!ok) fprintf(stderr, "AtValue: メモリを確保できません\n");
+
+    int block_count = (n + AT_VALUE_BLOCK - 1) / AT_VALUE_BLOCK;
+    for (int bi = 0; ok && bi < block_count; bi++) {
+        const ValueBlock* b = &job->blocks[bi];
+        for (int ni = 0; ni < b->node_count; ni++) {
+            diag[bi * AT_VALUE_BLOCK + ni] = 1.0 - b->nodes[ni].self_prob;
+            rhs[bi * AT_VALUE_BLOCK + ni] = b->nodes[ni].mean_diff;
+        }
+    }
+    double second_residual = 0.0;
+    ok = ok && solve_system(job, threads, diag, rhs, mean, &stats->iterations, &stats->residual);
+
+    for (int bi = 0; ok && bi < block_count; bi++) {
+        const ValueBlock* b = &job->blocks[bi];
+        for (int ni = 0; ni < b->node_count; ni++) {
+            const ValueNode* node = &b->nodes[ni];
+            const ValueEdge* edge = &b->edges[node->first_edge];
+            int i = bi * AT_VALUE_BLOCK + ni;
+            double m = node->mean_sq_diff + 2.0 * node->self_prob_diff * mean[i];
+            for (uint32_t k = 0; k < node->edge_count; k++) {
+                m += 2.0 * edge[k].prob_diff * mean[edge[k].next];
+            }
+            rhs[i] = m;
+        }
+    }
+    ok = ok && solve_system(job, threads, diag, rhs, second, &stats->iterations, &second_residual);
+
+    if (diag && rhs && !ok) {
+        fprintf(stderr, "AtValue: 連立方程式が収束しませんでした (残差 %.3g / %.3g)\n", stats->residual, second_residual);
+    }
+    free(diag);
+    free(rhs);
+    return ok;
+}
+
+static void fill_header(const ValueLayout* layout, AtValueHeader* header) {
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, AT_VALUE_MAGIC, sizeof(header->magic));
+    header->version = AT_VALUE_VERSION;
+    header->cell_count = (uint32_t)layout->cell_count;
+    header->dims[0] = VALUE_STATE_COUNT;
+    header->dims[1] = (uint32_t)layout->hiyoku_count;
+    header->dims[2] = GAMES_COUNT;
+    header->dims[3] = (uint32_t)layout->countdown_count;
+    header->dims[4] = REMAIN_COUNT;
+    header->dims[5] = (uint32_t)layout->franxx_remain_count;
+    header->dims[6] = QUEUE_COUNT;
+    header->dims[7] = PART_COUNT;
+    // MachineSpec の全項目 (Spec_Print の書式ではなく値) のハッシュ。どの項目が変わっても表は無効になる
+    header->spec_hash = Spec_GetHash(Spec_Get());
+}
+
+static bool write_table(const char* path, const ValueLayout* layout, const double* mean, const double* second) {
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        fprintf(stderr, "AtValue: %s を書き込めません\n", path);
+        return false;
+    }
+    AtValueHeader header;
+    fill_header(layout, &header);
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (int i = 0; i < layout->cell_count && ok; i++) {
+        double variance = second[i] - mean[i] * mean[i];
+        AtValueCell c = { (float)mean[i], (float)(variance > 0.0 ? variance : 0.0) };
+        ok = fwrite(&c, sizeof(c), 1, file) == 1;
+    }
+    if (fclose(file) != 0) ok = false;
+    if (!ok) fprintf(stderr, "AtValue: %s の書き込みに失敗しました\n", path);
+    return ok;
+}
+
+static void free_table(AtValueTable* table) {
+#ifdef _WIN32
+    if (table->view) UnmapViewOfFile(table->view);
+    if (table->mapping) CloseHandle(table->mapping);
+    if (table->file != INVALID_HANDLE_VALUE) CloseHandle(table->file);
+#else
+    if (table->view) munmap(table->view, table->size);
+#endif
+    free(table);
+}
+
+// --- 公開関数 ---
+
+bool AtValue_Build(const char* path, int threads, AtValueBuildStats* stats) {
+    AtValueBuildStats local;
+    if (!stats) stats = &local;
+    memset(stats, 0, sizeof(*stats));
+
+    ValueLayout layout;
+    get_layout(&layout);
+
+    int block_count = (layout.cell_count + AT_VALUE_BLOCK - 1) / AT_VALUE_BLOCK;
+    BuildJob job = { &layout, calloc((size_t)block_count, sizeof(ValueBlock)) };
+    double* mean = malloc((size_t)layout.cell_count * sizeof(double));
+    double* second = malloc((size_t)layout.cell_count * sizeof(double));
+    bool ok = job.blocks && mean && second;
+    if (!ok) fprintf(stderr, "AtValue: メモリを確保できません\n");
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    if (ok) {
+        // 列挙の間だけ抽選の差し替えを有効にする (ほかのコマンドの抽選は差し替えを確認しない)
+        WeightedTable_EnableSampleHooks(true);
+        Parallel_Run(block_count, threads, build_task, &job);
+        WeightedTable_EnableSampleHooks(false);
+        for (int i = 0; i < block_count; i++) {
+            ValueBlock* b = &job.blocks[i];
+            if (b->failed) ok = false;
+            stats->replays += b->replays;
+            stats->transitions += (long long)b->edge_count;
+        }
+    }
+    Uint64 built = SDL_GetPerformanceCounter();
+    stats->build_seconds = (double)(built - start) / SDL_GetPerformanceFrequency();
+
+    if (ok) {
+        stats->cells = layout.cell_count;
+        ok = solve_values(&job, threads, mean, second, stats);
+        stats->solve_seconds = (double)(SDL_GetPerformanceCounter() - built) / SDL_GetPerformanceFrequency();
+    }
+    if (ok) {
+        ok = write_table(path, &layout, mean, second);
+    }
+
+    if (job.blocks) {
+        for (int i = 0; i < block_count; i++) {
+            free(job.blocks[i].nodes);
+            free(job.blocks[i].edges);
+        }
+        free(job.blocks);
+    }
+    free(mean);
+    free(second);
+    return ok;
+}
+
+AtValueTable* AtValue_Open(const char* path) {
+    AtValueTable* table = calloc(1, sizeof(AtValueTable));
+    if (!table) return NULL;
+
+#ifdef _WIN32
+    table->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    LARGE_INTEGER size;
+    if (table->file == INVALID_HANDLE_VALUE || !GetFileSizeEx(table->file, &size)) {
+        fprintf(stderr, "AtValue: %s を開けません\n", path);
+        free_table(table);
+        return NULL;
+    }
+    table->size = (size_t)size.QuadPart;
+    table->mapping = CreateFileMappingA(table->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (table->mapping) table->view = MapViewOfFile(table->mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        fprintf(stderr, "AtValue: %s を開けません\n", path);
+        if (fd >= 0) close(fd);
+        free_table(table);
+        return NULL;
+    }
+    table->size = (size_t)st.st_size;
+    if (table->size > 0) {
+        table->view = mmap(NULL, table->size, PROT_READ, MAP_SHARED, fd, 0);
+        if (table->view == MAP_FAILED) table->view = NULL;
+    }
+    close(fd);
+#endif
+    if (!table->view) {
+        fprintf(stderr, "AtValue: %s を mmap できません\n", path);
+        free_table(table);
+        return NULL;
+    }
+
+    // 格子・スペックが今のビルド・スペックと一致するときだけ使う
+    get_layout(&table->layout);
+    AtValueHeader expected;
+    fill_header(&table->layout, &expected);
+    const AtValueHeader* header = table->view;
+    if (table->size < sizeof(AtValueHeader) ||
+        memcmp(header, &expected, sizeof(AtValueHeader)) != 0 ||
+        table->size < sizeof(AtValueHeader) + (size_t)header->cell_count * sizeof(AtValueCell)) {
+        fprintf(stderr, "AtValue: %s は現在のスペック・形式の価値表ではありません\n", path);
+        free_table(table);
+        return NULL;
+    }
+    table->cells = (const AtValueCell*)(header + 1);
+    return table;
+}
+
+void AtValue_Close(AtValueTable* table) {
+    if (table) free_table(table);
+}
+
+bool AtValue_Lookup(const AtValueTable* table, const GameData* data, AtValue* out) {
+    out->mean = 0.0;
+    out->variance = 0.0;
+    if (data->current_state == STATE_AT_END) return true;
+
+    int cells[16];
+    double weights[16];
+    int n = encode_state(&table->layout, data, cells, weights);
+    if (n == 0) return false;
+
+    // 補間は混合分布として扱う (分散は二次モーメントを補間して戻す)
+    double mean = 0.0, second = 0.0;
+    for (int i = 0; i < n; i++) {
+        AtValueCell c = table->cells[cells[i]];
+        mean += weights[i] * c.mean;
+        second += weights[i] * ((double)c.variance + (double)c.mean * c.mean);
+    }
+    double variance = second - mean * mean;
+    out->mean = mean;
+    out->variance = variance > 0.0 ? variance : 0.0;
+    return true;
+}
@@ -0,0 +1,67 @@
+#ifndef AT_VALUE_H
+#define AT_VALUE_H
+
+#include "game_data.h"
+#include <stdbool.h>
+
+// =================================================================
+// AT状態価値表 (AT終了までの残り獲得差枚の期待値・分散)
+// -----------------------------------------------------------------
+// AT中の状態を (状態, ボーナス高確率G数, ボーナスの残り獲得枚数,
+// BB EX 待機枚数, 比翼BEATS のレベル・残りST / フランクスボーナス部の
+// 残り枚数) の格子点に集約し、格子点ごとに 1 ゲームの遷移を
+// 成立役 × AT内の全抽選分岐の列挙で求めて、連立方程式 (前処理付き BiCGSTAB) で解く。
+// 格子点の間の値は各軸の線形補間で表す (遷移先も同じ重みで振り分ける)。
+// ボーナス高確率の G数は毎ゲーム減るため、320G までは 1G 刻みで持つ。
+//
+// 結果は格子点の密な配列としてファイルに書き出し、mmap して参照する。
+// 参照は補間する高々 16 点の読み出しだけなので O(1)。
+// スペックのハッシュを記録し、異なるスペックで作った表は開かない。
+// =================================================================
+
+typedef struct AtValueTable AtValueTable;
+
+// 残り獲得差枚 (AT終了まで、現在のゲームは含まない)
+typedef struct {
+    double mean;
+    double variance;
+} AtValue;
+
+typedef struct {
+    int cells;               // 計算した格子点数
+    long long replays;       // 列挙で再生したゲーム数
+    long long transitions;   // 集約後の遷移数
+    int iterations;          // 反復解法の反復回数 (期待値・二次モーメントの合計)
+    double residual;         // 解いた連立方程式の最大残差 (枚)
+    double build_seconds;    // 遷移の列挙にかかった時間
+    double solve_seconds;    // 連立方程式の求解にかかった時間
+} AtValueBuildStats;
+
+/**
+ * @brief 現在のスペック (Sim_InitTables 済み) で価値表を計算し、ファイルに書き出します。
+ * 遷移の列挙は格子点ごとに並列に行い、結果はスレッド数に依存しません。
+ * @param threads ワーカー数 (0 以下で既定値)
+ * @param stats 計算の統計の出力先 (NULL 可)
+ * @return 書き込みに失敗した場合は false
+ */
+bool AtValue_Build(const char* path, int threads, AtValueBuildStats* stats);
+
+/**
+ * @brief 価値表ファイルを読み取り専用で mmap します。
+ * @return 形式・格子・スペックが一致しない場合は NULL
+ */
+AtValueTable* AtValue_Open(const char* path);
+
+/**
+ * @brief AtValue_Open で開いた表を閉じます。
+ */
+void AtValue_Close(AtValueTable* table);
+
+/**
+ * @brief ゲームの区切りの AT中の状態の価値を引きます。
+ * AT終了状態は 0 を返します。
+ * @return AT中でない (通常時・CZ) か、表にない状態の場合は false
+ */
+bool AtValue_Lookup(const AtValueTable* table, const GameData* data, AtValue* out);
+
+#endif // AT_VALUE_H
@@ -0,0 +1,190 @@
+#include "checkpoint.h"
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECKPOINT_MAGIC "FXCKPT\0"
+#define CHECKPOINT_VERSION 1
+#define CHECKPOINT_KIND_LEN 16
+
+// ファイル形式: ヘッダ + 完了フラグ (1 バイト × task_count) + records + shared
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t task_count;
+    char kind[CHECKPOINT_KIND_LEN];
+    uint64_t config_hash;
+    uint64_t record_size;
+    uint64_t shared_size;
+} CheckpointHeader;
+
+struct Checkpoint {
+    char* path;
+    char* temp_path;
+    CheckpointLayout layout;
+    CheckpointHeader header;
+    unsigned char* done;
+    int done_count;
+    double interval;
+    Uint64 last_save;
+};
+
+// --- 内部ヘルパー関数 ---
+
+static void fill_header(const CheckpointLayout* layout, CheckpointHeader* header) {
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, CHECKPOINT_MAGIC, sizeof(header->magic));
+    header->version = CHECKPOINT_VERSION;
+    header->task_count = (uint32_t)layout->task_count;
+    strncpy(header->kind, layout->kind ? layout->kind : "", CHECKPOINT_KIND_LEN - 1);
+    header->config_hash = layout->config_hash;
+    header->record_size = layout->records ? layout->record_size : 0;
+    header->shared_size = layout->shared ? layout->shared_size : 0;
+}
+
+static bool read_block(FILE* file, void* data, size_t size) {
+    return size == 0 || fread(data, size, 1, file) == 1;
+}
+
+static bool write_block(FILE* file, const void* data, size_t size) {
+    return size == 0 || fwrite(data, size, 1, file) == 1;
+}
+
+// 既存のファイルを読み戻す。ファイルがなければ true (最初から)
+static bool load(Checkpoint* cp) {
+    FILE* file = fopen(cp->path, "rb");
+    if (!file) return true;
+
+    CheckpointHeader header;
+    bool ok = read_block(file, &header, sizeof(header));
+    if (!ok || memcmp(&header, &cp->header, sizeof(header)) != 0) {
+        fprintf(stderr, "Checkpoint: %s は別の設定 (種類・シード・回数・スペック) のチェックポイントです\n", cp->path);
+        fclose(file);
+        return false;
+    }
+    size_t tasks = (size_t)cp->layout.task_count;
+    ok = read_block(file, cp->done, tasks) &&
+         read_block(file, cp->layout.records, (size_t)header.record_size * tasks) &&
+         read_block(file, cp->layout.shared, (size_t)header.shared_size);
+    fclose(file);
+    if (!ok) {
+        fprintf(stderr, "Checkpoint: %s を読み込めません\n", cp->path);
+        return false;
+    }
+    cp->done_count = 0;
+    for (size_t i = 0; i < tasks; i++) {
+        if (cp->done[i]) cp->done_count++;
+    }
+    return true;
+}
+
+static char* copy_string(const char* s, const char* suffix) {
+    size_t len = strlen(s), suffix_len = strlen(suffix);
+    char* out = (char*)malloc(len + suffix_len + 1);
+    if (out) {
+        memcpy(out, s, len);
+        memcpy(out + len, suffix, suffix_len + 1);
+    }
+    return out;
+}
+
+static void free_checkpoint(Checkpoint* cp) {
+    free(cp->path);
+    free(cp->temp_path);
+    free(cp->done);
+    free(cp);
+}
+
+// --- 公開関数 ---
+
+Checkpoint* Checkpoint_Open(const char* path, const CheckpointLayout* layout, double interval_seconds) {
+    if (layout->task_count <= 0) {
+        fprintf(stderr, "Checkpoint: タスク数が不正です\n");
+        return NULL;
+    }
+    Checkpoint* cp = (Checkpoint*)calloc(1, sizeof(Checkpoint));
+    if (!cp) return NULL;
+    cp->path = copy_string(path, "");
+    cp->temp_path = copy_string(path, ".tmp");
+    cp->done = (unsigned char*)calloc((size_t)layout->task_count, 1);
+    if (!cp->path || !cp->temp_path || !cp->done) {
+        fprintf(stderr, "Checkpoint: メモリ確保に失敗しました\n");
+        free_checkpoint(cp);
+        return NULL;
+    }
+    cp->layout = *layout;
+    fill_header(layout, &cp->header);
+    cp->interval = interval_seconds > 0 ? interval_seconds : CHECKPOINT_DEFAULT_INTERVAL;
+    cp->last_save = SDL_GetPerformanceCounter();
+
+    if (!load(cp)) {
+        free_checkpoint(cp);
+        return NULL;
+    }
+    return cp;
+}
+
+int Checkpoint_GetDoneCount(const Checkpoint* checkpoint) {
+    return checkpoint ? checkpoint->done_count : 0;
+}
+
+bool Checkpoint_IsDone(const Checkpoint* checkpoint, int task) {
+    return checkpoint && task >= 0 && task < checkpoint->layout.task_count && checkpoint->done[task];
+}
+
+void Checkpoint_MarkDone(Checkpoint* checkpoint, int task) {
+    if (!checkpoint || task < 0 || task >= checkpoint->layout.task_count) return;
+    if (!checkpoint->done[task]) {
+        checkpoint->done[task] = 1;
+        checkpoint->done_count++;
+    }
+    double elapsed = (double)(SDL_GetPerformanceCounter() - checkpoint->last_save) / SDL_GetPerformanceFrequency();
+    if (elapsed >= checkpoint->interval) {
+        Checkpoint_Save(checkpoint); // 失敗しても実行は続ける (次の間隔で再試行)
+    }
+}
+
+bool Checkpoint_Save(Checkpoint* checkpoint) {
+    Checkpoint* cp = checkpoint;
+    cp->last_save = SDL_GetPerformanceCounter();
+    FILE* file = fopen(cp->temp_path, "wb");
+    if (!file) {
+        fprintf(stderr, "Checkpoint: %s を書き込めません\n", cp->temp_path);
+        return false;
+    }
+    size_t tasks = (size_t)cp->layout.task_count;
+    bool ok = write_block(file, &cp->header, sizeof(cp->header)) &&
+              write_block(file, cp->done, tasks) &&
+              write_block(file, cp->layout.records, (size_t)cp->header.record_size * tasks) &&
+              write_block(file, cp->layout.shared, (size_t)cp->header.shared_size);
+    if (fflush(file) != 0) ok = false;
+    if (fclose(file) != 0) ok = false;
+
+    // 書き終えてから置き換える (Windows の rename は既存のファイルを上書きしない)
+#ifdef _WIN32
+    if (ok) remove(cp->path);
+#endif
+    if (ok && rename(cp->temp_path, cp->path) != 0) ok = false;
+    if (!ok) {
+        fprintf(stderr, "Checkpoint: %s の書き出しに失敗しました\n", cp->path);
+        remove(cp->temp_path);
+    }
+    return ok;
+}
+
+bool Checkpoint_Close(Checkpoint* checkpoint) {
+    if (!checkpoint) return true;
+    bool ok = Checkpoint_Save(checkpoint);
+    free_checkpoint(checkpoint);
+    return ok;
+}
+
+uint64_t Checkpoint_HashValue(uint64_t hash, uint64_t value) {
+    if (hash == 0) hash = 0xCBF29CE484222325ULL;
+    for (int i = 0; i < 8; i++) {
+        hash ^= (value >> (i * 8)) & 0xFF;
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
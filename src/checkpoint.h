@@ -0,0 +1,79 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// =================================================================
+// 長時間シミュレーションのチェックポイント
+// -----------------------------------------------------------------
+// タスクごとの完了フラグと結果 (タスク番号の位置)、タスク間で合算する
+// 集計 (整数のヒストグラムや、逐次実行の乱数状態・累積値) を一定間隔で
+// ファイルに書き出し、同じ設定で再実行したときに読み戻して完了済みの
+// タスクを飛ばす。結果はタスク番号順に合算するため (合算する集計は整数のみ)、
+// 中断・再開しても中断しなかった場合と同じ結果になる。
+//
+// 書き出しは一時ファイルに書いてから置き換えるため、書き込み中に
+// 中断されても直前のチェックポイントが残る。種類・設定のハッシュ・
+// 大きさが一致しないファイルは読み込まない。
+// =================================================================
+
+#define CHECKPOINT_DEFAULT_INTERVAL 60.0 // 秒
+
+typedef struct Checkpoint Checkpoint;
+
+// 保存する領域 (呼び出し元が確保する)
+typedef struct {
+    const char* kind;          // 実行の種類 ("day" など、15 文字まで)
+    uint64_t config_hash;      // 結果に影響する設定 (スペック・シード・回数など) のハッシュ
+    int task_count;
+    void* records;             // タスクごとの結果 (record_size × task_count、NULL 可)
+    size_t record_size;
+    void* shared;              // タスク間で合算する集計 (NULL 可)
+    size_t shared_size;
+} CheckpointLayout;
+
+/**
+ * @brief チェックポイントを開きます。ファイルがあれば records / shared と完了フラグを読み戻します。
+ * layout の領域は Checkpoint_Close まで有効であること。
+ * @param interval_seconds 書き出し間隔 (0 以下で既定値)
+ * @return ファイルが別の設定のもの・読み込みに失敗した場合は NULL
+ */
+Checkpoint* Checkpoint_Open(const char* path, const CheckpointLayout* layout, double interval_seconds);
+
+/**
+ * @brief 完了済みのタスク数を返します (NULL の場合は 0)。
+ */
+int Checkpoint_GetDoneCount(const Checkpoint* checkpoint);
+
+/**
+ * @brief タスクが完了済み (読み戻した分を含む) かを返します (NULL の場合は false)。
+ * 同じタスクの実行とは並行に呼ばないでください。
+ */
+bool Checkpoint_IsDone(const Checkpoint* checkpoint, int task);
+
+/**
+ * @brief タスクを完了済みにし、前回の書き出しから間隔が過ぎていれば書き出します (NULL の場合は何もしない)。
+ * records / shared を更新するロックを持ったまま呼んでください (書き出す内容が揃うように)。
+ */
+void Checkpoint_MarkDone(Checkpoint* checkpoint, int task);
+
+/**
+ * @brief 現在の内容を書き出します。
+ * @return 書き込みに失敗した場合は false
+ */
+bool Checkpoint_Save(Checkpoint* checkpoint);
+
+/**
+ * @brief 最後の状態を書き出して閉じます (NULL の場合は何もしない)。
+ * @return 書き込みに失敗した場合は false
+ */
+bool Checkpoint_Close(Checkpoint* checkpoint);
+
+/**
+ * @brief 設定のハッシュに値を混ぜます (FNV-1a。構造体のパディングを避けるため項目ごとに渡す)。
+ */
+uint64_t Checkpoint_HashValue(uint64_t hash, uint64_t value);
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,499 @@
+#include "conform.h"
+#include "lottery.h"
+#include "normal.h"
+#include "parallel.h"
+#include "rng.h"
+#include "spec.h"
+#include "weighted_table.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CONFORM_MAX_BINS 256
+#define CONFORM_SAMPLES_PER_TASK (1LL << 20)
+#define CONFORM_MIN_EXPECTED 5.0          // カイ二乗検定で単独の区分とする期待度数の下限
+#define CONFORM_RNG_BELOW_N (3 << 29)     // 2^32 の約数でない n (剰余で作ると上位 1/3 が 2 倍出にくくなる)
+#define CONFORM_RNG_BELOW_SHIFT 29
+#define CONFORM_GAMMA_MAX_ITER 100000
+#define CONFORM_GAMMA_EPS 1e-15
+#define CONFORM_GAMMA_TINY 1e-300
+
+typedef enum {
+    CONFORM_SOURCE_LOTTERY_NORMAL,   // Lottery_GetResult_Normal
+    CONFORM_SOURCE_LOTTERY_FRANXX,   // Lottery_GetResult_FranxxHighProb
+    CONFORM_SOURCE_LOTTERY_AT,       // Lottery_GetResult_AT
+    CONFORM_SOURCE_BONUS_AT,         // Lottery_CheckBonus_AT
+    CONFORM_SOURCE_TABLE,            // 登録済みの WeightedTable
+    CONFORM_SOURCE_RNG_HIGH_BYTE,    // 16bit 抽選値の上位バイト
+    CONFORM_SOURCE_RNG_LOW_BYTE,     // 16bit 抽選値の下位バイト
+    CONFORM_SOURCE_RNG_BELOW         // Rng_Below(3 << 29) を 3 区分に
+} ConformSource;
+
+typedef struct {
+    char name[CONFORM_NAME_LEN];
+    ConformSource source;
+    YakuType yaku;                   // CONFORM_SOURCE_BONUS_AT
+    const WeightedTable* table;      // CONFORM_SOURCE_TABLE
+    int bin_count;
+    int values[CONFORM_MAX_BINS];    // 区分 → テーブルの値 (CONFORM_SOURCE_TABLE、昇順)
+    double prob[CONFORM_MAX_BINS];
+    bool from_build_weights;         // 期待確率をテーブルの構築元の重みから求めた (対応するスペックの項目がない)
+} ConformTest;
+
+typedef struct {
+    const ConformTest* test;
+    uint64_t seed;
+    uint64_t stream_base;
+    long long samples;
+    uint64_t* counts;                // タスクごとに bin_count + 1 個 (末尾はテーブルにない値)
+} ConformJob;
+
+static const char* k_bonus_keys[] = { "NONE", "CONTINUE", "DARLING", "FRANXX", "BB_EX", "EPISODE" };
+#define CONFORM_BONUS_RESULTS ((int)(sizeof(k_bonus_keys) / sizeof(k_bonus_keys[0])))
+
+// 小役抽選テーブルの登録名 (lottery.c)
+static const char* k_lottery_table_names[LOTTERY_TABLE_COUNT] = { "小役/通常時", "小役/フランクス高確率" };
+
+// --- 内部ヘルパー関数 ---
+
+// 正則化された上側不完全ガンマ関数 Q(a, x)
+static double gamma_q(double a, double x) {
+    if (x <= 0.0) return 1.0;
+    double log_prefix = -x + a * log(x) - lgamma(a);
+    if (x < a + 1.0) {
+        // 級数展開で P(a, x) を求めて 1 から引く
+        double term = 1.0 / a;
+        double sum = term;
+        for (int n = 1; n < CONFORM_GAMMA_MAX_ITER; n++) {
+            term *= x / (a + n);
+            sum += term;
+            if (term < sum * CONFORM_GAMMA_EPS) break;
+        }
+        double q = 1.0 - sum * exp(log_prefix);
+        return q > 0.0 ? q : 0.0;
+    }
+    // 連分数展開 (修正 Lentz 法)
+    double b = x + 1.0 - a;
+    double c = 1.0 / CONFORM_GAMMA_TINY;
+    double d = 1.0 / b;
+    double h = d;
+    for (int i = 1; i < CONFORM_GAMMA_MAX_ITER; i++) {
+        double an = -i * (i - a);
+        b += 2.0;
+        d = an * d + b;
+        if (fabs(d) < CONFORM_GAMMA_TINY) d = CONFORM_GAMMA_TINY;
+        c = b + an / c;
+        if (fabs(c) < CONFORM_GAMMA_TINY) c = CONFORM_GAMMA_TINY;
+        d = 1.0 / d;
+        double delta = d * c;
+        h *= delta;
+        if (fabs(delta - 1.0) < CONFORM_GAMMA_EPS) break;
+    }
+    return exp(log_prefix) * h;
+}
+
+static int find_value_bin(const ConformTest* test, int value) {
+    int lo = 0, hi = test->bin_count - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        if (test->values[mid] == value) return mid;
+        if (test->values[mid] < value) lo = mid + 1;
+        else hi = mid - 1;
+    }
+    return test->bin_count;
+}
+
+static int draw_bin(const ConformTest* test) {
+    switch (test->source) {
+        case CONFORM_SOURCE_LOTTERY_NORMAL: return (int)Lottery_GetResult_Normal();
+        case CONFORM_SOURCE_LOTTERY_FRANXX: return (int)Lottery_GetResult_FranxxHighProb();
+        case CONFORM_SOURCE_LOTTERY_AT:     return (int)Lottery_GetResult_AT();
+        case CONFORM_SOURCE_BONUS_AT:       return (int)Lottery_CheckBonus_AT(test->yaku);
+        case CONFORM_SOURCE_TABLE:          return find_value_bin(test, WeightedTable_Sample(test->table));
+        case CONFORM_SOURCE_RNG_HIGH_BYTE:  return (int)(Rng_NextU32() >> 24);
+        case CONFORM_SOURCE_RNG_LOW_BYTE:   return (int)((Rng_NextU32() >> 16) & 0xFF);
+        case CONFORM_SOURCE_RNG_BELOW:      return Rng_Below(CONFORM_RNG_BELOW_N) >> CONFORM_RNG_BELOW_SHIFT;
+        default: return test->bin_count;
+    }
+}
+
+static void conform_task(int task_index, void* user) {
+    ConformJob* job = (ConformJob*)user;
+    const ConformTest* test = job->test;
+    uint64_t* counts = &job->counts[(size_t)task_index * (test->bin_count + 1)];
+    memset(counts, 0, sizeof(uint64_t) * (size_t)(test->bin_count + 1));
+
+    Rng_SeedStream(job->seed, job->stream_base | (uint64_t)task_index);
+    long long first = (long long)task_index * CONFORM_SAMPLES_PER_TASK;
+    long long n = job->samples - first < CONFORM_SAMPLES_PER_TASK ? job->samples - first : CONFORM_SAMPLES_PER_TASK;
+    for (long long i = 0; i < n; i++) {
+        int bin = draw_bin(test);
+        if (bin < 0 || bin > test->bin_count) bin = test->bin_count;
+        counts[bin]++;
+    }
+}
+
+static void bin_label(const ConformTest* test, int bin, char* buf, size_t size) {
+    if (bin >= test->bin_count) {
+        snprintf(buf, size, "(テーブルにない値)");
+        return;
+    }
+    switch (test->source) {
+        case CONFORM_SOURCE_LOTTERY_NORMAL:
+        case CONFORM_SOURCE_LOTTERY_FRANXX:
+        case CONFORM_SOURCE_LOTTERY_AT:
+            snprintf(buf, size, "%s", GetYakuName((YakuType)bin));
+            break;
+        case CONFORM_SOURCE_BONUS_AT:
+            snprintf(buf, size, "%s", k_bonus_keys[bin]);
+            break;
+        case CONFORM_SOURCE_TABLE:
+            snprintf(buf, size, "値 %d", test->values[bin]);
+            break;
+        case CONFORM_SOURCE_RNG_BELOW:
+            snprintf(buf, size, "%d/3", bin + 1);
+            break;
+        default:
+            snprintf(buf, size, "0x%02X", bin);
+            break;
+    }
+}
+
+// 値 value の区分に確率 p を加える (区分は値の昇順)
+static bool add_value_prob(ConformTest* test, int value, double p) {
+    int bin = find_value_bin(test, value);
+    if (bin == test->bin_count) {
+        if (test->bin_count >= CONFORM_MAX_BINS) {
+            fprintf(stderr, "Conform: %s は値の種類が %d を超えるため検定しません\n", test->name, CONFORM_MAX_BINS);
+            return false;
+        }
+        // 挿入ソート
+        bin = test->bin_count;
+        while (bin > 0 && test->values[bin - 1] > value) {
+            test->values[bin] = test->values[bin - 1];
+            test->prob[bin] = test->prob[bin - 1];
+            bin--;
+        }
+        test->values[bin] = value;
+        test->prob[bin] = 0.0;
+        test->bin_count++;
+    }
+    test->prob[bin] += p;
+    return true;
+}
+
+// スペックの当否 (千分率) × 種別振り分け (千分率) から AT高確中のボーナス抽選結果の確率を求める
+static void spec_bonus_prob(YakuType yaku, double prob[CONFORM_BONUS_RESULTS]) {
+    const SpecBonusRate* rate = &Spec_Get()->bonus_at[yaku];
+    memset(prob, 0, sizeof(double) * CONFORM_BONUS_RESULTS);
+    if (rate->success <= 0) {
+        prob[BONUS_NONE] = 1.0; // 抽選対象外の役
+        return;
+    }
+    double success = rate->success / 1000.0;
+    prob[BONUS_FRANXX] = success * rate->fb / 1000.0;
+    prob[BONUS_DARLING] = success * rate->db / 1000.0;
+    prob[BONUS_BB_EX] = success * rate->ex / 1000.0;
+    prob[BONUS_EPISODE] = success * rate->ep / 1000.0;
+    prob[BONUS_AT_CONTINUE] = 1.0 - prob[BONUS_FRANXX] - prob[BONUS_DARLING] - prob[BONUS_BB_EX] - prob[BONUS_EPISODE];
+}
+
+// 名前が "<category>/<役名>" のテーブルの役を探す
+static bool match_yaku_table(const char* name, const char* category, YakuType* yaku) {
+    size_t len = strlen(category);
+    if (strncmp(name, category, len) != 0 || name[len] != '/') return false;
+    for (int y = 0; y < YAKU_COUNT; y++) {
+        if (strcmp(name + len + 1, GetYakuName((YakuType)y)) == 0) {
+            *yaku = (YakuType)y;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool add_rate_list(ConformTest* test, const SpecRateList* rates, int denominator) {
+    for (int i = 0; i < rates->count; i++) {
+        if (rates->entries[i].weight == 0) continue;
+        if (!add_value_prob(test, rates->entries[i].value, (double)rates->entries[i].weight / denominator)) return false;
+    }
+    return true;
+}
+
+// 登録済みテーブルの期待確率を、テーブルの重みではなくスペックの項目から直接求める
+// (テーブルの組み立ての誤りも検出するため)。対応する項目がなければ matched = false
+static bool build_spec_table_prob(ConformTest* test, const WeightedTable* t, bool* matched) {
+    const MachineSpec* spec = Spec_Get();
+    const double D = SPEC_RATE_DENOMINATOR;
+    bool ok = true;
+    YakuType yaku;
+    *matched = true;
+
+    for (int i = 0; i < LOTTERY_TABLE_COUNT; i++) {
+        if (strcmp(t->name, k_lottery_table_names[i]) != 0) continue;
+        for (int y = 0; y < YAKU_COUNT && ok; y++) {
+            int weight = spec->lottery_weight[i][y];
+            if (weight > 0) ok = add_value_prob(test, y, (double)weight / LOTTERY_DENOMINATOR);
+        }
+        return ok;
+    }
+    if (match_yaku_table(t->name, "AT高確ボーナス", &yaku)) {
+        double prob[CONFORM_BONUS_RESULTS];
+        spec_bonus_prob(yaku, prob);
+        for (int r = 0; r < CONFORM_BONUS_RESULTS && ok; r++) {
+            if (prob[r] > 0.0) ok = add_value_prob(test, r, prob[r]);
+        }
+        return ok;
+    }
+    if (match_yaku_table(t->name, "通常時", &yaku)) {
+        // AT直撃 → (外れた場合) CZ当選
+        double at = spec->normal_at[yaku] / D;
+        double cz = spec->normal_cz[yaku] / D;
+        return add_value_prob(test, NORMAL_RESULT_NONE, (1.0 - at) * (1.0 - cz)) &&
+               add_value_prob(test, NORMAL_RESULT_CZ, (1.0 - at) * cz) &&
+               add_value_prob(test, NORMAL_RESULT_AT, at);
+    }
+    if (match_yaku_table(t->name, "CZ", &yaku)) {
+        double at = spec->cz_at[yaku] / D; // 値 1 = AT当選
+        return add_value_prob(test, 0, 1.0 - at) && add_value_prob(test, 1, at);
+    }
+    if (match_yaku_table(t->name, "G数上乗せ振り分け", &yaku)) {
+        return add_rate_list(test, &spec->gcount[yaku], SPEC_RATE_DENOMINATOR);
+    }
+    if (match_yaku_table(t->name, "差枚数上乗せ振り分け", &yaku)) {
+        return add_rate_list(test, &spec->payout_addon[yaku], SPEC_RATE_DENOMINATOR);
+    }
+    if (strcmp(t->name, "AT/比翼BEATS 初期レベル") == 0) {
+        return add_rate_list(test, &spec->hiyoku_init_level, SPEC_RATE_DENOMINATOR);
+    }
+    if (strcmp(t->name, "AT/BB EX 継続率") == 0) {
+        return add_rate_list(test, &spec->bb_ex_continue_rate, SPEC_BB_EX_RATE_DENOMINATOR);
+    }
+    for (int i = 0; i < spec->bb_ex_continue_rate.count; i++) {
+        int percent = spec->bb_ex_continue_rate.entries[i].value;
+        char name[WEIGHTED_NAME_LEN];
+        snprintf(name, sizeof(name), "AT/BB EX 継続回数/継続率%d%%", percent);
+        if (strcmp(t->name, name) != 0) continue;
+        // 継続回数 k は幾何分布 r^k (1 - r)。テーブルは K 回以上を値 -1 にまとめる (K = 区分数 - 1)
+        double r = percent / (double)SPEC_BB_EX_RATE_DENOMINATOR;
+        double p = 1.0;
+        for (int k = 0; k < t->count - 1 && ok; k++) {
+            ok = add_value_prob(test, k, p * (1.0 - r));
+            p *= r;
+        }
+        return ok && add_value_prob(test, -1, p);
+    }
+    *matched = false;
+    return true;
+}
+
+// 期待確率はスペックの対応する項目から求め、なければ (上乗せのカーネル等) 値ごとに構築元の重みを合算する
+static bool build_table_test(ConformTest* test, const WeightedTable* t) {
+    memset(test, 0, sizeof(*test));
+    test->source = CONFORM_SOURCE_TABLE;
+    test->table = t;
+    snprintf(test->name, sizeof(test->name), "%s", t->name);
+    if (t->denominator == 0) return false;
+
+    bool matched;
+    if (!build_spec_table_prob(test, t, &matched)) return false;
+    if (matched) return true;
+
+    test->from_build_weights = true;
+    for (int i = 0; i < t->count; i++) {
+        if (t->entries[i].weight == 0) continue;
+        if (!add_value_prob(test, t->entries[i].value, (double)t->entries[i].weight / (double)t->denominator)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void build_lottery_test(ConformTest* test, ConformSource source, LotteryTableId table, const char* name) {
+    memset(test, 0, sizeof(*test));
+    test->source = source;
+    test->bin_count = YAKU_COUNT;
+    snprintf(test->name, sizeof(test->name), "%s", name);
+    for (int y = 0; y < YAKU_COUNT; y++) {
+        test->prob[y] = (double)Spec_Get()->lottery_weight[table][y] / LOTTERY_DENOMINATOR;
+    }
+}
+
+static void build_bonus_test(ConformTest* test, YakuType yaku) {
+    memset(test, 0, sizeof(*test));
+    test->source = CONFORM_SOURCE_BONUS_AT;
+    test->yaku = yaku;
+    test->bin_count = CONFORM_BONUS_RESULTS;
+    snprintf(test->name, sizeof(test->name), "Lottery_CheckBonus_AT/%s", GetYakuName(yaku));
+    spec_bonus_prob(yaku, test->prob);
+}
+
+static void build_uniform_test(ConformTest* test, ConformSource source, int bins, const char* name) {
+    memset(test, 0, sizeof(*test));
+    test->source = source;
+    test->bin_count = bins;
+    snprintf(test->name, sizeof(test->name), "%s", name);
+    for (int b = 0; b < bins; b++) test->prob[b] = 1.0 / bins;
+}
+
+static int count_possible_bins(const ConformTest* test) {
+    int n = 0;
+    for (int b = 0; b < test->bin_count; b++) {
+        if (test->prob[b] > 0.0) n++;
+    }
+    return n;
+}
+
+// 検定の一覧を作る (区分が 1 つしかないものは除く)
+static int build_tests(const ConformConfig* config, ConformTest* tests, int capacity) {
+    int count = 0;
+    ConformTest test;
+
+#define CONFORM_ADD_TEST()                                                                        \
+    do {                                                                                          \
+        if (count < capacity && count_possible_bins(&test) >= 2 &&                                \
+            (!config->filter || strstr(test.name, config->filter))) tests[count++] = test;        \
+    } while (0)
+
+    build_uniform_test(&test, CONFORM_SOURCE_RNG_HIGH_BYTE, 256, "乱数/16bit抽選値の上位バイト");
+    CONFORM_ADD_TEST();
+    build_uniform_test(&test, CONFORM_SOURCE_RNG_LOW_BYTE, 256, "乱数/16bit抽選値の下位バイト");
+    CONFORM_ADD_TEST();
+    build_uniform_test(&test, CONFORM_SOURCE_RNG_BELOW, 3, "乱数/Rng_Below(3<<29)");
+    CONFORM_ADD_TEST();
+
+    build_lottery_test(&test, CONFORM_SOURCE_LOTTERY_NORMAL, LOTTERY_TABLE_NORMAL, "Lottery_GetResult_Normal");
+    CONFORM_ADD_TEST();
+    build_lottery_test(&test, CONFORM_SOURCE_LOTTERY_FRANXX, LOTTERY_TABLE_FRANXX_HIGH_PROB,
+                       "Lottery_GetResult_FranxxHighProb");
+    CONFORM_ADD_TEST();
+    build_lottery_test(&test, CONFORM_SOURCE_LOTTERY_AT, LOTTERY_TABLE_NORMAL, "Lottery_GetResult_AT");
+    CONFORM_ADD_TEST();
+    for (int y = 0; y < YAKU_COUNT; y++) {
+        build_bonus_test(&test, (YakuType)y);
+        CONFORM_ADD_TEST();
+    }
+
+    for (int i = 0; i < WeightedTable_GetRegisteredCount(); i++) {
+        if (build_table_test(&test, WeightedTable_GetRegistered(i))) CONFORM_ADD_TEST();
+    }
+#undef CONFORM_ADD_TEST
+    return count;
+}
+
+static void evaluate(const ConformTest* test, const uint64_t* counts, long long samples, double alpha,
+                     ConformResult* r) {
+    memset(r, 0, sizeof(*r));
+    snprintf(r->name, sizeof(r->name), "%s", test->name);
+    r->samples = samples;
+    r->from_build_weights = test->from_build_weights;
+    r->worst_p_value = 1.0;
+    r->impossible = counts[test->bin_count] > 0;
+    int worst_bin = -1;
+    if (r->impossible) worst_bin = test->bin_count;
+
+    // 期待度数の小さい区分はまとめて 1 区分にする (まとめても小さければ除く)
+    double pool_expected = 0.0;
+    uint64_t pool_observed = 0;
+    int chi_bins = 0;
+    int binomial_bins = 0;
+    for (int b = 0; b < test->bin_count; b++) {
+        double expected = test->prob[b] * (double)samples;
+        if (test->prob[b] <= 0.0) {
+            if (counts[b] > 0) {
+                r->impossible = true;
+                if (worst_bin < 0) worst_bin = b;
+            }
+            continue;
+        }
+        if (expected < CONFORM_MIN_EXPECTED) {
+            pool_expected += expected;
+            pool_observed += counts[b];
+            continue;
+        }
+        double diff = (double)counts[b] - expected;
+        r->chi2 += diff * diff / expected;
+        chi_bins++;
+
+        // 二項検定 (正規近似の両側 p 値)
+        double sd = sqrt(expected * (1.0 - test->prob[b]));
+        double p = (sd > 0.0) ? erfc(fabs(diff) / sd / sqrt(2.0)) : (diff == 0.0 ? 1.0 : 0.0);
+        binomial_bins++;
+        if (!r->impossible && p < r->worst_p_value) {
+            r->worst_p_value = p;
+            worst_bin = b;
+        }
+    }
+    if (pool_expected >= CONFORM_MIN_EXPECTED) {
+        double diff = (double)pool_observed - pool_expected;
+        r->chi2 += diff * diff / pool_expected;
+        chi_bins++;
+    }
+    r->df = chi_bins - 1;
+    r->p_value = (r->df >= 1) ? Conform_ChiSquareP(r->chi2, r->df) : 1.0;
+
+    if (worst_bin >= 0) {
+        bin_label(test, worst_bin, r->worst_label, sizeof(r->worst_label));
+        r->worst_observed = (long long)counts[worst_bin];
+        r->worst_expected = (worst_bin < test->bin_count) ? test->prob[worst_bin] * (double)samples : 0.0;
+    }
+    if (r->impossible) r->worst_p_value = 0.0;
+    r->flagged = r->impossible || r->p_value < alpha ||
+                 (binomial_bins > 0 && r->worst_p_value < alpha / binomial_bins);
+}
+
+// --- 公開関数 ---
+
+double Conform_ChiSquareP(double chi2, int df) {
+    if (df < 1) return 1.0;
+    return gamma_q(df / 2.0, chi2 / 2.0);
+}
+
+int Conform_Run(const ConformConfig* config, ConformCallback callback, void* user) {
+    if (config->samples <= 0) return 0;
+
+    int capacity = WeightedTable_GetRegisteredCount() + YAKU_COUNT + 8;
+    ConformTest* tests = (ConformTest*)malloc(sizeof(ConformTest) * (size_t)capacity);
+    long long task_count = (config->samples + CONFORM_SAMPLES_PER_TASK - 1) / CONFORM_SAMPLES_PER_TASK;
+    uint64_t* counts = (uint64_t*)malloc(sizeof(uint64_t) * (size_t)task_count * (CONFORM_MAX_BINS + 1));
+    uint64_t* total = (uint64_t*)malloc(sizeof(uint64_t) * (CONFORM_MAX_BINS + 1));
+    if (!tests || !counts || !total) {
+        fprintf(stderr, "Conform: メモリ確保に失敗しました\n");
+        free(tests);
+        free(counts);
+        free(total);
+        return -1;
+    }
+
+    int test_count = build_tests(config, tests, capacity);
+    int flagged = 0;
+    for (int i = 0; i < test_count; i++) {
+        const ConformTest* test = &tests[i];
+        ConformJob job;
+        job.test = test;
+        job.seed = config->seed;
+        job.stream_base = (uint64_t)i << 32;
+        job.samples = config->samples;
+        job.counts = counts;
+        if (!Parallel_Run((int)task_count, config->threads, conform_task, &job)) {
+            flagged = -1;
+            break;
+        }
+
+        memset(total, 0, sizeof(uint64_t) * (size_t)(test->bin_count + 1));
+        for (long long t = 0; t < task_count; t++) {
+            const uint64_t* c = &counts[(size_t)t * (test->bin_count + 1)];
+            for (int b = 0; b <= test->bin_count; b++) total[b] += c[b];
+        }
+
+        ConformResult result;
+        evaluate(test, total, config->samples, config->alpha, &result);
+        if (result.flagged) flagged++;
+        if (callback) callback(&result, user);
+    }
+
+    free(tests);
+    free(counts);
+    free(total);
+    return flagged;
+}
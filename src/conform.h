@@ -0,0 +1,64 @@
+#ifndef CONFORM_H
+#define CONFORM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// =================================================================
+// 抽選の適合性検定
+// -----------------------------------------------------------------
+// 各抽選関数 (Lottery_GetResult_* / Lottery_CheckBonus_AT)・登録済みの
+// 抽選テーブル (AT上乗せ等)・乱数そのものから大量に並列抽選し、
+// スペックから直接求めた確率とカイ二乗検定・二項検定で比べる (テーブルの
+// 組み立ての誤りも検出する)。スペックに対応する項目がないテーブル (上乗せの
+// カーネル・一括消化の表) だけは構築元の重みと比べる。
+// 乱数の検定は 16bit 抽選値の上位/下位バイトと Rng_Below の一様性を見る
+// (剰余で作った抽選値の偏りなどを検出するため)。
+// 検定 i の第 k タスクは Rng_SeedStream(seed, i << 32 | k) を使うため、
+// 結果はスレッド数によらない。
+// =================================================================
+
+#define CONFORM_NAME_LEN 160
+#define CONFORM_LABEL_LEN 64
+
+typedef struct {
+    long long samples;        // 1 検定あたりの抽選回数
+    unsigned long long seed;
+    int threads;              // 0 以下で既定値
+    double alpha;             // 有意水準 (検定ごと。二項検定は区分数で割る)
+    const char* filter;       // 名前にこの文字列を含む検定のみ (NULL で全部)
+} ConformConfig;
+
+typedef struct {
+    char name[CONFORM_NAME_LEN];
+    long long samples;
+    int df;                   // カイ二乗検定の自由度 (期待度数の小さい区分はまとめる)
+    double chi2;
+    double p_value;
+
+    // 期待度数からの外れが最も大きい区分 (二項検定)
+    char worst_label[CONFORM_LABEL_LEN];
+    double worst_expected;
+    long long worst_observed;
+    double worst_p_value;
+
+    bool impossible;          // 確率 0 の値が出た
+    bool flagged;             // 有意水準で棄却
+    bool from_build_weights;  // 期待確率がスペックではなくテーブルの構築元の重み
+} ConformResult;
+
+typedef void (*ConformCallback)(const ConformResult* result, void* user);
+
+/**
+ * @brief 検定を順に実行し、1 件ごとに callback を呼びます。Sim_InitTables 済みであること。
+ * 区分が 1 つしかない (抽選結果が 1 通りの) テーブルは検定しません。
+ * @return 棄却された検定の数 (メモリ確保・スレッド作成に失敗した場合は -1)
+ */
+int Conform_Run(const ConformConfig* config, ConformCallback callback, void* user);
+
+/**
+ * @brief カイ二乗分布の上側確率 P(X >= chi2) を返します。
+ */
+double Conform_ChiSquareP(double chi2, int df);
+
+#endif // CONFORM_H
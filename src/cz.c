@@ -1,21 +1,50 @@
 #include "cz.h"
+#include "game_event.h"
 #include "lottery.h"
 #include "at.h" // AT_Init() のため
+#include "spec.h"
+#include "weighted_table.h"
 #include <stdio.h>
 
+// CZ中の役別 AT 当選 (値 1 = 当選、千分率)
+static WeightedTable g_cz_tables[YAKU_COUNT];
+
+// --- 公開関数 ---
+
+bool CZ_InitTables(void) {
+    const MachineSpec* spec = Spec_Get();
+    bool ok = true;
+    for (int y = 0; y < YAKU_COUNT; y++) {
+        WeightedTable_Free(&g_cz_tables[y]);
+        int rate = spec->cz_at[y];
+        if (rate <= 0) continue;
+        WeightedEntry entries[] = {
+            { 0, (uint64_t)(SPEC_RATE_DENOMINATOR - rate) },
+            { 1, (uint64_t)rate },
+        };
+        char name[WEIGHTED_NAME_LEN];
+        snprintf(name, sizeof(name), "CZ/%s", GetYakuName((YakuType)y));
+        ok &= WeightedTable_Init(&g_cz_tables[y], name, entries, 2, SPEC_RATE_DENOMINATOR);
+    }
+    return ok;
+}
+
 void CZ_Init(GameData* data) {
-    // (将来的に実装する)
-    snprintf(data->info_message, sizeof(data->info_message), "CZ突入！ (未実装)");
+    data->current_state = STATE_CZ;
+    data->cz_games_remaining = Spec_Get()->cz_games;
+    GameEvent_Record(data, GAME_EVENT_CZ_START, YAKU_HAZURE, data->cz_games_remaining);
 }
 
 void CZ_Update(GameData* data, YakuType yaku) {
-    // (現在はATから開始するため、この関数は呼ばれない)
-    // (将来的に実装する)
-    
-    // (仮: レア役でAT突入)
-    if (IsRareYaku(yaku)) {
-        snprintf(data->info_message, sizeof(data->info_message), "CZ中レア役！ AT当選！");
+    data->cz_games_remaining--;
+
+    if (g_cz_tables[yaku].count > 0 && WeightedTable_Sample(&g_cz_tables[yaku]) == 1) {
+        GameEvent_Record(data, GAME_EVENT_CZ_AT_WIN, yaku, 0);
         AT_Init(data);
         return;
     }
-}
\ No newline at end of file
+    if (data->cz_games_remaining <= 0) {
+        GameEvent_Record(data, GAME_EVENT_CZ_FAIL, yaku, 0);
+        data->current_state = STATE_NORMAL;
+    }
+}
@@ -3,6 +3,14 @@
 
 #include "game_data.h"
 
+#define CZ_GAMES 10 // CZ のゲーム数 (既定スペックの値。実際の値は MachineSpec)
+
+/**
+ * @brief 現在のスペックから役別の CZ 中 AT 抽選テーブルを構築します。
+ * @return 不正な定義があれば false
+ */
+bool CZ_InitTables(void);
+
 /**
  * @brief CZ中のゲームロジックを更新します。
  */
@@ -13,4 +21,4 @@ void CZ_Update(GameData* data, YakuType yaku);
  */
 void CZ_Init(GameData* data);
 
-#endif // CZ_H
\ No newline at end of file
+#endif // CZ_H
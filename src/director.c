@@ -1,12 +1,19 @@
 #include "director.h"
 #include "game_data.h"
+#include "game_event.h"
 #include "lottery.h"
 #include "reel.h"
 #include "presentation.h"
+#include "pres_table.h"
 #include "sdl_utils.h"
 #include "normal.h"
 #include "cz.h"
 #include "at.h"
+#include "ev_predict.h"
+#include "rng.h"
+#include "sim.h"
+#include "weighted_table.h"
+#include "yaku_script.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -48,52 +55,97 @@ static int g_actual_push_order[3] = {-1, -1, -1};
 // 状態管理用
 static AT_State g_current_logic_state = STATE_NORMAL; 
 static AT_State g_current_media_state = STATE_NORMAL;
-static bool g_is_first_game = true;
+
+// 演出抽選用の乱数系列 (ゲームロジックの系列と分け、同じシードならヘッドレス
+// シミュレータと同じゲーム展開になるようにする)
+#define DIRECTOR_PRES_RNG_STREAM 1
+static RngState g_pres_rng;
+
+// AT演出ペアの振り分け (pres_table.h の表から構築)
+static WeightedTable g_pres_pair_lose_table;
+static WeightedTable g_pres_pair_win_table;
 
 // BB EX 演出用
 static int g_bb_ex_shown_payout = 0; // 現在告知済みの枚数
+static VideoType g_judge_part1 = VIDEO_NONE; // 再生中の当落演出 (Part1)
+
+// AT残り期待値の推定用 (ev_predict.h)
+static bool g_was_in_at = false;
+static long long g_at_start_payout = 0;   // AT開始時の総差枚 (早送りで AT中に入った場合はその時点)
+static bool g_ev_predict_enabled = true;  // 起動に失敗したら以降は推定しない
 
 // --- ヘルパー関数プロトタイプ ---
 static void HandleInput();
 static void UpdateGameLogic(bool all_reels_stopped);
 static void CheckAndPerformTransition();
 static void StartSpin();
+static bool ConsumeScriptSkips();
 static void SelectPresentationPair(GameData* data);
 static VideoType SelectJudgmentVideo(GameData* data);
-static VideoType GetJudgePart2(VideoType part1);
-static VideoType GetBBExShowVideo(int payout, bool is_intro);
-static const char* GetLoopKeyForState(AT_State state);
-static const char* GetTransitionKey(AT_State from, AT_State to);
-static const char* GetVideoKey(VideoType type);
 static bool PlayVideo(VideoType type, bool loop);
 static bool PlayVideoByKey(const char* key, bool loop);
 static void DrawDebugInfo();
+static void UpdateEvPredict();
+static void SwapPresentationRng();
 
 // --- 公開関数 実装 ---
 
 bool Director_Init(SDL_Renderer* renderer) {
     g_renderer_ref = renderer;
     memset(&g_game_data, 0, sizeof(GameData));
-    g_game_data.current_state = STATE_NORMAL;
+    Normal_Init(&g_game_data);
     g_current_logic_state = STATE_NORMAL;
     g_current_media_state = STATE_NORMAL;
-    g_is_first_game = true;
     g_dir_state = DIR_STATE_IDLE;
 
+    int lose_count, win_count;
+    const WeightedEntry* lose = PresTable_GetPairEntries(false, &lose_count);
+    const WeightedEntry* win = PresTable_GetPairEntries(true, &win_count);
+    if (!WeightedTable_Init(&g_pres_pair_lose_table, "AT演出ペア/非当選", lose, lose_count, PRES_PAIR_DENOMINATOR) ||
+        !WeightedTable_Init(&g_pres_pair_win_table, "AT演出ペア/当選", win, win_count, PRES_PAIR_DENOMINATOR)) {
+        return false;
+    }
+
     // デバックウィンドウの初期化
     if (!init_debug_window("Debug Info", 400, 600)) {
         fprintf(stderr, "Warning: Failed to init debug window.\n");
     }
 
     // 初期ループ動画再生
-    const char* loop_path = MediaConfig_GetPath(GetLoopKeyForState(STATE_NORMAL));
+    const char* loop_path = MediaConfig_GetPath(PresTable_GetLoopKey(STATE_NORMAL));
     Presentation_Play(g_renderer_ref, loop_path, true);
 
     return true;
 }
 
+void Director_SetSeed(uint64_t seed) {
+    Rng_SeedStream(seed, DIRECTOR_PRES_RNG_STREAM);
+    Rng_GetState(&g_pres_rng);
+    Rng_Seed(seed);
+}
+
+bool Director_Warp(long long games) {
+    EvPredict_Stop(); // 推定ワーカーが参照中のテーブルを構築し直すため
+    if (!Sim_InitTables()) return false;
+
+    // ヘッドレス・エンジンで同じ乱数系列のまま games ゲーム進め、その状態から再開する
+    SimContext ctx;
+    Sim_Init(&ctx, NULL);
+    ctx.data = g_game_data;
+    Sim_RunGames(&ctx, games);
+
+    g_game_data = ctx.data;
+    g_game_data.at_step = (g_game_data.current_state == STATE_BONUS_HIGH_PROB) ? AT_STEP_WAIT_LEVER1 : AT_STEP_NONE;
+    g_current_logic_state = g_game_data.current_state;
+    g_dir_state = DIR_STATE_IDLE;
+    return true;
+}
+
 void Director_Cleanup() {
-    // 特になし
+    EvPredict_Stop();
+    WeightedTable_Free(&g_pres_pair_lose_table);
+    WeightedTable_Free(&g_pres_pair_win_table);
+    YakuScript_Free();
 }
 
 void Director_Update() {
@@ -120,7 +172,7 @@ void Director_Update() {
             if (Presentation_IsFinished()) {
                 // 遷移終了 -> 新しい状態のループへ
                 g_current_media_state = g_current_logic_state;
-                const char* path = MediaConfig_GetPath(GetLoopKeyForState(g_current_media_state));
+                const char* path = MediaConfig_GetPath(PresTable_GetLoopKey(g_current_media_state));
                 Presentation_Play(g_renderer_ref, path, true);
                 
                 // ※ BB EX 突入時は特殊ステートへ
@@ -178,8 +230,7 @@ void Director_Update() {
                     }
                     
                     // Part2 再生
-                    VideoType part1 = SelectJudgmentVideo(&g_game_data); // 現在のPart1を取得
-                    VideoType part2 = GetJudgePart2(part1);
+                    VideoType part2 = PresTable_GetJudgePart2(g_judge_part1);
                     
                     PlayVideo(part2, false);
                     g_dir_state = DIR_STATE_AT_JUDGE_PART2;
@@ -192,12 +243,16 @@ void Director_Update() {
                         g_current_logic_state = STATE_AT_END;
                         g_game_data.current_state = STATE_AT_END;
                         g_dir_state = DIR_STATE_IDLE;
-                        PlayVideoByKey(GetLoopKeyForState(STATE_AT_END), true);
+                        PlayVideoByKey(PresTable_GetLoopKey(STATE_AT_END), true);
                     } else {
                         // 継続 -> 動画をループに戻し、自動的に次ゲーム開始 (3回目レバー不要)
-                        PlayVideoByKey(GetLoopKeyForState(STATE_BONUS_HIGH_PROB), true);
-                        StartSpin();
-                        // StartSpin内で g_dir_state = DIR_STATE_SPINNING になる
+                        PlayVideoByKey(PresTable_GetLoopKey(STATE_BONUS_HIGH_PROB), true);
+                        if (ConsumeScriptSkips()) {
+                            // 早送りで状態が変わりうるため、自動開始せずレバー待ちに戻す (Director_Warp で IDLE)
+                        } else {
+                            StartSpin();
+                            // StartSpin内で g_dir_state = DIR_STATE_SPINNING になる
+                        }
                     }
                 }
             }
@@ -233,7 +288,7 @@ void Director_Update() {
                 Reel_ForceStop(REEL_PATTERN_RED7_MID);
                 
                 // 現在の枚数に対応したループ動画を再生する
-                VideoType loop_video = GetBBExShowVideo(g_bb_ex_shown_payout, false);
+                VideoType loop_video = PresTable_GetBBExShowVideo(g_bb_ex_shown_payout, false);
                 PlayVideo(loop_video, true);
                 
                 g_dir_state = DIR_STATE_BB_EX_WAIT;
@@ -246,6 +301,9 @@ void Director_Update() {
             
         default: break;
     }
+
+    // 4. AT残り期待値の推定 (バックグラウンドで集計し、ここでは状態を渡すだけ)
+    UpdateEvPredict();
 }
 
 void Director_Draw(SDL_Renderer* renderer, int screen_width, int screen_height) {
@@ -303,7 +361,7 @@ static void DrawDebugInfo() {
     y += 10; // スペーサー
 
     // --- 役情報 ---
-    snprintf(buffer, sizeof(buffer), "Last Yaku: %s", g_game_data.last_yaku_name);
+    snprintf(buffer, sizeof(buffer), "Last Yaku: %s", GetYakuName(g_game_data.last_yaku));
     draw_text(gDebugRenderer, buffer, 10, y, yellow); y += h;
 
     // --- AT/ボーナス情報 ---
@@ -313,6 +371,26 @@ static void DrawDebugInfo() {
         
         snprintf(buffer, sizeof(buffer), "Total Payout: %lld", g_game_data.total_payout_diff);
         draw_text(gDebugRenderer, buffer, 10, y, green); y += h;
+
+        // 残り期待値 (推定中の状態に対する集計。試行数は順次増える)
+        EvPredictEstimate ev;
+        EvPredict_GetEstimate(&ev);
+        if (ev.valid) {
+            y += 10;
+            snprintf(buffer, sizeof(buffer), "--- AT EV (n=%lld) ---", ev.samples);
+            draw_text(gDebugRenderer, buffer, 10, y, white); y += h;
+
+            snprintf(buffer, sizeof(buffer), "Remain: %+.0f (+-%.0f) / %.0fG",
+                     ev.mean_remaining, 1.96 * ev.se_remaining, ev.mean_games);
+            draw_text(gDebugRenderer, buffer, 10, y, green); y += h;
+
+            snprintf(buffer, sizeof(buffer), "AT: %.0f -> %.0f", ev.at_payout, ev.at_payout + ev.mean_remaining);
+            draw_text(gDebugRenderer, buffer, 10, y, green); y += h;
+
+            snprintf(buffer, sizeof(buffer), "P(>=%d): %.1f%%  P(>=%d): %.1f%%",
+                     ev.targets[0], 100.0 * ev.reach_prob[0], ev.targets[1], 100.0 * ev.reach_prob[1]);
+            draw_text(gDebugRenderer, buffer, 10, y, green); y += h;
+        }
     }
 
     // --- AT高確率情報 ---
@@ -349,7 +427,8 @@ static void DrawDebugInfo() {
     snprintf(buffer, sizeof(buffer), "Bonus Stock: %d", g_game_data.bonus_stock_count);
     draw_text(gDebugRenderer, buffer, 10, y, white); y += h;
 
-    draw_text(gDebugRenderer, g_game_data.info_message, 10, y, white); y += h;
+    // イベントは表示する時だけ文字列化する
+    draw_text(gDebugRenderer, GameEvent_Format(&g_game_data.last_event, buffer, sizeof(buffer)), 10, y, white); y += h;
 
     SDL_RenderPresent(gDebugRenderer);
 }
@@ -357,6 +436,19 @@ static void DrawDebugInfo() {
 
 // --- 内部実装 ---
 
+static void UpdateEvPredict() {
+    bool in_at = g_current_logic_state >= STATE_BB_INITIAL && g_current_logic_state < STATE_AT_END;
+    if (in_at && !g_was_in_at) {
+        g_at_start_payout = g_game_data.total_payout_diff;
+    }
+    g_was_in_at = in_at;
+
+    // ゲームの区切り (レバー待ち) の状態だけを渡す。同じ状態なら集計は続く
+    if (in_at && g_dir_state == DIR_STATE_IDLE && g_ev_predict_enabled) {
+        g_ev_predict_enabled = EvPredict_Request(&g_game_data, g_at_start_payout);
+    }
+}
+
 static void HandleInput() {
     SDL_Event e;
     while (SDL_PollEvent(&e) != 0) {
@@ -368,6 +460,15 @@ static void HandleInput() {
                 
                 // 1. 通常/AT待機中
                 if (g_dir_state == DIR_STATE_IDLE) {
+
+                    // スクリプトの早送りはレバーON時に消化する
+                    ConsumeScriptSkips();
+
+                    // AT終了後は通常時へ戻る
+                    if (g_current_logic_state == STATE_AT_END) {
+                        Normal_Init(&g_game_data);
+                        g_current_logic_state = STATE_NORMAL;
+                    }
                     
                     // 状態不一致なら遷移演出へ (ここでのみ遷移を許可)
                     if (g_current_logic_state != g_current_media_state) {
@@ -381,6 +482,7 @@ static void HandleInput() {
                 // 2. AT高確 2回目レバー (当選時のみここに来る)
                 else if (g_dir_state == DIR_STATE_AT_PRES_LOOP) {
                     VideoType judgePart1 = SelectJudgmentVideo(&g_game_data);
+                    g_judge_part1 = judgePart1;
                     if (PlayVideo(judgePart1, false)) {
                         g_dir_state = DIR_STATE_AT_JUDGE_PART1; // Part1開始
                         g_game_data.at_step = AT_STEP_JUDGE_VIDEO;
@@ -391,66 +493,30 @@ static void HandleInput() {
                 }
                 // 3. AT高確 3回目レバー (当選時の告知後)
                 else if (g_dir_state == DIR_STATE_AT_JUDGE_WAIT) {
-                    switch (g_game_data.at_bonus_result) {
-                        case BONUS_DARLING:
-                            g_current_logic_state = STATE_BB_HIGH_PROB;
-                            g_game_data.current_state = STATE_BB_HIGH_PROB;
-                            g_dir_state = DIR_STATE_IDLE; // 遷移
-                            break;
-                        case BONUS_FRANXX:
-                            g_current_logic_state = STATE_FRANXX_BONUS;
-                            g_game_data.current_state = STATE_FRANXX_BONUS;
-                            g_dir_state = DIR_STATE_IDLE; // 遷移
-                            break;
-                        case BONUS_BB_EX:
-                            g_current_logic_state = STATE_BB_EX;
-                            g_game_data.current_state = STATE_BB_EX;
-                            if(g_game_data.queued_bb_ex_payout <= 0) g_game_data.queued_bb_ex_payout = 100;
-                            g_dir_state = DIR_STATE_IDLE; // 遷移
-                            break;
-                        case BONUS_EPISODE:
-                            g_current_logic_state = STATE_EPISODE_BONUS;
-                            g_game_data.current_state = STATE_EPISODE_BONUS;
-                            g_dir_state = DIR_STATE_IDLE; // 遷移
-                            break;
-                        default:
-                            // ハズレ時など通常はここに来ないが、念のため
-                            g_dir_state = DIR_STATE_IDLE;
-                            break;
-                    }
+                    // ヘッドレス・シミュレータと同じ遷移処理 (目標差枚の設定・BB EX 枚数の抽選)
+                    AT_StartBonus(&g_game_data, g_game_data.at_bonus_result);
+                    g_current_logic_state = g_game_data.current_state;
+                    g_dir_state = DIR_STATE_IDLE; // 遷移
                 }
                 
                 // 4. BB EX 枚数告知待機
                 else if (g_dir_state == DIR_STATE_BB_EX_WAIT) {
-                    int remaining = g_game_data.queued_bb_ex_payout - g_bb_ex_shown_payout;
+                    // BB EX 突入時に予約枚数は目標差枚へ移される
+                    int remaining = g_game_data.target_bonus_payout - g_bb_ex_shown_payout;
                     
                     if (remaining <= 0) {
                         // 完了 -> 最終確認へ (リプレイ再生)
-                        VideoType intro = GetBBExShowVideo(g_bb_ex_shown_payout, true);
+                        VideoType intro = PresTable_GetBBExShowVideo(g_bb_ex_shown_payout, true);
                         PlayVideo(intro, false);
                         g_dir_state = DIR_STATE_BB_EX_FINAL;
                     } 
                     else {
-                        // 次の加算枚数を決定
-                        int next_add = 0;
-                        if (g_bb_ex_shown_payout == 0) {
-                            next_add = 200; // 初回200
-                        } else if (g_bb_ex_shown_payout < 1000) {
-                            next_add = 100; // 1000未満は +100
-                        } else {
-                            next_add = 1000; // 1000以上は +1000
-                        }
-                        
-                        // 上限クリップ
-                        if (g_bb_ex_shown_payout + next_add > g_game_data.queued_bb_ex_payout) {
-                            next_add = g_game_data.queued_bb_ex_payout - g_bb_ex_shown_payout;
-                        }
-
-                        g_bb_ex_shown_payout += next_add;
+                        // 次の告知枚数を決定 (初回200、1000未満は +100、以降 +1000)
+                        g_bb_ex_shown_payout = PresTable_GetBBExNextShown(g_bb_ex_shown_payout, g_game_data.target_bonus_payout);
                         
                         // 告知開始 (即逆回転)
                         Reel_StartSpinning_Reverse();
-                        PlayVideo(GetBBExShowVideo(g_bb_ex_shown_payout, true), false);
+                        PlayVideo(PresTable_GetBBExShowVideo(g_bb_ex_shown_payout, true), false);
                         g_dir_state = DIR_STATE_BB_EX_REVEAL;
                     }
                 }
@@ -458,7 +524,7 @@ static void HandleInput() {
                 else if (g_dir_state == DIR_STATE_BB_EX_FINAL) {
                     if (Presentation_IsFinished()) { 
                         // ゲーム開始
-                        const char* loop_path = MediaConfig_GetPath(GetLoopKeyForState(STATE_BB_EX));
+                        const char* loop_path = MediaConfig_GetPath(PresTable_GetLoopKey(STATE_BB_EX));
                         Presentation_Play(g_renderer_ref, loop_path, true);
                         g_dir_state = DIR_STATE_IDLE;
                         Reel_ForceStop(REEL_PATTERN_NONE); 
@@ -485,7 +551,8 @@ static void HandleInput() {
 }
 
 static void CheckAndPerformTransition() {
-    const char* trans_key = GetTransitionKey(g_current_media_state, g_current_logic_state);
+    char trans_key[64];
+    PresTable_GetTransitionKey(g_current_media_state, g_current_logic_state, trans_key, sizeof(trans_key));
     
     if (PlayVideoByKey(trans_key, false)) {
         StartSpin(); 
@@ -493,41 +560,54 @@ static void CheckAndPerformTransition() {
     } else {
         // 動画がない -> 即切り替え
         g_current_media_state = g_current_logic_state;
-        const char* path = MediaConfig_GetPath(GetLoopKeyForState(g_current_media_state));
+        const char* path = MediaConfig_GetPath(PresTable_GetLoopKey(g_current_media_state));
         Presentation_Play(g_renderer_ref, path, true);
         
         StartSpin();
     }
 }
 
-static void StartSpin() {
-    // 1. 抽選
-    if (g_is_first_game) {
-        AT_Init(&g_game_data);
-        g_current_yaku = YAKU_HAZURE;
-        g_is_first_game = false;
-        g_current_logic_state = g_game_data.current_state;
-    } else {
-        if (g_game_data.current_state == STATE_BONUS_HIGH_PROB) {
-            // AT高確
-            g_game_data.bonus_high_prob_games--;
-            g_current_yaku = Lottery_GetResult_AT();
-            g_game_data.at_bonus_result = Lottery_CheckBonus_AT(g_current_yaku);
-            g_game_data.at_last_lottery_yaku = g_current_yaku;
-            g_game_data.at_step = AT_STEP_REEL_SPIN;
-        }
-        else if (g_game_data.current_state == STATE_CZ || 
-                 g_game_data.current_state == STATE_FRANXX_BONUS) {
-            g_current_yaku = Lottery_GetResult_FranxxHighProb();
-        }
-        else {
-            g_current_yaku = Lottery_GetResult_Normal();
+// スクリプト先頭の早送りをすべて消化する。ゲームを開始するすべての経路で StartSpin の前に呼ぶ
+static bool ConsumeScriptSkips() {
+    bool warped = false;
+    const YakuScriptEntry* entry;
+    while ((entry = YakuScript_Peek()) != NULL && entry->op == YAKU_SCRIPT_SKIP) {
+        if (!Director_Warp(entry->games)) {
+            fprintf(stderr, "YakuScript: %d 行目の早送りに失敗しました\n", entry->line);
         }
+        YakuScript_Advance();
+        warped = true;
+    }
+    return warped;
+}
+
+static void StartSpin() {
+    // 1. 抽選 (成立役スクリプトがあればその役・ボーナス抽選結果を使う)
+    const YakuScriptEntry* script = YakuScript_Peek();
+    bool scripted = script && script->op == YAKU_SCRIPT_YAKU;
+
+    if (g_game_data.current_state == STATE_BONUS_HIGH_PROB) {
+        // AT高確
+        g_game_data.bonus_high_prob_games--;
+        g_current_yaku = scripted ? script->yaku : Lottery_GetResult_AT();
+        g_game_data.at_bonus_result = (scripted && script->has_bonus)
+            ? script->bonus : Lottery_CheckBonus_AT(g_current_yaku);
+        g_game_data.at_last_lottery_yaku = g_current_yaku;
+        g_game_data.at_step = AT_STEP_REEL_SPIN;
+    }
+    else if (g_game_data.current_state == STATE_CZ || 
+             g_game_data.current_state == STATE_FRANXX_BONUS) {
+        g_current_yaku = scripted ? script->yaku : Lottery_GetResult_FranxxHighProb();
+    }
+    else {
+        g_current_yaku = scripted ? script->yaku : Lottery_GetResult_Normal();
     }
+    // 早送りはゲーム開始前に消化済み (ConsumeScriptSkips)。ここでは成立役の行だけ進める
+    if (script && script->op != YAKU_SCRIPT_SKIP) YakuScript_Advance();
 
     // 2. リール始動
     Reel_SetYaku(g_current_yaku);
-    snprintf(g_game_data.last_yaku_name, sizeof(g_game_data.last_yaku_name), "%s", GetYakuName(g_current_yaku));
+    g_game_data.last_yaku = g_current_yaku;
     Reel_StartSpinning();
     
     g_stop_order_counter = 1;
@@ -568,11 +648,14 @@ static void UpdateGameLogic(bool all_reels_stopped) {
         }
     } else {
         // 通常停止
-        if (g_current_logic_state == STATE_CZ) CZ_Update(&g_game_data, g_current_yaku);
-        else if (g_current_logic_state == STATE_NORMAL) Normal_Update(&g_game_data, g_current_yaku);
-        
+        if (g_current_logic_state == STATE_CZ || g_current_logic_state == STATE_NORMAL) {
+            if (g_current_logic_state == STATE_CZ) CZ_Update(&g_game_data, g_current_yaku);
+            else Normal_Update(&g_game_data, g_current_yaku);
+            // CZ突入・AT当選は次のレバーON時に遷移演出を再生する
+            g_current_logic_state = g_game_data.current_state;
+        }
         // ATロジック (毎フレーム更新関数だが、停止時処理として呼び出す)
-        if (g_current_logic_state >= STATE_BB_INITIAL && g_current_logic_state < STATE_AT_END) {
+        else if (g_current_logic_state >= STATE_BB_INITIAL && g_current_logic_state < STATE_AT_END) {
             AT_Update(&g_game_data, g_current_yaku, diff, false, true);
             g_current_logic_state = g_game_data.current_state;
         }
@@ -583,7 +666,7 @@ static void UpdateGameLogic(bool all_reels_stopped) {
 
 // --- Helper wrappers ---
 static bool PlayVideo(VideoType type, bool loop) {
-    const char* key = GetVideoKey(type);
+    const char* key = PresTable_GetVideoKey(type);
     return PlayVideoByKey(key, loop);
 }
 
@@ -596,171 +679,28 @@ static bool PlayVideoByKey(const char* key, bool loop) {
     return false;
 }
 
-static VideoType GetBBExShowVideo(int payout, bool is_intro) {
-    VideoType base = VIDEO_NONE;
-    switch (payout) {
-        case 200: base = VIDEO_BB_EX_SHOW_200_INTRO; break;
-        case 300: base = VIDEO_BB_EX_SHOW_300_INTRO; break;
-        case 400: base = VIDEO_BB_EX_SHOW_400_INTRO; break;
-        case 500: base = VIDEO_BB_EX_SHOW_500_INTRO; break;
-        case 600: base = VIDEO_BB_EX_SHOW_600_INTRO; break;
-        case 700: base = VIDEO_BB_EX_SHOW_700_INTRO; break;
-        case 800: base = VIDEO_BB_EX_SHOW_800_INTRO; break;
-        case 900: base = VIDEO_BB_EX_SHOW_900_INTRO; break;
-        case 1000: base = VIDEO_BB_EX_SHOW_1000_INTRO; break;
-        case 2000: base = VIDEO_BB_EX_SHOW_2000_INTRO; break;
-        case 3000: base = VIDEO_BB_EX_SHOW_3000_INTRO; break;
-        default: base = VIDEO_BB_EX_SHOW_200_INTRO; break;
-    }
-    return is_intro ? base : (VideoType)(base + 1);
-}
-
-// Helper: Part1のIDからPart2のIDを取得
-static VideoType GetJudgePart2(VideoType part1) {
-    // PART1の次は定義上 PART2 であることを利用
-    return (VideoType)(part1 + 1);
-}
-
-static const char* GetVideoKey(VideoType type) {
-    switch(type) {
-        case VIDEO_IDLE: return "LOOP_VIDEO_NORMAL";
-        case VIDEO_SPIN: return "LOOP_VIDEO_NORMAL"; 
-        case VIDEO_AT_PRES_A_INTRO: return "AT_PRES_A_INTRO";
-        case VIDEO_AT_PRES_A_LOOP:  return "AT_PRES_A_LOOP";
-        case VIDEO_AT_PRES_B_INTRO: return "AT_PRES_B_INTRO";
-        case VIDEO_AT_PRES_B_LOOP:  return "AT_PRES_B_LOOP";
-        case VIDEO_AT_PRES_C_INTRO: return "AT_PRES_C_INTRO";
-        case VIDEO_AT_PRES_C_LOOP:  return "AT_PRES_C_LOOP";
-        case VIDEO_AT_PRES_D_INTRO: return "AT_PRES_D_INTRO";
-        case VIDEO_AT_PRES_D_LOOP:  return "AT_PRES_D_LOOP";
-        case VIDEO_JUDGE_LOSE_1:    return "JUDGE_LOSE_1";
-        case VIDEO_JUDGE_LOSE_2:    return "JUDGE_LOSE_2";
-        case VIDEO_JUDGE_LOSE_3:    return "JUDGE_LOSE_3";
-        
-        case VIDEO_JUDGE_DARLING_1_PART1: return "JUDGE_DARLING_1_PART1";
-        case VIDEO_JUDGE_DARLING_1_PART2: return "JUDGE_DARLING_1_PART2";
-        case VIDEO_JUDGE_DARLING_2_PART1: return "JUDGE_DARLING_2_PART1";
-        case VIDEO_JUDGE_DARLING_2_PART2: return "JUDGE_DARLING_2_PART2";
-        case VIDEO_JUDGE_DARLING_3_PART1: return "JUDGE_DARLING_3_PART1";
-        case VIDEO_JUDGE_DARLING_3_PART2: return "JUDGE_DARLING_3_PART2";
-
-        case VIDEO_JUDGE_FRANXX_1_PART1:  return "JUDGE_FRANXX_1_PART1";
-        case VIDEO_JUDGE_FRANXX_1_PART2:  return "JUDGE_FRANXX_1_PART2";
-        case VIDEO_JUDGE_FRANXX_2_PART1:  return "JUDGE_FRANXX_2_PART1";
-        case VIDEO_JUDGE_FRANXX_2_PART2:  return "JUDGE_FRANXX_2_PART2";
-        case VIDEO_JUDGE_FRANXX_3_PART1:  return "JUDGE_FRANXX_3_PART1";
-        case VIDEO_JUDGE_FRANXX_3_PART2:  return "JUDGE_FRANXX_3_PART2";
-        
-        case VIDEO_BB_EX_ENTRY_INTRO: return "BB_EX_ENTRY_INTRO";
-        case VIDEO_BB_EX_ENTRY_LOOP:  return "BB_EX_ENTRY_LOOP";
-        
-        case VIDEO_BB_EX_SHOW_200_INTRO: return "BB_EX_SHOW_200_INTRO";
-        case VIDEO_BB_EX_SHOW_200_LOOP:  return "BB_EX_SHOW_200_LOOP";
-        case VIDEO_BB_EX_SHOW_300_INTRO: return "BB_EX_SHOW_300_INTRO";
-        case VIDEO_BB_EX_SHOW_300_LOOP:  return "BB_EX_SHOW_300_LOOP";
-        case VIDEO_BB_EX_SHOW_400_INTRO: return "BB_EX_SHOW_400_INTRO";
-        case VIDEO_BB_EX_SHOW_400_LOOP:  return "BB_EX_SHOW_400_LOOP";
-        case VIDEO_BB_EX_SHOW_500_INTRO: return "BB_EX_SHOW_500_INTRO";
-        case VIDEO_BB_EX_SHOW_500_LOOP:  return "BB_EX_SHOW_500_LOOP";
-        case VIDEO_BB_EX_SHOW_600_INTRO: return "BB_EX_SHOW_600_INTRO";
-        case VIDEO_BB_EX_SHOW_600_LOOP:  return "BB_EX_SHOW_600_LOOP";
-        case VIDEO_BB_EX_SHOW_700_INTRO: return "BB_EX_SHOW_700_INTRO";
-        case VIDEO_BB_EX_SHOW_700_LOOP:  return "BB_EX_SHOW_700_LOOP";
-        case VIDEO_BB_EX_SHOW_800_INTRO: return "BB_EX_SHOW_800_INTRO";
-        case VIDEO_BB_EX_SHOW_800_LOOP:  return "BB_EX_SHOW_800_LOOP";
-        case VIDEO_BB_EX_SHOW_900_INTRO: return "BB_EX_SHOW_900_INTRO";
-        case VIDEO_BB_EX_SHOW_900_LOOP:  return "BB_EX_SHOW_900_LOOP";
-        case VIDEO_BB_EX_SHOW_1000_INTRO: return "BB_EX_SHOW_1000_INTRO";
-        case VIDEO_BB_EX_SHOW_1000_LOOP:  return "BB_EX_SHOW_1000_LOOP";
-        case VIDEO_BB_EX_SHOW_2000_INTRO: return "BB_EX_SHOW_2000_INTRO";
-        case VIDEO_BB_EX_SHOW_2000_LOOP:  return "BB_EX_SHOW_2000_LOOP";
-        case VIDEO_BB_EX_SHOW_3000_INTRO: return "BB_EX_SHOW_3000_INTRO";
-        case VIDEO_BB_EX_SHOW_3000_LOOP:  return "BB_EX_SHOW_3000_LOOP";
-
-        default: return NULL;
-    }
-}
-
-static const char* GetLoopKeyForState(AT_State state) {
-    switch (state) {
-        case STATE_NORMAL:          return "LOOP_VIDEO_NORMAL";
-        case STATE_CZ:              return "LOOP_VIDEO_CZ";
-        case STATE_BB_INITIAL:      return "LOOP_VIDEO_BB_INITIAL";
-        case STATE_BONUS_HIGH_PROB: return "LOOP_VIDEO_BONUS_HIGH_PROB";
-        case STATE_BB_HIGH_PROB:    return "LOOP_VIDEO_BB_HIGH_PROB";
-        case STATE_FRANXX_BONUS:    return "LOOP_VIDEO_FRANXX_BONUS";
-        case STATE_BB_EX:           return "LOOP_VIDEO_BB_EX";
-        case STATE_HIYOKU_BEATS:    return "LOOP_VIDEO_HIYOKU_BEATS";
-        case STATE_EPISODE_BONUS:   return "LOOP_VIDEO_EPISODE_BONUS";
-        case STATE_TSUREDASHI:      return "LOOP_VIDEO_TSUREDASHI";
-        case STATE_AT_END:          return "LOOP_VIDEO_AT_END";
-        default: return "LOOP_VIDEO_NORMAL"; 
-    }
-}
-
-static const char* GetTransitionKey(AT_State from, AT_State to) {
-    static char buffer[256];
-    const char *f = "NORMAL", *t = "NORMAL";
-    
-    switch(from) {
-        case STATE_NORMAL: f = "NORMAL"; break;
-        case STATE_CZ: f = "CZ"; break;
-        case STATE_BB_INITIAL: f = "BB_INITIAL"; break;
-        case STATE_BONUS_HIGH_PROB: f = "BONUS_HIGH_PROB"; break;
-        case STATE_BB_HIGH_PROB: f = "BB_HIGH_PROB"; break;
-        case STATE_FRANXX_BONUS: f = "FRANXX_BONUS"; break;
-        case STATE_BB_EX: f = "BB_EX"; break;
-        case STATE_HIYOKU_BEATS: f = "HIYOKU_BEATS"; break;
-        case STATE_EPISODE_BONUS: f = "EPISODE_BONUS"; break;
-        case STATE_TSUREDASHI: f = "TSUREDASHI"; break;
-        case STATE_AT_END: f = "AT_END"; break;
-        default: break;
-    }
-    switch(to) {
-        case STATE_NORMAL: t = "NORMAL"; break;
-        case STATE_CZ: t = "CZ"; break;
-        case STATE_BB_INITIAL: t = "BB_INITIAL"; break;
-        case STATE_BONUS_HIGH_PROB: t = "BONUS_HIGH_PROB"; break;
-        case STATE_BB_HIGH_PROB: t = "BB_HIGH_PROB"; break;
-        case STATE_FRANXX_BONUS: t = "FRANXX_BONUS"; break;
-        case STATE_BB_EX: t = "BB_EX"; break;
-        case STATE_HIYOKU_BEATS: t = "HIYOKU_BEATS"; break;
-        case STATE_EPISODE_BONUS: t = "EPISODE_BONUS"; break;
-        case STATE_TSUREDASHI: t = "TSUREDASHI"; break;
-        case STATE_AT_END: t = "AT_END"; break;
-        default: break;
-    }
-    
-    snprintf(buffer, sizeof(buffer), "TRANSITION_%s_TO_%s", f, t);
-    return buffer;
-}
-
 static void SelectPresentationPair(GameData* data) {
-    int k = rand() % 100; 
-    VideoType intro, loop;
-    if (data->at_bonus_result == BONUS_AT_CONTINUE) {
-        if (k < 40) { intro = VIDEO_AT_PRES_A_INTRO; loop = VIDEO_AT_PRES_A_LOOP; }
-        else if (k < 70) { intro = VIDEO_AT_PRES_B_INTRO; loop = VIDEO_AT_PRES_B_LOOP; }
-        else if (k < 90) { intro = VIDEO_AT_PRES_C_INTRO; loop = VIDEO_AT_PRES_C_LOOP; }
-        else { intro = VIDEO_AT_PRES_D_INTRO; loop = VIDEO_AT_PRES_D_LOOP; }
-    } else { 
-        if (k < 5) { intro = VIDEO_AT_PRES_A_INTRO; loop = VIDEO_AT_PRES_A_LOOP; }
-        else if (k < 20) { intro = VIDEO_AT_PRES_B_INTRO; loop = VIDEO_AT_PRES_B_LOOP; }
-        else if (k < 50) { intro = VIDEO_AT_PRES_C_INTRO; loop = VIDEO_AT_PRES_C_LOOP; }
-        else { intro = VIDEO_AT_PRES_D_INTRO; loop = VIDEO_AT_PRES_D_LOOP; }
-    }
+    const WeightedTable* table = (data->at_bonus_result == BONUS_AT_CONTINUE)
+        ? &g_pres_pair_lose_table : &g_pres_pair_win_table;
+    SwapPresentationRng();
+    VideoType intro = (VideoType)WeightedTable_Sample(table);
+    SwapPresentationRng();
     data->at_pres_intro_id = intro;
-    data->at_pres_loop_id = loop;
+    data->at_pres_loop_id = (VideoType)(intro + 1);
 }
 
 static VideoType SelectJudgmentVideo(GameData* data) {
-    int k = rand() % 3; 
+    SwapPresentationRng();
+    int k = Rng_Below(PRES_JUDGE_VARIANTS);
+    SwapPresentationRng();
     data->at_judge_video_duration_ms = 5000; 
-    if (data->at_bonus_result == BONUS_AT_CONTINUE) {
-        return (VideoType)(VIDEO_JUDGE_LOSE_1 + k);
-    } else if (data->at_bonus_result == BONUS_FRANXX) {
-        return (VideoType)(VIDEO_JUDGE_FRANXX_1_PART1 + (k*2)); 
-    } else { 
-        return (VideoType)(VIDEO_JUDGE_DARLING_1_PART1 + (k*2)); 
-    }
-}
\ No newline at end of file
+    return PresTable_GetJudgeVideo(data->at_bonus_result, k);
+}
+
+// 演出抽選用とゲームロジック用の乱数系列を入れ替える
+static void SwapPresentationRng() {
+    RngState logic;
+    Rng_GetState(&logic);
+    Rng_SetState(&g_pres_rng);
+    g_pres_rng = logic;
+}
@@ -3,6 +3,7 @@
 
 #include <SDL2/SDL.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 /**
  * @brief 演出制御モジュール(Director)を初期化します。
@@ -10,6 +11,20 @@
  */
 bool Director_Init(SDL_Renderer* renderer);
 
+/**
+ * @brief 乱数シードを設定します (ゲームロジック用と演出抽選用の系列を初期化)。
+ * 同じシードからはヘッドレス・シミュレータ (sim seek) と同じゲーム展開になります。
+ * (通常時・CZ は順押し、AT中はナビどおりに停止した場合)
+ */
+void Director_SetSeed(uint64_t seed);
+
+/**
+ * @brief 現在の状態からヘッドレス・エンジンで指定ゲーム数を消化し (早送り)、その状態から再開します。
+ * 通常時・CZ は順押し、AT中はナビどおりに停止したものとして進めます。
+ * @return 抽選テーブルの構築に失敗した場合は false
+ */
+bool Director_Warp(long long games);
+
 /**
  * @brief Directorを終了し、リソースを解放します。
  */
@@ -0,0 +1,194 @@
+#include "episode.h"
+#include "at.h"
+#include "parallel.h"
+#include "rng.h"
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char* k_bonus_names[EPISODE_BONUS_COUNT] = {
+    "BB[初当り]", "BB[高確中]", "フランクスボーナス", "BB EX", "EPボーナス"
+};
+
+typedef struct {
+    const EpisodeConfig* config;
+    GameData start;
+    AtEpisode* episodes;
+} EpisodeJob;
+
+// --- 内部ヘルパー関数 ---
+
+static bool is_at_state(AT_State state) {
+    return state >= STATE_BB_INITIAL && state < STATE_AT_END;
+}
+
+// ボーナス状態に入ったら数える (比翼BEATS・高確率は数えない)
+static void count_bonus(AtEpisode* episode, AT_State state) {
+    int kind;
+    switch (state) {
+        case STATE_BB_INITIAL:    kind = EPISODE_BONUS_BB_INITIAL; break;
+        case STATE_BB_HIGH_PROB:  kind = EPISODE_BONUS_DARLING; break;
+        case STATE_FRANXX_BONUS:  kind = EPISODE_BONUS_FRANXX; break;
+        case STATE_BB_EX:         kind = EPISODE_BONUS_BB_EX; break;
+        case STATE_EPISODE_BONUS: kind = EPISODE_BONUS_EPISODE; break;
+        default: return;
+    }
+    if (episode->bonus_count[kind] < UINT16_MAX) episode->bonus_count[kind]++;
+}
+
+static void track_hiyoku(AtEpisode* episode, const GameData* data, bool was_active) {
+    if (!data->hiyoku_is_active) return;
+    if (!was_active && episode->hiyoku_count < UINT16_MAX) episode->hiyoku_count++;
+    if ((int)data->hiyoku_level > episode->hiyoku_max_level) episode->hiyoku_max_level = (uint8_t)data->hiyoku_level;
+}
+
+// エピソード 1 回を 1 タスクとする (長さのばらつきはワークスティーリングで均す)
+static void episode_task(int task_index, void* user) {
+    EpisodeJob* job = (EpisodeJob*)user;
+    Rng_SeedStream(job->config->seed, (uint64_t)task_index);
+    Episode_Sample(&job->start, &job->episodes[task_index]); // 開始状態は Episode_RunBatch で検証済み
+}
+
+static int compare_int32(const void* a, const void* b) {
+    int32_t x = *(const int32_t*)a, y = *(const int32_t*)b;
+    return (x > y) - (x < y);
+}
+
+// 昇順に並べた values の q 分位点
+static int quantile(const int32_t* sorted, long long n, double q) {
+    return n > 0 ? sorted[(long long)((n - 1) * q)] : 0;
+}
+
+// --- 公開関数 ---
+
+const char* Episode_GetBonusName(EpisodeBonusKind kind) {
+    return (kind >= 0 && kind < EPISODE_BONUS_COUNT) ? k_bonus_names[kind] : "?";
+}
+
+int Episode_GetChainLength(const AtEpisode* episode) {
+    int chain = 0;
+    for (int k = 0; k < EPISODE_BONUS_COUNT; k++) chain += episode->bonus_count[k];
+    return chain;
+}
+
+bool Episode_Run(SimContext* ctx, AtEpisode* episode) {
+    GameData* data = &ctx->data;
+    memset(episode, 0, sizeof(*episode));
+    if (data->current_state == STATE_AT_END) return true;
+    if (!is_at_state(data->current_state)) return false;
+
+    long long start_games = ctx->games;
+    long long start_payout = data->total_payout_diff;
+    AT_State state = data->current_state;
+    count_bonus(episode, state);
+    track_hiyoku(episode, data, false);
+
+    while (state != STATE_AT_END) {
+        bool was_active = data->hiyoku_is_active;
+        long long before = data->total_payout_diff;
+        Sim_Step(ctx);
+        // 状態が変わるのは最後のゲームだけなので、差枚は打つ前の状態に付ける
+        if (state == STATE_BB_EX) episode->ex_payout += (int32_t)(data->total_payout_diff - before);
+        if (data->current_state != state) {
+            state = data->current_state;
+            count_bonus(episode, state);
+        }
+        track_hiyoku(episode, data, was_active);
+    }
+
+    episode->payout = (int32_t)(data->total_payout_diff - start_payout);
+    episode->games = (int32_t)(ctx->games - start_games);
+    return true;
+}
+
+bool Episode_Sample(const GameData* start, AtEpisode* episode) {
+    SimOptions options = { .event_skip = true };
+    SimContext ctx;
+    Sim_Init(&ctx, &options);
+    ctx.data = *start;
+    return Episode_Run(&ctx, episode);
+}
+
+bool Episode_Summarize(const AtEpisode* episodes, long long count, EpisodeStats* stats) {
+    memset(stats, 0, sizeof(*stats));
+    if (count <= 0) return true;
+    int32_t* sorted = (int32_t*)malloc(sizeof(int32_t) * (size_t)count);
+    if (!sorted) {
+        fprintf(stderr, "Episode: メモリ確保に失敗しました\n");
+        return false;
+    }
+
+    double sq_sum = 0.0;
+    long long chain_sum = 0;
+    for (long long i = 0; i < count; i++) {
+        const AtEpisode* e = &episodes[i];
+        stats->games += e->games;
+        stats->payout += e->payout;
+        sq_sum += (double)e->payout * e->payout;
+        sorted[i] = e->payout;
+
+        int chain = Episode_GetChainLength(e);
+        chain_sum += chain;
+        stats->chain_counts[chain < EPISODE_MAX_CHAIN ? chain : EPISODE_MAX_CHAIN]++;
+        for (int k = 0; k < EPISODE_BONUS_COUNT; k++) stats->bonus_totals[k] += e->bonus_count[k];
+        stats->ex_payout += e->ex_payout;
+
+        if (e->hiyoku_count > 0) stats->hiyoku_episodes++;
+        stats->hiyoku_total += e->hiyoku_count;
+        stats->hiyoku_max_level_counts[e->hiyoku_max_level <= HIYOKU_MAXX ? e->hiyoku_max_level : HIYOKU_MAXX]++;
+    }
+    stats->episodes = count;
+    stats->mean_payout = (double)stats->payout / count;
+    stats->mean_games = (double)stats->games / count;
+    stats->mean_chain = (double)chain_sum / count;
+    double var = count > 1 ? (sq_sum - count * stats->mean_payout * stats->mean_payout) / (count - 1) : 0.0;
+    stats->payout_sd = sqrt(var > 0 ? var : 0.0);
+
+    qsort(sorted, (size_t)count, sizeof(int32_t), compare_int32);
+    stats->payout_q10 = quantile(sorted, count, 0.1);
+    stats->payout_q25 = quantile(sorted, count, 0.25);
+    stats->payout_q50 = quantile(sorted, count, 0.5);
+    stats->payout_q75 = quantile(sorted, count, 0.75);
+    stats->payout_q90 = quantile(sorted, count, 0.9);
+    stats->payout_q99 = quantile(sorted, count, 0.99);
+    free(sorted);
+    return true;
+}
+
+bool Episode_RunBatch(const EpisodeConfig* config, EpisodeStats* stats, AtEpisode* episodes) {
+    memset(stats, 0, sizeof(*stats));
+    if (config->episodes <= 0 || config->episodes > INT_MAX) {
+        fprintf(stderr, "Episode: 設定が不正です\n");
+        return false;
+    }
+    if (config->start && !is_at_state(config->start->current_state)) {
+        fprintf(stderr, "Episode: 開始状態が AT中ではありません (%s)\n", AT_GetStateName(config->start->current_state));
+        return false;
+    }
+
+    EpisodeJob job;
+    job.config = config;
+    if (config->start) {
+        job.start = *config->start;
+    } else {
+        SimContext ctx;
+        Sim_Init(&ctx, NULL);
+        Sim_StartAT(&ctx);
+        job.start = ctx.data;
+    }
+    job.episodes = episodes ? episodes : (AtEpisode*)malloc(sizeof(AtEpisode) * (size_t)config->episodes);
+    if (!job.episodes) {
+        fprintf(stderr, "Episode: メモリ確保に失敗しました\n");
+        return false;
+    }
+
+    bool ok = Parallel_Run((int)config->episodes, config->threads, episode_task, &job);
+    if (ok) {
+        ok = Episode_Summarize(job.episodes, config->episodes, stats);
+    }
+
+    if (!episodes) free(job.episodes);
+    return ok;
+}
@@ -0,0 +1,107 @@
+#ifndef EPISODE_H
+#define EPISODE_H
+
+#include "sim.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// =================================================================
+// AT単位 (エピソード) のサンプリングと集計
+// -----------------------------------------------------------------
+// 開始状態から AT終了までを一括消化込みで打ち、1 回の AT を差枚・G数・
+// ボーナス種別ごとの回数・BB EX の獲得枚数・比翼BEATS の突入回数と
+// 最高レベルだけの要約にする。集計は要約の配列から行い、連チャン数
+// (AT中のボーナス回数) の分布・ボーナスの内訳・獲得差枚の分位点を求める。
+// エピソード i は Rng_SeedStream(seed, i) の乱数列を使うため、
+// 結果はスレッド数によらない。
+// =================================================================
+
+#define EPISODE_MAX_CHAIN 50 // 連チャン数の分布の最後の区分 (これ以上をまとめる)
+
+// 連チャンに数えるボーナスの種類
+typedef enum {
+    EPISODE_BONUS_BB_INITIAL, // BB[初当り]
+    EPISODE_BONUS_DARLING,    // BB[高確中]
+    EPISODE_BONUS_FRANXX,     // フランクスボーナス
+    EPISODE_BONUS_BB_EX,      // BB EX (連れ出し・EXストックからの突入を含む)
+    EPISODE_BONUS_EPISODE,    // エピソードボーナス
+    EPISODE_BONUS_COUNT
+} EpisodeBonusKind;
+
+// AT 1 回分の要約
+typedef struct {
+    int32_t payout;                              // 獲得差枚 (開始状態から AT終了まで)
+    int32_t games;
+    int32_t ex_payout;                           // BB EX 中の獲得差枚
+    uint16_t bonus_count[EPISODE_BONUS_COUNT];   // 開始時点で消化中のボーナスも 1 回と数える
+    uint16_t hiyoku_count;                       // 比翼BEATS の突入回数 (並行作動・連れ出しを含む)
+    uint8_t hiyoku_max_level;                    // 到達した最高レベル (0 = 突入なし)
+} AtEpisode;
+
+typedef struct {
+    long long episodes;
+    unsigned long long seed;
+    int threads;                  // 0 以下で既定値
+    const GameData* start;        // 開始状態 (NULL で AT開始 = BB[初当り])
+} EpisodeConfig;
+
+typedef struct {
+    long long episodes;
+    long long games;
+    long long payout;
+    double mean_payout;
+    double payout_sd;
+    int payout_q10, payout_q25, payout_q50, payout_q75, payout_q90, payout_q99;
+    double mean_games;
+
+    // 連チャン数 (ボーナス回数の合計) の分布 [0..EPISODE_MAX_CHAIN]
+    long long chain_counts[EPISODE_MAX_CHAIN + 1];
+    double mean_chain;
+
+    // ボーナスの内訳
+    long long bonus_totals[EPISODE_BONUS_COUNT];
+    long long ex_payout;
+
+    // 比翼BEATS
+    long long hiyoku_episodes;              // 1 回以上突入したエピソード数
+    long long hiyoku_total;
+    long long hiyoku_max_level_counts[HIYOKU_MAXX + 1]; // 最高レベル別のエピソード数 (0 = 突入なし)
+} EpisodeStats;
+
+/**
+ * @brief ボーナス種別の表示名を返します。
+ */
+const char* Episode_GetBonusName(EpisodeBonusKind kind);
+
+/**
+ * @brief 連チャン数 (ボーナス回数の合計) を返します。
+ */
+int Episode_GetChainLength(const AtEpisode* episode);
+
+/**
+ * @brief ctx の現在の AT中の状態から AT終了まで打ち、要約を返します。
+ * 一括消化は ctx->options に従います。乱数はスレッドの現在の乱数列を使います。
+ * @return 通常時・CZ から呼んだ場合は false (何もしない)
+ */
+bool Episode_Run(SimContext* ctx, AtEpisode* episode);
+
+/**
+ * @brief 開始状態をコピーし、一括消化を有効にして AT終了まで打ちます。
+ * @return start が AT中の状態でない場合は false
+ */
+bool Episode_Sample(const GameData* start, AtEpisode* episode);
+
+/**
+ * @brief 要約の配列を先頭から順に集計します。
+ * @return メモリ確保に失敗した場合は false
+ */
+bool Episode_Summarize(const AtEpisode* episodes, long long count, EpisodeStats* stats);
+
+/**
+ * @brief エピソードを並列にサンプリングして集計します。Sim_InitTables 済みであること。
+ * @param episodes config->episodes 個の書き出し先 (NULL 可)
+ * @return 設定が不正・メモリ確保・スレッド作成に失敗した場合は false
+ */
+bool Episode_RunBatch(const EpisodeConfig* config, EpisodeStats* stats, AtEpisode* episodes);
+
+#endif // EPISODE_H
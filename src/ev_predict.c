@@ -0,0 +1,192 @@
+#include "ev_predict.h"
+#include "parallel.h"
+#include "rng.h"
+#include "sim.h"
+#include "thread_config.h"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_thread.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define EV_PREDICT_MAX_THREADS 8
+#define EV_PREDICT_BATCH 256            // 1 回のロックで受け取る試行数
+#define EV_PREDICT_SEED 0x45565052ULL   // 状態 g のバッチ b は Rng_SeedStream(seed ^ g, b)
+
+static const int k_targets[EV_PREDICT_TARGET_COUNT] = { 1000, 2000 };
+
+// 状態 1 つ分の集計
+typedef struct {
+    long long samples;
+    double sum;
+    double sq_sum;
+    double games_sum;
+    long long reach_count[EV_PREDICT_TARGET_COUNT];
+} EvPredictAccum;
+
+static SDL_mutex* g_mutex = NULL;
+static SDL_cond* g_cond = NULL;
+static SDL_Thread* g_threads[EV_PREDICT_MAX_THREADS];
+static int g_thread_count = 0;
+static bool g_stop = false;
+
+// 以下は g_mutex で保護する
+static uint64_t g_generation = 0;       // 状態が変わるたびに増やす (0 は未リクエスト)
+static GameData g_snapshot;
+static long long g_at_start_payout = 0;
+static long long g_next_batch = 0;
+static EvPredictAccum g_accum;
+
+// --- 内部ヘルパー関数 ---
+
+static bool has_work(void) {
+    return g_generation != 0 && g_next_batch * EV_PREDICT_BATCH < EV_PREDICT_MAX_SAMPLES;
+}
+
+static void run_batch(const GameData* snapshot, long long at_start_payout, EvPredictAccum* accum) {
+    SimOptions options = { true };
+    SimContext ctx;
+    for (int i = 0; i < EV_PREDICT_BATCH; i++) {
+        Sim_Init(&ctx, &options);
+        ctx.data = *snapshot;
+        Sim_RunAT(&ctx, EV_PREDICT_MAX_GAMES);
+
+        double remaining = (double)(ctx.data.total_payout_diff - snapshot->total_payout_diff);
+        long long at_payout = ctx.data.total_payout_diff - at_start_payout;
+        accum->samples++;
+        accum->sum += remaining;
+        accum->sq_sum += remaining * remaining;
+        accum->games_sum += (double)ctx.games;
+        for (int t = 0; t < EV_PREDICT_TARGET_COUNT; t++) {
+            if (at_payout >= k_targets[t]) accum->reach_count[t]++;
+        }
+    }
+}
+
+static int worker_main(void* arg) {
+    GameData snapshot;
+    ThreadConfig_Apply(THREAD_ROLE_EV_PREDICT, (int)(intptr_t)arg); // 既定は低優先度 (描画ループより後回し)
+    for (;;) {
+        SDL_LockMutex(g_mutex);
+        while (!g_stop && !has_work()) {
+            SDL_CondWait(g_cond, g_mutex);
+        }
+        if (g_stop) {
+            SDL_UnlockMutex(g_mutex);
+            break;
+        }
+        uint64_t generation = g_generation;
+        long long batch = g_next_batch++;
+        long long at_start_payout = g_at_start_payout;
+        snapshot = g_snapshot;
+        SDL_UnlockMutex(g_mutex);
+
+        EvPredictAccum local;
+        memset(&local, 0, sizeof(local));
+        Rng_SeedStream(EV_PREDICT_SEED ^ generation, (uint64_t)batch);
+        run_batch(&snapshot, at_start_payout, &local);
+
+        // 打っている間に状態が変わっていたら捨てる
+        SDL_LockMutex(g_mutex);
+        if (generation == g_generation) {
+            g_accum.samples += local.samples;
+            g_accum.sum += local.sum;
+            g_accum.sq_sum += local.sq_sum;
+            g_accum.games_sum += local.games_sum;
+            for (int t = 0; t < EV_PREDICT_TARGET_COUNT; t++) g_accum.reach_count[t] += local.reach_count[t];
+        }
+        SDL_UnlockMutex(g_mutex);
+    }
+    return 0;
+}
+
+static bool start_workers(void) {
+    // ワーカーが動いていない間にテーブルを構築する
+    if (!Sim_InitTables()) {
+        fprintf(stderr, "EvPredict: 抽選テーブルの構築に失敗しました\n");
+        return false;
+    }
+    if (!g_mutex) g_mutex = SDL_CreateMutex();
+    if (!g_cond) g_cond = SDL_CreateCond();
+    if (!g_mutex || !g_cond) {
+        fprintf(stderr, "EvPredict: 同期オブジェクトを作成できません: %s\n", SDL_GetError());
+        return false;
+    }
+
+    // 描画ループ用に 1 コア空ける (CPU を割り当てた場合はその数)
+    int count = ThreadConfig_GetCpuCount(THREAD_ROLE_EV_PREDICT);
+    if (count <= 0) count = Parallel_GetDefaultThreadCount() - 1;
+    if (count < 1) count = 1;
+    if (count > EV_PREDICT_MAX_THREADS) count = EV_PREDICT_MAX_THREADS;
+
+    g_stop = false;
+    for (int i = 0; i < count; i++) {
+        SDL_Thread* t = SDL_CreateThread(worker_main, "ev_predict", (void*)(intptr_t)i);
+        if (!t) {
+            fprintf(stderr, "EvPredict: スレッドを作成できません: %s\n", SDL_GetError());
+            break;
+        }
+        g_threads[g_thread_count++] = t;
+    }
+    return g_thread_count > 0;
+}
+
+// --- 公開関数 ---
+
+bool EvPredict_Request(const GameData* data, long long at_start_payout) {
+    if (g_thread_count == 0 && !start_workers()) return false;
+
+    SDL_LockMutex(g_mutex);
+    if (g_generation == 0 || at_start_payout != g_at_start_payout ||
+        memcmp(data, &g_snapshot, sizeof(GameData)) != 0) {
+        memcpy(&g_snapshot, data, sizeof(GameData)); // 比較と同じくパディングごと写す
+        g_at_start_payout = at_start_payout;
+        g_generation++;
+        g_next_batch = 0;
+        memset(&g_accum, 0, sizeof(g_accum));
+        SDL_CondBroadcast(g_cond);
+    }
+    SDL_UnlockMutex(g_mutex);
+    return true;
+}
+
+void EvPredict_GetEstimate(EvPredictEstimate* out) {
+    memset(out, 0, sizeof(*out));
+    for (int t = 0; t < EV_PREDICT_TARGET_COUNT; t++) out->targets[t] = k_targets[t];
+    if (!g_mutex) return;
+
+    SDL_LockMutex(g_mutex);
+    EvPredictAccum accum = g_accum;
+    out->valid = g_generation != 0;
+    out->at_payout = (double)(g_snapshot.total_payout_diff - g_at_start_payout);
+    SDL_UnlockMutex(g_mutex);
+
+    long long n = accum.samples;
+    out->samples = n;
+    if (n == 0) return;
+    out->mean_remaining = accum.sum / n;
+    out->mean_games = accum.games_sum / n;
+    if (n > 1) {
+        double var = (accum.sq_sum - n * out->mean_remaining * out->mean_remaining) / (n - 1);
+        out->se_remaining = sqrt((var > 0 ? var : 0.0) / n);
+    }
+    for (int t = 0; t < EV_PREDICT_TARGET_COUNT; t++) {
+        out->reach_prob[t] = (double)accum.reach_count[t] / n;
+    }
+}
+
+void EvPredict_Stop(void) {
+    if (g_thread_count == 0) return;
+
+    SDL_LockMutex(g_mutex);
+    g_stop = true;
+    g_generation = 0;
+    memset(&g_accum, 0, sizeof(g_accum));
+    SDL_CondBroadcast(g_cond);
+    SDL_UnlockMutex(g_mutex);
+
+    for (int i = 0; i < g_thread_count; i++) {
+        SDL_WaitThread(g_threads[i], NULL);
+    }
+    g_thread_count = 0;
+}
@@ -0,0 +1,51 @@
+#ifndef EV_PREDICT_H
+#define EV_PREDICT_H
+
+#include "game_data.h"
+#include <stdbool.h>
+
+// =================================================================
+// AT残り期待値のリアルタイム推定 (デバッグウィンドウ用)
+// -----------------------------------------------------------------
+// Director から渡された AT中の GameData を複製し、バックグラウンドの
+// ワーカースレッドでヘッドレス・エンジンにより AT終了まで繰り返し打つ。
+// 状態が変わるたびに集計をやり直し、推定値は打ち終えたバッチの分だけ
+// 順次更新される。呼び出し側 (描画ループ) は待たされない。
+// 抽選テーブルはワーカーの起動前に構築し、実行中は読み取りのみ行う。
+// =================================================================
+
+#define EV_PREDICT_TARGET_COUNT 2
+#define EV_PREDICT_MAX_SAMPLES 200000   // 1 状態あたりの試行数の上限
+#define EV_PREDICT_MAX_GAMES 100000     // 1 試行の打ち切りゲーム数
+
+typedef struct {
+    bool valid;               // 推定中の状態がある
+    long long samples;        // 集計済みの試行数
+    double mean_remaining;    // 残り期待獲得差枚
+    double se_remaining;      // その標準誤差
+    double mean_games;        // 残り期待G数
+    double at_payout;         // AT開始から現在までの差枚
+    int targets[EV_PREDICT_TARGET_COUNT];        // AT獲得差枚のしきい値 (1000 / 2000)
+    double reach_prob[EV_PREDICT_TARGET_COUNT];  // AT終了時にしきい値以上となる確率
+} EvPredictEstimate;
+
+/**
+ * @brief 推定する状態を渡します (AT中のゲームの区切りで呼び出す)。
+ * 前回と同じ状態なら何もしません。初回はワーカーを起動します (抽選テーブルもここで構築)。
+ * @param at_start_payout AT開始時の total_payout_diff
+ * @return 抽選テーブルの構築・スレッドの作成に失敗した場合は false
+ */
+bool EvPredict_Request(const GameData* data, long long at_start_payout);
+
+/**
+ * @brief 現在の推定値を取得します (ロックは集計のコピーの間だけ)。
+ */
+void EvPredict_GetEstimate(EvPredictEstimate* out);
+
+/**
+ * @brief 推定を止め、ワーカーの終了を待ちます。
+ * 抽選テーブルを構築し直す前にも呼び出してください (次の Request で再起動します)。
+ */
+void EvPredict_Stop(void);
+
+#endif // EV_PREDICT_H
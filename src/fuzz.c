@@ -0,0 +1,309 @@
+#include "fuzz.h"
+#include "at.h"
+#include "lottery.h"
+#include "parallel.h"
+#include "rng.h"
+#include "sim.h"
+#include "spec.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define FUZZ_CASES_PER_TASK 256
+#define FUZZ_DEFAULT_STUCK_STEPS 50000
+#define FUZZ_STEPS_PER_CASE_FACTOR 20     // 1 ケースの上限手数 = stuck_steps × これ
+#define FUZZ_HIGH_PROB_GAMES_MAX 100000
+#define FUZZ_PAYOUT_MIN (-100000)
+#define FUZZ_HIYOKU_ST_MAX 4              // レベルMAXX の ST
+#define FUZZ_RANDOM_DIFF_MAX 15
+
+static const char* k_violation_names[FUZZ_VIOLATION_COUNT] = {
+    "なし",
+    "AT中に AT以外の状態",
+    "獲得差枚が目標以上のまま / 範囲外",
+    "目標差枚が 0 以下",
+    "ボーナス高確率の残りG数が範囲外",
+    "比翼BEATS の残りST が範囲外",
+    "比翼BEATS のレベルが範囲外",
+    "hiyoku_is_frozen だが hiyoku_is_active でない",
+    "比翼BEATS 状態だが比翼BEATS が作動していない",
+    "フランクスボーナス部の残り枚数が範囲外",
+    "同じ状態から抜けない / ATが終わらない",
+};
+
+typedef struct {
+    long long steps;
+    long long visits[STATE_AT_END + 1];
+    long long transitions[STATE_AT_END + 1][STATE_AT_END + 1];
+} FuzzStats;
+
+typedef struct {
+    FuzzStats stats;
+    long long cases;
+    bool failed;
+    long long fail_case;
+    long long fail_step;
+    FuzzViolation violation;
+} FuzzTask;
+
+typedef struct {
+    const FuzzConfig* config;
+    FuzzTask* tasks;
+} FuzzJob;
+
+// --- 内部ヘルパー関数 ---
+
+// 入力生成用の乱数 (AT内部の抽選とは別系列。入力列を差し替えて再生しても内部の抽選は変わらない)
+static uint64_t input_next(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static uint64_t input_seed(const FuzzConfig* config, long long case_index) {
+    uint64_t x = config->seed ^ 0x5DEECE66DULL;
+    x = input_next(&x) ^ ((uint64_t)case_index * 0xD1B54A32D192ED03ULL);
+    return input_next(&x);
+}
+
+// 役は 15/16 を小役抽選テーブルから、残りを全役から一様に選ぶ。差枚は 3/4 を払い出しどおりにする
+static FuzzInput generate_input(uint64_t* state, AT_State current) {
+    FuzzInput in;
+    uint64_t r = input_next(state);
+    if ((r & 0xF) < 15) {
+        LotteryTableId table = (current == STATE_FRANXX_BONUS) ? LOTTERY_TABLE_FRANXX_HIGH_PROB : LOTTERY_TABLE_NORMAL;
+        in.yaku = Lottery_LookupTable(table, (int)((r >> 16) & 0xFFFF));
+    } else {
+        in.yaku = (YakuType)((r >> 16) % YAKU_COUNT);
+    }
+    if (((r >> 8) & 3) != 0) {
+        in.diff = GetPayoutForYaku(in.yaku, true) - BET_COUNT; // AT中はナビどおり
+    } else {
+        in.diff = (int)((r >> 32) % (FUZZ_RANDOM_DIFF_MAX + BET_COUNT + 1)) - BET_COUNT;
+    }
+    // ボーナス当選は 1 割 (4 種を均等)。多すぎると高確G数が溜まり続けて ATが終わらない
+    int b = (int)((r >> 48) % 40);
+    if (b < 4) in.bonus = (AT_BonusResultType)(BONUS_DARLING + b);
+    else if (b < 6) in.bonus = BONUS_AT_CONTINUE;
+    else in.bonus = BONUS_NONE;
+    return in;
+}
+
+// Sim と同じ手順 (Sim_ApplyATGame) で 1 手進める
+static void apply_input(GameData* d, const FuzzInput* in) {
+    Sim_ApplyATGame(d, in->yaku, in->diff, in->bonus);
+}
+
+static bool is_payout_state(AT_State s) {
+    switch (s) {
+        case STATE_BB_INITIAL:
+        case STATE_BB_HIGH_PROB:
+        case STATE_FRANXX_BONUS:
+        case STATE_BB_EX:
+        case STATE_EPISODE_BONUS:
+        case STATE_TSUREDASHI:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static FuzzViolation check_invariants(const GameData* d) {
+    AT_State s = d->current_state;
+    if (s < STATE_BB_INITIAL || s > STATE_AT_END) return FUZZ_BAD_STATE;
+    if (is_payout_state(s)) {
+        if (d->target_bonus_payout <= 0) return FUZZ_TARGET_NOT_POSITIVE;
+        if (d->current_bonus_payout >= d->target_bonus_payout ||
+            d->current_bonus_payout < FUZZ_PAYOUT_MIN) return FUZZ_PAYOUT_RANGE;
+    }
+    if (d->bonus_high_prob_games < 0 || d->bonus_high_prob_games > FUZZ_HIGH_PROB_GAMES_MAX ||
+        (s == STATE_BONUS_HIGH_PROB && d->bonus_high_prob_games < 1)) return FUZZ_HIGH_PROB_GAMES_RANGE;
+    if (d->hiyoku_is_frozen && !d->hiyoku_is_active) return FUZZ_FROZEN_NOT_ACTIVE;
+    if (d->hiyoku_is_active) {
+        if (d->hiyoku_level < HIYOKU_LV1 || d->hiyoku_level > HIYOKU_MAXX) return FUZZ_HIYOKU_LEVEL_RANGE;
+        if (d->hiyoku_st_games < 1 || d->hiyoku_st_games > FUZZ_HIYOKU_ST_MAX) return FUZZ_HIYOKU_ST_RANGE;
+    }
+    if (s == STATE_HIYOKU_BEATS && !d->hiyoku_is_active) return FUZZ_HIYOKU_BEATS_INACTIVE;
+    // 残り枚数は FB の獲得差枚が負だと目標差枚を超えうるため、上限は見ない
+    if (d->franxx_bonus_part_remaining < 0 ||
+        (d->hiyoku_is_frozen && d->franxx_bonus_part_remaining == 0)) return FUZZ_FRANXX_PART_RANGE;
+    return FUZZ_OK;
+}
+
+static int stuck_steps(const FuzzConfig* config) {
+    return config->stuck_steps > 0 ? config->stuck_steps : FUZZ_DEFAULT_STUCK_STEPS;
+}
+
+// 1 ケースを実行する。inputs が NULL なら入力を生成し、record に書き出す (FUZZ_MAX_INPUTS まで)。
+// inputs を与えた場合はそれを使い切った時点で終了する
+static FuzzViolation run_case(const FuzzConfig* config, long long case_index,
+                              const FuzzInput* inputs, int input_count,
+                              FuzzInput* record, FuzzStats* stats, long long* fail_step) {
+    Rng_SeedStream(config->seed, (uint64_t)case_index);
+    uint64_t gen = input_seed(config, case_index);
+
+    GameData d;
+    memset(&d, 0, sizeof(d));
+    AT_Init(&d);
+
+    long long max_steps = (long long)stuck_steps(config) * FUZZ_STEPS_PER_CASE_FACTOR;
+    long long same_state = 0;
+    FuzzViolation v = check_invariants(&d);
+    long long step = 0;
+    while (v == FUZZ_OK && d.current_state != STATE_AT_END) {
+        if (inputs && step >= input_count) break;
+        FuzzInput in = inputs ? inputs[step] : generate_input(&gen, d.current_state);
+        if (record && step < FUZZ_MAX_INPUTS) record[step] = in;
+
+        AT_State prev = d.current_state;
+        apply_input(&d, &in);
+        step++;
+        if (stats) {
+            stats->visits[prev]++;
+            if (d.current_state >= STATE_NORMAL && d.current_state <= STATE_AT_END) {
+                stats->transitions[prev][d.current_state]++;
+            }
+        }
+        same_state = (d.current_state == prev) ? same_state + 1 : 0;
+
+        v = check_invariants(&d);
+        if (v == FUZZ_OK && (same_state > stuck_steps(config) || step > max_steps)) v = FUZZ_STUCK;
+    }
+    if (stats) stats->steps += step;
+    *fail_step = step;
+    return v;
+}
+
+static void fuzz_task(int task_index, void* user) {
+    FuzzJob* job = (FuzzJob*)user;
+    const FuzzConfig* config = job->config;
+    FuzzTask* task = &job->tasks[task_index];
+    memset(task, 0, sizeof(*task));
+
+    long long first = (long long)task_index * FUZZ_CASES_PER_TASK;
+    for (long long c = first; c < first + FUZZ_CASES_PER_TASK && c < config->cases; c++) {
+        long long step;
+        FuzzViolation v = run_case(config, c, NULL, 0, NULL, &task->stats, &step);
+        task->cases++;
+        if (v != FUZZ_OK) {
+            task->failed = true;
+            task->fail_case = c;
+            task->fail_step = step;
+            task->violation = v;
+            return;
+        }
+    }
+}
+
+// 入力列を再生し、同じ違反が起きるか
+static bool reproduces(const FuzzConfig* config, long long fail_case, FuzzViolation violation,
+                       const FuzzInput* inputs, int count) {
+    long long step;
+    return run_case(config, fail_case, inputs, count, NULL, NULL, &step) == violation;
+}
+
+// --- 公開関数 ---
+
+bool Fuzz_IsStateReachable(AT_State state) {
+    return state >= STATE_BB_INITIAL && state <= STATE_AT_END && state != STATE_TSUREDASHI;
+}
+
+const char* Fuzz_GetViolationName(FuzzViolation violation) {
+    return (violation >= 0 && violation < FUZZ_VIOLATION_COUNT) ? k_violation_names[violation] : "?";
+}
+
+bool Fuzz_Run(const FuzzConfig* config, FuzzResult* result) {
+    memset(result, 0, sizeof(*result));
+    if (config->cases <= 0) return true;
+
+    long long task_count = (config->cases + FUZZ_CASES_PER_TASK - 1) / FUZZ_CASES_PER_TASK;
+    FuzzJob job;
+    job.config = config;
+    job.tasks = (FuzzTask*)malloc(sizeof(FuzzTask) * (size_t)task_count);
+    if (!job.tasks) {
+        fprintf(stderr, "Fuzz: メモリ確保に失敗しました\n");
+        return false;
+    }
+    bool ok = Parallel_Run((int)task_count, config->threads, fuzz_task, &job);
+
+    // タスク番号順に合算 (最初の失敗より後のタスクも集計には含める)
+    for (long long t = 0; ok && t < task_count; t++) {
+        const FuzzTask* task = &job.tasks[t];
+        result->cases += task->cases;
+        result->steps += task->stats.steps;
+        for (int s = 0; s <= STATE_AT_END; s++) {
+            result->visits[s] += task->stats.visits[s];
+            for (int u = 0; u <= STATE_AT_END; u++) result->transitions[s][u] += task->stats.transitions[s][u];
+        }
+        if (task->failed && !result->failed) {
+            result->failed = true;
+            result->fail_case = task->fail_case;
+            result->fail_step = task->fail_step;
+            result->violation = task->violation;
+        }
+    }
+    free(job.tasks);
+    return ok;
+}
+
+int Fuzz_Minimize(const FuzzConfig* config, const FuzzResult* result, FuzzInput* inputs) {
+    if (!result->failed || result->fail_step > FUZZ_MAX_INPUTS) return 0;
+
+    long long step;
+    run_case(config, result->fail_case, NULL, 0, inputs, NULL, &step);
+    int count = (int)step;
+    if (!reproduces(config, result->fail_case, result->violation, inputs, count)) return 0;
+    // 手数そのものが原因の違反は縮小しない
+    if (result->violation == FUZZ_STUCK) return count;
+
+    // ddmin: n 分割した断片を除いても再現すれば除く
+    static _Thread_local FuzzInput trial[FUZZ_MAX_INPUTS];
+    int n = 2;
+    while (count >= 2) {
+        int chunk = (count + n - 1) / n;
+        bool reduced = false;
+        for (int i = 0; i < n && !reduced; i++) {
+            int lo = i * chunk;
+            int hi = lo + chunk < count ? lo + chunk : count;
+            if (lo >= hi) break;
+            int m = 0;
+            for (int k = 0; k < count; k++) {
+                if (k < lo || k >= hi) trial[m++] = inputs[k];
+            }
+            if (reproduces(config, result->fail_case, result->violation, trial, m)) {
+                memcpy(inputs, trial, sizeof(FuzzInput) * (size_t)m);
+                count = m;
+                n = n > 2 ? n - 1 : 2;
+                reduced = true;
+            }
+        }
+        if (!reduced) {
+            if (n >= count) break;
+            n = n * 2 < count ? n * 2 : count;
+        }
+    }
+    return count;
+}
+
+void Fuzz_PrintTrace(FILE* out, const FuzzConfig* config, long long fail_case, const FuzzInput* inputs, int count) {
+    Rng_SeedStream(config->seed, (uint64_t)fail_case);
+    GameData d;
+    memset(&d, 0, sizeof(d));
+    AT_Init(&d);
+
+    fprintf(out, "%4s %-18s %-28s %5s %-9s %s\n", "手", "状態", "成立役", "差枚", "ボーナス", "結果");
+    static const char* bonus_keys[] = { "NONE", "CONTINUE", "DARLING", "FRANXX", "BB_EX", "EPISODE" };
+    for (int i = 0; i < count; i++) {
+        AT_State prev = d.current_state;
+        apply_input(&d, &inputs[i]);
+        bool high_prob = prev == STATE_BONUS_HIGH_PROB;
+        fprintf(out, "%4d %-18s %-28s %+5d %-9s -> %s  差枚 %d/%d  高確 %dG  比翼 %s Lv%d ST%d%s  FB残 %d",
+                i + 1, AT_GetStateName(prev), GetYakuName(inputs[i].yaku), inputs[i].diff,
+                high_prob ? bonus_keys[inputs[i].bonus] : "-", AT_GetStateName(d.current_state),
+                d.current_bonus_payout, d.target_bonus_payout, d.bonus_high_prob_games,
+                d.hiyoku_is_active ? "ON" : "OFF", d.hiyoku_level, d.hiyoku_st_games,
+                d.hiyoku_is_frozen ? " (凍結)" : "", d.franxx_bonus_part_remaining);
+        FuzzViolation v = check_invariants(&d);
+        fprintf(out, "%s\n", v != FUZZ_OK ? "  <- 違反" : "");
+    }
+}
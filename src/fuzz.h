@@ -0,0 +1,91 @@
+#ifndef FUZZ_H
+#define FUZZ_H
+
+#include "game_data.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// =================================================================
+// AT状態遷移の不変条件ファジング
+// -----------------------------------------------------------------
+// AT_Init から AT終了まで、ランダムな成立役・差枚・(AT高確中は) ボーナス
+// 抽選結果を AT_Update / AT_StartBonus に与え、1 手ごとに不変条件を検査する。
+// ケース i の入力と AT内部の抽選は Rng_SeedStream(seed, i) から決まるため、
+// 失敗したケースは (seed, i) で再現できる。失敗時は入力列を ddmin で縮小する。
+// =================================================================
+
+#define FUZZ_MAX_INPUTS 4096 // 縮小する入力列の最大長
+
+typedef enum {
+    FUZZ_OK,
+    FUZZ_BAD_STATE,             // AT中に AT以外の状態
+    FUZZ_PAYOUT_RANGE,          // ボーナス中の獲得差枚が目標以上のまま / 範囲外
+    FUZZ_TARGET_NOT_POSITIVE,   // 差枚で終了するボーナスの目標差枚が 0 以下
+    FUZZ_HIGH_PROB_GAMES_RANGE, // ボーナス高確率の残りG数が範囲外
+    FUZZ_HIYOKU_ST_RANGE,       // 比翼BEATS の残りST が範囲外
+    FUZZ_HIYOKU_LEVEL_RANGE,    // 比翼BEATS のレベルが範囲外
+    FUZZ_FROZEN_NOT_ACTIVE,     // hiyoku_is_frozen なのに hiyoku_is_active でない
+    FUZZ_HIYOKU_BEATS_INACTIVE, // 比翼BEATS 状態なのに作動していない (抜けられない)
+    FUZZ_FRANXX_PART_RANGE,     // フランクスボーナス部の残り枚数が範囲外
+    FUZZ_STUCK,                 // 同じ状態から抜けない / ATが終わらない
+    FUZZ_VIOLATION_COUNT
+} FuzzViolation;
+
+// 1 手分の入力
+typedef struct {
+    YakuType yaku;
+    int diff;
+    AT_BonusResultType bonus; // AT高確中のみ使用
+} FuzzInput;
+
+typedef struct {
+    long long cases;
+    unsigned long long seed;
+    int threads;       // 0 以下で既定値
+    int stuck_steps;   // 同じ状態に留まってよい手数 (0 以下で既定値)
+} FuzzConfig;
+
+typedef struct {
+    long long cases;
+    long long steps;                                    // 全ケースの総手数
+    long long visits[STATE_AT_END + 1];                 // 状態ごとの滞在手数
+    long long transitions[STATE_AT_END + 1][STATE_AT_END + 1];
+
+    // 最初に失敗したケース (番号の最も小さいもの)
+    bool failed;
+    long long fail_case;
+    long long fail_step;
+    FuzzViolation violation;
+} FuzzResult;
+
+/**
+ * @brief ファジングを並列に実行します。Sim_InitTables 済みであること。
+ * @return メモリ確保・スレッド作成に失敗した場合は false (不変条件違反は result->failed)
+ */
+bool Fuzz_Run(const FuzzConfig* config, FuzzResult* result);
+
+/**
+ * @brief AT_Update で遷移しうる状態かを返します。
+ * STATE_TSUREDASHI は連れ出しを hiyoku_is_frozen で表すようになってから遷移しないため false。
+ */
+bool Fuzz_IsStateReachable(AT_State state);
+
+/**
+ * @brief 違反の説明を返します。
+ */
+const char* Fuzz_GetViolationName(FuzzViolation violation);
+
+/**
+ * @brief 失敗したケースの入力列を再生成し、同じ違反が起きる最小の入力列に縮小します。
+ * @param inputs FUZZ_MAX_INPUTS 個の書き出し先
+ * @return 縮小後の手数 (入力列が長すぎる・再現しない場合は 0)
+ */
+int Fuzz_Minimize(const FuzzConfig* config, const FuzzResult* result, FuzzInput* inputs);
+
+/**
+ * @brief 縮小した入力列を再生し、1 手ごとの状態を出力します。
+ */
+void Fuzz_PrintTrace(FILE* out, const FuzzConfig* config, long long fail_case, const FuzzInput* inputs, int count);
+
+#endif // FUZZ_H
@@ -45,6 +45,36 @@ typedef enum {
     REEL_PATTERN_FRANXX_BONUS   // 左中:赤7, 右:SHITA (★修正: BARではなくSHITA)
 } ReelForceStopPattern;
 
+// =================================================================
+// 表示用イベント
+// ロジックは種類と引数だけを記録し、文字列化は表示時に行う (game_event.h)
+// =================================================================
+typedef enum {
+    GAME_EVENT_NONE,
+    GAME_EVENT_CZ_START,          // value = CZ のG数
+    GAME_EVENT_CZ_AT_WIN,         // yaku = 当選役
+    GAME_EVENT_CZ_FAIL,
+    GAME_EVENT_CEILING_AT,
+    GAME_EVENT_NORMAL_AT_WIN,     // yaku = 当選役
+    GAME_EVENT_EX_STOCK,          // yaku = 契機役
+    GAME_EVENT_GAME_ADDON,        // value = 上乗せG数
+    GAME_EVENT_PAYOUT_ADDON,      // value = 上乗せ枚数
+    GAME_EVENT_STATE_CHANGE,      // value = 遷移先の AT_State
+    GAME_EVENT_AT_END,            // value = 総獲得枚数
+    GAME_EVENT_BONUS_STOCK,       // value = 1: BB EX / 0: ボーナス
+    GAME_EVENT_HIYOKU_LEVEL_UP,   // value = 昇格後の HiyokuLevel
+    GAME_EVENT_HIYOKU_END,
+    GAME_EVENT_FRANXX_PART_END,
+    GAME_EVENT_PAYOUT_RESET,
+    GAME_EVENT_TSUREDASHI,        // value = 1: BB EX へ / 0: 比翼BEATS (ホールド)
+    GAME_EVENT_COUNT
+} GameEventType;
+
+typedef struct {
+    GameEventType type;
+    YakuType yaku;
+    long long value;
+} GameEvent;
 
 // --- 全モジュール共通 ゲームデータ構造体 ---
 typedef struct {
@@ -55,6 +85,8 @@ typedef struct {
     
     // --- 2. AT/CZ 関連データ ---
     int bonus_high_prob_games; // 2. ボーナス高確率_残りG数
+    int normal_games;          // 通常時G数 (天井カウンタ、CZ中は数えない。AT終了後の通常時で 0 から)
+    int cz_games_remaining;    // CZ 残りG数
 
     // --- 3. ボーナス差枚管理 ---
     int current_bonus_payout; // 現在のボーナスで獲得した差枚
@@ -71,8 +103,8 @@ typedef struct {
     int hiyoku_st_games;
 
     // --- 6. 表示用データ ---
-    char last_yaku_name[64];  // 最後に成立した役の名前
-    char info_message[128]; // 画面に表示するメッセージ
+    YakuType last_yaku;       // 最後に成立した役
+    GameEvent last_event;     // 画面に表示するイベント (最後に起きたもの)
     bool oshijun_success;     // そのゲームで押し順に成功したか
 
     // =================================================================
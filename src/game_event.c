@@ -0,0 +1,64 @@
+#include "game_event.h"
+#include "at.h"      // AT_GetStateName() のため
+#include "lottery.h" // GetYakuName() のため
+#include <stdio.h>
+
+// --- 公開関数 ---
+
+const char* GameEvent_Format(const GameEvent* event, char* buffer, size_t size) {
+    switch (event->type) {
+        case GAME_EVENT_CZ_START:
+            snprintf(buffer, size, "CZ突入！ (%lldG)", event->value);
+            break;
+        case GAME_EVENT_CZ_AT_WIN:
+            snprintf(buffer, size, "CZ中 %s！ AT当選！", GetYakuName(event->yaku));
+            break;
+        case GAME_EVENT_CZ_FAIL:
+            snprintf(buffer, size, "CZ失敗…");
+            break;
+        case GAME_EVENT_CEILING_AT:
+            snprintf(buffer, size, "天井到達！ AT当選！");
+            break;
+        case GAME_EVENT_NORMAL_AT_WIN:
+            snprintf(buffer, size, "%s AT直撃！", GetYakuName(event->yaku));
+            break;
+        case GAME_EVENT_EX_STOCK:
+            snprintf(buffer, size, "%s! EXストック+1",
+                     event->yaku == YAKU_HP_REVERSE_STRONG_FRANXX ? "最強フランクス目" : "ストレリチア目");
+            break;
+        case GAME_EVENT_GAME_ADDON:
+            snprintf(buffer, size, "G数上乗せ +%lldG！", event->value);
+            break;
+        case GAME_EVENT_PAYOUT_ADDON:
+            snprintf(buffer, size, "差枚数上乗せ +%lld枚！", event->value);
+            break;
+        case GAME_EVENT_STATE_CHANGE:
+            snprintf(buffer, size, "%s へ遷移", AT_GetStateName((AT_State)event->value));
+            break;
+        case GAME_EVENT_AT_END:
+            snprintf(buffer, size, "AT終了。 総獲得: %lld枚", event->value);
+            break;
+        case GAME_EVENT_BONUS_STOCK:
+            snprintf(buffer, size, "%s ストック！", event->value ? "BB EX" : "ボーナス");
+            break;
+        case GAME_EVENT_HIYOKU_LEVEL_UP:
+            snprintf(buffer, size, "%sへ昇格！", event->value == HIYOKU_MAXX ? "レベルMAXX" : "レベル2");
+            break;
+        case GAME_EVENT_HIYOKU_END:
+            snprintf(buffer, size, "比翼BEATS (並行) 終了");
+            break;
+        case GAME_EVENT_FRANXX_PART_END:
+            snprintf(buffer, size, "フランクスボーナス部 終了！ 比翼BEATS再開！");
+            break;
+        case GAME_EVENT_PAYOUT_RESET:
+            snprintf(buffer, size, "差枚リセット！");
+            break;
+        case GAME_EVENT_TSUREDASHI:
+            snprintf(buffer, size, "%s", event->value ? "連れ出し + BB EXへ！" : "連れ出し！比翼BEATS (ホールド)");
+            break;
+        default:
+            if (size > 0) buffer[0] = '\0';
+            break;
+    }
+    return buffer;
+}
@@ -0,0 +1,22 @@
+#ifndef GAME_EVENT_H
+#define GAME_EVENT_H
+
+#include "game_data.h"
+#include <stddef.h>
+
+/**
+ * @brief 表示用イベントを記録します (文字列化はしない)。
+ */
+static inline void GameEvent_Record(GameData* data, GameEventType type, YakuType yaku, long long value) {
+    data->last_event.type = type;
+    data->last_event.yaku = yaku;
+    data->last_event.value = value;
+}
+
+/**
+ * @brief イベントを表示用のメッセージに整形します。
+ * @return 書き込んだ文字列 (buffer)。GAME_EVENT_NONE は空文字列
+ */
+const char* GameEvent_Format(const GameEvent* event, char* buffer, size_t size);
+
+#endif // GAME_EVENT_H
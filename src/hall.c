@@ -0,0 +1,291 @@
+#include "hall.h"
+#include "at.h"
+#include "parallel.h"
+#include "rng.h"
+#include <math.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HALL_MACHINES_PER_TASK 16
+#define HALL_LAYOUT_STREAM UINT64_MAX     // 設定の配置に使う乱数系列 (台は 0 〜 machines-1)
+#define HALL_COLUMN_NAME_LEN 16
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t row_count;
+    uint32_t column_count;
+} HallColumnsHeader;
+
+typedef struct {
+    char name[HALL_COLUMN_NAME_LEN];
+    uint32_t size;            // 4: int32 / 8: int64
+} HallColumnDesc;
+
+static const struct {
+    const char* name;
+    size_t offset;
+    uint32_t size;
+} k_columns[] = {
+    { "machine",        offsetof(HallMachineDay, machine),        sizeof(int) },
+    { "setting",        offsetof(HallMachineDay, setting),        sizeof(int) },
+    { "players",        offsetof(HallMachineDay, players),        sizeof(int) },
+    { "active_minutes", offsetof(HallMachineDay, active_minutes), sizeof(int) },
+    { "games",          offsetof(HallMachineDay, games),          sizeof(long long) },
+    { "at_count",       offsetof(HallMachineDay, at_count),       sizeof(int) },
+    { "cz_count",       offsetof(HallMachineDay, cz_count),       sizeof(int) },
+    { "bonus_count",    offsetof(HallMachineDay, bonus_count),    sizeof(int) },
+    { "payout",         offsetof(HallMachineDay, payout),         sizeof(long long) },
+    { "max_payout",     offsetof(HallMachineDay, max_payout),     sizeof(long long) },
+    { "min_payout",     offsetof(HallMachineDay, min_payout),     sizeof(long long) },
+};
+#define HALL_COLUMN_COUNT (int)(sizeof(k_columns) / sizeof(k_columns[0]))
+
+typedef struct {
+    const HallConfig* config;
+    const int* members;       // この設定の台番号
+    int member_count;
+    int setting_number;
+    HallMachineDay* days;
+} HallGroup;
+
+// --- 内部ヘルパー関数 ---
+
+static double exponential_minutes(double mean) {
+    return -mean * log(1.0 - Rng_NextDouble());
+}
+
+static bool is_bonus_state(AT_State s) {
+    switch (s) {
+        case STATE_BB_INITIAL:
+        case STATE_BB_HIGH_PROB:
+        case STATE_FRANXX_BONUS:
+        case STATE_BB_EX:
+        case STATE_EPISODE_BONUS:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// 1 台の 1 日。着席中の客は通常時 (と AT終了時) にだけ離席を判断する
+static void simulate_machine(const HallConfig* config, int machine, HallMachineDay* day) {
+    Rng_SeedStream(config->seed, (uint64_t)machine);
+    SimContext ctx;
+    Sim_Init(&ctx, &config->options);
+
+    double minutes_per_game = 1.0 / config->games_per_minute;
+    double leave_rate = config->mean_play_games > 0 ? 1.0 / config->mean_play_games : 0.0;
+    double minute = exponential_minutes(config->mean_idle_minutes);
+    double active = 0.0;
+
+    while (minute < config->open_minutes) {
+        day->players++;
+        long long seated_payout = ctx.data.total_payout_diff;
+        bool leave = false;
+        while (!leave && minute < config->open_minutes) {
+            AT_State prev = ctx.data.current_state;
+            int games = Sim_Step(&ctx);
+            minute += games * minutes_per_game;
+            active += games * minutes_per_game;
+
+            AT_State s = ctx.data.current_state;
+            long long payout = ctx.data.total_payout_diff;
+            if (s != prev && is_bonus_state(s)) day->bonus_count++;
+            if (payout > day->max_payout) day->max_payout = payout;
+            if (payout < day->min_payout) day->min_payout = payout;
+
+            if (s == STATE_AT_END) {
+                leave = Rng_NextDouble() < config->quit_after_at_rate;
+            } else if (s == STATE_NORMAL) {
+                leave = (config->stop_loss_medals > 0 && payout - seated_payout <= -config->stop_loss_medals) ||
+                        Rng_NextDouble() < leave_rate;
+            }
+        }
+        minute += exponential_minutes(config->mean_idle_minutes);
+    }
+
+    day->machine = machine;
+    day->active_minutes = (int)active;
+    day->games = ctx.games;
+    day->at_count = (int)ctx.at_count;
+    day->cz_count = (int)ctx.cz_count;
+    day->payout = ctx.data.total_payout_diff;
+}
+
+static void hall_task(int task_index, void* user) {
+    HallGroup* group = (HallGroup*)user;
+    int first = task_index * HALL_MACHINES_PER_TASK;
+    for (int i = first; i < first + HALL_MACHINES_PER_TASK && i < group->member_count; i++) {
+        int machine = group->members[i];
+        HallMachineDay* day = &group->days[machine];
+        memset(day, 0, sizeof(*day));
+        simulate_machine(group->config, machine, day);
+        day->setting = group->setting_number;
+    }
+}
+
+// 比率どおりの台数 (最大剰余法) を割り当て、台番号をシャッフルする
+static void layout_settings(const HallConfig* config, int setting_count, int* setting_of) {
+    long long total_weight = 0;
+    for (int s = 0; s < setting_count; s++) total_weight += config->settings[s].weight;
+
+    int counts[HALL_MAX_SETTINGS];
+    long long remainders[HALL_MAX_SETTINGS];
+    int assigned = 0;
+    for (int s = 0; s < setting_count; s++) {
+        long long share = (long long)config->machines * config->settings[s].weight;
+        counts[s] = (int)(share / total_weight);
+        remainders[s] = share % total_weight;
+        assigned += counts[s];
+    }
+    while (assigned < config->machines) {
+        int best = 0;
+        for (int s = 1; s < setting_count; s++) {
+            if (remainders[s] > remainders[best]) best = s;
+        }
+        counts[best]++;
+        remainders[best] = -1;
+        assigned++;
+    }
+
+    int m = 0;
+    for (int s = 0; s < setting_count; s++) {
+        for (int k = 0; k < counts[s]; k++) setting_of[m++] = s;
+    }
+    Rng_SeedStream(config->seed, HALL_LAYOUT_STREAM);
+    for (int i = config->machines - 1; i > 0; i--) {
+        int j = Rng_Below(i + 1);
+        int tmp = setting_of[i];
+        setting_of[i] = setting_of[j];
+        setting_of[j] = tmp;
+    }
+}
+
+// --- 公開関数 ---
+
+void Hall_InitConfig(HallConfig* config) {
+    memset(config, 0, sizeof(*config));
+    config->machines = 1000;
+    config->open_minutes = 765;
+    config->games_per_minute = 12.0;
+    config->mean_idle_minutes = 20.0;
+    config->mean_play_games = 800.0;
+    config->stop_loss_medals = 1000;
+    config->quit_after_at_rate = 0.5;
+}
+
+bool Hall_Run(const HallConfig* config, HallMachineDay* days) {
+    if (config->machines <= 0 || config->open_minutes <= 0 || config->games_per_minute <= 0.0 ||
+        config->mean_idle_minutes <= 0.0 || config->setting_count < 0 ||
+        config->setting_count > HALL_MAX_SETTINGS) {
+        fprintf(stderr, "Hall: 設定が不正です\n");
+        return false;
+    }
+    for (int s = 0; s < config->setting_count; s++) {
+        if (config->settings[s].weight <= 0) {
+            fprintf(stderr, "Hall: 設定 %d の比率が 0 以下です\n", config->settings[s].number);
+            return false;
+        }
+    }
+
+    int* setting_of = (int*)malloc(sizeof(int) * (size_t)config->machines);
+    int* members = (int*)malloc(sizeof(int) * (size_t)config->machines);
+    if (!setting_of || !members) {
+        fprintf(stderr, "Hall: メモリ確保に失敗しました\n");
+        free(setting_of);
+        free(members);
+        return false;
+    }
+
+    const MachineSpec base = *Spec_Get();
+    int setting_count = config->setting_count > 0 ? config->setting_count : 1;
+    if (config->setting_count > 0) {
+        layout_settings(config, setting_count, setting_of);
+    } else {
+        memset(setting_of, 0, sizeof(int) * (size_t)config->machines);
+    }
+
+    // 設定ごとにテーブルを構築し、該当する台をまとめて打つ
+    bool ok = true;
+    for (int s = 0; ok && s < setting_count; s++) {
+        HallGroup group;
+        group.config = config;
+        group.members = members;
+        group.member_count = 0;
+        group.setting_number = config->setting_count > 0 ? config->settings[s].number : 1;
+        group.days = days;
+        for (int m = 0; m < config->machines; m++) {
+            if (setting_of[m] == s) members[group.member_count++] = m;
+        }
+        if (group.member_count == 0) continue;
+
+        if (config->setting_count > 0) {
+            Spec_Set(&config->settings[s].spec);
+            ok = Sim_InitTables();
+        }
+        int task_count = (group.member_count + HALL_MACHINES_PER_TASK - 1) / HALL_MACHINES_PER_TASK;
+        ok = ok && Parallel_Run(task_count, config->threads, hall_task, &group);
+    }
+
+    if (config->setting_count > 0) {
+        Spec_Set(&base);
+        ok = Sim_InitTables() && ok;
+    }
+    free(setting_of);
+    free(members);
+    return ok;
+}
+
+bool Hall_WriteColumns(const char* path, const HallMachineDay* days, int count) {
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        fprintf(stderr, "Hall: %s を書き込めません\n", path);
+        return false;
+    }
+
+    HallColumnsHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, HALL_COLUMNS_MAGIC, sizeof(header.magic));
+    header.version = HALL_COLUMNS_VERSION;
+    header.row_count = (uint32_t)count;
+    header.column_count = HALL_COLUMN_COUNT;
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (int c = 0; ok && c < HALL_COLUMN_COUNT; c++) {
+        HallColumnDesc desc;
+        memset(&desc, 0, sizeof(desc));
+        strncpy(desc.name, k_columns[c].name, sizeof(desc.name) - 1);
+        desc.size = k_columns[c].size;
+        ok = fwrite(&desc, sizeof(desc), 1, file) == 1;
+    }
+
+    // 列ごとに値を詰めて書く
+    unsigned char* buf = (unsigned char*)malloc(sizeof(long long) * (size_t)(count > 0 ? count : 1));
+    if (!buf) ok = false;
+    for (int c = 0; ok && c < HALL_COLUMN_COUNT; c++) {
+        uint32_t size = k_columns[c].size;
+        for (int r = 0; r < count; r++) {
+            memcpy(buf + (size_t)r * size, (const unsigned char*)&days[r] + k_columns[c].offset, size);
+        }
+        ok = fwrite(buf, size, (size_t)count, file) == (size_t)count;
+    }
+    free(buf);
+
+    if (fclose(file) != 0) ok = false;
+    if (!ok) fprintf(stderr, "Hall: %s の書き込みに失敗しました\n", path);
+    return ok;
+}
+
+void Hall_WriteCsv(FILE* out, const HallMachineDay* days, int count) {
+    for (int c = 0; c < HALL_COLUMN_COUNT; c++) {
+        fprintf(out, "%s%s", c > 0 ? "," : "", k_columns[c].name);
+    }
+    fprintf(out, "\n");
+    for (int r = 0; r < count; r++) {
+        const HallMachineDay* d = &days[r];
+        fprintf(out, "%d,%d,%d,%d,%lld,%d,%d,%d,%lld,%lld,%lld\n", d->machine, d->setting, d->players,
+                d->active_minutes, d->games, d->at_count, d->cz_count, d->bonus_count, d->payout,
+                d->max_payout, d->min_payout);
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef HALL_H
+#define HALL_H
+
+#include "sim.h"
+#include "spec.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+// =================================================================
+// ホール単位のシミュレーション (データカウンタの合成データ生成)
+// -----------------------------------------------------------------
+// 台ごとに独立した SimContext を持ち、開店から閉店まで客の着席・離席を
+// 繰り返しながら打つ。台の状態 (天井までのG数など) は客が替わっても引き継ぐ。
+// 台 m は Rng_SeedStream(seed, m) の乱数列だけを使い、台どうしで共有する
+// 可変の状態はない (共有するのは構築済みの抽選テーブルのみ)。
+// 設定 (スペック) は抽選テーブルがプロセス共通のため、設定ごとに
+// テーブルを構築し直して該当する台をまとめて並列に打つ。
+// 結果はスレッド数によらない。
+// =================================================================
+
+#define HALL_MAX_SETTINGS 8
+#define HALL_COLUMNS_MAGIC "HALLCOL1"
+#define HALL_COLUMNS_VERSION 1
+
+typedef struct {
+    int number;               // 設定番号 (出力用)
+    int weight;               // 台数の比率
+    MachineSpec spec;
+} HallSetting;
+
+typedef struct {
+    int machines;
+    HallSetting settings[HALL_MAX_SETTINGS];
+    int setting_count;        // 0 の場合は現在のスペックを設定 1 として全台に使う
+    int open_minutes;         // 営業時間 (分)
+    double games_per_minute;  // 1 分あたりの消化ゲーム数
+    double mean_idle_minutes; // 空き台に次の客が座るまでの平均 (分、指数分布)
+    double mean_play_games;   // 通常時に 1G ごとに 1/この値 の確率で離席
+    long long stop_loss_medals; // 客の差枚がこの枚数だけ負けたら通常時に離席 (0 で無効)
+    double quit_after_at_rate;  // AT終了時に離席する確率
+    unsigned long long seed;
+    int threads;              // 0 以下で既定値
+    SimOptions options;
+} HallConfig;
+
+// 台ごとの 1 日のデータ (データカウンタの項目)
+typedef struct {
+    int machine;
+    int setting;
+    int players;              // 着席した客の数
+    int active_minutes;       // 稼働時間 (分)
+    long long games;
+    int at_count;             // AT初当り
+    int cz_count;
+    int bonus_count;          // AT中のボーナス (BB / FB / BB EX / EP) 突入回数
+    long long payout;         // 差枚 (客側)
+    long long max_payout;     // 1 日の最大差枚
+    long long min_payout;     // 1 日の最小差枚
+} HallMachineDay;
+
+/**
+ * @brief 設定を既定値 (1000 台、10:00〜22:45、12 G/分) にします。
+ */
+void Hall_InitConfig(HallConfig* config);
+
+/**
+ * @brief ホールの 1 日をシミュレーションします。Sim_InitTables 済みであること。
+ * 終了時には実行前のスペックと抽選テーブルに戻します。
+ * @param days config->machines 個の書き出し先 (台番号順)
+ * @return 設定が不正・メモリ確保・スレッド作成に失敗した場合は false
+ */
+bool Hall_Run(const HallConfig* config, HallMachineDay* days);
+
+/**
+ * @brief 台ごとのデータを列指向のバイナリ形式で書き出します。
+ * 形式: ヘッダ (magic "HALLCOL1", version, 行数, 列数) → 列定義 (名前 16 バイト, 型) × 列数
+ *       → 列ごとに全行の値を連続して格納 (型 4: int32 / 8: int64、ホストのバイト順)
+ * @return ファイルを書き込めない場合は false
+ */
+bool Hall_WriteColumns(const char* path, const HallMachineDay* days, int count);
+
+/**
+ * @brief 台ごとのデータを CSV (見出し行付き) で出力します。
+ */
+void Hall_WriteCsv(FILE* out, const HallMachineDay* days, int count);
+
+#endif // HALL_H
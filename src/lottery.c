@@ -1,47 +1,24 @@
 #include "lottery.h"
+#include "rng.h"
+#include "weighted_table.h"
+#include "spec.h"
 #include <stdlib.h> 
 #include <stdio.h>
+#include <string.h>
 
-// 0〜65535 を偏りなく生成するための 8bit×2 合成
+// 0〜65535 の一様乱数 (32bit乱数の上位16bit)
 static inline unsigned rand_u16(void) {
-    unsigned hi = (unsigned)(rand() % 256); // 0..255
-    unsigned lo = (unsigned)(rand() % 256); // 0..255
-    return (hi << 8) | lo;                  // 0..65535
+    return Rng_NextU32() >> 16;             // 0..65535
 }
 
-// (★追加) 0〜999 (1000未満) の乱数を生成
-static inline int rand_1000(void) {
-    return rand() % 1000;
-}
 
 // --- 役情報 (払い出し) ---
-int GetPayoutForYaku(YakuType yaku, bool oshijun_success) {
-    switch (yaku) {
-        case YAKU_OSHIJUN_BELL_LMR:
-        case YAKU_OSHIJUN_BELL_LRM:
-        case YAKU_OSHIJUN_BELL_MLR:
-        case YAKU_OSHIJUN_BELL_MRL:
-        case YAKU_OSHIJUN_BELL_RLM:
-        case YAKU_OSHIJUN_BELL_RML:
-            return oshijun_success ? 10 : 0; 
-
-        case YAKU_REPLAY:         return 3;
-        case YAKU_COMMON_BELL:    return 1;
-        case YAKU_CHERRY:         return 3;
-        case YAKU_CHANCE_ME:      return 3;
-        case YAKU_FRANXX_ME:      return 3;
-        case YAKU_STRELITZIA_ME:  return 3;
-        
-        case YAKU_HP_REVERSE_FRANXX:      return 3;
-        case YAKU_HP_REVERSE_STRONG_FRANXX: return 3;
-        case YAKU_HP_REVERSE_STRELITZIA:  return 3;
-        
-        case YAKU_FRANXX_SYMBOL:  return 15;
+// [役][押し順成功] の払い出し枚数 (Lottery_InitTables でスペックから展開)
+static int g_payout_table[YAKU_COUNT][2];
 
-        case YAKU_HAZURE:
-        default:
-            return 0;
-    }
+int GetPayoutForYaku(YakuType yaku, bool oshijun_success) {
+    if ((unsigned)yaku >= YAKU_COUNT) return 0;
+    return g_payout_table[yaku][oshijun_success ? 1 : 0];
 }
 
 // --- 役情報 (名称) ---
@@ -68,6 +45,40 @@ const char* GetYakuName(YakuType yaku) {
     }
 }
 
+// --- 役情報 (識別名) ---
+const char* GetYakuKey(YakuType yaku) {
+    switch (yaku) {
+        case YAKU_OSHIJUN_BELL_LMR: return "OSHIJUN_BELL_LMR";
+        case YAKU_OSHIJUN_BELL_LRM: return "OSHIJUN_BELL_LRM";
+        case YAKU_OSHIJUN_BELL_MLR: return "OSHIJUN_BELL_MLR";
+        case YAKU_OSHIJUN_BELL_MRL: return "OSHIJUN_BELL_MRL";
+        case YAKU_OSHIJUN_BELL_RLM: return "OSHIJUN_BELL_RLM";
+        case YAKU_OSHIJUN_BELL_RML: return "OSHIJUN_BELL_RML";
+        case YAKU_REPLAY:           return "REPLAY";
+        case YAKU_COMMON_BELL:      return "COMMON_BELL";
+        case YAKU_CHERRY:           return "CHERRY";
+        case YAKU_CHANCE_ME:        return "CHANCE_ME";
+        case YAKU_FRANXX_ME:        return "FRANXX_ME";
+        case YAKU_STRELITZIA_ME:    return "STRELITZIA_ME";
+        case YAKU_HP_REVERSE_FRANXX:        return "HP_REVERSE_FRANXX";
+        case YAKU_HP_REVERSE_STRONG_FRANXX: return "HP_REVERSE_STRONG_FRANXX";
+        case YAKU_HP_REVERSE_STRELITZIA:    return "HP_REVERSE_STRELITZIA";
+        case YAKU_HAZURE:           return "HAZURE";
+        case YAKU_FRANXX_SYMBOL:    return "FRANXX_SYMBOL";
+        default:                    return "UNKNOWN";
+    }
+}
+
+bool FindYakuByKey(const char* key, YakuType* yaku) {
+    for (int y = 0; y < YAKU_COUNT; y++) {
+        if (strcmp(key, GetYakuKey((YakuType)y)) == 0) {
+            *yaku = (YakuType)y;
+            return true;
+        }
+    }
+    return false;
+}
+
 // --- 役情報 (レア役判定) ---
 bool IsRareYaku(YakuType yaku) {
     switch (yaku) {
@@ -97,76 +108,32 @@ bool CheckOshijun(YakuType yaku, int push_order[3]) {
     }
 }
 
-// --- 公開抽選関数 (通常時) ---
-YakuType Lottery_GetResult_Normal() {
-    int r = (int)rand_u16(); 
-    int cumulative_prob = 0;
+// =================================================================
+// 小役抽選テーブル (分母 65536、値はスペックの [Lottery.*])
+// =================================================================
+static WeightedTable g_lottery_tables[LOTTERY_TABLE_COUNT];
+
+YakuType Lottery_LookupTable(LotteryTableId table, int r) {
+    return (YakuType)WeightedTable_Lookup(&g_lottery_tables[table], (uint64_t)r);
+}
 
-    cumulative_prob += 5545; // YAKU_OSHIJUN_BELL_LMR
-    if (r < cumulative_prob) return YAKU_OSHIJUN_BELL_LMR;
-    cumulative_prob += 5545; // YAKU_OSHIJUN_BELL_LRM
-    if (r < cumulative_prob) return YAKU_OSHIJUN_BELL_LRM;
-    cumulative_prob += 9449; // YAKU_OSHIJUN_BELL_MLR
-    if (r < cumulative_prob) return YAKU_OSHIJUN_BELL_MLR;
-    cumulative_prob += 9449; // YAKU_OSHIJUN_BELL_MRL
-    if (r < cumulative_prob) return YAKU_OSHIJUN_BELL_MRL;
-    cumulative_prob += 9449; // YAKU_OSHIJUN_BELL_RLM
-    if (r < cumulative_prob) return YAKU_OSHIJUN_BELL_RLM;
-    cumulative_prob += 9449; // YAKU_OSHIJUN_BELL_RML
-    if (r < cumulative_prob) return YAKU_OSHIJUN_BELL_RML;
-    cumulative_prob += 8402; // YAKU_REPLAY
-    if (r < cumulative_prob) return YAKU_REPLAY;
-    cumulative_prob += 4615; // YAKU_COMMON_BELL
-    if (r < cumulative_prob) return YAKU_COMMON_BELL;
-    cumulative_prob += 1280; // YAKU_CHERRY
-    if (r < cumulative_prob) return YAKU_CHERRY;
-    cumulative_prob += 200; // YAKU_CHANCE_ME
-    if (r < cumulative_prob) return YAKU_CHANCE_ME;
-    cumulative_prob += 368; // YAKU_FRANXX_ME
-    if (r < cumulative_prob) return YAKU_FRANXX_ME;
-    cumulative_prob += 28; // YAKU_STRELITZIA_ME
-    if (r < cumulative_prob) return YAKU_STRELITZIA_ME;
+int Lottery_GetWeight(LotteryTableId table, YakuType yaku) {
+    const WeightedTable* t = &g_lottery_tables[table];
+    int weight = 0;
+    for (int i = 0; i < t->count; i++) {
+        if (t->entries[i].value == (int)yaku) weight += (int)t->entries[i].weight;
+    }
+    return weight;
+}
 
-    return YAKU_HAZURE;
+// --- 公開抽選関数 (通常時) ---
+YakuType Lottery_GetResult_Normal() {
+    return Lottery_LookupTable(LOTTERY_TABLE_NORMAL, (int)rand_u16());
 }
 
 // --- 公開抽選関数 (フランクス高確率) ---
 YakuType Lottery_GetResult_FranxxHighProb() {
-    int r = (int)rand_u16(); 
-    int cumulative_prob = 0;
-
-    cumulative_prob += 4965; // YAKU_HP_REVERSE_FRANXX
-    if (r < cumulative_prob) return YAKU_HP_REVERSE_FRANXX;
-    cumulative_prob += 8; // YAKU_HP_REVERSE_STRONG_FRANXX
-    if (r < cumulative_prob) return YAKU_HP_REVERSE_STRONG_FRANXX;
-    cumulative_prob += 8; // YAKU_HP_REVERSE_STRELITZIA
-    if (r < cumulative_prob) return YAKU_HP_REVERSE_STRELITZIA;
-    cumulative_prob += 3421; // YAKU_REPLAY
-    if (r < cumulative_prob) return YAKU_REPLAY;
-    cumulative_prob += 5545; // YAKU_OSHIJUN_BELL_LMR
-    if (r < cumulative_prob) return YAKU_OSHIJUN_BELL_LMR;
-    cumulative_prob += 5545; // YAKU_OSHIJUN_BELL_LRM
-    if (r < cumulative_prob) return YAKU_OSHIJUN_BELL_LRM;
-    cumulative_prob += 9449; // YAKU_OSHIJUN_BELL_MLR
-    if (r < cumulative_prob) return YAKU_OSHIJUN_BELL_MLR;
-    cumulative_prob += 9449; // YAKU_OSHIJUN_BELL_MRL
-    if (r < cumulative_prob) return YAKU_OSHIJUN_BELL_MRL;
-    cumulative_prob += 9449; // YAKU_OSHIJUN_BELL_RLM
-    if (r < cumulative_prob) return YAKU_OSHIJUN_BELL_RLM;
-    cumulative_prob += 9449; // YAKU_OSHIJUN_BELL_RML
-    if (r < cumulative_prob) return YAKU_OSHIJUN_BELL_RML;
-    cumulative_prob += 4615; // YAKU_COMMON_BELL
-    if (r < cumulative_prob) return YAKU_COMMON_BELL;
-    cumulative_prob += 1280; // YAKU_CHERRY
-    if (r < cumulative_prob) return YAKU_CHERRY;
-    cumulative_prob += 200; // YAKU_CHANCE_ME
-    if (r < cumulative_prob) return YAKU_CHANCE_ME;
-    cumulative_prob += 368; // YAKU_FRANXX_ME
-    if (r < cumulative_prob) return YAKU_FRANXX_ME;
-    cumulative_prob += 28; // YAKU_STRELITZIA_ME
-    if (r < cumulative_prob) return YAKU_STRELITZIA_ME;
-
-    return YAKU_HAZURE;
+    return Lottery_LookupTable(LOTTERY_TABLE_FRANXX_HIGH_PROB, (int)rand_u16());
 }
 
 
@@ -182,79 +149,82 @@ YakuType Lottery_GetResult_AT(void) {
     return Lottery_GetResult_Normal();
 }
 
-/**
- * @brief 【AT高確率状態】のボーナス当否・種別抽選 (完全実装版)
- */
-AT_BonusResultType Lottery_CheckBonus_AT(YakuType yaku) {
-    // 1. 当否判定 (当選率)
-    int r_success = rand_1000();
-    bool is_success = false;
+// =================================================================
+// (★) AT高確率状態 ボーナス当否・種別抽選
+// -----------------------------------------------------------------
+// 当否 (千分率) × 種別振り分け (千分率) を、役ごとの同時分布
+// (分母 1000×1000) にまとめて 1 回の抽選で引く。
+//
+//  FB: フランクスボーナス / DB: ダーリンボーナス
+//  EX: BB EX           / EP: エピソードボーナス
+// =================================================================
+#define BONUS_RATE_DENOMINATOR 1000
+#define BONUS_JOINT_DENOMINATOR (BONUS_RATE_DENOMINATOR * BONUS_RATE_DENOMINATOR)
 
-    switch (yaku) {
-        case YAKU_REPLAY:       is_success = (r_success < 318); break; // 31.8%
-        case YAKU_COMMON_BELL:  is_success = (r_success < 379); break; // 37.9%
-        case YAKU_HAZURE:       is_success = false; break;
-        default:
-            // レア役・確定役は 100% 当選
-            if (IsRareYaku(yaku)) is_success = true;
-            break;
+static WeightedTable g_bonus_joint[YAKU_COUNT];
+
+static const char* k_lottery_table_names[LOTTERY_TABLE_COUNT] = {
+    "小役/通常時", "小役/フランクス高確率"
+};
+
+bool Lottery_InitTables(void) {
+    const MachineSpec* spec = Spec_Get();
+    bool ok = true;
+
+    for (int y = 0; y < YAKU_COUNT; y++) {
+        g_payout_table[y][0] = spec->payout_oshijun_fail[y];
+        g_payout_table[y][1] = spec->payout[y];
     }
 
-    if (!is_success) {
-        // 抽選対象役 (リプ/ベル) なら演出用継続、それ以外はハズレ
-        if (yaku == YAKU_REPLAY || yaku == YAKU_COMMON_BELL) {
-            return BONUS_AT_CONTINUE;
+    for (int t = 0; t < LOTTERY_TABLE_COUNT; t++) {
+        WeightedEntry entries[YAKU_COUNT];
+        int count = 0;
+        for (int y = 0; y < YAKU_COUNT; y++) {
+            if (spec->lottery_weight[t][y] <= 0) continue;
+            entries[count].value = y;
+            entries[count].weight = (uint64_t)spec->lottery_weight[t][y];
+            count++;
         }
-        return BONUS_NONE;
+        WeightedTable_Free(&g_lottery_tables[t]);
+        ok &= WeightedTable_Init(&g_lottery_tables[t], k_lottery_table_names[t], entries, count, LOTTERY_DENOMINATOR);
     }
 
-    // 2. 種別振り分け (0.1%単位、0-999)
-    int r_type = rand_1000(); 
-
-    /*
-     * FB: フランクスボーナス
-     * DB: ダーリンボーナス
-     * EX: BB EX
-     * EP: エピソードボーナス
-     */
+    for (int y = 0; y < YAKU_COUNT; y++) {
+        YakuType yaku = (YakuType)y;
+        SpecBonusRate rate = spec->bonus_at[y];
+        int typed = rate.fb + rate.db + rate.ex + rate.ep;
+        if (typed > BONUS_RATE_DENOMINATOR) {
+            fprintf(stderr, "Lottery: %s の種別振り分けが 1000 を超えています\n", GetYakuName(yaku));
+            ok = false;
+            continue;
+        }
 
-    switch (yaku) {
-        case YAKU_REPLAY: 
-        case YAKU_COMMON_BELL: 
-            // FB 37%, DB 50%, EX 13%, EP 0%
-            if (r_type < 370) return BONUS_FRANXX;      // 0-369
-            if (r_type < 870) return BONUS_DARLING;     // 370-869 (370+500)
-            return BONUS_BB_EX;                         // 870-999 (残り130)
-        
-        case YAKU_CHANCE_ME: 
-            // FB 0%, DB 80%, EX 19%, EP 1%
-            if (r_type < 800) return BONUS_DARLING;     // 0-799
-            if (r_type < 990) return BONUS_BB_EX;       // 800-989 (800+190)
-            return BONUS_EPISODE;                       // 990-999 (残り10)
-        
-        case YAKU_CHERRY: 
-            // FB 50%, DB 40%, EX 9%, EP 1%
-            if (r_type < 500) return BONUS_FRANXX;      // 0-499
-            if (r_type < 900) return BONUS_DARLING;     // 500-899 (500+400)
-            if (r_type < 990) return BONUS_BB_EX;       // 900-989 (900+90)
-            return BONUS_EPISODE;                       // 990-999 (残り10)
-        
-        case YAKU_FRANXX_ME: 
-            // FB 25%, DB 37.5%, EX 36.5%, EP 1%
-            // (37.5% -> 375, 36.5% -> 365)
-            if (r_type < 250) return BONUS_FRANXX;      // 0-249
-            if (r_type < 625) return BONUS_DARLING;     // 250-624 (250+375)
-            if (r_type < 990) return BONUS_BB_EX;       // 625-989 (625+365)
-            return BONUS_EPISODE;                       // 990-999 (残り10)
+        // 落選: 抽選対象役 (当選率が 0 より大きい役) なら演出用継続、それ以外はハズレ
+        bool is_target = (rate.success > 0);
+        WeightedEntry joint[] = {
+            { BONUS_FRANXX,  (uint64_t)rate.success * rate.fb },
+            { BONUS_DARLING, (uint64_t)rate.success * rate.db },
+            { BONUS_BB_EX,   (uint64_t)rate.success * rate.ex },
+            { BONUS_EPISODE, (uint64_t)rate.success * rate.ep },
+            // 当選したが振り分けのない役は継続扱い
+            { BONUS_AT_CONTINUE, (uint64_t)rate.success * (BONUS_RATE_DENOMINATOR - typed) },
+            { is_target ? BONUS_AT_CONTINUE : BONUS_NONE,
+              (uint64_t)(BONUS_RATE_DENOMINATOR - rate.success) * BONUS_RATE_DENOMINATOR },
+        };
+
+        char name[WEIGHTED_NAME_LEN];
+        snprintf(name, sizeof(name), "AT高確ボーナス/%s", GetYakuName(yaku));
+        WeightedTable_Free(&g_bonus_joint[y]);
+        ok &= WeightedTable_Init(&g_bonus_joint[y], name, joint, (int)(sizeof(joint) / sizeof(joint[0])),
+                                 BONUS_JOINT_DENOMINATOR);
+    }
+    return ok;
+}
 
-        case YAKU_STRELITZIA_ME: 
-        case YAKU_HP_REVERSE_STRONG_FRANXX:
-        case YAKU_HP_REVERSE_STRELITZIA:
-            // FB 0%, DB 0%, EX 95%, EP 5%
-            if (r_type < 950) return BONUS_BB_EX;       // 0-949
-            return BONUS_EPISODE;                       // 950-999
+AT_BonusResultType Lottery_CheckBonus_AT(YakuType yaku) {
+    return (AT_BonusResultType)WeightedTable_Sample(&g_bonus_joint[yaku]);
+}
 
-        default:
-            return BONUS_AT_CONTINUE; 
-    }
-}
\ No newline at end of file
+double Lottery_GetBonusProbability_AT(YakuType yaku, AT_BonusResultType result) {
+    return WeightedTable_GetProbability(&g_bonus_joint[yaku], (int)result);
+}
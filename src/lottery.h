@@ -4,6 +4,23 @@
 #include "common.h" 
 #include "game_data.h" // (★追加) AT_BonusResultType のため
 
+// 小役抽選の分母 (16bit乱数)
+#define LOTTERY_DENOMINATOR 65536
+
+// --- 小役抽選テーブルの種類 ---
+typedef enum {
+    LOTTERY_TABLE_NORMAL,           // 通常時 (AT中のボーナス/高確率も流用)
+    LOTTERY_TABLE_FRANXX_HIGH_PROB, // フランクス高確率 (CZ / フランクスボーナス)
+    LOTTERY_TABLE_COUNT
+} LotteryTableId;
+
+/**
+ * @brief 現在のスペック (Spec_Get) から抽選テーブル (ボーナス当否の同時分布など) を構築・検証します。
+ * 抽選を行う前に呼び出してください (スペックを変更した場合は再度呼び出す)。
+ * @return テーブルの重みが分母と一致しないなど、不正な定義があれば false
+ */
+bool Lottery_InitTables(void);
+
 /**
  * @brief 【通常時】の確率テーブルに基づいて小役を抽選します。
  * @return 当選した YakuType
@@ -16,6 +33,20 @@ YakuType Lottery_GetResult_Normal();
  */
 YakuType Lottery_GetResult_FranxxHighProb();
 
+/**
+ * @brief 抽選値から成立役を引きます (乱数は消費しません)。
+ * @param table 使用するテーブル
+ * @param r 抽選値 (0 〜 LOTTERY_DENOMINATOR-1)
+ * @return 成立役
+ */
+YakuType Lottery_LookupTable(LotteryTableId table, int r);
+
+/**
+ * @brief テーブル上の役の当選数 (分母 LOTTERY_DENOMINATOR) を取得します。
+ * ハズレはテーブルの残り全体を返します。
+ */
+int Lottery_GetWeight(LotteryTableId table, YakuType yaku);
+
 /**
  * @brief (★新規) 【AT高確率状態】の確率テーブルに基づいて小役を抽選します。
  * (現在は通常時と同じテーブルを流用します)
@@ -25,11 +56,18 @@ YakuType Lottery_GetResult_AT(void);
 
 /**
  * @brief (★新規) 【AT高確率状態】で、成立役に基づきボーナス当否を抽選します。
+ * (当否と種別振り分けの同時分布から 1 回の抽選で決定)
  * @param yaku 成立役
  * @return 抽選結果 (AT_BonusResultType)
  */
 AT_BonusResultType Lottery_CheckBonus_AT(YakuType yaku);
 
+/**
+ * @brief 【AT高確率状態】のボーナス抽選で、成立役 yaku のときに result となる確率を取得します。
+ * (Lottery_CheckBonus_AT が引く同時分布の値。乱数は消費しません)
+ */
+double Lottery_GetBonusProbability_AT(YakuType yaku, AT_BonusResultType result);
+
 
 /**
  * @brief 役の日本語名を取得します。
@@ -37,7 +75,18 @@ AT_BonusResultType Lottery_CheckBonus_AT(YakuType yaku);
 const char* GetYakuName(YakuType yaku);
 
 /**
- * @brief 役の払い出し枚数を取得します。
+ * @brief 役の識別名 (列挙名から YAKU_ を除いたもの。spec ファイル等で使用) を取得します。
+ */
+const char* GetYakuKey(YakuType yaku);
+
+/**
+ * @brief 識別名から役を引きます。
+ * @return 該当する役がなければ false
+ */
+bool FindYakuByKey(const char* key, YakuType* yaku);
+
+/**
+ * @brief 役の払い出し枚数を取得します (現在のスペックの値)。
  */
 int GetPayoutForYaku(YakuType yaku, bool oshijun_success);
 
@@ -4,6 +4,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <SDL2/SDL.h>
 
@@ -11,27 +12,69 @@
 #include "director.h"
 #include "reel.h"
 #include "presentation.h"
+#include "lottery.h"
+#include "at.h"
+#include "normal.h"
+#include "spec.h"
+#include "thread_config.h"
+#include "yaku_script.h"
 
 #define SCREEN_WIDTH 838
 #define SCREEN_HEIGHT 600
 #define FONT_PATH "font.ttf" 
 #define FONT_SIZE 24         
 #define CONFIG_PATH "media.cfg" 
+#define SPEC_PATH "spec.cfg"
 
 int SDL_main(int argc, char* args[]) {
+    // 起動オプション: --seed <シード> [--warp <ゲーム数>] (sim seek の出力から再現する)
+    //                 --script <成立役スクリプト> (yaku_script.h)
+    uint64_t seed = (uint64_t)time(NULL);
+    bool seed_given = false;
+    long long warp_games = 0;
+    const char* script_path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(args[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(args[++i], NULL, 10);
+            seed_given = true;
+        } else if (strcmp(args[i], "--warp") == 0 && i + 1 < argc) {
+            warp_games = atoll(args[++i]);
+        } else if (strcmp(args[i], "--script") == 0 && i + 1 < argc) {
+            script_path = args[++i];
+        }
+    }
+
     // 1. システム初期化
     if (!init_sdl("Slot Simulator", SCREEN_WIDTH, SCREEN_HEIGHT) ||
         !load_media(FONT_PATH, FONT_SIZE)) { 
         close_sdl();
         return -1;
     }
-    srand((unsigned int)time(NULL));
+
+    MachineSpec spec;
+    if (!Spec_LoadCached(SPEC_PATH, NULL, &spec)) {
+        fprintf(stderr, "spec.cfg の読み込みに失敗しました。\n");
+        close_sdl();
+        return -1;
+    }
+    Spec_Set(&spec);
+    if (!Lottery_InitTables() || !AT_InitTables() || !Normal_InitTables()) {
+        fprintf(stderr, "抽選テーブルの構築に失敗しました。\n");
+        close_sdl();
+        return -1;
+    }
     
     if (!MediaConfig_Load(CONFIG_PATH)) {
         fprintf(stderr, "media.cfg の読み込みに失敗しました。\n");
         close_sdl();
         return -1;
     }
+    // デコード・推定ワーカーのスレッドを起動する前に CPU 割り当てを決める ([Threads])
+    if (!ThreadConfig_Load(CONFIG_PATH)) {
+        fprintf(stderr, "media.cfg の [Threads] が不正です。\n");
+        close_sdl();
+        return -1;
+    }
 
     // 2. サブシステム初期化
     // (Reel, PresentationはDirector内部でも使うが、初期化順序の依存のためここで呼ぶ)
@@ -52,6 +95,20 @@ int SDL_main(int argc, char* args[]) {
         close_sdl();
         return -1;
     }
+    Director_SetSeed(seed);
+    if (warp_games > 0 && !Director_Warp(warp_games)) {
+        fprintf(stderr, "Director Warp Failed\n");
+        close_sdl();
+        return -1;
+    }
+    if (seed_given || warp_games > 0) {
+        // 再現起動のときだけ、どのシード・位置から始めたかを表示する
+        printf("seed: %llu (warp %lld G)\n", (unsigned long long)seed, warp_games);
+    }
+    if (script_path && !YakuScript_Load(script_path)) {
+        close_sdl();
+        return -1;
+    }
 
     // 4. メインループ
     bool quit = false;
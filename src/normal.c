@@ -1,22 +1,82 @@
 #include "normal.h"
+#include "game_event.h"
 #include "lottery.h"
 #include "at.h" // AT_Init() のため
+#include "cz.h"
+#include "spec.h"
+#include "weighted_table.h"
 #include <stdio.h>
 #include <stdlib.h> 
+#include <string.h>
+
+// =================================================================
+// 通常時の役別抽選
+// -----------------------------------------------------------------
+// AT直撃 → (外れた場合) CZ当選 の連鎖抽選を、役ごとの同時分布
+// {なし, CZ, AT} にまとめて 1 回で引く (分母 千分率×千分率)。
+// =================================================================
+
+#define NORMAL_JOINT_DENOMINATOR ((uint64_t)SPEC_RATE_DENOMINATOR * SPEC_RATE_DENOMINATOR)
+
+static WeightedTable g_normal_tables[YAKU_COUNT];
+static bool g_normal_active[YAKU_COUNT]; // 抽選のある役か
+
+// --- 公開関数 ---
+
+bool Normal_InitTables(void) {
+    const MachineSpec* spec = Spec_Get();
+    const uint64_t D = SPEC_RATE_DENOMINATOR;
+    bool ok = true;
+
+    for (int y = 0; y < YAKU_COUNT; y++) {
+        WeightedTable_Free(&g_normal_tables[y]);
+        g_normal_active[y] = spec->normal_at[y] > 0 || spec->normal_cz[y] > 0;
+        if (!g_normal_active[y]) continue;
+
+        uint64_t at = (uint64_t)spec->normal_at[y];
+        uint64_t cz = (uint64_t)spec->normal_cz[y];
+        WeightedEntry entries[] = {
+            { NORMAL_RESULT_NONE, (D - at) * (D - cz) },
+            { NORMAL_RESULT_CZ,   (D - at) * cz },
+            { NORMAL_RESULT_AT,   at * D },
+        };
+        char name[WEIGHTED_NAME_LEN];
+        snprintf(name, sizeof(name), "通常時/%s", GetYakuName((YakuType)y));
+        ok &= WeightedTable_Init(&g_normal_tables[y], name, entries, 3, NORMAL_JOINT_DENOMINATOR);
+    }
+    return ok & CZ_InitTables();
+}
+
+void Normal_Init(GameData* data) {
+    long long total_payout_diff = data->total_payout_diff;
+    memset(data, 0, sizeof(*data));
+    data->total_payout_diff = total_payout_diff;
+    data->current_state = STATE_NORMAL;
+}
 
 /**
  * @brief 通常時のゲームロジックを更新
  */
 void Normal_Update(GameData* data, YakuType yaku) {
-    // (現在はATから開始するため、この関数は呼ばれない)
-    // (将来的に実装する)
-    
-    // (仮: レア役でAT突入テスト)
-    if (IsRareYaku(yaku)) {
-        if (yaku == YAKU_STRELITZIA_ME) {
-             snprintf(data->info_message, sizeof(data->info_message), "ストレリチア目！ AT当選！");
-             AT_Init(data); // ATモジュールを初期化
-             return;
-        }
+    const MachineSpec* spec = Spec_Get();
+    data->normal_games++;
+
+    if (data->normal_games >= spec->normal_ceiling) {
+        GameEvent_Record(data, GAME_EVENT_CEILING_AT, yaku, 0);
+        AT_Init(data);
+        return;
+    }
+    if (!g_normal_active[yaku]) return;
+
+    switch ((NormalResult)WeightedTable_Sample(&g_normal_tables[yaku])) {
+        case NORMAL_RESULT_AT:
+            GameEvent_Record(data, GAME_EVENT_NORMAL_AT_WIN, yaku, 0);
+            AT_Init(data);
+            break;
+        case NORMAL_RESULT_CZ:
+            CZ_Init(data);
+            break;
+        default:
+            break;
     }
-}
\ No newline at end of file
+}
@@ -3,10 +3,31 @@
 
 #include "game_data.h" 
 
+#define NORMAL_CEILING_GAMES 1000 // 天井 (既定スペックの値。実際の値は MachineSpec)
+
+// 役別抽選テーブル (通常時/<役名>) の値
+typedef enum {
+    NORMAL_RESULT_NONE,
+    NORMAL_RESULT_CZ,
+    NORMAL_RESULT_AT
+} NormalResult;
+
+/**
+ * @brief 現在のスペックから役別の通常時抽選テーブル (CZ当選 / AT直撃) を構築します。
+ * @return 不正な定義があれば false
+ */
+bool Normal_InitTables(void);
+
+/**
+ * @brief 通常時の初期状態にします (AT終了後の復帰にも使う)。
+ * 差枚は引き継ぎ、天井カウンタと AT/CZ の状態をリセットします。
+ */
+void Normal_Init(GameData* data);
+
 /**
  * @brief 通常時のゲームロジックを更新します。
- * (レア役でのAT/CZ抽選など)
+ * (天井・レア役での CZ / AT直撃抽選)
  */
 void Normal_Update(GameData* data, YakuType yaku);
 
-#endif // NORMAL_H
\ No newline at end of file
+#endif // NORMAL_H
@@ -0,0 +1,438 @@
+#include "pace.h"
+#include "parallel.h"
+#include "pres_table.h"
+#include "rng.h"
+#include "sim_eval.h"
+#include <ctype.h>
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PACE_MAX_LINE 1024
+#define PACE_MAX_ENTRIES 512
+#define PACE_MAX_PATH 1024
+#define PACE_MAX_BOX_DEPTH 4
+
+typedef struct {
+    char key[64];
+    char value[PACE_MAX_PATH];
+} PaceEntry;
+
+typedef struct {
+    const PaceConfig* config;
+    const PaceModel* model;
+    PaceTotals* days;
+    double pair_intro_ms[2];          // [当選]
+    double judge_ms[BONUS_EPISODE + 1];
+} PaceJob;
+
+static const char* k_time_names[PACE_TIME_COUNT] = {
+    "操作 (ベット・レバー・停止)", "ウェイト", "遷移演出", "AT高確率の演出ペア", "当落演出", "BB EX の枚数告知",
+};
+
+static const struct {
+    const char* key;
+    size_t offset;
+} k_timing_keys[] = {
+    { "GAME_WAIT_MS", offsetof(PaceTiming, game_wait_ms) },
+    { "BET_LEVER_MS", offsetof(PaceTiming, bet_lever_ms) },
+    { "FIRST_STOP_MS", offsetof(PaceTiming, first_stop_ms) },
+    { "STOP_INTERVAL_MS", offsetof(PaceTiming, stop_interval_ms) },
+    { "LEVER_WAIT_MS", offsetof(PaceTiming, lever_wait_ms) },
+};
+
+// --- 内部ヘルパー関数 ---
+
+static char* trim(char* s) {
+    while (isspace((unsigned char)*s)) s++;
+    char* end = s + strlen(s);
+    while (end > s && isspace((unsigned char)end[-1])) end--;
+    *end = '\0';
+    return s;
+}
+
+static uint64_t read_be(const unsigned char* p, int bytes) {
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; i++) v = (v << 8) | p[i];
+    return v;
+}
+
+// [begin, end) の範囲のボックスから type を探し、中身の位置と大きさを返す
+static bool find_box(FILE* file, long long begin, long long end, const char* type,
+                     long long* body, long long* body_size) {
+    long long pos = begin;
+    while (pos + 8 <= end) {
+        unsigned char header[16];
+        if (fseek(file, (long)pos, SEEK_SET) != 0 || fread(header, 8, 1, file) != 1) return false;
+        long long size = (long long)read_be(header, 4);
+        long long header_size = 8;
+        if (size == 1) {
+            if (fread(header + 8, 8, 1, file) != 1) return false;
+            size = (long long)read_be(header + 8, 8);
+            header_size = 16;
+        } else if (size == 0) {
+            size = end - pos; // ファイルの終わりまで
+        }
+        if (size < header_size || pos + size > end) return false;
+        if (memcmp(header + 4, type, 4) == 0) {
+            *body = pos + header_size;
+            *body_size = size - header_size;
+            return true;
+        }
+        pos += size;
+    }
+    return false;
+}
+
+// MP4 (ISO BMFF) の moov/mvhd から長さを読む
+static bool read_mp4_duration(const char* path, double* ms) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+    bool ok = false;
+    long long file_size = 0;
+    if (fseek(file, 0, SEEK_END) == 0) file_size = ftell(file);
+
+    long long moov, moov_size, mvhd, mvhd_size;
+    unsigned char buf[32];
+    if (file_size > 0 &&
+        find_box(file, 0, file_size, "moov", &moov, &moov_size) &&
+        find_box(file, moov, moov + moov_size, "mvhd", &mvhd, &mvhd_size) &&
+        mvhd_size >= 20 && fseek(file, (long)mvhd, SEEK_SET) == 0 && fread(buf, 1, 1, file) == 1) {
+        // version 0: 作成・更新時刻 4 バイト、長さ 4 バイト / version 1: 8 バイト
+        int version = buf[0];
+        int skip = (version == 1) ? 3 + 16 : 3 + 8;
+        int duration_bytes = (version == 1) ? 8 : 4;
+        if (mvhd_size >= 1 + skip + 4 + duration_bytes && fseek(file, (long)(mvhd + 1 + skip), SEEK_SET) == 0 &&
+            fread(buf, (size_t)(4 + duration_bytes), 1, file) == 1) {
+            uint64_t timescale = read_be(buf, 4);
+            uint64_t duration = read_be(buf + 4, duration_bytes);
+            if (timescale > 0) {
+                *ms = 1000.0 * (double)duration / (double)timescale;
+                ok = true;
+            }
+        }
+    }
+    fclose(file);
+    return ok;
+}
+
+static const char* find_entry(const PaceEntry* entries, int count, const char* key) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(entries[i].key, key) == 0) return entries[i].value;
+    }
+    return NULL;
+}
+
+// キーの動画の長さ。定義のないキーは 0 (再生されない)
+static double media_duration(PaceModel* model, const PaceEntry* entries, int count, const char* dir,
+                             const char* key, bool* defined) {
+    *defined = false;
+    const char* value = key ? find_entry(entries, count, key) : NULL;
+    if (!value) return 0.0;
+
+    char path[PACE_MAX_PATH * 2];
+    bool absolute = value[0] == '/' || value[0] == '\\' || (value[0] && value[1] == ':');
+    snprintf(path, sizeof(path), "%s%s", absolute ? "" : dir, value);
+    double ms;
+    if (!read_mp4_duration(path, &ms)) {
+        // 動画を置いていない環境では大半が読めないため、最初の 1 本だけ表示する
+        if (model->missing_count == 0) {
+            fprintf(stderr, "Pace: %s の長さを読めません (%s、0 秒として扱います)\n", key, path);
+        }
+        model->missing_count++;
+        return 0.0;
+    }
+    *defined = true;
+    model->media_count++;
+    return ms;
+}
+
+// レバーONで区切った時間の流れ。状態の実時間はレバーONから次のレバーONまでをそのゲームに数える
+typedef struct {
+    double now;          // レバーを押せるようになった時刻
+    double last_lever;   // 直前のレバーON
+    AT_State owner;      // 直前のレバーONの状態
+} PaceClock;
+
+// 操作 lever_ms の後、ウェイトが明けていればレバーON
+static void press_lever(PaceTotals* totals, const PaceTiming* t, PaceClock* clock, double lever_ms, AT_State state) {
+    double ready = clock->now + lever_ms;
+    double lever = (ready > clock->last_lever + t->game_wait_ms) ? ready : clock->last_lever + t->game_wait_ms;
+    totals->ms[PACE_TIME_PLAY] += lever_ms;
+    totals->ms[PACE_TIME_WAIT] += lever - ready;
+    totals->state_ms[clock->owner] += lever - (clock->last_lever > 0 ? clock->last_lever : 0.0);
+    clock->owner = state;
+    clock->last_lever = lever;
+    clock->now = lever;
+}
+
+// n ゲーム (演出なし) を進める。pre_ms は 1 ゲーム目の停止前の演出
+static void play_games(PaceTotals* totals, const PaceTiming* t, PaceClock* clock, int n, double lever_ms,
+                       double pre_ms, AT_State state) {
+    double stops = t->first_stop_ms + 2.0 * t->stop_interval_ms;
+    for (int i = 0; i < n; i++) {
+        press_lever(totals, t, clock, lever_ms, state);
+        totals->ms[PACE_TIME_PLAY] += stops;
+        totals->ms[PACE_TIME_TRANSITION] += pre_ms;
+        clock->now += pre_ms + stops;
+        lever_ms = t->bet_lever_ms; // 2 ゲーム目以降 (一括消化した分) は通常のゲーム
+        pre_ms = 0.0;
+    }
+}
+
+static void pace_task(int task_index, void* user) {
+    PaceJob* job = (PaceJob*)user;
+    const PaceModel* m = job->model;
+    const PaceTiming* t = &m->timing;
+    PaceTotals* totals = &job->days[task_index];
+    memset(totals, 0, sizeof(*totals));
+
+    Rng_SeedStream(job->config->seed, (uint64_t)task_index);
+    SimContext ctx;
+    Sim_Init(&ctx, &job->config->options);
+
+    AT_State media = STATE_NORMAL;       // 再生中のループ動画の状態 (Director の g_current_media_state)
+    PaceClock clock = { 0.0, -t->game_wait_ms, STATE_NORMAL };
+    bool auto_start = false;             // 落選の当落演出の後は次ゲームが自動で始まる
+
+    while (ctx.games < job->config->games_per_day) {
+        // AT終了後はレバーONで通常時へ戻る
+        AT_State logic = (ctx.data.current_state == STATE_AT_END) ? STATE_NORMAL : ctx.data.current_state;
+        double pre = 0.0;
+
+        // 状態が変わっていれば遷移演出 (レバーONから再生し、終わるまで停止できない)
+        if (logic != media) {
+            pre = m->transition_ms[media][logic];
+            if (m->has_transition[media][logic]) totals->transitions++;
+            if (logic == STATE_BB_EX && m->has_transition[media][logic]) {
+                // 遷移演出のレバーは枚数告知に使われ、最初のゲームは告知後のレバーから
+                int reveals;
+                double reveal = Pace_GetBBExRevealMs(m, ctx.data.target_bonus_payout, &reveals);
+                press_lever(totals, t, &clock, t->bet_lever_ms, logic);
+                totals->ms[PACE_TIME_TRANSITION] += pre;
+                totals->ms[PACE_TIME_BB_EX] += reveal;
+                totals->bb_ex_reveals += reveals;
+                clock.now += pre + reveal;
+                pre = 0.0;
+            }
+            media = logic;
+        }
+
+        int games = Sim_Step(&ctx);
+        play_games(totals, t, &clock, games, auto_start ? 0.0 : t->bet_lever_ms, pre, logic);
+        totals->state_games[logic] += games;
+        auto_start = false;
+
+        // AT高確率のボーナス抽選 (停止後に演出ペア → 当落演出)
+        AT_BonusResultType r = ctx.data.at_bonus_result;
+        if (logic == STATE_BONUS_HIGH_PROB && r != BONUS_NONE) {
+            bool win = r != BONUS_AT_CONTINUE;
+            double pres = job->pair_intro_ms[win] + t->lever_wait_ms;
+            double judge = job->judge_ms[r] + (win ? t->lever_wait_ms : 0.0);
+            totals->ms[PACE_TIME_AT_PRES] += pres;
+            totals->ms[PACE_TIME_JUDGE] += judge;
+            totals->judges++;
+            clock.now += pres + judge;
+            auto_start = !win && ctx.data.current_state == STATE_BONUS_HIGH_PROB;
+        }
+    }
+    // 最後のゲームの停止 (と演出) まで
+    totals->state_ms[clock.owner] += clock.now - clock.last_lever;
+    totals->games = ctx.games;
+    totals->payout = ctx.data.total_payout_diff;
+}
+
+// --- 公開関数 ---
+
+PaceTiming Pace_GetDefaultTiming(void) {
+    PaceTiming timing = PACE_DEFAULT_TIMING;
+    return timing;
+}
+
+bool Pace_Load(const char* config_path, PaceModel* model) {
+    memset(model, 0, sizeof(*model));
+    model->timing = Pace_GetDefaultTiming();
+
+    FILE* file = fopen(config_path, "r");
+    if (!file) {
+        fprintf(stderr, "Pace: %s を開けません\n", config_path);
+        return false;
+    }
+    PaceEntry* entries = (PaceEntry*)malloc(sizeof(PaceEntry) * PACE_MAX_ENTRIES);
+    if (!entries) {
+        fprintf(stderr, "Pace: メモリ確保に失敗しました\n");
+        fclose(file);
+        return false;
+    }
+
+    int count = 0;
+    bool ok = true;
+    enum { SECTION_OTHER, SECTION_MEDIA, SECTION_TIMING } section = SECTION_OTHER;
+    char line[PACE_MAX_LINE];
+    while (fgets(line, sizeof(line), file)) {
+        char* s = trim(line);
+        if (s[0] == '#' || s[0] == '\0') continue;
+        if (s[0] == '[') {
+            section = strcmp(s, "[Media]") == 0 ? SECTION_MEDIA
+                    : strcmp(s, "[Timing]") == 0 ? SECTION_TIMING : SECTION_OTHER;
+            continue;
+        }
+        char* equals = strchr(s, '=');
+        if (section == SECTION_OTHER || !equals) continue;
+        *equals = '\0';
+        char* key = trim(s);
+        char* value = trim(equals + 1);
+
+        if (section == SECTION_MEDIA) {
+            if (count < PACE_MAX_ENTRIES && *value) {
+                snprintf(entries[count].key, sizeof(entries[count].key), "%s", key);
+                snprintf(entries[count].value, sizeof(entries[count].value), "%s", value);
+                count++;
+            }
+            continue;
+        }
+        bool known = false;
+        for (size_t i = 0; i < sizeof(k_timing_keys) / sizeof(k_timing_keys[0]); i++) {
+            if (strcmp(key, k_timing_keys[i].key) != 0) continue;
+            known = true;
+            char* end;
+            double ms = strtod(value, &end);
+            if (end == value || *end != '\0' || ms < 0) {
+                fprintf(stderr, "Pace: %s の値が不正です: %s\n", key, value);
+                ok = false;
+            } else {
+                *(double*)((char*)&model->timing + k_timing_keys[i].offset) = ms;
+            }
+        }
+        if (!known) {
+            fprintf(stderr, "Pace: 不明なキーです: %s\n", key);
+            ok = false;
+        }
+    }
+    fclose(file);
+
+    // 動画のパスは設定ファイルのディレクトリから解決する (本体は media.cfg のあるディレクトリで起動する)
+    char dir[PACE_MAX_PATH] = "";
+    const char* slash = strrchr(config_path, '/');
+    const char* backslash = strrchr(config_path, '\\');
+    if (backslash && (!slash || backslash > slash)) slash = backslash;
+    if (slash && (size_t)(slash - config_path + 1) < sizeof(dir)) {
+        memcpy(dir, config_path, (size_t)(slash - config_path + 1));
+        dir[slash - config_path + 1] = '\0';
+    }
+
+    bool defined;
+    for (int v = 0; v < VIDEO_COUNT; v++) {
+        // ループ動画は長さを使わない (レバー待ちの時間は操作時間で数える)
+        const char* key = PresTable_GetVideoKey((VideoType)v);
+        if (!key || strstr(key, "_LOOP") || strncmp(key, "LOOP_VIDEO_", 11) == 0) continue;
+        model->video_ms[v] = media_duration(model, entries, count, dir, key, &defined);
+    }
+    for (int from = 0; from < PACE_STATE_COUNT; from++) {
+        for (int to = 0; to < PACE_STATE_COUNT; to++) {
+            if (from == to) continue;
+            char key[64];
+            PresTable_GetTransitionKey((AT_State)from, (AT_State)to, key, sizeof(key));
+            model->transition_ms[from][to] = media_duration(model, entries, count, dir, key, &defined);
+            model->has_transition[from][to] = defined;
+        }
+    }
+    free(entries);
+    if (model->missing_count > 1) {
+        fprintf(stderr, "Pace: ほかに %d 本の動画の長さを読めません\n", model->missing_count - 1);
+    }
+    return ok;
+}
+
+double Pace_GetPairIntroMs(const PaceModel* model, bool win) {
+    int count;
+    const WeightedEntry* entries = PresTable_GetPairEntries(win, &count);
+    double sum = 0.0, weight = 0.0;
+    for (int i = 0; i < count; i++) {
+        sum += (double)entries[i].weight * model->video_ms[entries[i].value];
+        weight += (double)entries[i].weight;
+    }
+    return weight > 0 ? sum / weight : 0.0;
+}
+
+double Pace_GetJudgeMs(const PaceModel* model, AT_BonusResultType result) {
+    if (result == BONUS_NONE) return 0.0;
+    double sum = 0.0;
+    for (int k = 0; k < PRES_JUDGE_VARIANTS; k++) {
+        VideoType part1 = PresTable_GetJudgeVideo(result, k);
+        sum += model->video_ms[part1];
+        if (result != BONUS_AT_CONTINUE) sum += model->video_ms[PresTable_GetJudgePart2(part1)];
+    }
+    return sum / PRES_JUDGE_VARIANTS;
+}
+
+double Pace_GetBBExRevealMs(const PaceModel* model, int target_payout, int* reveals) {
+    const PaceTiming* t = &model->timing;
+    double ms = model->video_ms[VIDEO_BB_EX_ENTRY_INTRO];
+    int shown = 0, count = 0;
+    while (shown < target_payout) {
+        shown = PresTable_GetBBExNextShown(shown, target_payout);
+        ms += t->lever_wait_ms + model->video_ms[PresTable_GetBBExShowVideo(shown, true)];
+        count++;
+    }
+    // 最終告知 (レバー) → 静止画待ち (レバーで最初のゲームへ)
+    ms += t->lever_wait_ms + model->video_ms[PresTable_GetBBExShowVideo(shown, true)] + t->lever_wait_ms;
+    if (reveals) *reveals = count;
+    return ms;
+}
+
+bool Pace_Run(const PaceConfig* config, const PaceModel* model, PaceResult* result, PaceTotals* day_totals) {
+    memset(result, 0, sizeof(*result));
+    if (config->days <= 0 || config->days > INT_MAX || config->games_per_day <= 0) {
+        fprintf(stderr, "Pace: 設定が不正です\n");
+        return false;
+    }
+
+    PaceJob job;
+    job.config = config;
+    job.model = model;
+    job.pair_intro_ms[0] = Pace_GetPairIntroMs(model, false);
+    job.pair_intro_ms[1] = Pace_GetPairIntroMs(model, true);
+    for (int r = 0; r <= BONUS_EPISODE; r++) {
+        job.judge_ms[r] = Pace_GetJudgeMs(model, (AT_BonusResultType)r);
+    }
+    job.days = day_totals ? day_totals : (PaceTotals*)malloc(sizeof(PaceTotals) * (size_t)config->days);
+    if (!job.days) {
+        fprintf(stderr, "Pace: メモリ確保に失敗しました\n");
+        return false;
+    }
+    bool ok = Parallel_Run((int)config->days, config->threads, pace_task, &job);
+
+    // 日番号順に合算
+    PaceTotals* total = &result->total;
+    for (long long d = 0; ok && d < config->days; d++) {
+        const PaceTotals* day = &job.days[d];
+        total->games += day->games;
+        total->payout += day->payout;
+        for (int k = 0; k < PACE_TIME_COUNT; k++) total->ms[k] += day->ms[k];
+        for (int s = 0; s < PACE_STATE_COUNT; s++) {
+            total->state_games[s] += day->state_games[s];
+            total->state_ms[s] += day->state_ms[s];
+        }
+        total->transitions += day->transitions;
+        total->judges += day->judges;
+        total->bb_ex_reveals += day->bb_ex_reveals;
+    }
+    if (ok) {
+        for (int k = 0; k < PACE_TIME_COUNT; k++) result->total_ms += total->ms[k];
+        double hours = result->total_ms / 3600000.0;
+        result->seconds_per_game = total->games > 0 ? result->total_ms / 1000.0 / total->games : 0.0;
+        result->games_per_hour = hours > 0 ? total->games / hours : 0.0;
+        result->payout_per_hour = hours > 0 ? total->payout / hours : 0.0;
+        result->rtp = SimEval_GetRtp(total->games, total->payout);
+    }
+    if (!day_totals) free(job.days);
+    return ok;
+}
+
+const char* Pace_GetTimeName(PaceTimeKind kind) {
+    return (kind >= 0 && kind < PACE_TIME_COUNT) ? k_time_names[kind] : "?";
+}
@@ -0,0 +1,127 @@
+#ifndef PACE_H
+#define PACE_H
+
+#include "sim.h"
+#include "video_defs.h"
+#include <stdbool.h>
+
+// =================================================================
+// 実時間の時速モデル
+// -----------------------------------------------------------------
+// ヘッドレス・エンジンで打った各ゲームに、Director が再生する演出の
+// 実際の長さ (media.cfg が参照する動画ファイルの長さ) と、ベット・レバー・
+// リール停止の操作時間、最小遊技時間 (ウェイト) を割り当て、1G あたりの
+// 実時間と 1 時間あたりのゲーム数・差枚を求める。
+//
+//  - 状態遷移: 次のレバーで遷移演出を再生し、終わるまで停止できない
+//  - AT高確率のボーナス抽選: 停止後に演出ペアの導入 → ループでレバー待ち →
+//    当落演出 (当選時は Part2 の告知 → レバー待ち)。落選時は次ゲームが自動で始まる
+//  - BB EX 突入: 遷移演出の後、導入 → 告知ごとにレバー → 最終告知 → レバー
+// 演出の選択は振り分け (pres_table.h) による期待値で数えるため、ゲームの
+// 乱数列には影響しない。読めない動画は再生されないもの (0 秒) として扱う。
+// 日 d は Rng_SeedStream(seed, d) の乱数列を使い、結果はスレッド数によらない。
+// =================================================================
+
+#define PACE_STATE_COUNT (STATE_AT_END + 1)
+
+// 操作時間 (ミリ秒)。media.cfg の [Timing] で変更できる
+typedef struct {
+    double game_wait_ms;      // 最小遊技時間 (前回のレバーONから次のレバーONまで、GAME_WAIT_MS)
+    double bet_lever_ms;      // 停止からベット・レバーONまで (BET_LEVER_MS)
+    double first_stop_ms;     // レバーONから第1停止まで (FIRST_STOP_MS)
+    double stop_interval_ms;  // 第1→第2、第2→第3停止の間隔 (STOP_INTERVAL_MS)
+    double lever_wait_ms;     // 演出中のレバー待ち・静止画待ちでレバーを押すまで (LEVER_WAIT_MS)
+} PaceTiming;
+
+#define PACE_DEFAULT_TIMING { 4100.0, 600.0, 800.0, 400.0, 700.0 }
+
+typedef struct {
+    PaceTiming timing;
+    double video_ms[VIDEO_COUNT];                                  // 動画の長さ (読めない・未定義は 0)
+    double transition_ms[PACE_STATE_COUNT][PACE_STATE_COUNT];      // 遷移演出の長さ [遷移元][遷移先]
+    bool has_transition[PACE_STATE_COUNT][PACE_STATE_COUNT];       // 遷移演出が再生されるか
+    int media_count;                                               // 長さを読めた動画の数
+    int missing_count;                                             // 定義はあるが読めなかった動画の数
+} PaceModel;
+
+// 時間の内訳
+typedef enum {
+    PACE_TIME_PLAY,        // ベット・レバー・リール停止
+    PACE_TIME_WAIT,        // ウェイト (最小遊技時間までの待ち)
+    PACE_TIME_TRANSITION,  // 状態遷移演出
+    PACE_TIME_AT_PRES,     // AT高確率の演出ペア (導入 + ループのレバー待ち)
+    PACE_TIME_JUDGE,       // 当落演出 (当選時の告知・レバー待ちを含む)
+    PACE_TIME_BB_EX,       // BB EX の枚数告知
+    PACE_TIME_COUNT
+} PaceTimeKind;
+
+typedef struct {
+    long long days;
+    long long games_per_day;
+    unsigned long long seed;
+    int threads;
+    SimOptions options;
+} PaceConfig;
+
+typedef struct {
+    long long games;
+    long long payout;                              // 差枚
+    double ms[PACE_TIME_COUNT];
+    long long state_games[PACE_STATE_COUNT];       // レバーON時の状態ごとのゲーム数
+    double state_ms[PACE_STATE_COUNT];             // 同じく実時間
+    long long transitions;                         // 遷移演出の回数
+    long long judges;                              // 当落演出の回数
+    long long bb_ex_reveals;                       // BB EX の枚数告知の回数
+} PaceTotals;
+
+typedef struct {
+    PaceTotals total;
+    double total_ms;
+    double seconds_per_game;
+    double games_per_hour;
+    double payout_per_hour;   // 1 時間あたりの差枚
+    double rtp;               // 機械割
+} PaceResult;
+
+/**
+ * @brief 操作時間の既定値を返します。
+ */
+PaceTiming Pace_GetDefaultTiming(void);
+
+/**
+ * @brief 設定ファイルの [Media] が参照する動画の長さと [Timing] の操作時間を読み込みます。
+ * 動画のパスは設定ファイルのあるディレクトリからの相対パスとして解決します。
+ * 長さは MP4 (ISO BMFF) の mvhd から求め、読めない動画は 0 秒として警告します。
+ * @return ファイルを開けない・[Timing] の値が不正な場合は false
+ */
+bool Pace_Load(const char* config_path, PaceModel* model);
+
+/**
+ * @brief AT高確率の演出ペアの導入動画の長さの期待値を返します (振り分けによる加重平均)。
+ */
+double Pace_GetPairIntroMs(const PaceModel* model, bool win);
+
+/**
+ * @brief 当落演出の長さの期待値を返します (当選時は Part1 + Part2)。
+ */
+double Pace_GetJudgeMs(const PaceModel* model, AT_BonusResultType result);
+
+/**
+ * @brief BB EX 突入時の枚数告知 (遷移演出の後から最初のゲームのレバー待ちまで) の長さを返します。
+ * @param reveals 告知の回数の書き出し先 (NULL 可)
+ */
+double Pace_GetBBExRevealMs(const PaceModel* model, int target_payout, int* reveals);
+
+/**
+ * @brief 1 日単位で打ち、実時間を集計します。Sim_InitTables 済みであること。
+ * @param day_totals days 個の書き出し先 (NULL 可)
+ * @return 設定が不正・メモリ確保・スレッド作成に失敗した場合は false
+ */
+bool Pace_Run(const PaceConfig* config, const PaceModel* model, PaceResult* result, PaceTotals* day_totals);
+
+/**
+ * @brief 時間の内訳の表示名を返します。
+ */
+const char* Pace_GetTimeName(PaceTimeKind kind);
+
+#endif // PACE_H
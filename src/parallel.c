@@ -0,0 +1,139 @@
+#include "parallel.h"
+#include "thread_config.h"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_thread.h>
+#include <stdio.h>
+#include <string.h>
+
+#define PARALLEL_MAX_THREADS 64
+#define PARALLEL_CACHE_LINE 64
+
+// ワーカー 1 つ分の両端キュー (未実行のタスク番号 [begin, end))
+// 持ち主は先頭から、盗む側は末尾から取る。両者とも lock を取って操作する
+typedef struct {
+    SDL_SpinLock lock;
+    int begin;
+    int end;
+    char padding[PARALLEL_CACHE_LINE - sizeof(SDL_SpinLock) - 2 * sizeof(int)];
+} ParallelDeque;
+
+typedef struct {
+    int worker_count;
+    ParallelDeque deques[PARALLEL_MAX_THREADS];
+    ParallelTaskFunc func;
+    void* user;
+} ParallelJob;
+
+typedef struct {
+    ParallelJob* job;
+    int worker;
+} ParallelWorker;
+
+// --- 内部ヘルパー関数 ---
+
+static bool pop_front(ParallelDeque* d, int* index) {
+    bool found = false;
+    SDL_AtomicLock(&d->lock);
+    if (d->begin < d->end) {
+        *index = d->begin++;
+        found = true;
+    }
+    SDL_AtomicUnlock(&d->lock);
+    return found;
+}
+
+// victim の残りの後ろ半分 (1 個なら その 1 個) を盗み、self に入れて 1 個取り出す
+static bool steal_half(ParallelDeque* victim, ParallelDeque* self, int* index) {
+    int begin, end;
+    SDL_AtomicLock(&victim->lock);
+    end = victim->end;
+    begin = victim->begin + (victim->end - victim->begin) / 2;
+    victim->end = begin;
+    SDL_AtomicUnlock(&victim->lock);
+    if (begin >= end) return false;
+
+    *index = begin;
+    SDL_AtomicLock(&self->lock);
+    self->begin = begin + 1;
+    self->end = end;
+    SDL_AtomicUnlock(&self->lock);
+    return true;
+}
+
+static void run_tasks(ParallelJob* job, int worker) {
+    ParallelDeque* self = &job->deques[worker];
+    for (;;) {
+        int index;
+        if (!pop_front(self, &index)) {
+            // 隣から順に盗む。一巡して何もなければ残りは他のワーカーが実行中
+            bool stolen = false;
+            for (int k = 1; k < job->worker_count && !stolen; k++) {
+                stolen = steal_half(&job->deques[(worker + k) % job->worker_count], self, &index);
+            }
+            if (!stolen) break;
+        }
+        job->func(index, job->user);
+    }
+}
+
+static int worker_main(void* arg) {
+    ParallelWorker* w = (ParallelWorker*)arg;
+    ThreadConfig_Apply(THREAD_ROLE_SIM_WORKER, w->worker);
+    run_tasks(w->job, w->worker);
+    return 0;
+}
+
+// --- 公開関数 ---
+
+int Parallel_GetDefaultThreadCount(void) {
+    int n = ThreadConfig_GetCpuCount(THREAD_ROLE_SIM_WORKER); // CPU を割り当てた場合はその数
+    if (n <= 0) n = SDL_GetCPUCount();
+    if (n < 1) n = 1;
+    if (n > PARALLEL_MAX_THREADS) n = PARALLEL_MAX_THREADS;
+    return n;
+}
+
+bool Parallel_Run(int task_count, int thread_count, ParallelTaskFunc func, void* user) {
+    if (task_count <= 0) return true;
+    if (thread_count <= 0) thread_count = Parallel_GetDefaultThreadCount();
+    if (thread_count > PARALLEL_MAX_THREADS) thread_count = PARALLEL_MAX_THREADS;
+    if (thread_count > task_count) thread_count = task_count;
+
+    // 初期配分は番号の連続した等分 (作成できなかったワーカーの分は盗まれて実行される)
+    ParallelJob job;
+    memset(&job, 0, sizeof(job));
+    job.worker_count = thread_count;
+    job.func = func;
+    job.user = user;
+    for (int i = 0; i < thread_count; i++) {
+        job.deques[i].begin = (int)((long long)task_count * i / thread_count);
+        job.deques[i].end = (int)((long long)task_count * (i + 1) / thread_count);
+    }
+
+    // 呼び出し元スレッドもワーカー 0 として働く。実行中だけワーカー 0 の CPU に固定し
+    // (動画デコード用に空けた CPU で動かないように)、終わったら元へ戻す。優先度は変更しない
+    ThreadAffinity caller_affinity;
+    ThreadConfig_ApplyAffinity(THREAD_ROLE_SIM_WORKER, 0, &caller_affinity);
+    SDL_Thread* threads[PARALLEL_MAX_THREADS];
+    ParallelWorker workers[PARALLEL_MAX_THREADS];
+    int started = 0;
+    bool ok = true;
+    for (int i = 1; i < thread_count; i++) {
+        workers[i].job = &job;
+        workers[i].worker = i;
+        SDL_Thread* t = SDL_CreateThread(worker_main, "sim_worker", &workers[i]);
+        if (!t) {
+            fprintf(stderr, "Parallel: スレッドを作成できません: %s\n", SDL_GetError());
+            ok = false;
+            break;
+        }
+        threads[started++] = t;
+    }
+
+    run_tasks(&job, 0);
+    for (int i = 0; i < started; i++) {
+        SDL_WaitThread(threads[i], NULL);
+    }
+    ThreadConfig_RestoreAffinity(&caller_affinity);
+    return ok;
+}
@@ -0,0 +1,40 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stdbool.h>
+
+// =================================================================
+// 並列タスク実行 (SDL スレッド)
+// -----------------------------------------------------------------
+// 0 〜 task_count-1 のタスクをワーカースレッドに配り、全完了まで待つ。
+// タスクは番号で結果を書き分け、集計は呼び出し元が番号順に行う
+// (スレッド数や実行順に結果が依存しないようにするため)。
+//
+// 各ワーカーは連続したタスク番号の区間を自分の両端キューとして持ち、
+// 先頭から順に取り出す。空になったら他のワーカーの区間の後ろ半分を盗む
+// (ワークスティーリング)。AT のように 1 タスクの長さが桁違いにばらつく場合も
+// 終盤に手の空いたワーカーが残りを分け合う。盗まれても結果の書き先は
+// タスク番号で決まるため、結果は変わらない。
+//
+// 浮動小数点の合算はタスク番号順の 1 本の鎖 (固定の合算順) で行い、
+// ワーカーごとの部分和や完了順の合算はしない (加算順で丸めが変わるため)。
+// タスクの乱数列は Rng_SeedStream(シード, タスク番号) で決め、ワーカーの
+// スレッドローカルな状態に依存させない。これにより結果はスレッド数・盗まれ方
+// によらずビット単位で一致する (sim digest で確認できる)。
+// =================================================================
+
+typedef void (*ParallelTaskFunc)(int task_index, void* user);
+
+/**
+ * @brief 既定のワーカー数 (論理 CPU 数、thread_config.h で CPU を割り当てた場合はその数) を返します。
+ */
+int Parallel_GetDefaultThreadCount(void);
+
+/**
+ * @brief タスクを並列に実行し、すべての完了を待ちます。
+ * @param thread_count ワーカー数 (0 以下で既定値、1 の場合は呼び出し元スレッドで実行)
+ * @return スレッドの作成に失敗した場合は false (作成できた分だけで実行は完了する)
+ */
+bool Parallel_Run(int task_count, int thread_count, ParallelTaskFunc func, void* user);
+
+#endif // PARALLEL_H
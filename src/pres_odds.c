@@ -0,0 +1,129 @@
+#include "pres_odds.h"
+#include "lottery.h"
+#include "pres_table.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char* k_kind_names[PRES_ODDS_KIND_COUNT] = { "演出ペア", "成立役×演出ペア", "当落演出" };
+static const char* k_kind_keys[PRES_ODDS_KIND_COUNT] = { "pair", "yaku_pair", "judge" };
+static const char* k_result_keys[PRES_ODDS_RESULT_COUNT] = {
+    "none", "continue", "darling", "franxx", "bb_ex", "episode",
+};
+
+// --- 内部ヘルパー関数 ---
+
+// 同じ種類・役・動画の行に同時確率を加える (なければ末尾に追加)
+static void add_prob(PresOddsTable* table, PresOddsKind kind, YakuType yaku, VideoType video,
+                     AT_BonusResultType result, double p) {
+    PresOddsRow* row = NULL;
+    for (int i = 0; i < table->row_count; i++) {
+        PresOddsRow* r = &table->rows[i];
+        if (r->kind == kind && r->yaku == yaku && r->video == video) {
+            row = r;
+            break;
+        }
+    }
+    if (!row) {
+        row = &table->rows[table->row_count++];
+        memset(row, 0, sizeof(*row));
+        row->kind = kind;
+        row->yaku = yaku;
+        row->video = video;
+    }
+    row->prob += p;
+    row->result_prob[result] += p;
+}
+
+// 成立役・結果の同時確率 p を、種類 kind の演出の振り分けで分ける
+static void add_presentations(PresOddsTable* table, PresOddsKind kind, YakuType yaku,
+                              AT_BonusResultType result, double p) {
+    if (kind == PRES_ODDS_JUDGE) {
+        // 当落演出は結果ごとに均等に選ぶ
+        for (int k = 0; k < PRES_JUDGE_VARIANTS; k++) {
+            add_prob(table, kind, YAKU_COUNT, PresTable_GetJudgeVideo(result, k), result, p / PRES_JUDGE_VARIANTS);
+        }
+        return;
+    }
+    int count;
+    const WeightedEntry* entries = PresTable_GetPairEntries(result != BONUS_AT_CONTINUE, &count);
+    for (int i = 0; i < count; i++) {
+        double q = (double)entries[i].weight / PRES_PAIR_DENOMINATOR;
+        add_prob(table, kind, kind == PRES_ODDS_YAKU_PAIR ? yaku : YAKU_COUNT, (VideoType)entries[i].value,
+                 result, p * q);
+    }
+}
+
+// --- 公開関数 ---
+
+bool PresOdds_Build(PresOddsTable* table) {
+    memset(table, 0, sizeof(*table));
+    int lose_count, win_count;
+    PresTable_GetPairEntries(false, &lose_count);
+    PresTable_GetPairEntries(true, &win_count);
+    int capacity = (YAKU_COUNT + 1) * (lose_count + win_count) + PRES_ODDS_RESULT_COUNT * PRES_JUDGE_VARIANTS;
+    table->rows = (PresOddsRow*)malloc(sizeof(PresOddsRow) * (size_t)capacity);
+    if (!table->rows) {
+        fprintf(stderr, "PresOdds: メモリ確保に失敗しました\n");
+        return false;
+    }
+
+    // 種類ごとに行をまとめるため、種類を外側に回す
+    for (int kind = 0; kind < PRES_ODDS_KIND_COUNT; kind++) {
+        for (int y = 0; y < YAKU_COUNT; y++) {
+            // AT高確率の小役抽選は通常時のテーブルを流用する (Lottery_GetResult_AT)
+            double p_yaku = (double)Lottery_GetWeight(LOTTERY_TABLE_NORMAL, (YakuType)y) / LOTTERY_DENOMINATOR;
+            if (p_yaku <= 0.0) continue;
+            for (int r = 0; r < PRES_ODDS_RESULT_COUNT; r++) {
+                double p = p_yaku * Lottery_GetBonusProbability_AT((YakuType)y, (AT_BonusResultType)r);
+                if (p <= 0.0) continue;
+                if (kind == PRES_ODDS_PAIR) table->result_prob[r] += p;
+                // ハズレは演出なし
+                if (r != BONUS_NONE) add_presentations(table, (PresOddsKind)kind, (YakuType)y, (AT_BonusResultType)r, p);
+            }
+        }
+    }
+    return true;
+}
+
+void PresOdds_Free(PresOddsTable* table) {
+    free(table->rows);
+    table->rows = NULL;
+    table->row_count = 0;
+}
+
+double PresOdds_GetLotteryProbability(const PresOddsTable* table) {
+    double p = 0.0;
+    for (int r = BONUS_AT_CONTINUE; r < PRES_ODDS_RESULT_COUNT; r++) p += table->result_prob[r];
+    return p;
+}
+
+double PresOdds_GetWinProbability(const PresOddsRow* row) {
+    return row->prob > 0.0 ? 1.0 - row->result_prob[BONUS_AT_CONTINUE] / row->prob : 0.0;
+}
+
+double PresOdds_GetResultProbability(const PresOddsRow* row, AT_BonusResultType result) {
+    return row->prob > 0.0 ? row->result_prob[result] / row->prob : 0.0;
+}
+
+void PresOdds_WriteCsv(FILE* out, const PresOddsTable* table) {
+    double lottery = PresOdds_GetLotteryProbability(table);
+    fprintf(out, "kind,yaku,video,prob,share,win");
+    for (int r = BONUS_AT_CONTINUE; r < PRES_ODDS_RESULT_COUNT; r++) fprintf(out, ",%s", k_result_keys[r]);
+    fprintf(out, "\n");
+    for (int i = 0; i < table->row_count; i++) {
+        const PresOddsRow* row = &table->rows[i];
+        const char* video = PresTable_GetVideoKey(row->video);
+        // share: 抽選演出が出たときにこの演出が選ばれる確率
+        fprintf(out, "%s,%s,%s,%.10g,%.10g,%.10g", k_kind_keys[row->kind],
+                row->kind == PRES_ODDS_YAKU_PAIR ? GetYakuKey(row->yaku) : "", video ? video : "",
+                row->prob, lottery > 0.0 ? row->prob / lottery : 0.0, PresOdds_GetWinProbability(row));
+        for (int r = BONUS_AT_CONTINUE; r < PRES_ODDS_RESULT_COUNT; r++) {
+            fprintf(out, ",%.10g", PresOdds_GetResultProbability(row, (AT_BonusResultType)r));
+        }
+        fprintf(out, "\n");
+    }
+}
+
+const char* PresOdds_GetKindName(PresOddsKind kind) {
+    return (kind >= 0 && kind < PRES_ODDS_KIND_COUNT) ? k_kind_names[kind] : "?";
+}
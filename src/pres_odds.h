@@ -0,0 +1,80 @@
+#ifndef PRES_ODDS_H
+#define PRES_ODDS_H
+
+#include "common.h"
+#include "game_data.h"
+#include "video_defs.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+// =================================================================
+// 演出の期待度
+// -----------------------------------------------------------------
+// AT高確率の 1G を、成立役 (Lottery_GetResult_AT のテーブル) × ボーナス抽選
+// (Lottery_CheckBonus_AT の同時分布) × 演出の振り分け (pres_table.h) に分解し、
+// 演出ペア・成立役ごとの演出ペア・当落演出のそれぞれについて、出現率と
+// 結果 (落選 / 各ボーナス) の同時確率を厳密に求める。期待度 (当選の事後確率)
+// とボーナスの内訳は同時確率の比で表す。抽選テーブルは構築済みの現在の
+// スペックのものを使うため、Sim_InitTables 後に呼び出す。
+// =================================================================
+
+#define PRES_ODDS_RESULT_COUNT (BONUS_EPISODE + 1)
+
+typedef enum {
+    PRES_ODDS_PAIR,       // 演出ペア (導入動画)
+    PRES_ODDS_YAKU_PAIR,  // 成立役 × 演出ペア
+    PRES_ODDS_JUDGE,      // 当落演出 (落選動画 / 当選時の Part1)
+    PRES_ODDS_KIND_COUNT
+} PresOddsKind;
+
+typedef struct {
+    PresOddsKind kind;
+    YakuType yaku;                               // PRES_ODDS_YAKU_PAIR のみ (ほかは YAKU_COUNT)
+    VideoType video;
+    double prob;                                 // AT高確率 1G あたりの出現率
+    double result_prob[PRES_ODDS_RESULT_COUNT];  // 結果ごとの同時確率 (合計 = prob)
+} PresOddsRow;
+
+typedef struct {
+    double result_prob[PRES_ODDS_RESULT_COUNT];  // AT高確率 1G あたりの抽選結果の確率
+    PresOddsRow* rows;                           // 種類ごとにまとめて並べる
+    int row_count;
+} PresOddsTable;
+
+/**
+ * @brief 現在の抽選テーブルと演出の振り分けから期待度の表を作ります。
+ * @return メモリ確保に失敗した場合は false
+ */
+bool PresOdds_Build(PresOddsTable* table);
+
+/**
+ * @brief PresOdds_Build で確保した表を解放します。
+ */
+void PresOdds_Free(PresOddsTable* table);
+
+/**
+ * @brief 抽選演出 (ボーナス抽選の結果がハズレ以外) が出る確率を返します (AT高確率 1G あたり)。
+ */
+double PresOdds_GetLotteryProbability(const PresOddsTable* table);
+
+/**
+ * @brief 演出が出たときに当選している確率 (期待度) を返します。
+ */
+double PresOdds_GetWinProbability(const PresOddsRow* row);
+
+/**
+ * @brief 演出が出たときに結果が result である確率を返します。
+ */
+double PresOdds_GetResultProbability(const PresOddsRow* row, AT_BonusResultType result);
+
+/**
+ * @brief 表を CSV (見出し行付き) で出力します。
+ */
+void PresOdds_WriteCsv(FILE* out, const PresOddsTable* table);
+
+/**
+ * @brief 種類の表示名を返します。
+ */
+const char* PresOdds_GetKindName(PresOddsKind kind);
+
+#endif // PRES_ODDS_H
@@ -0,0 +1,164 @@
+#include "pres_table.h"
+#include <stdio.h>
+
+// AT演出ペアの振り分け (値 = 導入動画、ループ動画は直後の定義)
+static const WeightedEntry k_pres_pair_lose[] = {
+    {VIDEO_AT_PRES_A_INTRO, 40}, {VIDEO_AT_PRES_B_INTRO, 30},
+    {VIDEO_AT_PRES_C_INTRO, 20}, {VIDEO_AT_PRES_D_INTRO, 10},
+};
+static const WeightedEntry k_pres_pair_win[] = {
+    {VIDEO_AT_PRES_A_INTRO, 5},  {VIDEO_AT_PRES_B_INTRO, 15},
+    {VIDEO_AT_PRES_C_INTRO, 30}, {VIDEO_AT_PRES_D_INTRO, 50},
+};
+
+// 遷移演出のキーに使う状態名
+static const char* k_state_keys[] = {
+    "NORMAL", "CZ", "BB_INITIAL", "BONUS_HIGH_PROB", "BB_HIGH_PROB", "FRANXX_BONUS",
+    "BB_EX", "HIYOKU_BEATS", "EPISODE_BONUS", "TSUREDASHI", "AT_END",
+};
+
+// --- 内部ヘルパー関数 ---
+
+static const char* state_key(AT_State state) {
+    int count = (int)(sizeof(k_state_keys) / sizeof(k_state_keys[0]));
+    return (state >= 0 && (int)state < count) ? k_state_keys[state] : "NORMAL";
+}
+
+// --- 公開関数 ---
+
+const WeightedEntry* PresTable_GetPairEntries(bool win, int* count) {
+    if (win) {
+        *count = (int)(sizeof(k_pres_pair_win) / sizeof(k_pres_pair_win[0]));
+        return k_pres_pair_win;
+    }
+    *count = (int)(sizeof(k_pres_pair_lose) / sizeof(k_pres_pair_lose[0]));
+    return k_pres_pair_lose;
+}
+
+VideoType PresTable_GetJudgeVideo(AT_BonusResultType result, int variant) {
+    if (result == BONUS_AT_CONTINUE) {
+        return (VideoType)(VIDEO_JUDGE_LOSE_1 + variant);
+    } else if (result == BONUS_FRANXX) {
+        return (VideoType)(VIDEO_JUDGE_FRANXX_1_PART1 + (variant * 2));
+    } else {
+        return (VideoType)(VIDEO_JUDGE_DARLING_1_PART1 + (variant * 2));
+    }
+}
+
+VideoType PresTable_GetJudgePart2(VideoType part1) {
+    // PART1の次は定義上 PART2 であることを利用
+    return (VideoType)(part1 + 1);
+}
+
+VideoType PresTable_GetBBExShowVideo(int payout, bool is_intro) {
+    VideoType base = VIDEO_NONE;
+    switch (payout) {
+        case 200: base = VIDEO_BB_EX_SHOW_200_INTRO; break;
+        case 300: base = VIDEO_BB_EX_SHOW_300_INTRO; break;
+        case 400: base = VIDEO_BB_EX_SHOW_400_INTRO; break;
+        case 500: base = VIDEO_BB_EX_SHOW_500_INTRO; break;
+        case 600: base = VIDEO_BB_EX_SHOW_600_INTRO; break;
+        case 700: base = VIDEO_BB_EX_SHOW_700_INTRO; break;
+        case 800: base = VIDEO_BB_EX_SHOW_800_INTRO; break;
+        case 900: base = VIDEO_BB_EX_SHOW_900_INTRO; break;
+        case 1000: base = VIDEO_BB_EX_SHOW_1000_INTRO; break;
+        case 2000: base = VIDEO_BB_EX_SHOW_2000_INTRO; break;
+        case 3000: base = VIDEO_BB_EX_SHOW_3000_INTRO; break;
+        default: base = VIDEO_BB_EX_SHOW_200_INTRO; break;
+    }
+    return is_intro ? base : (VideoType)(base + 1);
+}
+
+int PresTable_GetBBExNextShown(int shown, int target) {
+    int next_add;
+    if (shown == 0) {
+        next_add = PRES_BB_EX_FIRST_SHOW; // 初回200
+    } else if (shown < 1000) {
+        next_add = 100; // 1000未満は +100
+    } else {
+        next_add = 1000; // 1000以上は +1000
+    }
+    // 上限クリップ
+    return (shown + next_add > target) ? target : shown + next_add;
+}
+
+const char* PresTable_GetVideoKey(VideoType type) {
+    switch(type) {
+        case VIDEO_IDLE: return "LOOP_VIDEO_NORMAL";
+        case VIDEO_SPIN: return "LOOP_VIDEO_NORMAL";
+        case VIDEO_AT_PRES_A_INTRO: return "AT_PRES_A_INTRO";
+        case VIDEO_AT_PRES_A_LOOP:  return "AT_PRES_A_LOOP";
+        case VIDEO_AT_PRES_B_INTRO: return "AT_PRES_B_INTRO";
+        case VIDEO_AT_PRES_B_LOOP:  return "AT_PRES_B_LOOP";
+        case VIDEO_AT_PRES_C_INTRO: return "AT_PRES_C_INTRO";
+        case VIDEO_AT_PRES_C_LOOP:  return "AT_PRES_C_LOOP";
+        case VIDEO_AT_PRES_D_INTRO: return "AT_PRES_D_INTRO";
+        case VIDEO_AT_PRES_D_LOOP:  return "AT_PRES_D_LOOP";
+        case VIDEO_JUDGE_LOSE_1:    return "JUDGE_LOSE_1";
+        case VIDEO_JUDGE_LOSE_2:    return "JUDGE_LOSE_2";
+        case VIDEO_JUDGE_LOSE_3:    return "JUDGE_LOSE_3";
+
+        case VIDEO_JUDGE_DARLING_1_PART1: return "JUDGE_DARLING_1_PART1";
+        case VIDEO_JUDGE_DARLING_1_PART2: return "JUDGE_DARLING_1_PART2";
+        case VIDEO_JUDGE_DARLING_2_PART1: return "JUDGE_DARLING_2_PART1";
+        case VIDEO_JUDGE_DARLING_2_PART2: return "JUDGE_DARLING_2_PART2";
+        case VIDEO_JUDGE_DARLING_3_PART1: return "JUDGE_DARLING_3_PART1";
+        case VIDEO_JUDGE_DARLING_3_PART2: return "JUDGE_DARLING_3_PART2";
+
+        case VIDEO_JUDGE_FRANXX_1_PART1:  return "JUDGE_FRANXX_1_PART1";
+        case VIDEO_JUDGE_FRANXX_1_PART2:  return "JUDGE_FRANXX_1_PART2";
+        case VIDEO_JUDGE_FRANXX_2_PART1:  return "JUDGE_FRANXX_2_PART1";
+        case VIDEO_JUDGE_FRANXX_2_PART2:  return "JUDGE_FRANXX_2_PART2";
+        case VIDEO_JUDGE_FRANXX_3_PART1:  return "JUDGE_FRANXX_3_PART1";
+        case VIDEO_JUDGE_FRANXX_3_PART2:  return "JUDGE_FRANXX_3_PART2";
+
+        case VIDEO_BB_EX_ENTRY_INTRO: return "BB_EX_ENTRY_INTRO";
+        case VIDEO_BB_EX_ENTRY_LOOP:  return "BB_EX_ENTRY_LOOP";
+
+        case VIDEO_BB_EX_SHOW_200_INTRO: return "BB_EX_SHOW_200_INTRO";
+        case VIDEO_BB_EX_SHOW_200_LOOP:  return "BB_EX_SHOW_200_LOOP";
+        case VIDEO_BB_EX_SHOW_300_INTRO: return "BB_EX_SHOW_300_INTRO";
+        case VIDEO_BB_EX_SHOW_300_LOOP:  return "BB_EX_SHOW_300_LOOP";
+        case VIDEO_BB_EX_SHOW_400_INTRO: return "BB_EX_SHOW_400_INTRO";
+        case VIDEO_BB_EX_SHOW_400_LOOP:  return "BB_EX_SHOW_400_LOOP";
+        case VIDEO_BB_EX_SHOW_500_INTRO: return "BB_EX_SHOW_500_INTRO";
+        case VIDEO_BB_EX_SHOW_500_LOOP:  return "BB_EX_SHOW_500_LOOP";
+        case VIDEO_BB_EX_SHOW_600_INTRO: return "BB_EX_SHOW_600_INTRO";
+        case VIDEO_BB_EX_SHOW_600_LOOP:  return "BB_EX_SHOW_600_LOOP";
+        case VIDEO_BB_EX_SHOW_700_INTRO: return "BB_EX_SHOW_700_INTRO";
+        case VIDEO_BB_EX_SHOW_700_LOOP:  return "BB_EX_SHOW_700_LOOP";
+        case VIDEO_BB_EX_SHOW_800_INTRO: return "BB_EX_SHOW_800_INTRO";
+        case VIDEO_BB_EX_SHOW_800_LOOP:  return "BB_EX_SHOW_800_LOOP";
+        case VIDEO_BB_EX_SHOW_900_INTRO: return "BB_EX_SHOW_900_INTRO";
+        case VIDEO_BB_EX_SHOW_900_LOOP:  return "BB_EX_SHOW_900_LOOP";
+        case VIDEO_BB_EX_SHOW_1000_INTRO: return "BB_EX_SHOW_1000_INTRO";
+        case VIDEO_BB_EX_SHOW_1000_LOOP:  return "BB_EX_SHOW_1000_LOOP";
+        case VIDEO_BB_EX_SHOW_2000_INTRO: return "BB_EX_SHOW_2000_INTRO";
+        case VIDEO_BB_EX_SHOW_2000_LOOP:  return "BB_EX_SHOW_2000_LOOP";
+        case VIDEO_BB_EX_SHOW_3000_INTRO: return "BB_EX_SHOW_3000_INTRO";
+        case VIDEO_BB_EX_SHOW_3000_LOOP:  return "BB_EX_SHOW_3000_LOOP";
+
+        default: return NULL;
+    }
+}
+
+const char* PresTable_GetLoopKey(AT_State state) {
+    switch (state) {
+        case STATE_NORMAL:          return "LOOP_VIDEO_NORMAL";
+        case STATE_CZ:              return "LOOP_VIDEO_CZ";
+        case STATE_BB_INITIAL:      return "LOOP_VIDEO_BB_INITIAL";
+        case STATE_BONUS_HIGH_PROB: return "LOOP_VIDEO_BONUS_HIGH_PROB";
+        case STATE_BB_HIGH_PROB:    return "LOOP_VIDEO_BB_HIGH_PROB";
+        case STATE_FRANXX_BONUS:    return "LOOP_VIDEO_FRANXX_BONUS";
+        case STATE_BB_EX:           return "LOOP_VIDEO_BB_EX";
+        case STATE_HIYOKU_BEATS:    return "LOOP_VIDEO_HIYOKU_BEATS";
+        case STATE_EPISODE_BONUS:   return "LOOP_VIDEO_EPISODE_BONUS";
+        case STATE_TSUREDASHI:      return "LOOP_VIDEO_TSUREDASHI";
+        case STATE_AT_END:          return "LOOP_VIDEO_AT_END";
+        default: return "LOOP_VIDEO_NORMAL";
+    }
+}
+
+void PresTable_GetTransitionKey(AT_State from, AT_State to, char* buffer, size_t size) {
+    snprintf(buffer, size, "TRANSITION_%s_TO_%s", state_key(from), state_key(to));
+}
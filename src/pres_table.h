@@ -0,0 +1,66 @@
+#ifndef PRES_TABLE_H
+#define PRES_TABLE_H
+
+#include "common.h"
+#include "game_data.h"
+#include "video_defs.h"
+#include "weighted_table.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// =================================================================
+// 演出の振り分けと動画キー
+// -----------------------------------------------------------------
+// Director が再生する演出 (AT高確率の演出ペア・当落演出・BB EX の枚数告知)
+// の選び方と、media.cfg のキーへの対応をまとめる。描画に依存しないため、
+// ヘッドレス・シミュレータの時間モデル (pace.h) からも同じ表を参照する。
+// =================================================================
+
+#define PRES_PAIR_DENOMINATOR 100
+#define PRES_JUDGE_VARIANTS 3      // 当落演出の種類数 (結果ごと、均等に選ぶ)
+#define PRES_BB_EX_FIRST_SHOW 200  // BB EX 告知の初回の枚数
+
+/**
+ * @brief AT高確率の演出ペアの振り分けを返します (値 = 導入動画、ループ動画は直後の定義)。
+ * @param win ボーナス当選時 (落選 = BONUS_AT_CONTINUE は false)
+ * @param count 要素数の書き出し先
+ */
+const WeightedEntry* PresTable_GetPairEntries(bool win, int* count);
+
+/**
+ * @brief 当落演出 (落選動画 または 当選時の Part1) を返します。
+ * @param variant 0 〜 PRES_JUDGE_VARIANTS-1
+ */
+VideoType PresTable_GetJudgeVideo(AT_BonusResultType result, int variant);
+
+/**
+ * @brief 当選時の Part1 に続く告知動画 (Part2) を返します。
+ */
+VideoType PresTable_GetJudgePart2(VideoType part1);
+
+/**
+ * @brief BB EX の告知済み枚数に対応する告知動画を返します (導入 / ループ)。
+ */
+VideoType PresTable_GetBBExShowVideo(int payout, bool is_intro);
+
+/**
+ * @brief BB EX の次の告知枚数を返します (初回 200、1000 未満は +100、以降 +1000。目標枚数で頭打ち)。
+ */
+int PresTable_GetBBExNextShown(int shown, int target);
+
+/**
+ * @brief 動画の media.cfg のキーを返します (定義のない種類は NULL)。
+ */
+const char* PresTable_GetVideoKey(VideoType type);
+
+/**
+ * @brief 状態のループ動画のキーを返します。
+ */
+const char* PresTable_GetLoopKey(AT_State state);
+
+/**
+ * @brief 状態遷移演出のキー (TRANSITION_<遷移元>_TO_<遷移先>) を書き出します。
+ */
+void PresTable_GetTransitionKey(AT_State from, AT_State to, char* buffer, size_t size);
+
+#endif // PRES_TABLE_H
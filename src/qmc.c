@@ -0,0 +1,139 @@
+#include "qmc.h"
+#include "rng.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SOBOL_BITS 32
+
+// Sobol 列の方向数 (Joe & Kuo)。1 次元目は van der Corput 列
+typedef struct {
+    int degree;      // 原始多項式の次数 s
+    uint32_t coeff;  // 多項式の中間係数 a
+    uint32_t m[5];   // 初期方向数 m_1..m_s
+} SobolPoly;
+
+static const SobolPoly k_sobol_polys[QMC_MAX_DIMENSIONS - 1] = {
+    {1, 0, {1}},
+    {2, 1, {1, 3}},
+    {3, 1, {1, 3, 1}},
+    {3, 2, {1, 1, 1}},
+    {4, 1, {1, 1, 3, 3}},
+    {4, 4, {1, 3, 5, 13}},
+    {5, 2, {1, 1, 5, 5, 17}},
+};
+
+static uint32_t g_sobol_v[QMC_MAX_DIMENSIONS][SOBOL_BITS];
+static bool g_sobol_ready = false;
+
+// --- 内部ヘルパー関数 ---
+
+static void build_sobol_directions(void) {
+    for (int k = 0; k < SOBOL_BITS; k++) {
+        g_sobol_v[0][k] = 1u << (SOBOL_BITS - 1 - k);
+    }
+    for (int d = 1; d < QMC_MAX_DIMENSIONS; d++) {
+        const SobolPoly* p = &k_sobol_polys[d - 1];
+        uint32_t* v = g_sobol_v[d];
+        int s = p->degree;
+        for (int k = 0; k < s; k++) {
+            v[k] = p->m[k] << (SOBOL_BITS - 1 - k);
+        }
+        for (int k = s; k < SOBOL_BITS; k++) {
+            v[k] = v[k - s] ^ (v[k - s] >> s);
+            for (int j = 1; j < s; j++) {
+                if ((p->coeff >> (s - 1 - j)) & 1) v[k] ^= v[k - j];
+            }
+        }
+    }
+    g_sobol_ready = true;
+}
+
+static uint32_t sobol_point(int index, int dim) {
+    uint32_t x = 0;
+    uint32_t i = (uint32_t)index;
+    for (int k = 0; i != 0; k++, i >>= 1) {
+        if (i & 1) x ^= g_sobol_v[dim][k];
+    }
+    return x;
+}
+
+// --- 公開関数 ---
+
+bool QmcBatch_Init(QmcBatch* batch, QmcMode mode, int size, int dimensions) {
+    memset(batch, 0, sizeof(*batch));
+    if (size <= 0 || dimensions < 0 || dimensions > QMC_MAX_DIMENSIONS) {
+        fprintf(stderr, "QmcBatch: 不正なサイズです (size=%d, dimensions=%d)\n", size, dimensions);
+        return false;
+    }
+    batch->mode = mode;
+    batch->size = size;
+    batch->dimensions = dimensions;
+
+    switch (mode) {
+        case QMC_MODE_SOBOL:
+            if (!g_sobol_ready) build_sobol_directions();
+            for (int d = 0; d < dimensions; d++) {
+                batch->shift[d] = Rng_NextU32();
+            }
+            break;
+        case QMC_MODE_STRATIFIED:
+            batch->strata = (uint32_t*)malloc(sizeof(uint32_t) * (size_t)size * (dimensions > 0 ? dimensions : 1));
+            if (!batch->strata) {
+                fprintf(stderr, "QmcBatch: メモリ確保に失敗しました\n");
+                return false;
+            }
+            for (int d = 0; d < dimensions; d++) {
+                uint32_t* perm = batch->strata + (size_t)d * size;
+                for (int i = 0; i < size; i++) perm[i] = (uint32_t)i;
+                // Fisher-Yates
+                for (int i = size - 1; i > 0; i--) {
+                    int j = Rng_Below(i + 1);
+                    uint32_t tmp = perm[i]; perm[i] = perm[j]; perm[j] = tmp;
+                }
+            }
+            break;
+        default:
+            batch->dimensions = 0;
+            break;
+    }
+    return true;
+}
+
+void QmcBatch_Free(QmcBatch* batch) {
+    free(batch->strata);
+    batch->strata = NULL;
+}
+
+uint32_t QmcBatch_Point(const QmcBatch* batch, int index, int dim) {
+    switch (batch->mode) {
+        case QMC_MODE_SOBOL:
+            return sobol_point(index, dim) ^ batch->shift[dim];
+        case QMC_MODE_STRATIFIED: {
+            // 層 [k/size, (k+1)/size) 内の一様な位置
+            uint64_t k = batch->strata[(size_t)dim * batch->size + index];
+            return (uint32_t)(((k << 32) | Rng_NextU32()) / (uint64_t)batch->size);
+        }
+        default:
+            return Rng_NextU32();
+    }
+}
+
+const char* Qmc_GetModeName(QmcMode mode) {
+    switch (mode) {
+        case QMC_MODE_IID:        return "iid";
+        case QMC_MODE_STRATIFIED: return "strat";
+        case QMC_MODE_SOBOL:      return "sobol";
+        default:                  return "?";
+    }
+}
+
+bool Qmc_ParseMode(const char* name, QmcMode* mode) {
+    for (int m = 0; m < QMC_MODE_COUNT; m++) {
+        if (strcmp(name, Qmc_GetModeName((QmcMode)m)) == 0) {
+            *mode = (QmcMode)m;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,57 @@
+#ifndef QMC_H
+#define QMC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// =================================================================
+// 層化 / 準モンテカルロ抽選点
+// -----------------------------------------------------------------
+// 1 バッチ = size 個の試行 (例: AT size 回) に対して、
+// 各試行の先頭 dimensions 回の抽選値を互いに偏りなく配置する。
+//  - 層化: 次元ごとに [0,1) を size 個の層に分け、層の割り当てをランダムに並べ替える
+//  - Sobol: Sobol 列の先頭 size 点にランダムなデジタルシフト (XOR) を掛ける
+// どちらも各点は単独で見ると一様乱数と同じ分布 (不偏) になる。
+// =================================================================
+#define QMC_MAX_DIMENSIONS 8
+
+typedef enum {
+    QMC_MODE_IID,        // 通常の独立乱数
+    QMC_MODE_STRATIFIED, // 層化 (ラテン超方格)
+    QMC_MODE_SOBOL,      // スクランブル Sobol 列
+    QMC_MODE_COUNT
+} QmcMode;
+
+typedef struct {
+    QmcMode mode;
+    int size;        // バッチ内の試行数
+    int dimensions;  // 試行ごとに置き換える抽選回数
+    uint32_t shift[QMC_MAX_DIMENSIONS];  // Sobol: デジタルシフト
+    uint32_t* strata;                    // 層化: [dimensions][size] の層番号
+} QmcBatch;
+
+/**
+ * @brief バッチを構築します (シフト・並べ替えは呼び出し元スレッドの乱数で決まる)。
+ * @param size 試行数 (Sobol では 2 の累乗を推奨)
+ * @param dimensions 置き換える抽選回数 (QMC_MAX_DIMENSIONS 以下)
+ */
+bool QmcBatch_Init(QmcBatch* batch, QmcMode mode, int size, int dimensions);
+
+/**
+ * @brief バッチを解放します。
+ */
+void QmcBatch_Free(QmcBatch* batch);
+
+/**
+ * @brief index 番目の試行の dim 次元目の抽選値 (32bit 一様) を返します。
+ * 層化モードでは層内の位置に乱数を 1 回使います。
+ */
+uint32_t QmcBatch_Point(const QmcBatch* batch, int index, int dim);
+
+/**
+ * @brief モード名 ("iid" / "strat" / "sobol") との相互変換。
+ */
+const char* Qmc_GetModeName(QmcMode mode);
+bool Qmc_ParseMode(const char* name, QmcMode* mode);
+
+#endif // QMC_H
@@ -0,0 +1,92 @@
+#include "rng.h"
+
+// スレッドごとの乱数状態 (未シード時は固定の初期値)
+static _Thread_local uint64_t g_rng_state[4] = {
+    0x9E3779B97F4A7C15ULL, 0xBF58476D1CE4E5B9ULL,
+    0x94D049BB133111EBULL, 0x2545F4914F6CDD1DULL
+};
+
+static inline uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+// シード展開用 (splitmix64)
+static uint64_t splitmix64(uint64_t* x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static inline uint64_t next_u64(void) {
+    uint64_t* s = g_rng_state;
+    uint64_t result = rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return result;
+}
+
+// --- 公開関数 ---
+
+void Rng_Seed(uint64_t seed) {
+    uint64_t x = seed;
+    for (int i = 0; i < 4; i++) {
+        g_rng_state[i] = splitmix64(&x);
+    }
+}
+
+void Rng_SeedStream(uint64_t seed, uint64_t stream) {
+    uint64_t x = seed;
+    uint64_t mixed = splitmix64(&x) ^ (stream * 0xD1B54A32D192ED03ULL);
+    Rng_Seed(splitmix64(&mixed));
+}
+
+void Rng_GetState(RngState* state) {
+    for (int i = 0; i < 4; i++) {
+        state->s[i] = g_rng_state[i];
+    }
+}
+
+void Rng_SetState(const RngState* state) {
+    for (int i = 0; i < 4; i++) {
+        g_rng_state[i] = state->s[i];
+    }
+}
+
+uint32_t Rng_NextU32(void) {
+    return (uint32_t)(next_u64() >> 32);
+}
+
+int Rng_Below(int n) {
+    // Lemire の乗算法 (端数は棄却して偏りをなくす)
+    uint64_t m = (uint64_t)Rng_NextU32() * (uint32_t)n;
+    uint32_t low = (uint32_t)m;
+    if (low < (uint32_t)n) {
+        uint32_t threshold = (uint32_t)(-(uint32_t)n) % (uint32_t)n;
+        while (low < threshold) {
+            m = (uint64_t)Rng_NextU32() * (uint32_t)n;
+            low = (uint32_t)m;
+        }
+    }
+    return (int)(m >> 32);
+}
+
+uint64_t Rng_BelowU64(uint64_t n) {
+    // 2^64 mod n 未満の値を棄却して剰余の偏りをなくす
+    uint64_t threshold = (uint64_t)(-n) % n;
+    uint64_t x = next_u64();
+    while (x < threshold) {
+        x = next_u64();
+    }
+    return x % n;
+}
+
+double Rng_NextDouble(void) {
+    return (double)(next_u64() >> 11) * (1.0 / 9007199254740992.0);
+}
@@ -0,0 +1,62 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+// =================================================================
+// 乱数モジュール
+// (xoshiro256** / スレッドごとに独立した状態を持つ)
+// =================================================================
+
+// 乱数系列の状態 (保存・復元用)
+typedef struct {
+    uint64_t s[4];
+} RngState;
+
+/**
+ * @brief 呼び出し元スレッドの乱数系列を初期化します。
+ * @param seed シード値 (同じシードからは常に同じ系列が得られる)
+ */
+void Rng_Seed(uint64_t seed);
+
+/**
+ * @brief シードと系列番号から、互いに独立な乱数系列を初期化します。
+ * (並列実行でタスクごとに系列を分けるために使用。スレッド数に依存しない)
+ * @param seed 基本シード
+ * @param stream 系列番号 (タスク番号など)
+ */
+void Rng_SeedStream(uint64_t seed, uint64_t stream);
+
+/**
+ * @brief 呼び出し元スレッドの乱数状態を取得します。
+ */
+void Rng_GetState(RngState* state);
+
+/**
+ * @brief 呼び出し元スレッドの乱数状態を設定します (Rng_GetState で取得した位置から再開)。
+ */
+void Rng_SetState(const RngState* state);
+
+/**
+ * @brief 32bit の一様乱数を返します。
+ */
+uint32_t Rng_NextU32(void);
+
+/**
+ * @brief 0 〜 n-1 の一様乱数を返します (偏りなし)。
+ * @param n 上限 (1以上)
+ */
+int Rng_Below(int n);
+
+/**
+ * @brief 0 〜 n-1 の一様乱数を返します (64bit版、偏りなし)。
+ * @param n 上限 (1以上)
+ */
+uint64_t Rng_BelowU64(uint64_t n);
+
+/**
+ * @brief [0, 1) の一様乱数を返します (53bit精度)。
+ */
+double Rng_NextDouble(void);
+
+#endif // RNG_H
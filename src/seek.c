@@ -0,0 +1,184 @@
+#include "seek.h"
+#include "at.h"
+#include "lottery.h"
+#include "parallel.h"
+#include "rng.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define SEEK_CHUNK 16             // 1 タスクあたりのシード数
+#define SEEK_TASKS_PER_THREAD 4   // 1 ラウンドあたりのタスク数 (スレッド数の倍数)
+
+static const char* k_target_names[SEEK_TARGET_COUNT] = {
+    "bbex3000", "ep-maxx", "tsuredashi", "ceiling"
+};
+
+// 1 ゲーム前の状態 (目標の判定用)
+typedef struct {
+    AT_State state;
+    bool hiyoku_frozen;
+    long long ceiling_count;
+} SeekPrev;
+
+typedef struct {
+    const SeekConfig* config;
+    long long first_task;  // このラウンドの先頭タスク番号
+    SeekHit* hits;         // タスクごとに want 個
+    int* hit_counts;
+} SeekRound;
+
+// --- 内部ヘルパー関数 ---
+
+static bool target_reached(SeekTarget target, const SeekPrev* prev, const SimContext* ctx) {
+    const GameData* d = &ctx->data;
+    switch (target) {
+        case SEEK_TARGET_BB_EX_3000:
+            // 突入時に予約枚数が目標差枚へ移される
+            return prev->state != STATE_BB_EX && d->current_state == STATE_BB_EX &&
+                   d->target_bonus_payout >= 3000;
+        case SEEK_TARGET_EP_MAXX:
+            return prev->state == STATE_EPISODE_BONUS && d->current_state == STATE_HIYOKU_BEATS &&
+                   d->hiyoku_level == HIYOKU_MAXX;
+        case SEEK_TARGET_TSUREDASHI:
+            return prev->state == STATE_FRANXX_BONUS && !prev->hiyoku_frozen && d->hiyoku_is_frozen;
+        case SEEK_TARGET_CEILING:
+            return ctx->ceiling_count > prev->ceiling_count;
+        default:
+            return false;
+    }
+}
+
+// 1 ゲーム進めて目標に到達したかを返す
+static bool seek_step(SimContext* ctx, SeekTarget target) {
+    SeekPrev prev;
+    prev.state = ctx->data.current_state;
+    prev.hiyoku_frozen = ctx->data.hiyoku_is_frozen;
+    prev.ceiling_count = ctx->ceiling_count;
+    Sim_Step(ctx);
+    return target_reached(target, &prev, ctx);
+}
+
+// 本体と同じ初期状態 (Director_SetSeed + Director_Init) から到達ゲームを探す
+static long long find_hit_game(const SeekConfig* config, uint64_t seed) {
+    Rng_Seed(seed);
+    SimContext ctx;
+    Sim_Init(&ctx, NULL); // 一括消化なし (本体と 1 ゲームずつ一致させる)
+    while (ctx.games < config->max_games) {
+        if (seek_step(&ctx, config->target)) return ctx.games;
+    }
+    return 0;
+}
+
+static void seek_task(int task_index, void* user) {
+    SeekRound* round = (SeekRound*)user;
+    const SeekConfig* config = round->config;
+    long long task = round->first_task + task_index;
+    SeekHit* hits = &round->hits[(size_t)task_index * config->want];
+    int count = 0;
+
+    for (long long i = task * SEEK_CHUNK; i < (task + 1) * SEEK_CHUNK && i < config->seed_count; i++) {
+        uint64_t seed = config->first_seed + (uint64_t)i;
+        long long hit_game = find_hit_game(config, seed);
+        if (hit_game <= 0) continue;
+
+        SeekHit* h = &hits[count++];
+        h->seed = seed;
+        h->hit_game = hit_game;
+        h->warp_games = hit_game - 1 - config->lead_games;
+        if (h->warp_games < 0) h->warp_games = 0;
+        if (count >= config->want) break;
+    }
+    round->hit_counts[task_index] = count;
+}
+
+// 押し順ベルはナビどおり、それ以外は順押し
+static const char* push_keys(AT_State state, YakuType yaku) {
+    if (state < STATE_BB_INITIAL) return "zxc";
+    switch (yaku) {
+        case YAKU_OSHIJUN_BELL_LMR: return "zxc";
+        case YAKU_OSHIJUN_BELL_LRM: return "zcx";
+        case YAKU_OSHIJUN_BELL_MLR: return "xzc";
+        case YAKU_OSHIJUN_BELL_MRL: return "xcz";
+        case YAKU_OSHIJUN_BELL_RLM: return "czx";
+        case YAKU_OSHIJUN_BELL_RML: return "cxz";
+        default: return "zxc";
+    }
+}
+
+// --- 公開関数 ---
+
+bool Seek_ParseTarget(const char* name, SeekTarget* target) {
+    for (int i = 0; i < SEEK_TARGET_COUNT; i++) {
+        if (strcmp(name, k_target_names[i]) == 0) {
+            *target = (SeekTarget)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* Seek_GetTargetName(SeekTarget target) {
+    return (target >= 0 && target < SEEK_TARGET_COUNT) ? k_target_names[target] : "?";
+}
+
+int Seek_Run(const SeekConfig* config, SeekHit* hits) {
+    if (config->want <= 0 || config->seed_count <= 0) return 0;
+
+    int threads = config->threads > 0 ? config->threads : Parallel_GetDefaultThreadCount();
+    int tasks_per_round = threads * SEEK_TASKS_PER_THREAD;
+    long long task_count = (config->seed_count + SEEK_CHUNK - 1) / SEEK_CHUNK;
+
+    SeekRound round;
+    round.config = config;
+    round.hits = (SeekHit*)malloc(sizeof(SeekHit) * (size_t)tasks_per_round * config->want);
+    round.hit_counts = (int*)malloc(sizeof(int) * (size_t)tasks_per_round);
+    if (!round.hits || !round.hit_counts) {
+        fprintf(stderr, "Seek: メモリ確保に失敗しました\n");
+        free(round.hits);
+        free(round.hit_counts);
+        return -1;
+    }
+
+    // ラウンドごとに並列評価し、シード順に集める (必要数に達したら打ち切り)
+    int found = 0;
+    for (round.first_task = 0; round.first_task < task_count && found < config->want;
+         round.first_task += tasks_per_round) {
+        long long remaining = task_count - round.first_task;
+        int n = remaining < tasks_per_round ? (int)remaining : tasks_per_round;
+        if (!Parallel_Run(n, config->threads, seek_task, &round)) {
+            found = -1;
+            break;
+        }
+        for (int t = 0; t < n && found < config->want; t++) {
+            const SeekHit* task_hits = &round.hits[(size_t)t * config->want];
+            for (int i = 0; i < round.hit_counts[t] && found < config->want; i++) {
+                hits[found++] = task_hits[i];
+            }
+        }
+    }
+
+    free(round.hits);
+    free(round.hit_counts);
+    return found;
+}
+
+void Seek_WriteScript(FILE* out, const SeekConfig* config, const SeekHit* hit) {
+    fprintf(out, "# 目標 %s / シード %llu / %lld ゲーム目で到達\n",
+            Seek_GetTargetName(config->target), (unsigned long long)hit->seed, hit->hit_game);
+    fprintf(out, "# 本体: --seed %llu --warp %lld\n", (unsigned long long)hit->seed, hit->warp_games);
+    fprintf(out, "# ゲーム 状態 成立役 停止順 (z/x/c = 左/中/右)\n");
+
+    Rng_Seed(hit->seed);
+    SimContext ctx;
+    Sim_Init(&ctx, NULL);
+    while (ctx.games < hit->hit_game) {
+        AT_State state = ctx.data.current_state;
+        if (state == STATE_AT_END) state = STATE_NORMAL; // Sim_Step が通常時に戻してから打つ
+        bool reached = seek_step(&ctx, config->target);
+        if (ctx.games > hit->warp_games) {
+            fprintf(out, "%lld %s %s %s%s\n", ctx.games, AT_GetStateName(state),
+                    GetYakuName(ctx.data.last_yaku), push_keys(state, ctx.data.last_yaku),
+                    reached ? "  <- 到達" : "");
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef SEEK_H
+#define SEEK_H
+
+#include "sim.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// =================================================================
+// シード探索 (演出確認用)
+// -----------------------------------------------------------------
+// シード seed で Rng_Seed した通常時から 1 ゲームずつ進め、目標の展開
+// (BB EX 3000枚など) に到達するシードを並列に探す。本体は Director_SetSeed と
+// Director_Warp で同じ展開を再現できる (通常時・CZ は順押し、AT中はナビどおり)。
+// シードは番号順に評価し、見つかった順ではなくシードの小さい順に報告する
+// (結果はスレッド数に依存しない)。
+// =================================================================
+
+typedef enum {
+    SEEK_TARGET_BB_EX_3000,  // 3000枚以上の BB EX に突入 (VIDEO_BB_EX_SHOW_3000_*)
+    SEEK_TARGET_EP_MAXX,     // エピソードボーナス後に比翼BEATS レベルMAXX
+    SEEK_TARGET_TSUREDASHI,  // フランクスボーナスから連れ出し
+    SEEK_TARGET_CEILING,     // 天井到達
+    SEEK_TARGET_COUNT
+} SeekTarget;
+
+typedef struct {
+    SeekTarget target;
+    uint64_t first_seed;     // 探索を始めるシード
+    long long seed_count;    // 探索するシードの数
+    long long max_games;     // 1 シードあたりの打ち切りゲーム数
+    int want;                // 見つけるシードの数
+    int lead_games;          // 到達ゲームの何ゲーム前から本体で打つか
+    int threads;             // 0 以下で既定値
+} SeekConfig;
+
+typedef struct {
+    uint64_t seed;
+    long long hit_game;      // 目標に到達したゲーム (1 始まり)
+    long long warp_games;    // 本体の --warp に渡すゲーム数
+} SeekHit;
+
+/**
+ * @brief 目標名 (bbex3000 / ep-maxx / tsuredashi / ceiling) をパースします。
+ */
+bool Seek_ParseTarget(const char* name, SeekTarget* target);
+
+/**
+ * @brief 目標名を返します。
+ */
+const char* Seek_GetTargetName(SeekTarget target);
+
+/**
+ * @brief シードを探索します。Sim_InitTables 済みであること。
+ * @param hits config->want 個の書き出し先
+ * @return 見つけた数 (失敗した場合は -1)
+ */
+int Seek_Run(const SeekConfig* config, SeekHit* hits);
+
+/**
+ * @brief 見つけたシードを再生し、warp_games の次のゲームから到達ゲームまでの
+ * 停止手順 (z/x/c = 左/中/右) を書き出します。
+ */
+void Seek_WriteScript(FILE* out, const SeekConfig* config, const SeekHit* hit);
+
+#endif // SEEK_H
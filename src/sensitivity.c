@@ -0,0 +1,262 @@
+#include "sensitivity.h"
+#include "lottery.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    const SensConfig* config;
+    int task_count;
+    EvalResult result;
+    EvalTotals* totals;
+} SensRun;
+
+// --- 内部ヘルパー関数 ---
+
+static bool run_spec(const MachineSpec* spec, SensRun* run) {
+    Spec_Set(spec);
+    if (!Sim_InitTables()) return false;
+    return SimEval_RunTasks(&run->config->eval, &run->result, run->totals);
+}
+
+static bool result_metric(const SensConfig* config, const EvalResult* r, SensMetric m, double* value) {
+    switch (m) {
+        case SENS_METRIC_RTP:
+            *value = config->eval.from_normal ? r->total_rtp : r->rtp;
+            return r->games > 0;
+        case SENS_METRIC_PAYOUT:
+            *value = r->mean_payout;
+            return r->at_count > 0;
+        case SENS_METRIC_HIT_RATE:
+            *value = r->hit_rate;
+            return config->eval.from_normal && r->normal_games > 0;
+        default:
+            return false;
+    }
+}
+
+static bool task_metric(const SensConfig* config, const EvalTotals* t, SensMetric m, double* value) {
+    switch (m) {
+        case SENS_METRIC_RTP:
+            if (config->eval.from_normal) {
+                *value = SimEval_GetRtp(t->games + t->normal_games, t->payout + t->normal_payout);
+            } else {
+                *value = SimEval_GetRtp(t->games, t->payout);
+            }
+            return t->games > 0;
+        case SENS_METRIC_PAYOUT:
+            if (t->at_count == 0) return false;
+            *value = (double)t->payout / t->at_count;
+            return true;
+        case SENS_METRIC_HIT_RATE:
+            if (!config->eval.from_normal || t->normal_games == 0) return false;
+            *value = (double)t->at_count / t->normal_games;
+            return true;
+        default:
+            return false;
+    }
+}
+
+// 2 つの評価結果から微分と (タスク単位の対応のある差分による) 標準誤差を求める
+static void compute_derivative(const SensConfig* config, const SensRun* lo, const SensRun* hi,
+                               double width, SensResult* out) {
+    for (int m = 0; m < SENS_METRIC_COUNT; m++) {
+        double v_lo, v_hi;
+        out->derivative[m] = 0.0;
+        out->se[m] = 0.0;
+        if (!result_metric(config, &lo->result, (SensMetric)m, &v_lo) ||
+            !result_metric(config, &hi->result, (SensMetric)m, &v_hi)) {
+            continue;
+        }
+        out->derivative[m] = (v_hi - v_lo) / width;
+
+        double sum = 0.0, sq_sum = 0.0;
+        int n = 0;
+        for (int t = 0; t < lo->task_count; t++) {
+            double a, b;
+            if (!task_metric(config, &lo->totals[t], (SensMetric)m, &a) ||
+                !task_metric(config, &hi->totals[t], (SensMetric)m, &b)) {
+                continue;
+            }
+            sum += b - a;
+            sq_sum += (b - a) * (b - a);
+            n++;
+        }
+        if (n >= 2) {
+            double mean = sum / n;
+            double var = (sq_sum - n * mean * mean) / (n - 1);
+            out->se[m] = sqrt(var > 0 ? var / n : 0.0) / width;
+        }
+    }
+}
+
+static double rel_step(const SensConfig* config) {
+    return config->rel_step > 0 ? config->rel_step : SENS_DEFAULT_REL_STEP;
+}
+
+// 基準値を相対刻み分増やしたときの影響 (並べ替えと表示に使う)
+static double impact(const SensConfig* config, const SensResult* r, SensMetric m) {
+    long long step = llround(r->base * rel_step(config));
+    if (step < 1) step = 1;
+    return r->derivative[m] * step;
+}
+
+static int add_name(char names[][64], int count, int max_count, const char* fmt, const char* key, int index) {
+    if (count >= max_count) return count;
+    snprintf(names[count], 64, fmt, key, index);
+    return count + 1;
+}
+
+// --- 公開関数 ---
+
+int Sensitivity_ListParams(const MachineSpec* spec, char names[][64], int max_count) {
+    static const char* lottery_sections[LOTTERY_TABLE_COUNT] = { "Normal", "FranxxHighProb" };
+    int n = 0;
+
+    for (int t = 0; t < LOTTERY_TABLE_COUNT; t++) {
+        for (int y = 0; y < YAKU_COUNT; y++) {
+            if (y == YAKU_HAZURE || spec->lottery_weight[t][y] <= 0) continue;
+            if (n < max_count) {
+                snprintf(names[n++], 64, "Lottery.%s.%s", lottery_sections[t], GetYakuKey((YakuType)y));
+            }
+        }
+    }
+    for (int y = 0; y < YAKU_COUNT; y++) {
+        const char* key = GetYakuKey((YakuType)y);
+        if (spec->bonus_at[y].success > 0) n = add_name(names, n, max_count, "BonusAT.%s.success", key, 0);
+        if (spec->gcount_trigger[y] > 0) n = add_name(names, n, max_count, "AT.GCount.%s.trigger", key, 0);
+        for (int i = 1; i < spec->gcount[y].count; i++) {
+            if (spec->gcount[y].entries[i].weight > 0) n = add_name(names, n, max_count, "AT.GCount.%s.%d", key, i);
+        }
+        for (int i = 1; i < spec->payout_addon[y].count; i++) {
+            if (spec->payout_addon[y].entries[i].weight > 0) n = add_name(names, n, max_count, "AT.PayoutAddOn.%s.%d", key, i);
+        }
+        if (spec->tsuredashi[y] > 0) n = add_name(names, n, max_count, "AT.Tsuredashi.%s", key, 0);
+        if (spec->hiyoku_add[y] > 0) n = add_name(names, n, max_count, "AT.Hiyoku.%s.add", key, 0);
+        if (spec->hiyoku_bonus[y] > 0) n = add_name(names, n, max_count, "AT.Hiyoku.%s.bonus", key, 0);
+        if (spec->hiyoku_ex[y] > 0) n = add_name(names, n, max_count, "AT.Hiyoku.%s.ex", key, 0);
+    }
+    for (int i = 1; i < spec->bb_ex_continue_rate.count; i++) {
+        if (spec->bb_ex_continue_rate.entries[i].weight > 0) n = add_name(names, n, max_count, "AT.%s.%d", "BB_EX_CONTINUE_RATE", i);
+    }
+    for (int i = 1; i < spec->hiyoku_init_level.count; i++) {
+        if (spec->hiyoku_init_level.entries[i].weight > 0) n = add_name(names, n, max_count, "AT.%s.%d", "HIYOKU_INIT_LEVEL", i);
+    }
+    static const char* levelup_keys[] = { "HIYOKU_LEVELUP_LV1", "HIYOKU_LEVELUP_LV2", "HIYOKU_LEVELUP_MAXX" };
+    for (int i = 0; i < 3; i++) {
+        if (spec->hiyoku_levelup[HIYOKU_LV1 + i] > 0) n = add_name(names, n, max_count, "AT.%s", levelup_keys[i], 0);
+    }
+    return n;
+}
+
+bool Sensitivity_Run(const SensConfig* config, SensResult* results, EvalResult* base_result) {
+    const MachineSpec base = *Spec_Get();
+    int task_count = SimEval_GetTaskCount(&config->eval);
+    SensRun runs[3]; // 基準 / 下側 / 上側
+    bool ok = true;
+
+    for (int p = 0; p < config->count; p++) {
+        long long v;
+        if (!Spec_GetParam(&base, config->names[p], &v)) {
+            fprintf(stderr, "Sensitivity: 不明なパラメータ %s\n", config->names[p]);
+            return false;
+        }
+    }
+    for (int i = 0; i < 3; i++) {
+        runs[i].config = config;
+        runs[i].task_count = task_count;
+        runs[i].totals = (EvalTotals*)calloc(task_count > 0 ? (size_t)task_count : 1, sizeof(EvalTotals));
+        if (!runs[i].totals) {
+            fprintf(stderr, "Sensitivity: メモリ確保に失敗しました\n");
+            for (int j = 0; j < i; j++) free(runs[j].totals);
+            return false;
+        }
+    }
+
+    SensRun* base_run = &runs[0];
+    ok = run_spec(&base, base_run);
+    if (ok && base_result) *base_result = base_run->result;
+
+    for (int p = 0; ok && p < config->count; p++) {
+        SensResult* r = &results[p];
+        memset(r, 0, sizeof(*r));
+        snprintf(r->name, sizeof(r->name), "%s", config->names[p]);
+        Spec_GetParam(&base, r->name, &r->base);
+
+        long long h = llround(r->base * rel_step(config));
+        if (h < 1) h = 1;
+
+        // 上下それぞれ、不正なスペックになる場合は基準値で代用 (片側差分)
+        MachineSpec lo_spec = base, hi_spec = base;
+        bool lo_ok = Spec_SetParam(&lo_spec, r->name, r->base - h) && Spec_Validate(&lo_spec, r->name);
+        bool hi_ok = Spec_SetParam(&hi_spec, r->name, r->base + h) && Spec_Validate(&hi_spec, r->name);
+        if (!lo_ok && !hi_ok) continue;
+
+        r->lo = lo_ok ? r->base - h : r->base;
+        r->hi = hi_ok ? r->base + h : r->base;
+        SensRun* lo_run = base_run;
+        SensRun* hi_run = base_run;
+        if (lo_ok) {
+            lo_run = &runs[1];
+            ok = run_spec(&lo_spec, lo_run);
+        }
+        if (ok && hi_ok) {
+            hi_run = &runs[2];
+            ok = run_spec(&hi_spec, hi_run);
+        }
+        if (!ok) break;
+        compute_derivative(config, lo_run, hi_run, (double)(r->hi - r->lo), r);
+        r->valid = true;
+    }
+
+    // 基準のスペックへ戻す
+    Spec_Set(&base);
+    if (!Sim_InitTables()) ok = false;
+    for (int i = 0; i < 3; i++) free(runs[i].totals);
+    return ok;
+}
+
+void Sensitivity_Print(FILE* out, const SensConfig* config, const SensResult* results, int top_count) {
+    int order[SENS_MAX_PARAMS];
+    int n = 0;
+    for (int p = 0; p < config->count; p++) {
+        if (results[p].valid) order[n++] = p;
+    }
+    // 出玉率への影響の大きい順 (挿入ソート)
+    for (int i = 1; i < n; i++) {
+        int key = order[i];
+        double k = fabs(impact(config, &results[key], SENS_METRIC_RTP));
+        int j = i - 1;
+        while (j >= 0 && fabs(impact(config, &results[order[j]], SENS_METRIC_RTP)) < k) {
+            order[j + 1] = order[j];
+            j--;
+        }
+        order[j + 1] = key;
+    }
+    if (top_count > 0 && top_count < n) n = top_count;
+
+    bool with_hit = config->eval.from_normal;
+    fprintf(out, "--- 基準値を %.0f%% 増やした場合の影響 (±は標準誤差、* は 2SE 超) ---\n", 100.0 * rel_step(config));
+    fprintf(out, "%-40s %8s %18s %18s%s\n", "パラメータ", "基準値",
+            with_hit ? "機械割(pt)" : "AT出玉率(pt)", "平均差枚(枚)",
+            with_hit ? "      初当り確率(‰pt)" : "");
+    for (int i = 0; i < n; i++) {
+        const SensResult* r = &results[order[i]];
+        long long step = llround(r->base * rel_step(config));
+        if (step < 1) step = 1;
+        double rtp = 100.0 * impact(config, r, SENS_METRIC_RTP);
+        double rtp_se = 100.0 * r->se[SENS_METRIC_RTP] * step;
+        double pay = impact(config, r, SENS_METRIC_PAYOUT);
+        double pay_se = r->se[SENS_METRIC_PAYOUT] * step;
+        fprintf(out, "%-40s %8lld %+9.3f ±%6.3f%s %+9.2f ±%6.2f%s",
+                r->name, r->base,
+                rtp, rtp_se, fabs(rtp) > 2 * rtp_se ? "*" : " ",
+                pay, pay_se, fabs(pay) > 2 * pay_se ? "*" : " ");
+        if (with_hit) {
+            double hit = 1000.0 * impact(config, r, SENS_METRIC_HIT_RATE);
+            double hit_se = 1000.0 * r->se[SENS_METRIC_HIT_RATE] * step;
+            fprintf(out, " %+9.4f ±%7.4f%s", hit, hit_se, fabs(hit) > 2 * hit_se ? "*" : " ");
+        }
+        fprintf(out, "%s\n", r->lo == r->base || r->hi == r->base ? "  (片側差分)" : "");
+    }
+}
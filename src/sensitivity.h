@@ -0,0 +1,66 @@
+#ifndef SENSITIVITY_H
+#define SENSITIVITY_H
+
+#include "sim_eval.h"
+#include "spec.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+// =================================================================
+// スペックパラメータの感度分析
+// -----------------------------------------------------------------
+// 各パラメータを基準値から ±h (h = 基準値 × 相対刻み) 動かした 2 スペックを
+// 同じシード (共通乱数) で評価し、中心差分で出玉率・平均獲得差枚・
+// AT初当り確率の微分を求める。標準誤差はタスク単位の差分から求めるため、
+// 共通乱数で打ち消される分だけ独立に評価するより小さくなる。
+// 上限 / 下限で片側が不正なスペックになる場合は片側差分を使う。
+// =================================================================
+
+#define SENS_MAX_PARAMS 256
+#define SENS_DEFAULT_REL_STEP 0.1
+
+typedef enum {
+    SENS_METRIC_RTP,      // 出玉率 (from_normal の場合は通常時込みの機械割)
+    SENS_METRIC_PAYOUT,   // ATあたりの平均獲得差枚
+    SENS_METRIC_HIT_RATE, // AT初当り確率 (from_normal のみ)
+    SENS_METRIC_COUNT
+} SensMetric;
+
+typedef struct {
+    char names[SENS_MAX_PARAMS][64]; // Spec_SetParam の名前
+    int count;
+    double rel_step;                 // 相対刻み (0 以下で既定値)
+    EvalConfig eval;
+} SensConfig;
+
+typedef struct {
+    char name[64];
+    long long base;
+    long long lo, hi;                       // 差分に使った値 (片側差分では一方が base)
+    bool valid;
+    double derivative[SENS_METRIC_COUNT];   // パラメータ 1 単位あたりの変化量
+    double se[SENS_METRIC_COUNT];           // 微分の標準誤差
+} SensResult;
+
+/**
+ * @brief スペック中の確率パラメータ (当否・契機率・振り分けの重み・小役抽選値) を列挙します。
+ * 値が 0 のもの、合計を保てない振り分けの先頭要素は除きます。
+ * @return 列挙した数 (最大 max_count)
+ */
+int Sensitivity_ListParams(const MachineSpec* spec, char names[][64], int max_count);
+
+/**
+ * @brief 現在のスペックを基準に感度分析を行います。
+ * 終了時には基準のスペックと抽選テーブルに戻します。
+ * @param results config->count 個の書き出し先
+ * @param base_result 基準スペックの評価結果 (NULL 可)
+ * @return パラメータ名が不正・評価に失敗した場合は false
+ */
+bool Sensitivity_Run(const SensConfig* config, SensResult* results, EvalResult* base_result);
+
+/**
+ * @brief 結果を「基準値の相対刻み分だけ増やした場合の影響」が大きい順に出力します。
+ */
+void Sensitivity_Print(FILE* out, const SensConfig* config, const SensResult* results, int top_count);
+
+#endif // SENSITIVITY_H
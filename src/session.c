@@ -0,0 +1,242 @@
+#include "session.h"
+#include "at.h"
+#include "parallel.h"
+#include "rng.h"
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SESSION_PLAYERS_PER_TASK 64
+#define SESSION_NO_RESULT LLONG_MIN // 破産後で打たなかった日
+
+static const char* k_end_reason_names[SESSION_END_COUNT] = {
+    "閉店", "投資上限", "利確", "AT終了ヤメ", "資金切れ"
+};
+
+// タスク 1 つ分の集計 (タスク番号の位置に書き込み、番号順に合算する)
+typedef struct {
+    long long sessions;
+    long long games;
+    long long payout;
+    long long end_counts[SESSION_END_COUNT];
+} SessionTask;
+
+typedef struct {
+    const SessionConfig* config;
+    SessionTask* tasks;
+    SessionPlayer* players;
+    long long* session_yen;   // [打ち手][日] の収支 (打たなかった日は SESSION_NO_RESULT)
+} SessionJob;
+
+// --- 内部ヘルパー関数 ---
+
+static double medal_value_yen(const SessionConfig* config, long long medals) {
+    return (double)medals * SESSION_YEN_PER_LOAN / config->exchange_medals;
+}
+
+// 1 日打つ。資金と最大下落は player に反映する
+static SessionEndReason play_session(const SessionConfig* config, SessionPlayer* player, double* peak_yen,
+                                     SessionTask* task) {
+    // 一括消化は 1 ステップで複数ゲームの差枚をまとめて反映するため、持ちメダルが途中で尽きる時点
+    // (貸し出し・投資上限・破産の判定) を再現できない。打ち手のシミュレーションでは 1 ゲームずつ打つ
+    SimContext ctx;
+    Sim_Init(&ctx, NULL);
+    long long medals = 0;
+    long long invested = 0;
+    SessionEndReason reason = SESSION_END_CLOSING;
+
+    while (ctx.games < config->max_games) {
+        if (medals < BET_COUNT) {
+            if (player->final_yen < SESSION_YEN_PER_LOAN) {
+                reason = SESSION_END_RUIN;
+                break;
+            }
+            if (config->stop_loss_yen > 0 && invested + SESSION_YEN_PER_LOAN > config->stop_loss_yen) {
+                reason = SESSION_END_STOP_LOSS;
+                break;
+            }
+            player->final_yen -= SESSION_YEN_PER_LOAN;
+            invested += SESSION_YEN_PER_LOAN;
+            medals += config->lend_medals;
+        }
+
+        long long before = ctx.data.total_payout_diff;
+        Sim_Step(&ctx);
+        medals += ctx.data.total_payout_diff - before;
+
+        double equity = (double)player->final_yen + medal_value_yen(config, medals);
+        if (equity > *peak_yen) *peak_yen = equity;
+        long long drawdown = (long long)(*peak_yen - equity);
+        if (drawdown > player->max_drawdown_yen) player->max_drawdown_yen = drawdown;
+
+        if (config->take_profit_medals > 0 && medals >= config->take_profit_medals) {
+            reason = SESSION_END_TAKE_PROFIT;
+            break;
+        }
+        if (config->quit_after_at && ctx.data.current_state == STATE_AT_END) {
+            reason = SESSION_END_AFTER_AT;
+            break;
+        }
+    }
+
+    // 持ちメダルを全て交換する (端数は切り捨て)
+    player->final_yen += medals * SESSION_YEN_PER_LOAN / config->exchange_medals;
+    task->games += ctx.games;
+    task->payout += ctx.data.total_payout_diff;
+    return reason;
+}
+
+static void session_task(int task_index, void* user) {
+    SessionJob* job = (SessionJob*)user;
+    const SessionConfig* config = job->config;
+    SessionTask* task = &job->tasks[task_index];
+    memset(task, 0, sizeof(*task));
+
+    long long first = (long long)task_index * SESSION_PLAYERS_PER_TASK;
+    for (long long p = first; p < first + SESSION_PLAYERS_PER_TASK && p < config->players; p++) {
+        Rng_SeedStream(config->seed, (uint64_t)p);
+        SessionPlayer* player = &job->players[p];
+        long long* session_yen = &job->session_yen[p * config->sessions];
+        memset(player, 0, sizeof(*player));
+        player->final_yen = config->bankroll_yen;
+        double peak_yen = (double)config->bankroll_yen;
+
+        for (int s = 0; s < config->sessions; s++) {
+            session_yen[s] = SESSION_NO_RESULT;
+            if (player->ruined) continue;
+            if (player->final_yen < SESSION_YEN_PER_LOAN) {
+                player->ruined = true;
+                continue;
+            }
+            long long start_yen = player->final_yen;
+            SessionEndReason reason = play_session(config, player, &peak_yen, task);
+            session_yen[s] = player->final_yen - start_yen;
+            player->sessions_played++;
+            task->sessions++;
+            task->end_counts[reason]++;
+            if (reason == SESSION_END_RUIN) player->ruined = true;
+        }
+    }
+}
+
+static int compare_long_long(const void* a, const void* b) {
+    long long x = *(const long long*)a, y = *(const long long*)b;
+    return (x > y) - (x < y);
+}
+
+// 昇順に並べた values の q 分位点
+static long long quantile(const long long* sorted, long long n, double q) {
+    return n > 0 ? sorted[(long long)((n - 1) * q)] : 0;
+}
+
+// --- 公開関数 ---
+
+void Session_InitConfig(SessionConfig* config) {
+    memset(config, 0, sizeof(*config));
+    config->players = 10000;
+    config->sessions = 10;
+    config->bankroll_yen = 100000;
+    config->lend_medals = 46;
+    config->exchange_medals = 56;
+    config->stop_loss_yen = 30000;
+    config->max_games = 8000;
+}
+
+const char* Session_GetEndReasonName(SessionEndReason reason) {
+    return (reason >= 0 && reason < SESSION_END_COUNT) ? k_end_reason_names[reason] : "?";
+}
+
+bool Session_Run(const SessionConfig* config, SessionResult* result, SessionPlayer* players) {
+    memset(result, 0, sizeof(*result));
+    if (config->players <= 0 || config->sessions <= 0 || config->lend_medals <= 0 ||
+        config->exchange_medals <= 0 || config->max_games <= 0) {
+        fprintf(stderr, "Session: 設定が不正です\n");
+        return false;
+    }
+
+    long long task_count = (config->players + SESSION_PLAYERS_PER_TASK - 1) / SESSION_PLAYERS_PER_TASK;
+    size_t session_slots = (size_t)config->players * (size_t)config->sessions;
+    SessionJob job;
+    job.config = config;
+    job.tasks = (SessionTask*)malloc(sizeof(SessionTask) * (size_t)task_count);
+    job.players = (SessionPlayer*)malloc(sizeof(SessionPlayer) * (size_t)config->players);
+    job.session_yen = (long long*)malloc(sizeof(long long) * session_slots);
+    long long* sorted = (long long*)malloc(sizeof(long long) * (session_slots > (size_t)config->players
+                                                                   ? session_slots : (size_t)config->players));
+    if (!job.tasks || !job.players || !job.session_yen || !sorted) {
+        fprintf(stderr, "Session: メモリ確保に失敗しました\n");
+        free(job.tasks);
+        free(job.players);
+        free(job.session_yen);
+        free(sorted);
+        return false;
+    }
+    bool ok = Parallel_Run((int)task_count, config->threads, session_task, &job);
+
+    if (ok) {
+        // タスク番号順に合算
+        for (long long t = 0; t < task_count; t++) {
+            const SessionTask* task = &job.tasks[t];
+            result->sessions += task->sessions;
+            result->games += task->games;
+            result->payout += task->payout;
+            for (int r = 0; r < SESSION_END_COUNT; r++) result->end_counts[r] += task->end_counts[r];
+        }
+        result->players = config->players;
+
+        // 1 日の収支
+        long long n = 0, wins = 0;
+        double sum = 0.0, sq_sum = 0.0;
+        for (size_t i = 0; i < session_slots; i++) {
+            long long yen = job.session_yen[i];
+            if (yen == SESSION_NO_RESULT) continue;
+            sorted[n++] = yen;
+            sum += (double)yen;
+            sq_sum += (double)yen * yen;
+            if (yen > 0) wins++;
+        }
+        if (n > 0) {
+            result->session_mean_yen = sum / n;
+            double var = n > 1 ? (sq_sum - n * result->session_mean_yen * result->session_mean_yen) / (n - 1) : 0.0;
+            result->session_sd_yen = sqrt(var > 0 ? var : 0.0);
+            result->session_win_rate = (double)wins / n;
+            qsort(sorted, (size_t)n, sizeof(long long), compare_long_long);
+            result->session_q10_yen = quantile(sorted, n, 0.1);
+            result->session_q50_yen = quantile(sorted, n, 0.5);
+            result->session_q90_yen = quantile(sorted, n, 0.9);
+        }
+
+        // 打ち手ごとの最終資金・最大下落・破産
+        long long ruined = 0;
+        double final_sum = 0.0, drawdown_sum = 0.0;
+        for (long long p = 0; p < config->players; p++) {
+            const SessionPlayer* player = &job.players[p];
+            if (player->ruined) ruined++;
+            final_sum += (double)player->final_yen;
+            drawdown_sum += (double)player->max_drawdown_yen;
+            sorted[p] = player->final_yen;
+        }
+        result->ruin_rate = (double)ruined / config->players;
+        result->final_mean_yen = final_sum / config->players;
+        result->drawdown_mean_yen = drawdown_sum / config->players;
+        qsort(sorted, (size_t)config->players, sizeof(long long), compare_long_long);
+        result->final_q10_yen = quantile(sorted, config->players, 0.1);
+        result->final_q50_yen = quantile(sorted, config->players, 0.5);
+        result->final_q90_yen = quantile(sorted, config->players, 0.9);
+        for (long long p = 0; p < config->players; p++) sorted[p] = job.players[p].max_drawdown_yen;
+        qsort(sorted, (size_t)config->players, sizeof(long long), compare_long_long);
+        result->drawdown_q50_yen = quantile(sorted, config->players, 0.5);
+        result->drawdown_q90_yen = quantile(sorted, config->players, 0.9);
+        result->drawdown_q99_yen = quantile(sorted, config->players, 0.99);
+
+        if (players) memcpy(players, job.players, sizeof(SessionPlayer) * (size_t)config->players);
+    }
+
+    free(job.tasks);
+    free(job.players);
+    free(job.session_yen);
+    free(sorted);
+    return ok;
+}
@@ -0,0 +1,90 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+#include "sim.h"
+#include <stdbool.h>
+
+// =================================================================
+// 資金管理・破産確率シミュレーション
+// -----------------------------------------------------------------
+// 資金 (円) を持った打ち手が 1 日ずつ稼働する。メダルが 3 枚を切ると
+// 1000 円ずつ借りて打ち、1 日の投資上限 (損切り)・持ちメダルの目標枚数
+// (利確)・AT終了でのヤメ・閉店 (最大ゲーム数) で 1 日を終えて全て交換する。
+// 資金が 1000 円を切った時点でメダルも足りなければ破産とする。
+// 打ち手 p は Rng_SeedStream(seed, p) の乱数列で全日を打つため、
+// 結果はスレッド数によらない。各日は新しい台 (通常時の初期状態) から打つ。
+// =================================================================
+
+#define SESSION_YEN_PER_LOAN 1000
+
+// 1 日を終えた理由
+typedef enum {
+    SESSION_END_CLOSING,     // 閉店 (最大ゲーム数)
+    SESSION_END_STOP_LOSS,   // 投資上限
+    SESSION_END_TAKE_PROFIT, // 持ちメダルが目標枚数に到達
+    SESSION_END_AFTER_AT,    // AT終了でヤメ
+    SESSION_END_RUIN,        // 資金切れ
+    SESSION_END_COUNT
+} SessionEndReason;
+
+typedef struct {
+    long long players;
+    int sessions;                   // 1 人あたりの稼働日数 (破産した打ち手は以降打たない)
+    long long bankroll_yen;         // 初期資金
+    int lend_medals;                // 1000 円あたりの貸出枚数
+    int exchange_medals;            // 1000 円に交換するのに必要な枚数 (端数は切り捨て)
+    long long stop_loss_yen;        // 1 日の投資上限 (0 で資金が尽きるまで)
+    long long take_profit_medals;   // 持ちメダルがこの枚数以上でヤメ (0 で無効)
+    bool quit_after_at;             // AT終了でヤメ (投資を回収していなくても)
+    long long max_games;            // 1 日の最大ゲーム数
+    unsigned long long seed;
+    int threads;                    // 0 以下で既定値
+} SessionConfig;
+
+// 打ち手 1 人分の結果
+typedef struct {
+    long long final_yen;            // 最終資金
+    long long max_drawdown_yen;     // 資産 (資金 + 持ちメダルの交換額) の最高値からの最大下落
+    int sessions_played;
+    bool ruined;
+} SessionPlayer;
+
+typedef struct {
+    long long players;
+    long long sessions;             // 打たれた日数の合計
+    long long games;
+    long long payout;               // 差枚の合計
+    long long end_counts[SESSION_END_COUNT];
+
+    // 1 日の収支 (円)
+    double session_mean_yen;
+    double session_sd_yen;
+    double session_win_rate;        // 収支がプラスの日の割合
+    long long session_q10_yen, session_q50_yen, session_q90_yen;
+
+    // 打ち手ごと
+    double ruin_rate;               // 破産した打ち手の割合
+    double final_mean_yen;
+    long long final_q10_yen, final_q50_yen, final_q90_yen;
+    double drawdown_mean_yen;
+    long long drawdown_q50_yen, drawdown_q90_yen, drawdown_q99_yen;
+} SessionResult;
+
+/**
+ * @brief 設定を既定値 (資金 10 万円、46 枚貸し / 5.6 枚交換、投資上限 3 万円、8000G) にします。
+ */
+void Session_InitConfig(SessionConfig* config);
+
+/**
+ * @brief 1 日の終了理由の表示名を返します。
+ */
+const char* Session_GetEndReasonName(SessionEndReason reason);
+
+/**
+ * @brief 打ち手を並列にシミュレーションします。Sim_InitTables 済みであること。
+ * @param players config->players 個の書き出し先 (NULL 可)
+ * @return 設定が不正・メモリ確保・スレッド作成に失敗した場合は false
+ */
+bool Session_Run(const SessionConfig* config, SessionResult* result, SessionPlayer* players);
+
+#endif // SESSION_H
@@ -0,0 +1,445 @@
+#include "sim.h"
+#include "at.h"
+#include "lottery.h"
+#include "normal.h"
+#include "cz.h"
+#include "rng.h"
+#include "spec.h"
+#include "weighted_table.h"
+#include <math.h>
+#include <string.h>
+
+// =================================================================
+// 無抽選ゲーム一括消化用カーネル
+// -----------------------------------------------------------------
+// ボーナス中の押順ベル/リプレイ/ハズレは差枚を進めるだけで抽選を伴わない。
+// 「次の抽選を伴う役までの無抽選ゲーム数 n」と「その n ゲームの合計差枚」の
+// 同時分布を 1 つのエイリアス表にしておき、乱数 1 回で次の抽選ゲームまで進める
+// (SKIP_BLOCK_MAX ゲーム以上続く分は「SKIP_BLOCK_MAX ゲーム進めて引き直し」の 1 枠)。
+// n ゲームの途中の差枚の最大値は (n, 合計差枚) から上から抑えられるので、その上限が
+// 目標差枚に届かなければまとめて適用する。届きうる場合だけ、合計差枚を条件に
+// 1 ゲームずつの差枚を引き直し (ブリッジ)、目標差枚に届くゲームを通常処理する。
+// =================================================================
+#define SKIP_BLOCK_MAX 32  // 同時分布の表に載せる最大ゲーム数
+#define SKIP_DIFF_SPAN 16  // 1ゲーム差枚の最大幅 (max - min)
+#define SKIP_RUN_STRIDE (SKIP_BLOCK_MAX * SKIP_DIFF_SPAN + 1)  // 同時分布の値 = n * STRIDE + 差枚の位置
+#define SKIP_RUN_DENOMINATOR (1ULL << 48)  // 同時分布の確率を整数の重みにする分母
+
+typedef struct {
+    YakuType yaku;
+    int diff;       // 1ゲームの差枚
+    int cumulative; // 条件付き抽選用の累積当選数
+} SkipYakuEntry;
+
+typedef struct {
+    bool enabled;                      // 差枚の幅が SKIP_DIFF_SPAN を超える場合は一括消化しない
+    double quiet_prob;                 // 1ゲームが無抽選となる確率
+    int min_diff, max_diff;            // 無抽選ゲーム1回の差枚の範囲
+
+    SkipYakuEntry quiet[YAKU_COUNT];   // 無抽選役 (条件付き抽選用)
+    int quiet_count;
+    SkipYakuEntry loud[YAKU_COUNT];    // 抽選を伴う役 (条件付き抽選用)
+    int loud_count;
+
+    // 無抽選ゲーム数 n と合計差枚 (n * min_diff + 位置) の同時分布。
+    // n == SKIP_BLOCK_MAX は「SKIP_BLOCK_MAX ゲーム以上無抽選が続く」
+    WeightedTable run_table;
+
+    // peak[n * STRIDE + 位置]: n ゲーム合計差枚 (n * min_diff + 位置) のときの途中の差枚の最大値の上限
+    short peak[(SKIP_BLOCK_MAX + 1) * SKIP_RUN_STRIDE];
+
+    int diff_pos[SKIP_DIFF_SPAN + 1];      // 1ゲーム差枚の位置 (確率が正のもの)
+    double diff_prob[SKIP_DIFF_SPAN + 1];  // その確率
+    int diff_count;
+
+    // pmf[n][k]: n ゲーム合計差枚が (n * min_diff + k) となる確率 (ブリッジ用)
+    double pmf[SKIP_BLOCK_MAX + 1][SKIP_BLOCK_MAX * SKIP_DIFF_SPAN + 1];
+} SkipKernel;
+
+static SkipKernel g_skip_kernels[LOTTERY_TABLE_COUNT];
+static bool g_tables_ready = false;
+
+// --- 内部ヘルパー関数 ---
+
+static LotteryTableId table_for_state(AT_State state) {
+    switch (state) {
+        case STATE_CZ:
+        case STATE_FRANXX_BONUS:
+            return LOTTERY_TABLE_FRANXX_HIGH_PROB;
+        default:
+            return LOTTERY_TABLE_NORMAL;
+    }
+}
+
+// AT中はナビに従う (押し順成功)、通常時/CZ中は順押し固定
+static bool sim_oshijun_success(const GameData* data, YakuType yaku) {
+    if (data->current_state >= STATE_BB_INITIAL) return true;
+    int push_order[3] = {0, 1, 2};
+    return CheckOshijun(yaku, push_order);
+}
+
+// n ゲーム合計 total の途中の差枚 S_j は j * max 以下、かつ total - (n - j) * min 以下
+static int run_peak(const SkipKernel* k, int n, int total) {
+    int peak = 0;
+    for (int j = 1; j <= n; j++) {
+        int up = j * k->max_diff;
+        int down = total - (n - j) * k->min_diff;
+        int bound = (up < down) ? up : down;
+        if (bound > peak) peak = bound;
+    }
+    return peak;
+}
+
+static bool build_skip_kernel(SkipKernel* k, LotteryTableId table, AT_State representative, const char* name) {
+    GameData probe;
+    memset(&probe, 0, sizeof(probe));
+    probe.current_state = representative;
+
+    WeightedTable_Free(&k->run_table);
+    memset(k, 0, sizeof(*k));
+    k->min_diff = 0;
+    k->max_diff = 0;
+
+    double pmf1[SKIP_DIFF_SPAN + 1] = {0};
+    int quiet_total = 0, loud_total = 0;
+    bool first = true;
+
+    for (int y = 0; y < YAKU_COUNT; y++) {
+        int w = Lottery_GetWeight(table, (YakuType)y);
+        if (w <= 0) continue;
+        if (AT_IsQuietGame(&probe, (YakuType)y)) {
+            int d = GetPayoutForYaku((YakuType)y, true) - BET_COUNT;
+            if (first || d < k->min_diff) k->min_diff = d;
+            if (first || d > k->max_diff) k->max_diff = d;
+            first = false;
+            quiet_total += w;
+            k->quiet[k->quiet_count].yaku = (YakuType)y;
+            k->quiet[k->quiet_count].diff = d;
+            k->quiet[k->quiet_count].cumulative = quiet_total;
+            k->quiet_count++;
+        } else {
+            loud_total += w;
+            k->loud[k->loud_count].yaku = (YakuType)y;
+            k->loud[k->loud_count].cumulative = loud_total;
+            k->loud_count++;
+        }
+    }
+    k->quiet_prob = (double)quiet_total / LOTTERY_DENOMINATOR;
+    k->enabled = quiet_total > 0 && loud_total > 0 && (k->max_diff - k->min_diff) <= SKIP_DIFF_SPAN;
+    if (!k->enabled) return true;
+
+    for (int i = 0; i < k->quiet_count; i++) {
+        YakuType y = k->quiet[i].yaku;
+        pmf1[k->quiet[i].diff - k->min_diff] += (double)Lottery_GetWeight(table, y) / quiet_total;
+    }
+    for (int j = 0; j <= SKIP_DIFF_SPAN; j++) {
+        if (pmf1[j] <= 0.0) continue;
+        k->diff_pos[k->diff_count] = j;
+        k->diff_prob[k->diff_count] = pmf1[j];
+        k->diff_count++;
+    }
+
+    // n ゲーム分の差枚分布を畳み込みで作成し、同時分布の重みを並べる
+    int span = k->max_diff - k->min_diff;
+    double loud_prob = (double)loud_total / LOTTERY_DENOMINATOR;
+    static WeightedEntry entries[(SKIP_BLOCK_MAX + 1) * SKIP_RUN_STRIDE];
+    int entry_count = 0;
+    double run_prob = 1.0; // quiet_prob^n
+    k->pmf[0][0] = 1.0;
+    for (int n = 0; n <= SKIP_BLOCK_MAX; n++) {
+        int width = n * span;
+        if (n > 0) {
+            for (int i = 0; i <= width - span; i++) {
+                if (k->pmf[n - 1][i] == 0.0) continue;
+                for (int j = 0; j <= span; j++) {
+                    k->pmf[n][i + j] += k->pmf[n - 1][i] * pmf1[j];
+                }
+            }
+            run_prob *= k->quiet_prob;
+        }
+
+        // n ゲーム無抽選の後に抽選ゲーム (最後の n は以降も続く分をまとめる)
+        double tail = (n < SKIP_BLOCK_MAX) ? loud_prob : 1.0;
+        for (int i = 0; i <= width; i++) {
+            int value = n * SKIP_RUN_STRIDE + i;
+            k->peak[value] = (short)run_peak(k, n, n * k->min_diff + i);
+            uint64_t w = (uint64_t)llround(run_prob * tail * k->pmf[n][i] * (double)SKIP_RUN_DENOMINATOR);
+            if (w == 0) continue;
+            entries[entry_count].value = value;
+            entries[entry_count].weight = w;
+            entry_count++;
+        }
+    }
+    return WeightedTable_Init(&k->run_table, name, entries, entry_count, 0);
+}
+
+static YakuType draw_from(const SkipYakuEntry* entries, int count) {
+    int r = Rng_Below(entries[count - 1].cumulative);
+    for (int i = 0; i < count; i++) {
+        if (r < entries[i].cumulative) return entries[i].yaku;
+    }
+    return entries[count - 1].yaku;
+}
+
+// 差枚が diff の無抽選役を引く
+static YakuType draw_quiet_with_diff(const SkipKernel* k, int diff) {
+    int total = 0, prev = 0;
+    for (int i = 0; i < k->quiet_count; i++) {
+        if (k->quiet[i].diff == diff) total += k->quiet[i].cumulative - prev;
+        prev = k->quiet[i].cumulative;
+    }
+    int r = Rng_Below(total);
+    prev = 0;
+    for (int i = 0; i < k->quiet_count; i++) {
+        int w = k->quiet[i].cumulative - prev;
+        prev = k->quiet[i].cumulative;
+        if (k->quiet[i].diff != diff) continue;
+        if (r < w) return k->quiet[i].yaku;
+        r -= w;
+    }
+    return k->quiet[k->quiet_count - 1].yaku;
+}
+
+static YakuType sim_draw_yaku(SimContext* ctx) {
+    const GameData* data = &ctx->data;
+    if (ctx->batch && ctx->draw_count < ctx->batch->dimensions) {
+        // 小役抽選は 16bit 値の純関数なので、抽選点の上位 16bit で引く
+        uint32_t u = QmcBatch_Point(ctx->batch, ctx->batch_index, ctx->draw_count++);
+        return Lottery_LookupTable(table_for_state(data->current_state), (int)(u >> 16));
+    }
+    switch (data->current_state) {
+        case STATE_BONUS_HIGH_PROB:
+            return Lottery_GetResult_AT();
+        case STATE_CZ:
+        case STATE_FRANXX_BONUS:
+            return Lottery_GetResult_FranxxHighProb();
+        default:
+            return Lottery_GetResult_Normal();
+    }
+}
+
+// 1ゲーム分 (レバーオン〜全停止) の処理
+static void sim_play_game(SimContext* ctx, YakuType yaku) {
+    GameData* data = &ctx->data;
+    AT_BonusResultType at_result = BONUS_NONE;
+    data->last_yaku = yaku;
+
+    // レバーオン (AT高確率はボーナス抽選。G数減算は Sim_ApplyATGame)
+    if (data->current_state == STATE_BONUS_HIGH_PROB) {
+        at_result = Lottery_CheckBonus_AT(yaku);
+        data->at_bonus_result = at_result;
+        data->at_last_lottery_yaku = yaku;
+    }
+
+    AT_State prev_state = data->current_state;
+
+    // 全停止
+    data->oshijun_success = sim_oshijun_success(data, yaku);
+    int diff = GetPayoutForYaku(yaku, data->oshijun_success) - BET_COUNT;
+    data->total_payout_diff += diff;
+    ctx->games++;
+
+    switch (data->current_state) {
+        case STATE_NORMAL:
+            Normal_Update(data, yaku);
+            break;
+        case STATE_CZ:
+            CZ_Update(data, yaku);
+            break;
+        default:
+            Sim_ApplyATGame(data, yaku, diff, at_result);
+            break;
+    }
+
+    // 通常時 / CZ からの遷移を集計
+    if (prev_state == STATE_NORMAL && data->current_state == STATE_CZ) {
+        ctx->cz_count++;
+    } else if ((prev_state == STATE_NORMAL || prev_state == STATE_CZ) && data->current_state >= STATE_BB_INITIAL) {
+        ctx->at_count++;
+        if (prev_state == STATE_CZ) ctx->cz_at_count++;
+        else if (data->normal_games >= Spec_Get()->normal_ceiling) ctx->ceiling_count++;
+    }
+}
+
+static bool sim_can_skip(const SimContext* ctx) {
+    const GameData* data = &ctx->data;
+    if (!ctx->options.event_skip || !g_tables_ready) return false;
+    if (ctx->batch && ctx->draw_count < ctx->batch->dimensions) return false;
+    if (data->current_bonus_payout >= data->target_bonus_payout) return false;
+    if (!g_skip_kernels[table_for_state(data->current_state)].enabled) return false;
+    return AT_IsQuietGame(data, YAKU_HAZURE);
+}
+
+static void sim_apply_quiet_block(SimContext* ctx, int games, int diff) {
+    ctx->data.current_bonus_payout += diff;
+    ctx->data.total_payout_diff += diff;
+    ctx->games += games;
+    ctx->skipped_games += games;
+}
+
+// 合計差枚の位置 pos が決まった無抽選ゲーム n 回を、合計を条件に 1 ゲームずつ差枚を引いてたどる。
+// 残りが目標差枚に届かなくなった時点でまとめて適用し、届くゲームだけ通常処理する。状態が変わった場合は false
+static bool sim_walk_quiet_games(SimContext* ctx, const SkipKernel* k, int n, int pos) {
+    GameData* data = &ctx->data;
+    AT_State state = data->current_state;
+    int block = 0, block_diff = 0;
+
+    for (int m = n; m > 0; m--) {
+        int remaining = data->target_bonus_payout - data->current_bonus_payout - block_diff;
+        if (k->peak[m * SKIP_RUN_STRIDE + pos] < remaining) {
+            // 残り m ゲームは途中でも届かない
+            block += m;
+            block_diff += m * k->min_diff + pos;
+            break;
+        }
+
+        // P(このゲームの位置 j | 残り m ゲームの合計位置 pos) = pmf1[j] * pmf[m-1][pos-j] / pmf[m][pos]
+        double u = Rng_NextDouble() * k->pmf[m][pos];
+        int pick = -1;
+        for (int i = 0; i < k->diff_count; i++) {
+            int j = k->diff_pos[i];
+            if (j > pos) break;
+            double p = k->diff_prob[i] * k->pmf[m - 1][pos - j];
+            if (p <= 0.0) continue;
+            pick = j;
+            u -= p;
+            if (u < 0.0) break;
+        }
+        pos -= pick;
+        int diff = k->min_diff + pick;
+
+        if (diff < remaining) {
+            block++;
+            block_diff += diff;
+            continue;
+        }
+        sim_apply_quiet_block(ctx, block, block_diff);
+        block = 0;
+        block_diff = 0;
+        sim_play_game(ctx, draw_quiet_with_diff(k, diff));
+        if (data->current_state != state || !sim_can_skip(ctx)) return false;
+    }
+    sim_apply_quiet_block(ctx, block, block_diff);
+    return true;
+}
+
+// 無抽選ゲームを一括消化し、次の抽選ゲームまで進める
+static int sim_skip_quiet_run(SimContext* ctx) {
+    GameData* data = &ctx->data;
+    const SkipKernel* k = &g_skip_kernels[table_for_state(data->current_state)];
+    long long start_games = ctx->games;
+
+    for (;;) {
+        // 次の抽選ゲームまでの無抽選ゲーム数と、その間の合計差枚を同時に引く
+        int value = WeightedTable_Sample(&k->run_table);
+        int n = value / SKIP_RUN_STRIDE;
+        int pos = value % SKIP_RUN_STRIDE;
+
+        if (k->peak[value] < data->target_bonus_payout - data->current_bonus_payout) {
+            // 途中でも目標差枚に届かない: まとめて適用
+            sim_apply_quiet_block(ctx, n, n * k->min_diff + pos);
+        } else if (!sim_walk_quiet_games(ctx, k, n, pos)) {
+            // 目標差枚に届いて状態が変わった: 以降の無抽選ゲームは使わない
+            return (int)(ctx->games - start_games);
+        }
+        if (n < SKIP_BLOCK_MAX) break;
+    }
+
+    sim_play_game(ctx, draw_from(k->loud, k->loud_count));
+    return (int)(ctx->games - start_games);
+}
+
+// --- 公開関数 ---
+
+bool Sim_InitTables(void) {
+    g_tables_ready = false;
+    if (!Lottery_InitTables() || !AT_InitTables() || !Normal_InitTables()) return false;
+    if (!build_skip_kernel(&g_skip_kernels[LOTTERY_TABLE_NORMAL], LOTTERY_TABLE_NORMAL, STATE_BB_HIGH_PROB,
+                           "一括消化/無抽選ゲーム数×差枚 (通常)") ||
+        !build_skip_kernel(&g_skip_kernels[LOTTERY_TABLE_FRANXX_HIGH_PROB], LOTTERY_TABLE_FRANXX_HIGH_PROB,
+                           STATE_FRANXX_BONUS, "一括消化/無抽選ゲーム数×差枚 (FRANXX高確率)")) {
+        return false;
+    }
+    g_tables_ready = true;
+    return true;
+}
+
+void Sim_Init(SimContext* ctx, const SimOptions* options) {
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->data.current_state = STATE_NORMAL;
+    if (options) {
+        ctx->options = *options;
+    }
+}
+
+void Sim_StartAT(SimContext* ctx) {
+    AT_Init(&ctx->data);
+}
+
+void Sim_SetSamplePoint(SimContext* ctx, const QmcBatch* batch, int index) {
+    ctx->batch = batch;
+    ctx->batch_index = index;
+    ctx->draw_count = 0;
+}
+
+int Sim_Step(SimContext* ctx) {
+    if (ctx->data.current_state == STATE_AT_END) {
+        Normal_Init(&ctx->data);
+    }
+    if (sim_can_skip(ctx)) {
+        return sim_skip_quiet_run(ctx);
+    }
+    sim_play_game(ctx, sim_draw_yaku(ctx));
+    return 1;
+}
+
+void Sim_PlayYaku(SimContext* ctx, YakuType yaku) {
+    sim_play_game(ctx, yaku);
+}
+
+void Sim_ApplyATGame(GameData* data, YakuType yaku, int diff, AT_BonusResultType bonus) {
+    switch (data->current_state) {
+        case STATE_BONUS_HIGH_PROB:
+            data->bonus_high_prob_games--;
+            if (bonus != BONUS_NONE && bonus != BONUS_AT_CONTINUE) {
+                AT_StartBonus(data, bonus);
+            } else if (data->bonus_high_prob_games <= 0) {
+                data->current_state = STATE_AT_END;
+            }
+            break;
+        case STATE_AT_END:
+            break;
+        default:
+            AT_Update(data, yaku, diff, false, true);
+            break;
+    }
+}
+
+long long Sim_RunUntilAT(SimContext* ctx, long long max_games) {
+    long long start_games = ctx->games;
+    if (ctx->data.current_state == STATE_AT_END) {
+        Normal_Init(&ctx->data);
+    }
+    while (ctx->data.current_state == STATE_NORMAL || ctx->data.current_state == STATE_CZ) {
+        if (max_games > 0 && ctx->games - start_games >= max_games) break;
+        Sim_Step(ctx);
+    }
+    return ctx->games - start_games;
+}
+
+long long Sim_RunAT(SimContext* ctx, long long max_games) {
+    long long start_games = ctx->games;
+    while (ctx->data.current_state != STATE_AT_END) {
+        if (max_games > 0 && ctx->games - start_games >= max_games) break;
+        Sim_Step(ctx);
+    }
+    return ctx->games - start_games;
+}
+
+long long Sim_RunGames(SimContext* ctx, long long games) {
+    long long start_games = ctx->games;
+    while (ctx->games - start_games < games) {
+        Sim_Step(ctx);
+    }
+    return ctx->games - start_games;
+}
@@ -0,0 +1,103 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include "game_data.h"
+#include "qmc.h"
+#include <stdbool.h>
+
+// =================================================================
+// ヘッドレス・シミュレーションエンジン
+// (Director のゲーム進行を描画・入力なしで再現する)
+// =================================================================
+
+// --- シミュレーション設定 ---
+typedef struct {
+    bool event_skip; // ボーナス中の無抽選ゲームを一括消化する
+} SimOptions;
+
+// --- シミュレーション実行コンテキスト (1台分) ---
+typedef struct {
+    GameData data;
+    SimOptions options;
+    long long games;         // 総消化ゲーム数
+    long long skipped_games; // うち一括消化したゲーム数
+
+    // 通常時の集計 (Sim_Init から累積)
+    long long at_count;      // AT当選回数
+    long long cz_count;      // CZ突入回数
+    long long cz_at_count;   // うち CZ から AT に当選した回数
+    long long ceiling_count; // 天井による AT 当選回数
+
+    // 層化 / 準モンテカルロ抽選 (NULL の場合は通常の乱数)
+    const QmcBatch* batch;
+    int batch_index;         // バッチ内の試行番号
+    int draw_count;          // この試行で消費した抽選点の数
+} SimContext;
+
+/**
+ * @brief 現在のスペックから共有テーブル (抽選テーブル・一括消化用の差枚分布など) を構築します。
+ * スレッドを起動する前に呼び出してください (Spec_Set でスペックを変更した場合は再度呼び出す)。
+ * @return 抽選テーブルの検証に失敗した場合は false
+ */
+bool Sim_InitTables(void);
+
+/**
+ * @brief コンテキストを通常時の初期状態にします。
+ * @param options NULL の場合は既定値
+ */
+void Sim_Init(SimContext* ctx, const SimOptions* options);
+
+/**
+ * @brief AT (BB[初当り]) から開始します。
+ */
+void Sim_StartAT(SimContext* ctx);
+
+/**
+ * @brief 以降の小役抽選の先頭 batch->dimensions 回を、バッチの index 番目の点で行います。
+ * 抽選点が残っている間は一括消化を行いません。
+ */
+void Sim_SetSamplePoint(SimContext* ctx, const QmcBatch* batch, int index);
+
+/**
+ * @brief 1 ステップ進めます (通常は 1 ゲーム、一括消化時は複数ゲーム)。
+ * AT終了状態の場合は通常時に戻してから進めます。
+ * @return 消化したゲーム数
+ */
+int Sim_Step(SimContext* ctx);
+
+/**
+ * @brief 成立役を指定して 1 ゲーム進めます (小役抽選・一括消化は行いません)。
+ * 以降の抽選 (ボーナス当否・上乗せなど) は通常どおり行います。
+ */
+void Sim_PlayYaku(SimContext* ctx, YakuType yaku);
+
+/**
+ * @brief AT中の 1 ゲームの状態遷移を適用します (Sim_Step / Sim_PlayYaku の AT部分)。
+ * 成立役・差枚・ボーナス抽選の結果を引数で受け取るため、ファズの入力列からも同じ手順で進められます。
+ * 上乗せ等の AT内部の抽選は通常どおり乱数で行います。
+ * @param bonus AT高確率中のボーナス抽選の結果 (Lottery_CheckBonus_AT。ほかの状態では無視)
+ */
+void Sim_ApplyATGame(GameData* data, YakuType yaku, int diff, AT_BonusResultType bonus);
+
+/**
+ * @brief 通常時 / CZ から AT に当選するまで進めます (AT終了状態からは通常時に戻して開始)。
+ * @param max_games 打ち切りゲーム数 (0 以下で無制限)
+ * @return 消化したゲーム数
+ */
+long long Sim_RunUntilAT(SimContext* ctx, long long max_games);
+
+/**
+ * @brief AT終了 (STATE_AT_END) まで進めます。
+ * @param max_games 打ち切りゲーム数 (0 以下で無制限)
+ * @return このAT中に消化したゲーム数
+ */
+long long Sim_RunAT(SimContext* ctx, long long max_games);
+
+/**
+ * @brief 通常時・CZ・AT を通して指定ゲーム数だけ進めます (ホールの 1 日分など)。
+ * 一括消化により最大で数十ゲーム超過することがあります。
+ * @return 消化したゲーム数
+ */
+long long Sim_RunGames(SimContext* ctx, long long games);
+
+#endif // SIM_H
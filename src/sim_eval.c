@@ -0,0 +1,286 @@
+#include "sim_eval.h"
+#include "at.h"
+#include "checkpoint.h"
+#include "parallel.h"
+#include "rng.h"
+#include "spec.h"
+#include <SDL2/SDL.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIM_EVAL_HIST_BINS 4096 // 0 〜 40950 枚 (超過分は最後のビン)
+
+// タスク 1 つ分の集計 (タスク番号の位置に書き込み、番号順に合算する)
+typedef struct {
+    EvalTotals totals;
+    long long over_1000;
+    int hist[SIM_EVAL_HIST_BINS];
+} EvalTask;
+
+typedef struct {
+    const EvalConfig* config;
+    int chunk;
+    EvalTask* tasks;
+} EvalJob;
+
+typedef struct {
+    const DayConfig* config;
+    DayTotals* days;
+    Checkpoint* checkpoint;   // NULL = チェックポイントなし
+    SDL_mutex* lock;          // チェックポイントの書き出しと結果の書き込みの排他
+} DayJob;
+
+// --- 内部ヘルパー関数 ---
+
+static void eval_task(int task_index, void* user) {
+    EvalJob* job = (EvalJob*)user;
+    EvalTask* task = &job->tasks[task_index];
+    long long first = (long long)task_index * job->chunk;
+    long long count = job->config->at_count - first;
+    if (count > job->chunk) count = job->chunk;
+
+    EvalTotals* totals = &task->totals;
+    for (long long n = 0; n < count; n++) {
+        // AT ごとに乱数列を分け、スペック間で同じ番号の AT が同じ乱数列から始まるようにする
+        Rng_SeedStream(job->config->seed, (uint64_t)(first + n));
+        SimContext ctx;
+        Sim_Init(&ctx, &job->config->options);
+        if (job->config->from_normal) {
+            Sim_RunUntilAT(&ctx, SIM_EVAL_NORMAL_MAX_GAMES);
+            totals->normal_games += ctx.games;
+            totals->normal_payout += ctx.data.total_payout_diff;
+            if (ctx.data.current_state == STATE_NORMAL || ctx.data.current_state == STATE_CZ) {
+                continue; // 打ち切り (AT非当選)
+            }
+        } else {
+            Sim_StartAT(&ctx);
+        }
+        long long normal_games = ctx.games;
+        long long normal_payout = ctx.data.total_payout_diff;
+        Sim_RunAT(&ctx, 0);
+
+        long long payout = ctx.data.total_payout_diff - normal_payout;
+        long long bin = payout / SIM_EVAL_HIST_STEP;
+        if (bin < 0) bin = 0;
+        if (bin >= SIM_EVAL_HIST_BINS) bin = SIM_EVAL_HIST_BINS - 1;
+        task->hist[bin]++;
+        if (payout >= 1000) task->over_1000++;
+        totals->games += ctx.games - normal_games;
+        totals->payout += payout;
+        totals->at_count++;
+    }
+}
+
+static void day_task(int task_index, void* user) {
+    DayJob* job = (DayJob*)user;
+    if (Checkpoint_IsDone(job->checkpoint, task_index)) return; // 前回の実行で完了済み
+
+    Rng_SeedStream(job->config->seed, (uint64_t)task_index);
+    SimContext ctx;
+    Sim_Init(&ctx, &job->config->options);
+    Sim_RunGames(&ctx, job->config->games_per_day);
+
+    DayTotals day;
+    day.games = ctx.games;
+    day.payout = ctx.data.total_payout_diff;
+    day.at_count = ctx.at_count;
+    day.cz_count = ctx.cz_count;
+    day.cz_at_count = ctx.cz_at_count;
+    day.ceiling_count = ctx.ceiling_count;
+
+    if (!job->checkpoint) {
+        job->days[task_index] = day;
+        return;
+    }
+    // 書き出し中の結果の配列を書き換えないようにする
+    SDL_LockMutex(job->lock);
+    job->days[task_index] = day;
+    Checkpoint_MarkDone(job->checkpoint, task_index);
+    SDL_UnlockMutex(job->lock);
+}
+
+// 結果に影響する設定のハッシュ (スレッド数は含めない)
+static uint64_t hash_day_config(const DayConfig* config) {
+    uint64_t hash = Checkpoint_HashValue(0, Spec_GetHash(Spec_Get()));
+    hash = Checkpoint_HashValue(hash, (uint64_t)config->days);
+    hash = Checkpoint_HashValue(hash, (uint64_t)config->games_per_day);
+    hash = Checkpoint_HashValue(hash, config->seed);
+    return Checkpoint_HashValue(hash, config->options.event_skip ? 1 : 0);
+}
+
+static int compare_long_long(const void* a, const void* b) {
+    long long x = *(const long long*)a, y = *(const long long*)b;
+    return (x > y) - (x < y);
+}
+
+static int hist_quantile(const long long* hist, long long total, double q) {
+    long long target = (long long)ceil(q * total);
+    long long cumulative = 0;
+    for (int i = 0; i < SIM_EVAL_HIST_BINS; i++) {
+        cumulative += hist[i];
+        if (cumulative >= target) return i * SIM_EVAL_HIST_STEP;
+    }
+    return (SIM_EVAL_HIST_BINS - 1) * SIM_EVAL_HIST_STEP;
+}
+
+// --- 公開関数 ---
+
+double SimEval_GetRtp(long long games, long long payout) {
+    double in = (double)games * BET_COUNT;
+    return in > 0 ? (in + payout) / in : 0.0;
+}
+
+int SimEval_GetTaskCount(const EvalConfig* config) {
+    if (config->at_count <= 0) return 0;
+    int chunk = config->chunk > 0 ? config->chunk : SIM_EVAL_DEFAULT_CHUNK;
+    return (int)((config->at_count + chunk - 1) / chunk);
+}
+
+bool SimEval_Run(const EvalConfig* config, EvalResult* result) {
+    return SimEval_RunTasks(config, result, NULL);
+}
+
+bool SimEval_RunTasks(const EvalConfig* config, EvalResult* result, EvalTotals* task_totals) {
+    memset(result, 0, sizeof(*result));
+    if (config->at_count <= 0) return true;
+
+    int chunk = config->chunk > 0 ? config->chunk : SIM_EVAL_DEFAULT_CHUNK;
+    int task_count = SimEval_GetTaskCount(config);
+    EvalJob job;
+    job.config = config;
+    job.chunk = chunk;
+    job.tasks = (EvalTask*)calloc((size_t)task_count, sizeof(EvalTask));
+    if (!job.tasks) {
+        fprintf(stderr, "SimEval: メモリ確保に失敗しました\n");
+        return false;
+    }
+    if (!Parallel_Run(task_count, config->threads, eval_task, &job)) {
+        free(job.tasks);
+        return false;
+    }
+
+    // タスク番号順に合算 (スレッド数によらず同じ結果)
+    long long hist[SIM_EVAL_HIST_BINS] = {0};
+    long long over_1000 = 0;
+    double rtp_sum = 0.0, rtp_sq_sum = 0.0;
+    double pay_sum = 0.0, pay_sq_sum = 0.0;
+    long long full_tasks = 0;
+    for (int t = 0; t < task_count; t++) {
+        const EvalTotals* task = &job.tasks[t].totals;
+        if (task_totals) task_totals[t] = *task;
+        result->at_count += task->at_count;
+        result->games += task->games;
+        result->payout += task->payout;
+        result->normal_games += task->normal_games;
+        result->normal_payout += task->normal_payout;
+        over_1000 += job.tasks[t].over_1000;
+        for (int i = 0; i < SIM_EVAL_HIST_BINS; i++) hist[i] += job.tasks[t].hist[i];
+
+        // 端数のタスクはバッチ平均の分散推定から除く
+        if ((long long)(t + 1) * chunk <= config->at_count && task->at_count > 0) {
+            double rtp = SimEval_GetRtp(task->games, task->payout);
+            double mean = (double)task->payout / task->at_count;
+            rtp_sum += rtp;
+            rtp_sq_sum += rtp * rtp;
+            pay_sum += mean;
+            pay_sq_sum += mean * mean;
+            full_tasks++;
+        }
+    }
+    free(job.tasks);
+
+    if (result->at_count == 0) return true;
+    result->rtp = SimEval_GetRtp(result->games, result->payout);
+    result->mean_payout = (double)result->payout / result->at_count;
+    result->mean_games = (double)result->games / result->at_count;
+    result->p_over_1000 = (double)over_1000 / result->at_count;
+    if (config->from_normal) {
+        result->hit_rate = result->normal_games > 0 ? (double)result->at_count / result->normal_games : 0.0;
+        result->total_rtp = SimEval_GetRtp(result->games + result->normal_games,
+                                           result->payout + result->normal_payout);
+    }
+    result->q50 = hist_quantile(hist, result->at_count, 0.5);
+    result->q90 = hist_quantile(hist, result->at_count, 0.9);
+    if (full_tasks >= 2) {
+        double m = rtp_sum / full_tasks;
+        double var = (rtp_sq_sum - full_tasks * m * m) / (full_tasks - 1);
+        result->rtp_se = sqrt(var > 0 ? var / full_tasks : 0.0);
+        m = pay_sum / full_tasks;
+        var = (pay_sq_sum - full_tasks * m * m) / (full_tasks - 1);
+        result->payout_se = sqrt(var > 0 ? var / full_tasks : 0.0);
+    }
+    return true;
+}
+
+bool SimEval_RunDays(const DayConfig* config, DayResult* result, DayTotals* day_totals) {
+    memset(result, 0, sizeof(*result));
+    if (config->days <= 0) return true;
+
+    DayJob job;
+    memset(&job, 0, sizeof(job));
+    job.config = config;
+    job.days = (DayTotals*)calloc((size_t)config->days, sizeof(DayTotals));
+    long long* payouts = (long long*)malloc(sizeof(long long) * (size_t)config->days);
+    if (!job.days || !payouts) {
+        fprintf(stderr, "SimEval: メモリ確保に失敗しました\n");
+        free(job.days);
+        free(payouts);
+        return false;
+    }
+    bool ok = true;
+    if (config->checkpoint_path) {
+        CheckpointLayout layout = {
+            .kind = "day",
+            .config_hash = hash_day_config(config),
+            .task_count = (int)config->days,
+            .records = job.days,
+            .record_size = sizeof(DayTotals),
+        };
+        job.checkpoint = Checkpoint_Open(config->checkpoint_path, &layout, config->checkpoint_interval);
+        job.lock = SDL_CreateMutex();
+        ok = job.checkpoint && job.lock;
+        if (ok && Checkpoint_GetDoneCount(job.checkpoint) > 0) {
+            fprintf(stderr, "SimEval: %s から再開します (%d / %lld 日完了済み)\n",
+                    config->checkpoint_path, Checkpoint_GetDoneCount(job.checkpoint), config->days);
+        }
+        for (long long d = 0; ok && d < config->days; d++) {
+            if (Checkpoint_IsDone(job.checkpoint, (int)d)) result->resumed_games += job.days[d].games;
+        }
+    }
+    if (ok) ok = Parallel_Run((int)config->days, config->threads, day_task, &job);
+    if (job.checkpoint && !Checkpoint_Close(job.checkpoint)) ok = false;
+    if (job.lock) SDL_DestroyMutex(job.lock);
+
+    // 日番号順に合算
+    DayTotals* total = &result->total;
+    double sum = 0.0, sq_sum = 0.0;
+    for (long long d = 0; ok && d < config->days; d++) {
+        const DayTotals* day = &job.days[d];
+        if (day_totals) day_totals[d] = *day;
+        total->games += day->games;
+        total->payout += day->payout;
+        total->at_count += day->at_count;
+        total->cz_count += day->cz_count;
+        total->cz_at_count += day->cz_at_count;
+        total->ceiling_count += day->ceiling_count;
+        sum += (double)day->payout;
+        sq_sum += (double)day->payout * day->payout;
+        payouts[d] = day->payout;
+    }
+    if (ok) {
+        long long n = config->days;
+        result->rtp = SimEval_GetRtp(total->games, total->payout);
+        result->payout_mean = sum / n;
+        double var = n > 1 ? (sq_sum - n * result->payout_mean * result->payout_mean) / (n - 1) : 0.0;
+        result->payout_sd = sqrt(var > 0 ? var : 0.0);
+        qsort(payouts, (size_t)n, sizeof(long long), compare_long_long);
+        result->payout_q10 = payouts[(n - 1) / 10];
+        result->payout_q50 = payouts[(n - 1) / 2];
+        result->payout_q90 = payouts[(n - 1) * 9 / 10];
+    }
+    free(job.days);
+    free(payouts);
+    return ok;
+}
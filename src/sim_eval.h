@@ -0,0 +1,124 @@
+#ifndef SIM_EVAL_H
+#define SIM_EVAL_H
+
+#include "sim.h"
+#include <stdbool.h>
+
+// =================================================================
+// 並列 AT 評価
+// -----------------------------------------------------------------
+// AT初当りから終了までを at_count 回シミュレーションし、出玉率と
+// 差枚分布を集計する。ATは chunk 回ずつのタスクに分けて並列に実行し、
+// i 回目の AT は Rng_SeedStream(seed, i) の乱数列を使う。
+// このため結果はスレッド数に依存せず、同じシードで評価したスペック同士は
+// 共通乱数 (common random numbers) で比較される。
+// =================================================================
+
+#define SIM_EVAL_DEFAULT_CHUNK 1024
+#define SIM_EVAL_NORMAL_MAX_GAMES 1000000 // 通常時の打ち切りゲーム数 (AT非当選扱い)
+
+typedef struct {
+    long long at_count;
+    unsigned long long seed;
+    int threads;   // 0 以下で既定値 (論理 CPU 数)
+    int chunk;     // 1 タスクあたりのAT回数 (0 以下で既定値)
+    SimOptions options;
+    bool from_normal; // 各ATの前に通常時 (AT当選まで) もシミュレーションする
+} EvalConfig;
+
+// タスク単位の集計 (共通乱数での差分の標準誤差などに使う)
+typedef struct {
+    long long at_count;
+    long long games;         // AT中のゲーム数
+    long long payout;        // AT中の獲得差枚
+    long long normal_games;  // 通常時のゲーム数 (from_normal のみ)
+    long long normal_payout; // 通常時の差枚 (from_normal のみ)
+} EvalTotals;
+
+typedef struct {
+    long long at_count;
+    long long games;        // AT中の総消化ゲーム数
+    long long payout;       // AT中の総獲得差枚
+    double rtp;             // AT中の出玉率 (OUT / IN)
+    double rtp_se;          // 出玉率の標準誤差 (タスク単位のバッチ平均から算出)
+    double mean_payout;     // ATあたりの平均獲得差枚
+    double payout_se;
+    double mean_games;      // ATあたりの平均ゲーム数
+    double p_over_1000;     // 獲得差枚 1000 枚以上の割合
+    int q50, q90;           // 獲得差枚の中央値 / 90% 点 (SIM_EVAL_HIST_STEP 枚単位)
+
+    // from_normal のみ
+    long long normal_games;
+    long long normal_payout;
+    double hit_rate;        // AT初当り確率 (通常時 1G あたり)
+    double total_rtp;       // 通常時 + AT の機械割
+} EvalResult;
+
+#define SIM_EVAL_HIST_STEP 10
+
+/**
+ * @brief 現在のスペックで AT を評価します。
+ * Sim_InitTables 済みであること。評価中にスペックを変更しないでください。
+ * @return メモリ確保・スレッド作成に失敗した場合は false
+ */
+bool SimEval_Run(const EvalConfig* config, EvalResult* result);
+
+/**
+ * @brief SimEval_Run と同じ評価を行い、タスク単位の集計も返します。
+ * @param task_totals SimEval_GetTaskCount 個の書き出し先 (NULL 可)
+ */
+bool SimEval_RunTasks(const EvalConfig* config, EvalResult* result, EvalTotals* task_totals);
+
+/**
+ * @brief ゲーム数と差枚から出玉率 (OUT / IN) を求めます。
+ */
+double SimEval_GetRtp(long long games, long long payout);
+
+/**
+ * @brief 評価で使うタスク数 (EvalTotals の個数) を返します。
+ */
+int SimEval_GetTaskCount(const EvalConfig* config);
+
+// =================================================================
+// 1 日単位の評価 (通常時・CZ・AT を通して games_per_day ゲーム)
+// 日 d は Rng_SeedStream(seed, d) の乱数列を使い、日ごとの結果を番号順に集計する。
+// =================================================================
+typedef struct {
+    long long days;
+    long long games_per_day;
+    unsigned long long seed;
+    int threads;
+    SimOptions options;
+    const char* checkpoint_path;  // NULL でチェックポイントなし (同じファイルがあれば続きから)
+    double checkpoint_interval;   // 書き出し間隔 [秒] (0 以下で既定値)
+} DayConfig;
+
+// 1 日分の結果
+typedef struct {
+    long long games;
+    long long payout;        // 差枚
+    long long at_count;
+    long long cz_count;
+    long long cz_at_count;
+    long long ceiling_count;
+} DayTotals;
+
+typedef struct {
+    DayTotals total;         // 全日の合計
+    double rtp;              // 機械割
+    double payout_mean;      // 1 日の平均差枚
+    double payout_sd;        // 1 日の差枚の標準偏差
+    long long payout_q10, payout_q50, payout_q90;
+    long long resumed_games; // チェックポイントから読み戻した日のゲーム数 (今回は打っていない分)
+} DayResult;
+
+/**
+ * @brief 1 日単位のシミュレーションを並列に行います。
+ * checkpoint_path を指定すると完了した日の結果を一定間隔で書き出し、再実行時は残りの日だけ打ちます
+ * (日ごとに乱数列が決まっているため、中断しなかった場合と同じ結果になる)。
+ * @param day_totals days 個の書き出し先 (NULL 可)
+ * @return メモリ確保・スレッド作成・チェックポイントの読み書きに失敗した場合は false
+ */
+bool SimEval_RunDays(const DayConfig* config, DayResult* result, DayTotals* day_totals);
+
+#endif // SIM_EVAL_H
@@ -0,0 +1,1434 @@
+/*
+ * src/sim_main.c (ヘッドレス・シミュレータ CLI)
+ *
+ * 使い方:
+ *   sim [--spec spec.cfg] [--cpus 0-3,6] [--priority low|normal|high] <コマンド> ...
+ *   sim run [-n AT回数] [-s シード] [--skip] [--sampling iid|strat|sobol] [--batch N] [--dims D] [--checkpoint FILE]
+ *   sim tables
+ *   sim bbex [-r 継続率]
+ *   sim spec
+ *   sim sens [-p 名前 ...] [-n AT回数] [-s シード] [-t スレッド数] [--step 相対刻み] [--normal] [--top N] [--skip]
+ *   sim sweep -p 名前=下限:上限[:刻み] ... (--target-rtp 出玉率% | --target-payout 枚) [-n AT回数] [-s シード] [-t スレッド数] [--search grid|coord] [--top N] [--skip]
+ *   sim day [-d 日数] [-g 1日のゲーム数] [-s シード] [-t スレッド数] [--skip] [--checkpoint FILE]
+ *   sim seek -g 目標 [-s 開始シード] [-n シード数] [-k 件数] [--max-games G] [--lead N] [-t スレッド数] [-o スクリプト]
+ *   sim fuzz [-n ケース数] [-s シード] [-t スレッド数] [--stuck 手数]
+ *   sim conform [-n 抽選回数] [-s シード] [-t スレッド数] [-a 有意水準] [-f 名前]
+ *   sim session [-p 人数] [-d 日数] [--bankroll 円] [--stop-loss 円] [--take-profit 枚] [--quit-after-at] ...
+ *   sim hall [-m 台数] [--setting 番号:spec.cfg:比率 ...] [-o 列形式ファイル] [--csv ファイル] ...
+ *   sim value [-o 価値表ファイル] [-t スレッド数] [-n 検証AT回数] [-s シード]
+ *   sim episode [-n AT回数] [-s シード] [-t スレッド数] [--hp G]
+ *   sim digest [-n AT回数] [-d 日数] [-s シード] [-t スレッド数]
+ *   sim pace [-m media.cfg] [-d 日数] [-g 1日のゲーム数] [-s シード] [-t スレッド数] [--skip]
+ *   sim pres [--csv ファイル|-]
+ */
+
+#define SDL_MAIN_HANDLED // SDL の main 置き換えを無効化 (描画なし)
+
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <SDL2/SDL.h>
+
+#include "sim.h"
+#include "at.h"
+#include "at_value.h"
+#include "checkpoint.h"
+#include "rng.h"
+#include "conform.h"
+#include "episode.h"
+#include "fuzz.h"
+#include "hall.h"
+#include "lottery.h"
+#include "pace.h"
+#include "pres_odds.h"
+#include "pres_table.h"
+#include "parallel.h"
+#include "seek.h"
+#include "sensitivity.h"
+#include "session.h"
+#include "sim_eval.h"
+#include "spec.h"
+#include "sweep.h"
+#include "thread_config.h"
+#include "weighted_table.h"
+
+#define DAY_DEFAULT_DAYS 10000
+#define DAY_DEFAULT_GAMES 8000
+#define SEEK_DEFAULT_LEAD 5
+#define SEEK_MAX_WANT 1000
+#define CONFORM_DEFAULT_SAMPLES 10000000LL
+#define CONFORM_DEFAULT_ALPHA 1e-6
+#define VALUE_DEFAULT_PATH "at_value.bin"
+#define PACE_DEFAULT_MEDIA "media.cfg"
+#define PACE_DEFAULT_DAYS 1000
+
+static void print_usage(void) {
+    fprintf(stderr,
+        "usage: sim [--spec spec.cfg] [--cpus CPUリスト] [--priority low|normal|high|time_critical] <コマンド>\n"
+        "       sim run [-n AT回数] [-s シード] [--skip] [--sampling iid|strat|sobol] [--batch N] [--dims D]\n"
+        "               [--checkpoint FILE [--checkpoint-interval 秒]]\n"
+        "       sim tables\n"
+        "       sim bbex [-r 継続率]\n"
+        "       sim spec\n"
+        "       sim sens [-p 名前 ...] [-n AT回数] [-s シード] [-t スレッド数] [--step 相対刻み] [--normal] [--top N] [--skip]\n"
+        "       sim sweep -p 名前=下限:上限[:刻み] ... (--target-rtp 出玉率%% | --target-payout 枚)\n"
+        "                 [-n AT回数] [-s シード] [-t スレッド数] [--search grid|coord] [--top N] [--skip]\n"
+        "       sim day [-d 日数] [-g 1日のゲーム数] [-s シード] [-t スレッド数] [--skip]\n"
+        "               [--checkpoint FILE [--checkpoint-interval 秒]]\n"
+        "       sim seek -g bbex3000|ep-maxx|tsuredashi|ceiling [-s 開始シード] [-n シード数] [-k 件数]\n"
+        "                [--max-games G] [--lead N] [-t スレッド数] [-o スクリプト]\n"
+        "       sim fuzz [-n ケース数] [-s シード] [-t スレッド数] [--stuck 手数]\n"
+        "       sim conform [-n 抽選回数] [-s シード] [-t スレッド数] [-a 有意水準] [-f 名前]\n"
+        "       sim session [-p 人数] [-d 日数] [-g 1日の最大ゲーム数] [--bankroll 円] [--lend 枚] [--exchange 枚]\n"
+        "                   [--stop-loss 円] [--take-profit 枚] [--quit-after-at] [-s シード] [-t スレッド数]\n"
+        "       sim hall [-m 台数] [--setting 番号:spec.cfg:比率 ...] [--open 分] [--gpm G/分] [--idle 分]\n"
+        "                [--play-games G] [--stop-loss 枚] [--at-quit 確率] [-o 列形式ファイル] [--csv ファイル|-]\n"
+        "                [-s シード] [-t スレッド数] [--skip]\n"
+        "       sim value [-o 価値表ファイル] [-t スレッド数] [-n 検証AT回数] [-s シード]\n"
+        "       sim episode [-n AT回数] [-s シード] [-t スレッド数] [--hp G]\n"
+        "       sim digest [-n AT回数] [-d 日数] [-s シード] [-t スレッド数]\n"
+        "       sim pace [-m media.cfg] [-d 日数] [-g 1日のゲーム数] [-s シード] [-t スレッド数] [--skip]\n"
+        "       sim pres [--csv ファイル|-]\n"
+        "  --spec  機種スペックファイル (省略時は組み込みの既定スペック。キャッシュは <file>.bin)\n"
+        "  --cpus  並列ワーカーを固定する CPU (0-3,6 の形式。ワーカーごとに 1 つずつ割り当てる)\n"
+        "  --priority 並列ワーカーの優先度\n"
+        "  -n      シミュレーションするAT回数 (既定: 100000)\n"
+        "  -s      乱数シード (既定: 時刻)\n"
+        "  --skip  ボーナス中の無抽選ゲームを一括消化する\n"
+        "  --sampling  小役抽選の抽選点 (iid: 独立乱数 / strat: 層化 / sobol: スクランブルSobol列)\n"
+        "  --batch 抽選点を共有するAT回数 (既定: 1024、標準誤差はバッチ平均から算出)\n"
+        "  --dims  ATごとに抽選点で置き換える小役抽選の回数 (既定: %d)\n"
+        "  --checkpoint  途中経過を FILE に一定間隔 (--checkpoint-interval、既定 %.0f 秒) で書き出し、\n"
+        "          同じ設定で再実行すると続きから再開する (run / day のみ。sweep / sens / hall などは未対応。\n"
+        "          結果は中断しなかった場合と同じ)\n"
+        "  tables  構築済みの抽選テーブルを一覧表示する\n"
+        "  bbex    BB EX 獲得枚数の厳密な分布を表示する (-r 省略時は継続率振り分け込み)\n"
+        "  spec    現在のスペックを spec ファイル形式で出力する\n"
+        "  sens    各パラメータを基準値の ±相対刻み (既定 0.1) 動かし、共通乱数の中心差分で\n"
+        "          出玉率・平均獲得差枚・AT初当り確率 (--normal 時) への感度を表示する (-p 省略時は全確率パラメータ)\n"
+        "  sweep   スペックのパラメータを動かしてATを並列評価し、目標に近い設定を信頼区間付きで表示する\n"
+        "          (-p は最大 %d 個。名前は Lottery.Normal.REPLAY / BonusAT.COMMON_BELL.success /\n"
+        "           AT.BB_EX_CONTINUE_RATE.1 など、spec.h の Spec_SetParam を参照)\n"
+        "  day     通常時・CZ・AT を通した 1 日 (既定 8000 G、%d 日) の稼働を並列にシミュレーションし、\n"
+        "          機械割・初当り確率・CZ成功率・天井到達率・1 日の差枚分布を表示する\n"
+        "  seek    目標の展開に到達するシードを並列に探す。本体を --seed S --warp W で起動すると\n"
+        "          到達の --lead (既定 %d) ゲーム前から打てる。-o で停止手順のスクリプトを書き出す\n"
+        "  fuzz    ランダムな成立役・差枚で AT の状態遷移を回し、不変条件 (差枚・G数・比翼BEATS の範囲、\n"
+        "          未到達・抜けられない状態) を検査する。違反時は入力列を縮小して表示し、終了コード 1\n"
+        "  conform 乱数・小役抽選・ボーナス抽選・登録済みテーブルから各 -n 回 (既定 %lld) 抽選し、\n"
+        "          期待確率とのカイ二乗検定・二項検定の p 値を表示する。-a (既定 %g) で棄却されれば終了コード 1\n"
+        "  session 資金 (--bankroll) を持った打ち手を並列にシミュレーションし、1 日の収支・最大下落・破産確率を表示する。\n"
+        "          1000 円で --lend 枚借り、--exchange 枚を 1000 円で交換。1 日の投資が --stop-loss 円に達するか、\n"
+        "          持ちメダルが --take-profit 枚に達するか、(--quit-after-at 時) AT が終わればヤメ\n"
+        "  hall    ホール全台の 1 日 (営業 --open 分) を客の着席・離席込みで並列にシミュレーションし、\n"
+        "          台ごとのデータ (G数・AT・ボーナス・差枚) を -o に列形式で、--csv に CSV で書き出す。\n"
+        "          --setting で設定ごとのスペックと台数比率を指定する (省略時は現在のスペックのみ)\n"
+        "  value   AT中の状態ごとの残り獲得差枚の期待値・分散を動的計画法で求め、-o (既定 %s) に書き出す。\n"
+        "          -n を指定すると AT開始時の値をその回数のシミュレーションと比較する\n"
+        "  episode AT を 1 回単位で並列にサンプリングし、連チャン数の分布・ボーナスの内訳・獲得差枚の分位点・\n"
+        "          比翼BEATS の突入率と最高レベルを表示する (--hp でボーナス高確率 残りG G から開始)\n"
+        "  digest  AT評価・1 日単位の稼働・AT単位のサンプリングを 1 / -t / 2×-t+1 スレッドで実行し、結果のビット列の\n"
+        "          ハッシュを表示する (既定 -n 20000 -d 1000 -s 1)。スレッド数で一致しなければ終了コード 1。\n"
+        "          変更前後のハッシュを比べれば、エンジンの最適化で結果が変わっていないことを厳密に確認できる\n"
+        "  pace    1 日単位の稼働に、-m (既定 %s) の動画の長さと [Timing] の操作時間・ウェイトを割り当て、\n"
+        "          実時間での 1G の秒数・時速 (G/時・差枚/時) と時間の内訳を表示する (既定 %d 日)\n"
+        "  pres    AT高確率の演出ペア・成立役ごとの演出ペア・当落演出について、出現率と期待度 (当選の事後確率)・\n"
+        "          ボーナスの内訳を抽選テーブルと演出の振り分けから厳密に求めて表示し、--csv に CSV で書き出す\n",
+        QMC_MAX_DIMENSIONS, CHECKPOINT_DEFAULT_INTERVAL, SWEEP_MAX_PARAMS, DAY_DEFAULT_DAYS, SEEK_DEFAULT_LEAD,
+        CONFORM_DEFAULT_SAMPLES, CONFORM_DEFAULT_ALPHA, VALUE_DEFAULT_PATH, PACE_DEFAULT_MEDIA, PACE_DEFAULT_DAYS);
+}
+
+// 処理時間と速度。チェックポイントから再開した場合は今回打った分だけで速度を求める
+static void print_elapsed(double elapsed, long long games, bool resumed) {
+    printf("処理時間      : %.3f 秒 (%s%.0f G/秒)\n", elapsed, resumed ? "再開後の " : "",
+           elapsed > 0 ? games / elapsed : 0.0);
+}
+
+// --- sim run: AT初当りから終了までを繰り返し集計 ---
+
+// sim run の途中経過 (バッチの境界でチェックポイントに書き出す)
+typedef struct {
+    long long next_batch;
+    RngState rng;                // 次のバッチの開始時点の乱数状態
+    long long total_games;
+    long long skipped_games;
+    long long total_payout;
+    // バッチ平均の分散 (標準誤差の推定用)
+    double batch_sum, batch_sq_sum;
+    long long batch_count;
+} RunProgress;
+
+static uint64_t hash_run_config(long long at_count, unsigned long long seed, const SimOptions* options,
+                                QmcMode sampling, int batch_size, int dimensions) {
+    uint64_t hash = Checkpoint_HashValue(0, Spec_GetHash(Spec_Get()));
+    hash = Checkpoint_HashValue(hash, (uint64_t)at_count);
+    hash = Checkpoint_HashValue(hash, seed);
+    hash = Checkpoint_HashValue(hash, options->event_skip ? 1 : 0);
+    hash = Checkpoint_HashValue(hash, (uint64_t)sampling);
+    hash = Checkpoint_HashValue(hash, (uint64_t)batch_size);
+    return Checkpoint_HashValue(hash, (uint64_t)dimensions);
+}
+
+static int cmd_run(int argc, char* argv[]) {
+    long long at_count = 100000;
+    unsigned long long seed = (unsigned long long)time(NULL);
+    SimOptions options = {0};
+    QmcMode sampling = QMC_MODE_IID;
+    int batch_size = 1024;
+    int dimensions = QMC_MAX_DIMENSIONS;
+    const char* checkpoint_path = NULL;
+    double checkpoint_interval = 0.0;
+
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            at_count = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--skip") == 0) {
+            options.event_skip = true;
+        } else if (strcmp(argv[i], "--sampling") == 0 && i + 1 < argc && Qmc_ParseMode(argv[i + 1], &sampling)) {
+            i++;
+        } else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            batch_size = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--dims") == 0 && i + 1 < argc) {
+            dimensions = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) {
+            checkpoint_path = argv[++i];
+        } else if (strcmp(argv[i], "--checkpoint-interval") == 0 && i + 1 < argc) {
+            checkpoint_interval = atof(argv[++i]);
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+    if (at_count <= 0 || batch_size <= 0 || (at_count + batch_size - 1) / batch_size > INT_MAX) {
+        print_usage();
+        return 1;
+    }
+    long long batches = (at_count + batch_size - 1) / batch_size;
+
+    RunProgress progress;
+    memset(&progress, 0, sizeof(progress));
+    Rng_Seed(seed);
+    Rng_GetState(&progress.rng);
+
+    Checkpoint* checkpoint = NULL;
+    if (checkpoint_path) {
+        CheckpointLayout layout = {
+            .kind = "run",
+            .config_hash = hash_run_config(at_count, seed, &options, sampling, batch_size, dimensions),
+            .task_count = (int)batches,
+            .shared = &progress,
+            .shared_size = sizeof(progress),
+        };
+        checkpoint = Checkpoint_Open(checkpoint_path, &layout, checkpoint_interval);
+        if (!checkpoint) {
+            return 1;
+        }
+        if (progress.next_batch > 0) {
+            fprintf(stderr, "%s から再開します (%lld / %lld バッチ完了済み)\n", checkpoint_path, progress.next_batch, batches);
+        }
+        Rng_SetState(&progress.rng);
+    }
+    long long resumed_games = progress.total_games; // 速度は今回打った分だけで求める
+    clock_t start = clock();
+
+    for (long long b = progress.next_batch; b < batches; b++) {
+        long long n = b * batch_size;
+        int size = (at_count - n < batch_size) ? (int)(at_count - n) : batch_size;
+        QmcBatch batch;
+        if (!QmcBatch_Init(&batch, sampling, size, dimensions)) {
+            Checkpoint_Close(checkpoint);
+            return 1;
+        }
+
+        long long payout = 0;
+        for (int i = 0; i < size; i++) {
+            SimContext ctx;
+            Sim_Init(&ctx, &options);
+            Sim_SetSamplePoint(&ctx, &batch, i);
+            Sim_StartAT(&ctx);
+            Sim_RunAT(&ctx, 0);
+            progress.total_games += ctx.games;
+            progress.skipped_games += ctx.skipped_games;
+            payout += ctx.data.total_payout_diff;
+        }
+        QmcBatch_Free(&batch);
+
+        progress.total_payout += payout;
+        if (size == batch_size) {
+            double mean = (double)payout / size;
+            progress.batch_sum += mean;
+            progress.batch_sq_sum += mean * mean;
+            progress.batch_count++;
+        }
+        progress.next_batch = b + 1;
+        if (checkpoint) {
+            Rng_GetState(&progress.rng);
+            Checkpoint_MarkDone(checkpoint, (int)b);
+        }
+    }
+    if (checkpoint && !Checkpoint_Close(checkpoint)) {
+        return 1;
+    }
+    long long total_games = progress.total_games;
+    long long skipped_games = progress.skipped_games;
+    long long total_payout = progress.total_payout;
+    double batch_sum = progress.batch_sum, batch_sq_sum = progress.batch_sq_sum;
+    long long batch_count = progress.batch_count;
+
+    double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("AT回数        : %lld\n", at_count);
+    printf("平均ゲーム数  : %.2f G\n", (double)total_games / at_count);
+    printf("平均獲得差枚  : %.2f 枚\n", (double)total_payout / at_count);
+    if (batch_count >= 2) {
+        double mean = batch_sum / batch_count;
+        double var = (batch_sq_sum - batch_count * mean * mean) / (batch_count - 1);
+        printf("標準誤差      : %.3f 枚 (%s, %lld バッチ × %d AT)\n",
+               sqrt(var > 0 ? var / batch_count : 0.0), Qmc_GetModeName(sampling), batch_count, batch_size);
+    }
+    printf("一括消化率    : %.1f %%\n", total_games > 0 ? 100.0 * skipped_games / total_games : 0.0);
+    print_elapsed(elapsed, total_games - resumed_games, resumed_games > 0);
+    return 0;
+}
+
+// --- sim tables: 登録済み抽選テーブルの一覧 ---
+static int cmd_tables(void) {
+    int count = WeightedTable_GetRegisteredCount();
+    for (int i = 0; i < count; i++) {
+        WeightedTable_Print(stdout, WeightedTable_GetRegistered(i));
+    }
+    printf("(%d テーブル)\n", count);
+    return 0;
+}
+
+// --- sim bbex: BB EX 獲得枚数の分布 ---
+#define BBEX_PRINT_MAX 40
+
+static int cmd_bbex(int argc, char* argv[]) {
+    int rate = 0;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            rate = atoi(argv[++i]);
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+
+    int payouts[BBEX_PRINT_MAX];
+    double probs[BBEX_PRINT_MAX];
+    double tail = 0.0;
+    int count = AT_GetBBExPayoutDistribution(rate, payouts, probs, BBEX_PRINT_MAX, &tail);
+    if (count == 0) {
+        fprintf(stderr, "継続率 %d%% の定義はありません\n", rate);
+        return 1;
+    }
+
+    double mean = 0.0, cumulative = 0.0;
+    for (int i = 0; i < count; i++) {
+        cumulative += probs[i];
+        mean += payouts[i] * probs[i];
+        printf("%6d 枚 : %.8f  (累積 %.8f)\n", payouts[i], probs[i], cumulative);
+    }
+    printf("それ以上 : %.3e\n", tail);
+    printf("平均 (表示範囲) : %.2f 枚\n", mean);
+    return 0;
+}
+
+// --- sim sens: 感度分析 ---
+static int cmd_sens(int argc, char* argv[]) {
+    static SensConfig config;
+    static SensResult results[SENS_MAX_PARAMS];
+    memset(&config, 0, sizeof(config));
+    config.eval.at_count = 100000;
+    config.eval.seed = (unsigned long long)time(NULL);
+    int top_count = 0;
+
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-p") == 0 && i + 1 < argc && config.count < SENS_MAX_PARAMS) {
+            snprintf(config.names[config.count++], sizeof(config.names[0]), "%s", argv[++i]);
+        } else if (strcmp(argv[i], "--step") == 0 && i + 1 < argc) {
+            config.rel_step = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--normal") == 0) {
+            config.eval.from_normal = true;
+        } else if (strcmp(argv[i], "--top") == 0 && i + 1 < argc) {
+            top_count = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            config.eval.at_count = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            config.eval.seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            config.eval.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--skip") == 0) {
+            config.eval.options.event_skip = true;
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+    if (config.count == 0) {
+        config.count = Sensitivity_ListParams(Spec_Get(), config.names, SENS_MAX_PARAMS);
+    }
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    EvalResult base;
+    if (!Sensitivity_Run(&config, results, &base)) {
+        return 1;
+    }
+    printf("基準: %lld AT / シード %llu  平均 %.1f G / %.1f 枚  出玉率 %.2f%%",
+           base.at_count, config.eval.seed, base.mean_games, base.mean_payout, 100.0 * base.rtp);
+    if (config.eval.from_normal) {
+        printf("  初当り 1/%.1f  機械割 %.2f%%", base.hit_rate > 0 ? 1.0 / base.hit_rate : 0.0, 100.0 * base.total_rtp);
+    }
+    printf("\n");
+    Sensitivity_Print(stdout, &config, results, top_count);
+    printf("処理時間 : %.3f 秒 (%d パラメータ)\n",
+           (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency(), config.count);
+    return 0;
+}
+
+// --- sim sweep: パラメータスイープ ---
+static int cmd_sweep(int argc, char* argv[]) {
+    SweepConfig config;
+    memset(&config, 0, sizeof(config));
+    config.search = SWEEP_SEARCH_GRID;
+    config.eval.at_count = 100000;
+    config.eval.seed = (unsigned long long)time(NULL);
+    bool has_target = false;
+
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            if (config.param_count >= SWEEP_MAX_PARAMS ||
+                !Sweep_ParseParam(argv[++i], &config.params[config.param_count++])) {
+                print_usage();
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--target-rtp") == 0 && i + 1 < argc) {
+            config.target_kind = SWEEP_TARGET_RTP;
+            config.target = atof(argv[++i]) / 100.0;
+            has_target = true;
+        } else if (strcmp(argv[i], "--target-payout") == 0 && i + 1 < argc) {
+            config.target_kind = SWEEP_TARGET_PAYOUT;
+            config.target = atof(argv[++i]);
+            has_target = true;
+        } else if (strcmp(argv[i], "--search") == 0 && i + 1 < argc) {
+            const char* name = argv[++i];
+            if (strcmp(name, "grid") == 0) config.search = SWEEP_SEARCH_GRID;
+            else if (strcmp(name, "coord") == 0) config.search = SWEEP_SEARCH_COORD;
+            else { print_usage(); return 1; }
+        } else if (strcmp(argv[i], "--top") == 0 && i + 1 < argc) {
+            config.report_count = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            config.eval.at_count = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            config.eval.seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            config.eval.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--skip") == 0) {
+            config.eval.options.event_skip = true;
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+    if (config.param_count == 0 || !has_target) {
+        print_usage();
+        return 1;
+    }
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    if (!Sweep_Run(&config, stdout)) {
+        return 1;
+    }
+    printf("処理時間 : %.3f 秒\n",
+           (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency());
+    return 0;
+}
+
+// --- sim day: 1 日単位の稼働シミュレーション ---
+static int cmd_day(int argc, char* argv[]) {
+    DayConfig config;
+    memset(&config, 0, sizeof(config));
+    config.days = DAY_DEFAULT_DAYS;
+    config.games_per_day = DAY_DEFAULT_GAMES;
+    config.seed = (unsigned long long)time(NULL);
+
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            config.days = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "-g") == 0 && i + 1 < argc) {
+            config.games_per_day = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            config.seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            config.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--skip") == 0) {
+            config.options.event_skip = true;
+        } else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) {
+            config.checkpoint_path = argv[++i];
+        } else if (strcmp(argv[i], "--checkpoint-interval") == 0 && i + 1 < argc) {
+            config.checkpoint_interval = atof(argv[++i]);
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+    if (config.days <= 0 || config.days > INT_MAX || config.games_per_day <= 0) {
+        print_usage();
+        return 1;
+    }
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    DayResult r;
+    if (!SimEval_RunDays(&config, &r, NULL)) {
+        return 1;
+    }
+    double elapsed = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+    const DayTotals* t = &r.total;
+    long long normal_at = t->at_count - t->cz_at_count - t->ceiling_count;
+    printf("日数          : %lld 日 × %lld G (シード %llu)\n", config.days, config.games_per_day, config.seed);
+    printf("機械割        : %.2f %%\n", 100.0 * r.rtp);
+    printf("1日の差枚     : 平均 %+.1f 枚 / SD %.1f 枚 (10%%点 %+lld / 中央値 %+lld / 90%%点 %+lld)\n",
+           r.payout_mean, r.payout_sd, r.payout_q10, r.payout_q50, r.payout_q90);
+    printf("AT初当り      : 1/%.1f (%lld 回)\n", t->at_count > 0 ? (double)t->games / t->at_count : 0.0, t->at_count);
+    printf("  内訳        : 通常時直撃 %lld / CZ経由 %lld / 天井 %lld\n", normal_at, t->cz_at_count, t->ceiling_count);
+    printf("CZ突入        : 1/%.1f (成功率 %.1f %%)\n",
+           t->cz_count > 0 ? (double)t->games / t->cz_count : 0.0,
+           t->cz_count > 0 ? 100.0 * t->cz_at_count / t->cz_count : 0.0);
+    printf("天井到達率    : %.2f %% (AT当選のうち)\n", t->at_count > 0 ? 100.0 * t->ceiling_count / t->at_count : 0.0);
+    print_elapsed(elapsed, t->games - r.resumed_games, r.resumed_games > 0);
+    return 0;
+}
+
+// --- sim seek: 目標の展開に到達するシードの探索 ---
+static int cmd_seek(int argc, char* argv[]) {
+    SeekConfig config;
+    memset(&config, 0, sizeof(config));
+    config.first_seed = 1;
+    config.seed_count = 100000;
+    config.max_games = 20000;
+    config.want = 5;
+    config.lead_games = SEEK_DEFAULT_LEAD;
+    bool has_target = false;
+    const char* script_path = NULL;
+
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-g") == 0 && i + 1 < argc) {
+            if (!Seek_ParseTarget(argv[++i], &config.target)) {
+                print_usage();
+                return 1;
+            }
+            has_target = true;
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            config.first_seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            config.seed_count = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) {
+            config.want = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--max-games") == 0 && i + 1 < argc) {
+            config.max_games = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--lead") == 0 && i + 1 < argc) {
+            config.lead_games = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            config.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            script_path = argv[++i];
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+    if (!has_target || config.want <= 0 || config.want > SEEK_MAX_WANT || config.lead_games < 0) {
+        print_usage();
+        return 1;
+    }
+
+    static SeekHit hits[SEEK_MAX_WANT];
+    Uint64 start = SDL_GetPerformanceCounter();
+    int found = Seek_Run(&config, hits);
+    if (found < 0) {
+        return 1;
+    }
+    printf("--- 目標 %s (シード %llu から %lld 個、1 シード %lld G まで) ---\n",
+           Seek_GetTargetName(config.target), (unsigned long long)config.first_seed,
+           config.seed_count, config.max_games);
+    for (int i = 0; i < found; i++) {
+        printf("seed %llu : %lld G目で到達  本体: --seed %llu --warp %lld\n",
+               (unsigned long long)hits[i].seed, hits[i].hit_game,
+               (unsigned long long)hits[i].seed, hits[i].warp_games);
+    }
+    if (found == 0) {
+        printf("見つかりませんでした (-n / --max-games を増やしてください)\n");
+    }
+
+    if (script_path && found > 0) {
+        FILE* out = fopen(script_path, "w");
+        if (!out) {
+            fprintf(stderr, "%s を開けません\n", script_path);
+            return 1;
+        }
+        for (int i = 0; i < found; i++) {
+            if (i > 0) fprintf(out, "\n");
+            Seek_WriteScript(out, &config, &hits[i]);
+        }
+        fclose(out);
+        printf("停止手順 : %s\n", script_path);
+    }
+    printf("処理時間 : %.3f 秒\n",
+           (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency());
+    return 0;
+}
+
+// --- sim fuzz: AT状態遷移の不変条件ファジング ---
+static int cmd_fuzz(int argc, char* argv[]) {
+    FuzzConfig config;
+    memset(&config, 0, sizeof(config));
+    config.cases = 100000;
+    config.seed = (unsigned long long)time(NULL);
+
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            config.cases = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            config.seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            config.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--stuck") == 0 && i + 1 < argc) {
+            config.stuck_steps = atoi(argv[++i]);
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+
+    static FuzzResult r;
+    Uint64 start = SDL_GetPerformanceCounter();
+    if (!Fuzz_Run(&config, &r)) {
+        return 1;
+    }
+    double elapsed = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+    printf("ケース数 : %lld (シード %llu)\n", r.cases, config.seed);
+    printf("総手数   : %lld (%.0f 手/秒)\n", r.steps, elapsed > 0 ? r.steps / elapsed : 0.0);
+
+    // 状態の到達 (AT_END は遷移先として数える)
+    int exit_code = 0;
+    printf("--- 状態ごとの滞在手数 / 遷移先 ---\n");
+    for (int s = STATE_BB_INITIAL; s <= STATE_AT_END; s++) {
+        long long reached = r.visits[s];
+        for (int u = STATE_BB_INITIAL; u <= STATE_AT_END; u++) reached += r.transitions[u][s];
+        printf("%-18s %12lld", AT_GetStateName((AT_State)s), r.visits[s]);
+        for (int u = STATE_BB_INITIAL; u <= STATE_AT_END; u++) {
+            if (u != s && r.transitions[s][u] > 0) printf("  ->%s", AT_GetStateName((AT_State)u));
+        }
+        bool expected = Fuzz_IsStateReachable((AT_State)s);
+        printf("%s\n", reached > 0 ? "" : expected ? "  (未到達)" : "  (未到達: 遷移しない状態)");
+        if (reached == 0 && expected && !r.failed) exit_code = 1;
+    }
+
+    if (r.failed) {
+        exit_code = 1;
+        printf("--- 違反: %s (ケース %lld の %lld 手目) ---\n",
+               Fuzz_GetViolationName(r.violation), r.fail_case, r.fail_step);
+        static FuzzInput inputs[FUZZ_MAX_INPUTS];
+        int count = Fuzz_Minimize(&config, &r, inputs);
+        if (count > 0) {
+            printf("縮小後 %d 手 (再現: sim fuzz -s %llu、ケース %lld)\n", count, config.seed, r.fail_case);
+            Fuzz_PrintTrace(stdout, &config, r.fail_case, inputs, count);
+        } else {
+            printf("入力列が長すぎるため縮小できません\n");
+        }
+    }
+    printf("処理時間 : %.3f 秒\n", elapsed);
+    return exit_code;
+}
+
+// --- sim session: 資金管理・破産確率 ---
+static int cmd_session(int argc, char* argv[]) {
+    SessionConfig config;
+    Session_InitConfig(&config);
+    config.seed = (unsigned long long)time(NULL);
+
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            config.players = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            config.sessions = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-g") == 0 && i + 1 < argc) {
+            config.max_games = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--bankroll") == 0 && i + 1 < argc) {
+            config.bankroll_yen = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--lend") == 0 && i + 1 < argc) {
+            config.lend_medals = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--exchange") == 0 && i + 1 < argc) {
+            config.exchange_medals = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--stop-loss") == 0 && i + 1 < argc) {
+            config.stop_loss_yen = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--take-profit") == 0 && i + 1 < argc) {
+            config.take_profit_medals = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--quit-after-at") == 0) {
+            config.quit_after_at = true;
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            config.seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            config.threads = atoi(argv[++i]);
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    SessionResult r;
+    if (!Session_Run(&config, &r, NULL)) {
+        return 1;
+    }
+    double elapsed = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+    printf("打ち手        : %lld 人 × 最大 %d 日 (シード %llu)\n", r.players, config.sessions, config.seed);
+    printf("条件          : 資金 %lld 円 / %d 枚貸し・%d 枚交換 / %lld G", config.bankroll_yen,
+           config.lend_medals, config.exchange_medals, config.max_games);
+    if (config.stop_loss_yen > 0) printf(" / 投資上限 %lld 円", config.stop_loss_yen);
+    if (config.take_profit_medals > 0) printf(" / 利確 %lld 枚", config.take_profit_medals);
+    printf("%s\n", config.quit_after_at ? " / AT終了ヤメ" : "");
+    printf("機械割        : %.2f %% (%lld 日 / %lld G)\n", 100.0 * SimEval_GetRtp(r.games, r.payout), r.sessions, r.games);
+    printf("1日の収支     : 平均 %+.0f 円 / SD %.0f 円 / 勝率 %.1f %% (10%%点 %+lld / 中央値 %+lld / 90%%点 %+lld)\n",
+           r.session_mean_yen, r.session_sd_yen, 100.0 * r.session_win_rate,
+           r.session_q10_yen, r.session_q50_yen, r.session_q90_yen);
+    printf("ヤメた理由    :");
+    for (int i = 0; i < SESSION_END_COUNT; i++) {
+        printf(" %s %.1f %%", Session_GetEndReasonName((SessionEndReason)i),
+               r.sessions > 0 ? 100.0 * r.end_counts[i] / r.sessions : 0.0);
+    }
+    printf("\n");
+    printf("最終資金      : 平均 %.0f 円 (10%%点 %lld / 中央値 %lld / 90%%点 %lld)\n",
+           r.final_mean_yen, r.final_q10_yen, r.final_q50_yen, r.final_q90_yen);
+    printf("最大下落      : 平均 %.0f 円 (中央値 %lld / 90%%点 %lld / 99%%点 %lld)\n",
+           r.drawdown_mean_yen, r.drawdown_q50_yen, r.drawdown_q90_yen, r.drawdown_q99_yen);
+    printf("破産確率      : %.2f %%\n", 100.0 * r.ruin_rate);
+    printf("処理時間      : %.3f 秒 (%.0f G/秒)\n", elapsed, elapsed > 0 ? r.games / elapsed : 0.0);
+    return 0;
+}
+
+// --- sim hall: ホール単位のシミュレーション ---
+// "番号:spec.cfg:比率" をパースしてスペックを読み込む
+static bool parse_hall_setting(char* text, HallSetting* setting) {
+    char* first = strchr(text, ':');
+    char* last = strrchr(text, ':');
+    if (!first || first == last) return false;
+    *first = '\0';
+    *last = '\0';
+    setting->number = atoi(text);
+    setting->weight = atoi(last + 1);
+    return setting->weight > 0 && Spec_LoadCached(first + 1, NULL, &setting->spec);
+}
+
+static int cmd_hall(int argc, char* argv[]) {
+    static HallConfig config;
+    Hall_InitConfig(&config);
+    config.seed = (unsigned long long)time(NULL);
+    const char* columns_path = NULL;
+    const char* csv_path = NULL;
+
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+            config.machines = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--setting") == 0 && i + 1 < argc) {
+            if (config.setting_count >= HALL_MAX_SETTINGS ||
+                !parse_hall_setting(argv[++i], &config.settings[config.setting_count])) {
+                fprintf(stderr, "--setting は 番号:spec.cfg:比率 で最大 %d 個です\n", HALL_MAX_SETTINGS);
+                return 1;
+            }
+            config.setting_count++;
+        } else if (strcmp(argv[i], "--open") == 0 && i + 1 < argc) {
+            config.open_minutes = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--gpm") == 0 && i + 1 < argc) {
+            config.games_per_minute = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--idle") == 0 && i + 1 < argc) {
+            config.mean_idle_minutes = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--play-games") == 0 && i + 1 < argc) {
+            config.mean_play_games = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--stop-loss") == 0 && i + 1 < argc) {
+            config.stop_loss_medals = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--at-quit") == 0 && i + 1 < argc) {
+            config.quit_after_at_rate = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            columns_path = argv[++i];
+        } else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            csv_path = argv[++i];
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            config.seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            config.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--skip") == 0) {
+            config.options.event_skip = true;
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+    if (config.machines <= 0) {
+        print_usage();
+        return 1;
+    }
+
+    HallMachineDay* days = (HallMachineDay*)malloc(sizeof(HallMachineDay) * (size_t)config.machines);
+    if (!days) {
+        fprintf(stderr, "メモリ確保に失敗しました\n");
+        return 1;
+    }
+    Uint64 start = SDL_GetPerformanceCounter();
+    bool ok = Hall_Run(&config, days);
+    double elapsed = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+    if (ok && columns_path) ok = Hall_WriteColumns(columns_path, days, config.machines);
+    if (ok && csv_path) {
+        FILE* out = strcmp(csv_path, "-") == 0 ? stdout : fopen(csv_path, "w");
+        if (out) {
+            Hall_WriteCsv(out, days, config.machines);
+            if (out != stdout) fclose(out);
+        } else {
+            fprintf(stderr, "%s を書き込めません\n", csv_path);
+            ok = false;
+        }
+    }
+    if (!ok) {
+        free(days);
+        return 1;
+    }
+
+    // 設定ごとの集計 (CSV を標準出力に出す場合は stderr へ)
+    FILE* report = (csv_path && strcmp(csv_path, "-") == 0) ? stderr : stdout;
+    fprintf(report, "台数          : %d 台 / 営業 %d 分 (シード %llu)\n", config.machines, config.open_minutes, config.seed);
+    fprintf(report, "%6s %6s %10s %10s %8s %8s %10s %8s\n", "設定", "台数", "平均G数", "平均差枚", "AT", "ボーナス", "稼働率", "機械割");
+    long long all_games = 0, all_payout = 0;
+    int setting_count = config.setting_count > 0 ? config.setting_count : 1;
+    for (int s = 0; s < setting_count; s++) {
+        int number = config.setting_count > 0 ? config.settings[s].number : 1;
+        long long n = 0, games = 0, payout = 0, at = 0, bonus = 0, minutes = 0;
+        for (int m = 0; m < config.machines; m++) {
+            if (days[m].setting != number) continue;
+            n++;
+            games += days[m].games;
+            payout += days[m].payout;
+            at += days[m].at_count;
+            bonus += days[m].bonus_count;
+            minutes += days[m].active_minutes;
+        }
+        all_games += games;
+        all_payout += payout;
+        if (n == 0) continue;
+        fprintf(report, "%6d %6lld %10.0f %+10.0f %8.2f %8.2f %9.1f%% %7.2f%%\n", number, n, (double)games / n,
+                (double)payout / n, (double)at / n, (double)bonus / n,
+                100.0 * minutes / ((double)n * config.open_minutes), 100.0 * SimEval_GetRtp(games, payout));
+    }
+    fprintf(report, "全体          : 平均 %.0f G / 平均差枚 %+.0f 枚 / 機械割 %.2f %%\n",
+            (double)all_games / config.machines, (double)all_payout / config.machines,
+            100.0 * SimEval_GetRtp(all_games, all_payout));
+    fprintf(report, "処理時間      : %.3f 秒 (%.0f G/秒)\n", elapsed, elapsed > 0 ? all_games / elapsed : 0.0);
+    free(days);
+    return 0;
+}
+
+// --- sim conform: 抽選の適合性検定 ---
+static void print_conform_result(const ConformResult* r, void* user) {
+    (void)user;
+    printf("%s %-44s χ²=%12.2f (自由度 %3d) p=%-10.3g", r->flagged ? "!!" : "  ", r->name, r->chi2, r->df, r->p_value);
+    if (r->worst_label[0]) {
+        printf("  最大偏差 %s: %lld / 期待 %.1f (p=%.3g)", r->worst_label, r->worst_observed, r->worst_expected,
+               r->worst_p_value);
+    }
+    printf("%s%s\n", r->impossible ? "  確率 0 の値が出現" : "", r->from_build_weights ? "  (期待: 構築元の重み)" : "");
+    fflush(stdout);
+}
+
+static int cmd_conform(int argc, char* argv[]) {
+    ConformConfig config;
+    memset(&config, 0, sizeof(config));
+    config.samples = CONFORM_DEFAULT_SAMPLES;
+    config.seed = (unsigned long long)time(NULL);
+    config.alpha = CONFORM_DEFAULT_ALPHA;
+
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            config.samples = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            config.seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            config.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) {
+            config.alpha = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            config.filter = argv[++i];
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+
+    printf("抽選回数 : %lld / 検定 (シード %llu、有意水準 %g)\n", config.samples, config.seed, config.alpha);
+    Uint64 start = SDL_GetPerformanceCounter();
+    int flagged = Conform_Run(&config, print_conform_result, NULL);
+    if (flagged < 0) {
+        return 1;
+    }
+    double elapsed = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+    printf("棄却     : %d 件\n", flagged);
+    printf("処理時間 : %.3f 秒\n", elapsed);
+    return flagged > 0 ? 1 : 0;
+}
+
+// --- sim value: AT状態価値表 ---
+static void print_value_row(const AtValueTable* table, const char* label, const GameData* data) {
+    AtValue v;
+    if (AtValue_Lookup(table, data, &v)) {
+        printf("%-28s %9.2f 枚  (標準偏差 %8.2f)\n", label, v.mean, sqrt(v.variance));
+    } else {
+        printf("%-28s (表にない状態)\n", label);
+    }
+}
+
+static int cmd_value(int argc, char* argv[]) {
+    const char* path = VALUE_DEFAULT_PATH;
+    int threads = 0;
+    long long check_count = 0;
+    unsigned long long seed = (unsigned long long)time(NULL);
+
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            path = argv[++i];
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            check_count = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+
+    AtValueBuildStats stats;
+    if (!AtValue_Build(path, threads, &stats)) {
+        return 1;
+    }
+    printf("格子点数     : %d (遷移 %lld、列挙したゲーム %lld)\n", stats.cells, stats.transitions, stats.replays);
+    printf("反復解法     : %d 回 (残差 %.2e 枚)\n", stats.iterations, stats.residual);
+    printf("処理時間     : 列挙 %.3f 秒 / 反復 %.3f 秒\n", stats.build_seconds, stats.solve_seconds);
+
+    // 書き出したファイルを mmap して引く
+    AtValueTable* table = AtValue_Open(path);
+    if (!table) {
+        return 1;
+    }
+    printf("--- 残り獲得差枚 (%s) ---\n", path);
+    SimContext ctx;
+    Sim_Init(&ctx, NULL);
+    Sim_StartAT(&ctx);
+    print_value_row(table, "AT開始 (BB[初当り])", &ctx.data);
+    static const int hp_games[] = { 10, 30, 50, 100 };
+    for (int i = 0; i < (int)(sizeof(hp_games) / sizeof(hp_games[0])); i++) {
+        GameData data;
+        memset(&data, 0, sizeof(data));
+        data.current_state = STATE_BONUS_HIGH_PROB;
+        data.at_step = AT_STEP_WAIT_LEVER1;
+        data.bonus_high_prob_games = hp_games[i];
+        char label[64];
+        snprintf(label, sizeof(label), "ボーナス高確率 残り%dG", hp_games[i]);
+        print_value_row(table, label, &data);
+    }
+
+    if (check_count > 0) {
+        AtValue start;
+        AtValue_Lookup(table, &ctx.data, &start);
+        Rng_Seed(seed);
+        double sum = 0.0, sq_sum = 0.0;
+        for (long long n = 0; n < check_count; n++) {
+            Sim_Init(&ctx, NULL);
+            Sim_StartAT(&ctx);
+            Sim_RunAT(&ctx, 0);
+            double payout = (double)ctx.data.total_payout_diff;
+            sum += payout;
+            sq_sum += payout * payout;
+        }
+        double mean = sum / check_count;
+        double var = check_count > 1 ? (sq_sum - check_count * mean * mean) / (check_count - 1) : 0.0;
+        printf("--- 検証: AT開始から %lld 回 (シード %llu) ---\n", check_count, seed);
+        printf("平均         : %9.2f 枚 ± %.2f (表 %.2f)\n", mean, 1.96 * sqrt(var / check_count), start.mean);
+        printf("標準偏差     : %9.2f 枚 (表 %.2f)\n", sqrt(var > 0 ? var : 0.0), sqrt(start.variance));
+    }
+    AtValue_Close(table);
+    return 0;
+}
+
+// --- sim episode: AT 1 回単位のサンプリング ---
+static int cmd_episode(int argc, char* argv[]) {
+    EpisodeConfig config;
+    memset(&config, 0, sizeof(config));
+    config.episodes = 100000;
+    config.seed = (unsigned long long)time(NULL);
+    int hp_games = 0;
+
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            config.episodes = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            config.seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            config.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--hp") == 0 && i + 1 < argc) {
+            hp_games = atoi(argv[++i]);
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+
+    GameData start;
+    if (hp_games > 0) {
+        memset(&start, 0, sizeof(start));
+        start.current_state = STATE_BONUS_HIGH_PROB;
+        start.at_step = AT_STEP_WAIT_LEVER1;
+        start.bonus_high_prob_games = hp_games;
+        config.start = &start;
+    }
+
+    Uint64 begin = SDL_GetPerformanceCounter();
+    EpisodeStats r;
+    if (!Episode_RunBatch(&config, &r, NULL)) {
+        return 1;
+    }
+    double elapsed = (double)(SDL_GetPerformanceCounter() - begin) / SDL_GetPerformanceFrequency();
+    double n = (double)r.episodes;
+
+    if (hp_games > 0) {
+        printf("開始状態      : ボーナス高確率 残り%dG\n", hp_games);
+    } else {
+        printf("開始状態      : %s\n", AT_GetStateName(STATE_BB_INITIAL));
+    }
+    printf("AT回数        : %lld (シード %llu)\n", r.episodes, config.seed);
+    printf("獲得差枚      : 平均 %.2f 枚 / SD %.2f 枚 / 平均 %.2f G\n", r.mean_payout, r.payout_sd, r.mean_games);
+    printf("分位点        : 10%% %d / 25%% %d / 50%% %d / 75%% %d / 90%% %d / 99%% %d 枚\n",
+           r.payout_q10, r.payout_q25, r.payout_q50, r.payout_q75, r.payout_q90, r.payout_q99);
+    printf("連チャン数    : 平均 %.3f 回\n", r.mean_chain);
+    long long cumulative = 0;
+    for (int c = 0; c <= EPISODE_MAX_CHAIN; c++) {
+        if (r.chain_counts[c] == 0) continue;
+        cumulative += r.chain_counts[c];
+        printf("  %3d 回%s  %8.4f %%  (累積 %8.4f %%)\n", c, c == EPISODE_MAX_CHAIN ? "以上" : "    ",
+               100.0 * r.chain_counts[c] / n, 100.0 * cumulative / n);
+    }
+    long long bonus_sum = 0;
+    for (int k = 0; k < EPISODE_BONUS_COUNT; k++) bonus_sum += r.bonus_totals[k];
+    printf("ボーナス内訳  :\n");
+    for (int k = 0; k < EPISODE_BONUS_COUNT; k++) {
+        printf("  %7.4f 回/AT  (%5.2f %%)  %s\n", r.bonus_totals[k] / n,
+               bonus_sum > 0 ? 100.0 * r.bonus_totals[k] / bonus_sum : 0.0, Episode_GetBonusName((EpisodeBonusKind)k));
+    }
+    printf("BB EX         : 平均 %.2f 枚/AT", r.ex_payout / n);
+    if (r.bonus_totals[EPISODE_BONUS_BB_EX] > 0) {
+        printf(" (1 回あたり %.2f 枚)", (double)r.ex_payout / r.bonus_totals[EPISODE_BONUS_BB_EX]);
+    }
+    printf("\n");
+    printf("比翼BEATS     : 突入率 %.2f %% / 平均 %.3f 回/AT / 最高レベル LV1 %.2f %% LV2 %.2f %% MAXX %.2f %%\n",
+           100.0 * r.hiyoku_episodes / n, r.hiyoku_total / n,
+           100.0 * r.hiyoku_max_level_counts[HIYOKU_LV1] / n, 100.0 * r.hiyoku_max_level_counts[HIYOKU_LV2] / n,
+           100.0 * r.hiyoku_max_level_counts[HIYOKU_MAXX] / n);
+    printf("処理時間      : %.3f 秒 (%.0f AT/秒、%.0f G/秒)\n", elapsed, elapsed > 0 ? n / elapsed : 0.0,
+           elapsed > 0 ? r.games / elapsed : 0.0);
+    return 0;
+}
+
+// --- sim digest: 並列集計のビット一致の確認 ---
+#define DIGEST_RUNS 3
+
+typedef struct {
+    long long at_count;
+    long long days;
+    unsigned long long seed;
+} DigestParams;
+
+typedef bool (*DigestFunc)(const DigestParams* params, int threads, uint64_t* digest);
+
+static uint64_t digest_double(uint64_t hash, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits)); // 表示の丸めで隠れる差も検出する
+    return Checkpoint_HashValue(hash, bits);
+}
+
+// 通常時から AT終了までの評価 (タスク単位の集計と出玉率・標準誤差)
+static bool digest_eval(const DigestParams* params, int threads, uint64_t* digest) {
+    EvalConfig config;
+    memset(&config, 0, sizeof(config));
+    config.at_count = params->at_count;
+    config.seed = params->seed;
+    config.threads = threads;
+    config.options.event_skip = true;
+    config.from_normal = true;
+    int task_count = SimEval_GetTaskCount(&config);
+    EvalTotals* tasks = (EvalTotals*)malloc(sizeof(EvalTotals) * (size_t)task_count);
+    EvalResult r;
+    if (!tasks || !SimEval_RunTasks(&config, &r, tasks)) {
+        free(tasks);
+        return false;
+    }
+    uint64_t h = 0;
+    for (int t = 0; t < task_count; t++) {
+        h = Checkpoint_HashValue(h, (uint64_t)tasks[t].at_count);
+        h = Checkpoint_HashValue(h, (uint64_t)tasks[t].games);
+        h = Checkpoint_HashValue(h, (uint64_t)tasks[t].payout);
+        h = Checkpoint_HashValue(h, (uint64_t)tasks[t].normal_games);
+        h = Checkpoint_HashValue(h, (uint64_t)tasks[t].normal_payout);
+    }
+    h = digest_double(h, r.rtp);
+    h = digest_double(h, r.rtp_se);
+    h = digest_double(h, r.payout_se);
+    h = digest_double(h, r.p_over_1000);
+    h = digest_double(h, r.total_rtp);
+    h = Checkpoint_HashValue(h, (uint64_t)r.q50);
+    *digest = Checkpoint_HashValue(h, (uint64_t)r.q90);
+    free(tasks);
+    return true;
+}
+
+// 1 日単位の稼働 (日ごとの結果と差枚の平均・SD)
+static bool digest_day(const DigestParams* params, int threads, uint64_t* digest) {
+    DayConfig config;
+    memset(&config, 0, sizeof(config));
+    config.days = params->days;
+    config.games_per_day = DAY_DEFAULT_GAMES;
+    config.seed = params->seed;
+    config.threads = threads;
+    config.options.event_skip = true;
+    DayTotals* days = (DayTotals*)malloc(sizeof(DayTotals) * (size_t)config.days);
+    DayResult r;
+    if (!days || !SimEval_RunDays(&config, &r, days)) {
+        free(days);
+        return false;
+    }
+    uint64_t h = 0;
+    for (long long d = 0; d < config.days; d++) {
+        h = Checkpoint_HashValue(h, (uint64_t)days[d].games);
+        h = Checkpoint_HashValue(h, (uint64_t)days[d].payout);
+        h = Checkpoint_HashValue(h, (uint64_t)days[d].at_count);
+        h = Checkpoint_HashValue(h, (uint64_t)days[d].cz_count);
+        h = Checkpoint_HashValue(h, (uint64_t)days[d].cz_at_count);
+        h = Checkpoint_HashValue(h, (uint64_t)days[d].ceiling_count);
+    }
+    h = digest_double(h, r.rtp);
+    h = digest_double(h, r.payout_mean);
+    *digest = digest_double(h, r.payout_sd);
+    free(days);
+    return true;
+}
+
+// AT単位のサンプリング (エピソードごとの要約と集計)
+static bool digest_episode(const DigestParams* params, int threads, uint64_t* digest) {
+    EpisodeConfig config;
+    memset(&config, 0, sizeof(config));
+    config.episodes = params->at_count;
+    config.seed = params->seed;
+    config.threads = threads;
+    AtEpisode* episodes = (AtEpisode*)malloc(sizeof(AtEpisode) * (size_t)config.episodes);
+    EpisodeStats r;
+    if (!episodes || !Episode_RunBatch(&config, &r, episodes)) {
+        free(episodes);
+        return false;
+    }
+    uint64_t h = 0;
+    for (long long i = 0; i < config.episodes; i++) {
+        const AtEpisode* e = &episodes[i];
+        h = Checkpoint_HashValue(h, (uint64_t)(uint32_t)e->payout);
+        h = Checkpoint_HashValue(h, (uint64_t)(uint32_t)e->games);
+        h = Checkpoint_HashValue(h, (uint64_t)(uint32_t)e->ex_payout);
+        for (int k = 0; k < EPISODE_BONUS_COUNT; k++) h = Checkpoint_HashValue(h, e->bonus_count[k]);
+        h = Checkpoint_HashValue(h, e->hiyoku_count);
+        h = Checkpoint_HashValue(h, e->hiyoku_max_level);
+    }
+    h = digest_double(h, r.mean_payout);
+    h = digest_double(h, r.payout_sd);
+    *digest = digest_double(h, r.mean_chain);
+    free(episodes);
+    return true;
+}
+
+static int cmd_digest(int argc, char* argv[]) {
+    DigestParams params = { 20000, 1000, 1 };
+    int threads = Parallel_GetDefaultThreadCount();
+
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            params.at_count = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            params.days = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            params.seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+    if (params.at_count <= 0 || params.at_count > INT_MAX || params.days <= 0 || params.days > INT_MAX || threads < 1) {
+        print_usage();
+        return 1;
+    }
+
+    static const struct {
+        const char* name;
+        DigestFunc func;
+    } k_workloads[] = {
+        { "AT評価 (通常時から)", digest_eval },
+        { "1日単位の稼働", digest_day },
+        { "AT単位のサンプリング", digest_episode },
+    };
+    // 1 スレッド・指定数・CPU 数より多い数 (盗み合いが起きやすい) で実行して比べる
+    int thread_counts[DIGEST_RUNS] = { 1, threads, threads * 2 + 1 };
+
+    printf("スペック %016llx / シード %llu / %lld AT / %lld 日\n",
+           (unsigned long long)Spec_GetHash(Spec_Get()), params.seed, params.at_count, params.days);
+    int mismatches = 0;
+    for (size_t w = 0; w < sizeof(k_workloads) / sizeof(k_workloads[0]); w++) {
+        uint64_t digests[DIGEST_RUNS];
+        for (int r = 0; r < DIGEST_RUNS; r++) {
+            if (!k_workloads[w].func(&params, thread_counts[r], &digests[r])) {
+                return 1;
+            }
+        }
+        bool same = digests[1] == digests[0] && digests[2] == digests[0];
+        printf("%s : %016llx", k_workloads[w].name, (unsigned long long)digests[0]);
+        if (same) {
+            printf("  (%d / %d / %d スレッドで一致)\n", thread_counts[0], thread_counts[1], thread_counts[2]);
+        } else {
+            printf("  !! スレッド数で不一致 (%d: %016llx / %d: %016llx)\n",
+                   thread_counts[1], (unsigned long long)digests[1], thread_counts[2], (unsigned long long)digests[2]);
+            mismatches++;
+        }
+    }
+    return mismatches > 0 ? 1 : 0;
+}
+
+// --- sim pace: 演出の長さ込みの実時間の時速 ---
+static int cmd_pace(int argc, char* argv[]) {
+    const char* media_path = PACE_DEFAULT_MEDIA;
+    PaceConfig config;
+    memset(&config, 0, sizeof(config));
+    config.days = PACE_DEFAULT_DAYS;
+    config.games_per_day = DAY_DEFAULT_GAMES;
+    config.seed = (unsigned long long)time(NULL);
+
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+            media_path = argv[++i];
+        } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            config.days = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "-g") == 0 && i + 1 < argc) {
+            config.games_per_day = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            config.seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            config.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--skip") == 0) {
+            config.options.event_skip = true;
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+    if (config.days <= 0 || config.days > INT_MAX || config.games_per_day <= 0) {
+        print_usage();
+        return 1;
+    }
+
+    PaceModel model;
+    if (!Pace_Load(media_path, &model)) {
+        return 1;
+    }
+    PaceResult r;
+    if (!Pace_Run(&config, &model, &r, NULL)) {
+        return 1;
+    }
+    const PaceTotals* t = &r.total;
+    const PaceTiming* timing = &model.timing;
+    printf("日数          : %lld 日 × %lld G (シード %llu)\n", config.days, config.games_per_day, config.seed);
+    printf("動画          : %s (長さを読めた %d 本 / 読めない %d 本)\n", media_path, model.media_count, model.missing_count);
+    printf("操作時間      : ウェイト %.0f / レバー %.0f / 第1停止 %.0f / 停止間隔 %.0f / 演出のレバー待ち %.0f ms\n",
+           timing->game_wait_ms, timing->bet_lever_ms, timing->first_stop_ms, timing->stop_interval_ms,
+           timing->lever_wait_ms);
+    printf("機械割        : %.2f %%\n", 100.0 * r.rtp);
+    printf("1G の実時間   : %.3f 秒\n", r.seconds_per_game);
+    printf("時速          : %.0f G/時 / 差枚 %+.1f 枚/時\n", r.games_per_hour, r.payout_per_hour);
+    printf("\n時間の内訳\n");
+    for (int k = 0; k < PACE_TIME_COUNT; k++) {
+        printf("  %6.2f %% (1G あたり %.3f 秒)  %s\n",
+               r.total_ms > 0 ? 100.0 * t->ms[k] / r.total_ms : 0.0,
+               t->games > 0 ? t->ms[k] / 1000.0 / t->games : 0.0, Pace_GetTimeName((PaceTimeKind)k));
+    }
+    printf("  遷移演出 %lld 回 / 当落演出 %lld 回 / BB EX 告知 %lld 回\n", t->transitions, t->judges, t->bb_ex_reveals);
+    printf("\n状態ごとの時速 (レバーON時の状態)\n");
+    for (int s = 0; s < PACE_STATE_COUNT; s++) {
+        if (t->state_games[s] == 0) continue;
+        printf("  %6.2f %% の G / %6.2f %% の時間 / %5.0f G/時  %s\n",
+               100.0 * t->state_games[s] / t->games,
+               r.total_ms > 0 ? 100.0 * t->state_ms[s] / r.total_ms : 0.0,
+               t->state_ms[s] > 0 ? t->state_games[s] / (t->state_ms[s] / 3600000.0) : 0.0,
+               AT_GetStateName((AT_State)s));
+    }
+    return 0;
+}
+
+// --- sim pres: 演出の期待度 ---
+static void print_pres_rows(FILE* out, const PresOddsTable* table, PresOddsKind kind) {
+    double lottery = PresOdds_GetLotteryProbability(table);
+    fprintf(out, "\n%s\n", PresOdds_GetKindName(kind));
+    fprintf(out, "  %8s %8s %8s %8s %8s %8s  %s\n", "選択率", "期待度", "ダーリン", "フランクス", "BB EX", "EP", "演出");
+    for (int i = 0; i < table->row_count; i++) {
+        const PresOddsRow* row = &table->rows[i];
+        if (row->kind != kind) continue;
+        const char* video = PresTable_GetVideoKey(row->video);
+        fprintf(out, "  %7.2f%% %7.2f%% %7.2f%% %7.2f%% %7.2f%% %7.2f%%  ", 100.0 * row->prob / lottery,
+                100.0 * PresOdds_GetWinProbability(row),
+                100.0 * PresOdds_GetResultProbability(row, BONUS_DARLING),
+                100.0 * PresOdds_GetResultProbability(row, BONUS_FRANXX),
+                100.0 * PresOdds_GetResultProbability(row, BONUS_BB_EX),
+                100.0 * PresOdds_GetResultProbability(row, BONUS_EPISODE));
+        if (kind == PRES_ODDS_YAKU_PAIR) fprintf(out, "%s / ", GetYakuName(row->yaku));
+        fprintf(out, "%s\n", video ? video : "?");
+    }
+}
+
+static int cmd_pres(int argc, char* argv[]) {
+    const char* csv_path = NULL;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            csv_path = argv[++i];
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+
+    PresOddsTable table;
+    if (!PresOdds_Build(&table)) {
+        return 1;
+    }
+    if (csv_path) {
+        FILE* out = strcmp(csv_path, "-") == 0 ? stdout : fopen(csv_path, "w");
+        if (!out) {
+            fprintf(stderr, "%s を書き込めません\n", csv_path);
+            PresOdds_Free(&table);
+            return 1;
+        }
+        PresOdds_WriteCsv(out, &table);
+        if (out != stdout) fclose(out);
+    }
+
+    // CSV を標準出力に出す場合は stderr へ
+    FILE* report = (csv_path && strcmp(csv_path, "-") == 0) ? stderr : stdout;
+    double lottery = PresOdds_GetLotteryProbability(&table);
+    double win = lottery - table.result_prob[BONUS_AT_CONTINUE];
+    fprintf(report, "AT高確率 1G あたり\n");
+    fprintf(report, "  抽選演出      : 1/%.2f\n", lottery > 0 ? 1.0 / lottery : 0.0);
+    fprintf(report, "  ボーナス当選  : 1/%.2f (抽選演出の期待度 %.2f %%)\n", win > 0 ? 1.0 / win : 0.0,
+            lottery > 0 ? 100.0 * win / lottery : 0.0);
+    fprintf(report, "  当選時の内訳  : ダーリン %.2f %% / フランクス %.2f %% / BB EX %.2f %% / EP %.2f %%\n",
+            win > 0 ? 100.0 * table.result_prob[BONUS_DARLING] / win : 0.0,
+            win > 0 ? 100.0 * table.result_prob[BONUS_FRANXX] / win : 0.0,
+            win > 0 ? 100.0 * table.result_prob[BONUS_BB_EX] / win : 0.0,
+            win > 0 ? 100.0 * table.result_prob[BONUS_EPISODE] / win : 0.0);
+    if (lottery > 0) {
+        for (int k = 0; k < PRES_ODDS_KIND_COUNT; k++) print_pres_rows(report, &table, (PresOddsKind)k);
+    }
+    PresOdds_Free(&table);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    // 共通オプション (コマンドより前)
+    while (argc >= 3 && strncmp(argv[1], "--", 2) == 0) {
+        if (strcmp(argv[1], "--spec") == 0) {
+            MachineSpec spec;
+            if (!Spec_LoadCached(argv[2], NULL, &spec)) {
+                return 1;
+            }
+            Spec_Set(&spec);
+        } else if (strcmp(argv[1], "--cpus") == 0) {
+            if (!ThreadConfig_SetCpus(THREAD_ROLE_SIM_WORKER, argv[2])) return 1;
+        } else if (strcmp(argv[1], "--priority") == 0) {
+            if (!ThreadConfig_SetPriority(THREAD_ROLE_SIM_WORKER, argv[2])) return 1;
+        } else {
+            break;
+        }
+        argc -= 2;
+        argv += 2;
+    }
+    // 呼び出し元スレッドも Parallel_Run のワーカー 0 として働く
+    ThreadConfig_Apply(THREAD_ROLE_SIM_WORKER, 0);
+    if (argc < 2) {
+        print_usage();
+        return 1;
+    }
+
+    if (!Sim_InitTables()) {
+        return 1;
+    }
+
+    if (strcmp(argv[1], "run") == 0) {
+        return cmd_run(argc - 2, argv + 2);
+    }
+    if (strcmp(argv[1], "tables") == 0) {
+        return cmd_tables();
+    }
+    if (strcmp(argv[1], "bbex") == 0) {
+        return cmd_bbex(argc - 2, argv + 2);
+    }
+    if (strcmp(argv[1], "sens") == 0) {
+        return cmd_sens(argc - 2, argv + 2);
+    }
+    if (strcmp(argv[1], "sweep") == 0) {
+        return cmd_sweep(argc - 2, argv + 2);
+    }
+    if (strcmp(argv[1], "fuzz") == 0) {
+        return cmd_fuzz(argc - 2, argv + 2);
+    }
+    if (strcmp(argv[1], "conform") == 0) {
+        return cmd_conform(argc - 2, argv + 2);
+    }
+    if (strcmp(argv[1], "session") == 0) {
+        return cmd_session(argc - 2, argv + 2);
+    }
+    if (strcmp(argv[1], "hall") == 0) {
+        return cmd_hall(argc - 2, argv + 2);
+    }
+    if (strcmp(argv[1], "seek") == 0) {
+        return cmd_seek(argc - 2, argv + 2);
+    }
+    if (strcmp(argv[1], "day") == 0) {
+        return cmd_day(argc - 2, argv + 2);
+    }
+    if (strcmp(argv[1], "episode") == 0) {
+        return cmd_episode(argc - 2, argv + 2);
+    }
+    if (strcmp(argv[1], "value") == 0) {
+        return cmd_value(argc - 2, argv + 2);
+    }
+    if (strcmp(argv[1], "digest") == 0) {
+        return cmd_digest(argc - 2, argv + 2);
+    }
+    if (strcmp(argv[1], "pace") == 0) {
+        return cmd_pace(argc - 2, argv + 2);
+    }
+    if (strcmp(argv[1], "pres") == 0) {
+        return cmd_pres(argc - 2, argv + 2);
+    }
+    if (strcmp(argv[1], "spec") == 0) {
+        Spec_Print(stdout, Spec_Get());
+        return 0;
+    }
+
+    print_usage();
+    return 1;
+}
@@ -0,0 +1,1051 @@
+#include "spec.h"
+#include "at.h"
+#include "cz.h"
+#include "normal.h"
+#include <ctype.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SPEC_MAX_LINE_LEN 1024
+#define SPEC_CACHE_MAGIC "FXSPEC\0"
+#define SPEC_CACHE_VERSION 3
+
+// --- セクション ---
+typedef enum {
+    SPEC_SECTION_NONE,
+    SPEC_SECTION_IGNORED,       // 他モジュールのセクション ([Media] など)
+    SPEC_SECTION_NORMAL,
+    SPEC_SECTION_CZ,
+    SPEC_SECTION_LOTTERY_NORMAL,
+    SPEC_SECTION_LOTTERY_FRANXX,
+    SPEC_SECTION_PAYOUT,
+    SPEC_SECTION_BONUS_AT,
+    SPEC_SECTION_AT,
+    SPEC_SECTION_AT_GCOUNT,
+    SPEC_SECTION_AT_PAYOUT_ADDON,
+    SPEC_SECTION_AT_EX_STOCK,
+    SPEC_SECTION_AT_TSUREDASHI,
+    SPEC_SECTION_AT_HIYOKU,
+} SpecSection;
+
+typedef struct {
+    const char* name;
+    SpecSection section;
+} SpecSectionName;
+
+static const SpecSectionName k_section_names[] = {
+    { "[Media]",                SPEC_SECTION_IGNORED },
+    { "[Normal]",               SPEC_SECTION_NORMAL },
+    { "[CZ]",                   SPEC_SECTION_CZ },
+    { "[Lottery.Normal]",       SPEC_SECTION_LOTTERY_NORMAL },
+    { "[Lottery.FranxxHighProb]", SPEC_SECTION_LOTTERY_FRANXX },
+    { "[Payout]",               SPEC_SECTION_PAYOUT },
+    { "[BonusAT]",              SPEC_SECTION_BONUS_AT },
+    { "[AT]",                   SPEC_SECTION_AT },
+    { "[AT.GCount]",            SPEC_SECTION_AT_GCOUNT },
+    { "[AT.PayoutAddOn]",       SPEC_SECTION_AT_PAYOUT_ADDON },
+    { "[AT.ExStock]",           SPEC_SECTION_AT_EX_STOCK },
+    { "[AT.Tsuredashi]",        SPEC_SECTION_AT_TSUREDASHI },
+    { "[AT.Hiyoku]",            SPEC_SECTION_AT_HIYOKU },
+};
+
+// バイナリキャッシュのヘッダ (構造体サイズ・組み込みの既定スペック込みで一致したときだけ使う)
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t spec_size;
+    uint64_t source_hash;
+    uint64_t default_hash;  // Spec_GetDefault の Spec_GetHash (記載のない項目は既定値を使うため)
+} SpecCacheHeader;
+
+static MachineSpec g_spec;
+static bool g_spec_ready = false;
+
+// --- 内部ヘルパー関数 ---
+
+static void set_rates(SpecRateList* list, const WeightedEntry* entries, int count) {
+    list->count = count;
+    for (int i = 0; i < count; i++) list->entries[i] = entries[i];
+}
+
+#define SET_RATES(list, ...) do { \
+        const WeightedEntry e_[] = { __VA_ARGS__ }; \
+        set_rates((list), e_, (int)(sizeof(e_) / sizeof(e_[0]))); \
+    } while (0)
+
+static char* trim_whitespace(char* str) {
+    while (isspace((unsigned char)*str)) str++;
+    if (*str == 0) return str;
+    char* end = str + strlen(str) - 1;
+    while (end > str && isspace((unsigned char)*end)) end--;
+    *(end + 1) = 0;
+    return str;
+}
+
+// "a, b, c" 形式の整数列 (戻り値は読めた個数、不正な場合は -1)
+static int parse_int_list(const char* text, int* out, int max_count) {
+    int count = 0;
+    const char* p = text;
+    while (*p) {
+        char* end;
+        long v = strtol(p, &end, 10);
+        if (end == p || count >= max_count || v < INT_MIN || v > INT_MAX) return -1;
+        out[count++] = (int)v;
+        p = end;
+        while (isspace((unsigned char)*p)) p++;
+        if (*p == ',') p++;
+        else if (*p != '\0') return -1;
+        while (isspace((unsigned char)*p)) p++;
+    }
+    return count;
+}
+
+// "値:重み, 値:重み" 形式の振り分け
+static bool parse_rate_list(const char* text, SpecRateList* list) {
+    list->count = 0;
+    const char* p = text;
+    while (*p) {
+        char* end;
+        long value = strtol(p, &end, 10);
+        if (end == p || *end != ':' || list->count >= SPEC_MAX_CHOICES || value < INT_MIN || value > INT_MAX) {
+            return false;
+        }
+        p = end + 1;
+        long long weight = strtoll(p, &end, 10);
+        if (end == p || weight < 0) return false;
+        list->entries[list->count].value = (int)value;
+        list->entries[list->count].weight = (uint64_t)weight;
+        list->count++;
+        p = end;
+        while (isspace((unsigned char)*p)) p++;
+        if (*p == ',') p++;
+        else if (*p != '\0') return false;
+        while (isspace((unsigned char)*p)) p++;
+    }
+    return list->count > 0;
+}
+
+static bool parse_single_int(const char* text, int* out) {
+    return parse_int_list(text, out, 1) == 1;
+}
+
+// セクションに入ったとき、そのセクションが定義する値をクリアする
+static void clear_section(MachineSpec* spec, SpecSection section) {
+    switch (section) {
+        case SPEC_SECTION_NORMAL:
+            memset(spec->normal_cz, 0, sizeof(spec->normal_cz));
+            memset(spec->normal_at, 0, sizeof(spec->normal_at));
+            break;
+        case SPEC_SECTION_CZ:
+            memset(spec->cz_at, 0, sizeof(spec->cz_at));
+            break;
+        case SPEC_SECTION_LOTTERY_NORMAL:
+            memset(spec->lottery_weight[LOTTERY_TABLE_NORMAL], 0, sizeof(spec->lottery_weight[0]));
+            break;
+        case SPEC_SECTION_LOTTERY_FRANXX:
+            memset(spec->lottery_weight[LOTTERY_TABLE_FRANXX_HIGH_PROB], 0, sizeof(spec->lottery_weight[0]));
+            break;
+        case SPEC_SECTION_PAYOUT:
+            memset(spec->payout, 0, sizeof(spec->payout));
+            memset(spec->payout_oshijun_fail, 0, sizeof(spec->payout_oshijun_fail));
+            break;
+        case SPEC_SECTION_BONUS_AT:
+            memset(spec->bonus_at, 0, sizeof(spec->bonus_at));
+            break;
+        case SPEC_SECTION_AT_GCOUNT:
+            memset(spec->gcount_trigger, 0, sizeof(spec->gcount_trigger));
+            memset(spec->gcount, 0, sizeof(spec->gcount));
+            break;
+        case SPEC_SECTION_AT_PAYOUT_ADDON:
+            for (int y = 0; y < YAKU_COUNT; y++) SET_RATES(&spec->payout_addon[y], {0, SPEC_RATE_DENOMINATOR});
+            break;
+        case SPEC_SECTION_AT_EX_STOCK:
+            memset(spec->ex_stock, 0, sizeof(spec->ex_stock));
+            break;
+        case SPEC_SECTION_AT_TSUREDASHI:
+            memset(spec->tsuredashi, 0, sizeof(spec->tsuredashi));
+            break;
+        case SPEC_SECTION_AT_HIYOKU:
+            memset(spec->hiyoku_add, 0, sizeof(spec->hiyoku_add));
+            memset(spec->hiyoku_bonus, 0, sizeof(spec->hiyoku_bonus));
+            memset(spec->hiyoku_ex, 0, sizeof(spec->hiyoku_ex));
+            break;
+        default:
+            break;
+    }
+}
+
+// [AT] セクションの項目
+static bool parse_at_key(MachineSpec* spec, const char* key, const char* value) {
+    struct { const char* key; int* field; } scalars[] = {
+        { "TARGET_BB_INITIAL",       &spec->target_bb_initial },
+        { "TARGET_BB_HIGH_PROB",     &spec->target_bb_high_prob },
+        { "TARGET_FRANXX_BONUS",     &spec->target_franxx_bonus },
+        { "TARGET_BB_EX",            &spec->target_bb_ex },
+        { "TARGET_EP_BONUS",         &spec->target_ep_bonus },
+        { "TARGET_TSUREDASHI",       &spec->target_tsuredashi },
+        { "GAMES_ON_BB_INITIAL_END", &spec->games_on_bb_initial_end },
+        { "HIYOKU_LEVELUP_LV1",      &spec->hiyoku_levelup[HIYOKU_LV1] },
+        { "HIYOKU_LEVELUP_LV2",      &spec->hiyoku_levelup[HIYOKU_LV2] },
+        { "HIYOKU_LEVELUP_MAXX",     &spec->hiyoku_levelup[HIYOKU_MAXX] },
+    };
+    for (int i = 0; i < (int)(sizeof(scalars) / sizeof(scalars[0])); i++) {
+        if (strcmp(key, scalars[i].key) == 0) return parse_single_int(value, scalars[i].field);
+    }
+    if (strcmp(key, "BB_EX_CONTINUE_RATE") == 0) return parse_rate_list(value, &spec->bb_ex_continue_rate);
+    if (strcmp(key, "HIYOKU_INIT_LEVEL") == 0) return parse_rate_list(value, &spec->hiyoku_init_level);
+    return false;
+}
+
+// 役をキーとするセクション内の整数項目 ([Normal] の CEILING など)
+static int* find_section_scalar(MachineSpec* spec, SpecSection section, const char* key) {
+    if (section == SPEC_SECTION_NORMAL && strcmp(key, "CEILING") == 0) return &spec->normal_ceiling;
+    if (section == SPEC_SECTION_CZ && strcmp(key, "GAMES") == 0) return &spec->cz_games;
+    return NULL;
+}
+
+// 役をキーとするセクションの項目
+static bool parse_yaku_key(MachineSpec* spec, SpecSection section, YakuType y, const char* value) {
+    int v[5];
+    switch (section) {
+        case SPEC_SECTION_NORMAL:
+            if (parse_int_list(value, v, 2) != 2) return false;
+            spec->normal_cz[y] = v[0];
+            spec->normal_at[y] = v[1];
+            return true;
+        case SPEC_SECTION_CZ:
+            return parse_single_int(value, &spec->cz_at[y]);
+        case SPEC_SECTION_LOTTERY_NORMAL:
+            return parse_single_int(value, &spec->lottery_weight[LOTTERY_TABLE_NORMAL][y]);
+        case SPEC_SECTION_LOTTERY_FRANXX:
+            return parse_single_int(value, &spec->lottery_weight[LOTTERY_TABLE_FRANXX_HIGH_PROB][y]);
+        case SPEC_SECTION_PAYOUT: {
+            int n = parse_int_list(value, v, 2);
+            if (n < 1) return false;
+            spec->payout[y] = v[0];
+            spec->payout_oshijun_fail[y] = (n == 2) ? v[1] : v[0];
+            return true;
+        }
+        case SPEC_SECTION_BONUS_AT:
+            if (parse_int_list(value, v, 5) != 5) return false;
+            spec->bonus_at[y] = (SpecBonusRate){ v[0], v[1], v[2], v[3], v[4] };
+            return true;
+        case SPEC_SECTION_AT_GCOUNT: {
+            // "契機率 | G数:重み, ..."
+            char buf[SPEC_MAX_LINE_LEN];
+            snprintf(buf, sizeof(buf), "%s", value);
+            char* bar = strchr(buf, '|');
+            if (!bar) return false;
+            *bar = '\0';
+            return parse_single_int(trim_whitespace(buf), &spec->gcount_trigger[y]) &&
+                   parse_rate_list(trim_whitespace(bar + 1), &spec->gcount[y]);
+        }
+        case SPEC_SECTION_AT_PAYOUT_ADDON:
+            return parse_rate_list(value, &spec->payout_addon[y]);
+        case SPEC_SECTION_AT_EX_STOCK:
+            if (!parse_single_int(value, v)) return false;
+            spec->ex_stock[y] = (v[0] != 0);
+            return true;
+        case SPEC_SECTION_AT_TSUREDASHI:
+            return parse_single_int(value, &spec->tsuredashi[y]);
+        case SPEC_SECTION_AT_HIYOKU:
+            if (parse_int_list(value, v, 3) != 3) return false;
+            spec->hiyoku_add[y] = v[0];
+            spec->hiyoku_bonus[y] = v[1];
+            spec->hiyoku_ex[y] = v[2];
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool check_rate(const char* source, const char* what, YakuType y, int rate, int denominator) {
+    if (rate < 0 || rate > denominator) {
+        fprintf(stderr, "Spec[%s]: %s/%s の値 %d が範囲外です (0〜%d)\n",
+                source, what, GetYakuKey(y), rate, denominator);
+        return false;
+    }
+    return true;
+}
+
+static bool check_rate_list(const char* source, const char* what, const SpecRateList* list, uint64_t denominator) {
+    uint64_t total = 0;
+    for (int i = 0; i < list->count; i++) total += list->entries[i].weight;
+    if (total != denominator) {
+        fprintf(stderr, "Spec[%s]: %s の重みの合計 %llu が %llu ではありません\n",
+                source, what, (unsigned long long)total, (unsigned long long)denominator);
+        return false;
+    }
+    return true;
+}
+
+// AT の上乗せ (G数・差枚) は AtDelta の short に格納するため、値が short に収まることを確認する
+static bool check_short_values(const char* source, const char* what, const SpecRateList* list) {
+    bool ok = true;
+    for (int i = 0; i < list->count; i++) {
+        int value = list->entries[i].value;
+        if (value < SHRT_MIN || value > SHRT_MAX) {
+            fprintf(stderr, "Spec[%s]: %s の値 %d が範囲外です (%d〜%d)\n", source, what, value, SHRT_MIN, SHRT_MAX);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+static void print_rate_list(FILE* out, const SpecRateList* list) {
+    for (int i = 0; i < list->count; i++) {
+        fprintf(out, "%s%d:%llu", i > 0 ? ", " : "", list->entries[i].value,
+                (unsigned long long)list->entries[i].weight);
+    }
+}
+
+// FNV-1a (キャッシュの照合用)
+static uint64_t hash_bytes(const unsigned char* data, size_t size) {
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for (size_t i = 0; i < size; i++) {
+        h ^= data[i];
+        h *= 0x100000001B3ULL;
+    }
+    return h;
+}
+
+// 値をリトルエンディアンの 8 バイトとして混ぜる (ホストのバイト順・パディングによらない)
+static uint64_t hash_value(uint64_t h, uint64_t v) {
+    for (int b = 0; b < 8; b++) {
+        h ^= (v >> (b * 8)) & 0xFF;
+        h *= 0x100000001B3ULL;
+    }
+    return h;
+}
+
+static uint64_t hash_ints(uint64_t h, const int* values, int count) {
+    for (int i = 0; i < count; i++) h = hash_value(h, (uint64_t)(int64_t)values[i]);
+    return h;
+}
+
+static uint64_t hash_rate_list(uint64_t h, const SpecRateList* list) {
+    h = hash_ints(h, &list->count, 1);
+    for (int i = 0; i < list->count; i++) {
+        h = hash_value(h, (uint64_t)(int64_t)list->entries[i].value);
+        h = hash_value(h, list->entries[i].weight);
+    }
+    return h;
+}
+
+static unsigned char* read_whole_file(const char* path, size_t* size) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return NULL;
+    fseek(file, 0, SEEK_END);
+    long len = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    unsigned char* buf = (len >= 0) ? (unsigned char*)malloc((size_t)len + 1) : NULL;
+    if (buf && fread(buf, 1, (size_t)len, file) != (size_t)len) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(file);
+    if (buf) {
+        buf[len] = '\0';
+        *size = (size_t)len;
+    }
+    return buf;
+}
+
+// テキストをパースして spec に反映する (path はエラー表示用)
+static bool parse_spec_text(char* text, const char* path, MachineSpec* spec) {
+    SpecSection section = SPEC_SECTION_NONE;
+    bool ok = true;
+    int line_no = 0;
+
+    for (char* line = text; line; ) {
+        char* next = strchr(line, '\n');
+        if (next) *next++ = '\0';
+        line_no++;
+        line[strcspn(line, "\r")] = '\0';
+        char* trimmed = trim_whitespace(line);
+        line = next;
+
+        if (trimmed[0] == '#' || trimmed[0] == '\0') continue;
+
+        if (trimmed[0] == '[') {
+            section = SPEC_SECTION_NONE;
+            for (int i = 0; i < (int)(sizeof(k_section_names) / sizeof(k_section_names[0])); i++) {
+                if (strcmp(trimmed, k_section_names[i].name) == 0) section = k_section_names[i].section;
+            }
+            if (section == SPEC_SECTION_NONE) {
+                fprintf(stderr, "Spec[%s:%d]: 不明なセクション %s\n", path, line_no, trimmed);
+                ok = false;
+            }
+            clear_section(spec, section);
+            continue;
+        }
+        if (section == SPEC_SECTION_IGNORED) continue;
+
+        char* equals = strchr(trimmed, '=');
+        if (!equals || section == SPEC_SECTION_NONE) {
+            fprintf(stderr, "Spec[%s:%d]: 解釈できない行です\n", path, line_no);
+            ok = false;
+            continue;
+        }
+        *equals = '\0';
+        char* key = trim_whitespace(trimmed);
+        char* value = trim_whitespace(equals + 1);
+
+        bool parsed;
+        int* scalar = find_section_scalar(spec, section, key);
+        if (section == SPEC_SECTION_AT) {
+            parsed = parse_at_key(spec, key, value);
+        } else if (scalar) {
+            parsed = parse_single_int(value, scalar);
+        } else {
+            YakuType y;
+            if (!FindYakuByKey(key, &y)) {
+                fprintf(stderr, "Spec[%s:%d]: 不明な役 %s\n", path, line_no, key);
+                ok = false;
+                continue;
+            }
+            parsed = parse_yaku_key(spec, section, y, value);
+        }
+        if (!parsed) {
+            fprintf(stderr, "Spec[%s:%d]: 項目 %s (値 \"%s\") が不正です\n", path, line_no, key, value);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+// パラメータ名の解決結果 (整数項目 または 振り分けの 1 要素)
+typedef struct {
+    int* field;          // 整数項目
+    SpecRateList* list;  // 振り分け
+    int index;
+    bool list_value;     // true: 要素の値 / false: 要素の重み
+    int* balance;        // 設定時に合計を保つための調整先 (小役抽選値)
+} SpecParamRef;
+
+#define SPEC_PARAM_MAX_TOKENS 5
+
+static bool resolve_list_param(SpecRateList* list, char** tok, int n, SpecParamRef* ref) {
+    if (n < 1 || n > 2) return false;
+    char* end;
+    long index = strtol(tok[0], &end, 10);
+    if (*end != '\0' || index < 0 || index >= list->count) return false;
+    if (n == 2 && strcmp(tok[1], "value") != 0) return false;
+    ref->list = list;
+    ref->index = (int)index;
+    ref->list_value = (n == 2);
+    return true;
+}
+
+static bool resolve_param(MachineSpec* spec, const char* name, SpecParamRef* ref) {
+    char buf[SPEC_MAX_LINE_LEN];
+    char* tok[SPEC_PARAM_MAX_TOKENS];
+    int n = 0;
+    snprintf(buf, sizeof(buf), "%s", name);
+    for (char* p = strtok(buf, "."); p; p = strtok(NULL, ".")) {
+        if (n >= SPEC_PARAM_MAX_TOKENS) return false;
+        tok[n++] = p;
+    }
+    memset(ref, 0, sizeof(*ref));
+    if (n < 2) return false;
+
+    YakuType y;
+    if (strcmp(tok[0], "Normal") == 0) {
+        if (n == 2) ref->field = find_section_scalar(spec, SPEC_SECTION_NORMAL, tok[1]);
+        if (n == 3 && FindYakuByKey(tok[1], &y)) {
+            if (strcmp(tok[2], "cz") == 0) ref->field = &spec->normal_cz[y];
+            else if (strcmp(tok[2], "at") == 0) ref->field = &spec->normal_at[y];
+        }
+        return ref->field != NULL;
+    }
+    if (strcmp(tok[0], "CZ") == 0 && n == 2) {
+        ref->field = find_section_scalar(spec, SPEC_SECTION_CZ, tok[1]);
+        if (!ref->field && FindYakuByKey(tok[1], &y)) ref->field = &spec->cz_at[y];
+        return ref->field != NULL;
+    }
+    if (strcmp(tok[0], "Lottery") == 0 && n == 3 && FindYakuByKey(tok[2], &y)) {
+        int t;
+        if (strcmp(tok[1], "Normal") == 0) t = LOTTERY_TABLE_NORMAL;
+        else if (strcmp(tok[1], "FranxxHighProb") == 0) t = LOTTERY_TABLE_FRANXX_HIGH_PROB;
+        else return false;
+        ref->field = &spec->lottery_weight[t][y];
+        if (y != YAKU_HAZURE) ref->balance = &spec->lottery_weight[t][YAKU_HAZURE];
+        return true;
+    }
+    if (strcmp(tok[0], "Payout") == 0 && n == 2 && FindYakuByKey(tok[1], &y)) {
+        ref->field = &spec->payout[y];
+        return true;
+    }
+    if (strcmp(tok[0], "BonusAT") == 0 && n == 3 && FindYakuByKey(tok[1], &y)) {
+        SpecBonusRate* b = &spec->bonus_at[y];
+        if (strcmp(tok[2], "success") == 0) ref->field = &b->success;
+        else if (strcmp(tok[2], "fb") == 0) ref->field = &b->fb;
+        else if (strcmp(tok[2], "db") == 0) ref->field = &b->db;
+        else if (strcmp(tok[2], "ex") == 0) ref->field = &b->ex;
+        else if (strcmp(tok[2], "ep") == 0) ref->field = &b->ep;
+        return ref->field != NULL;
+    }
+    if (strcmp(tok[0], "AT") != 0) return false;
+
+    if (strcmp(tok[1], "BB_EX_CONTINUE_RATE") == 0) {
+        return resolve_list_param(&spec->bb_ex_continue_rate, tok + 2, n - 2, ref);
+    }
+    if (strcmp(tok[1], "HIYOKU_INIT_LEVEL") == 0) {
+        return resolve_list_param(&spec->hiyoku_init_level, tok + 2, n - 2, ref);
+    }
+    if (n >= 3 && FindYakuByKey(tok[2], &y)) {
+        if (strcmp(tok[1], "GCount") == 0 && n == 4 && strcmp(tok[3], "trigger") == 0) {
+            ref->field = &spec->gcount_trigger[y];
+            return true;
+        }
+        if (strcmp(tok[1], "GCount") == 0) return resolve_list_param(&spec->gcount[y], tok + 3, n - 3, ref);
+        if (strcmp(tok[1], "PayoutAddOn") == 0) return resolve_list_param(&spec->payout_addon[y], tok + 3, n - 3, ref);
+        if (strcmp(tok[1], "Tsuredashi") == 0 && n == 3) {
+            ref->field = &spec->tsuredashi[y];
+            return true;
+        }
+        if (strcmp(tok[1], "Hiyoku") == 0 && n == 4) {
+            if (strcmp(tok[3], "add") == 0) ref->field = &spec->hiyoku_add[y];
+            else if (strcmp(tok[3], "bonus") == 0) ref->field = &spec->hiyoku_bonus[y];
+            else if (strcmp(tok[3], "ex") == 0) ref->field = &spec->hiyoku_ex[y];
+            return ref->field != NULL;
+        }
+        return false;
+    }
+    // [AT] の整数項目 (parse_at_key と同じ名前)
+    if (n != 2) return false;
+    struct { const char* key; int* field; } scalars[] = {
+        { "TARGET_BB_INITIAL",       &spec->target_bb_initial },
+        { "TARGET_BB_HIGH_PROB",     &spec->target_bb_high_prob },
+        { "TARGET_FRANXX_BONUS",     &spec->target_franxx_bonus },
+        { "TARGET_BB_EX",            &spec->target_bb_ex },
+        { "TARGET_EP_BONUS",         &spec->target_ep_bonus },
+        { "TARGET_TSUREDASHI",       &spec->target_tsuredashi },
+        { "GAMES_ON_BB_INITIAL_END", &spec->games_on_bb_initial_end },
+        { "HIYOKU_LEVELUP_LV1",      &spec->hiyoku_levelup[HIYOKU_LV1] },
+        { "HIYOKU_LEVELUP_LV2",      &spec->hiyoku_levelup[HIYOKU_LV2] },
+        { "HIYOKU_LEVELUP_MAXX",     &spec->hiyoku_levelup[HIYOKU_MAXX] },
+    };
+    for (int i = 0; i < (int)(sizeof(scalars) / sizeof(scalars[0])); i++) {
+        if (strcmp(tok[1], scalars[i].key) == 0) {
+            ref->field = scalars[i].field;
+            return true;
+        }
+    }
+    return false;
+}
+
+// キャッシュを一時ファイルに書いてから置き換える (書き込み中に止まっても壊れたキャッシュを残さない)
+static bool write_cache(const char* cache_path, const SpecCacheHeader* header, const MachineSpec* spec) {
+    char temp_path[SPEC_MAX_LINE_LEN + sizeof(".tmp")];
+    int len = snprintf(temp_path, sizeof(temp_path), "%s.tmp", cache_path);
+    if (len < 0 || (size_t)len >= sizeof(temp_path)) return false;
+    FILE* cache = fopen(temp_path, "wb");
+    if (!cache) return false;
+    bool ok = fwrite(header, sizeof(*header), 1, cache) == 1 &&
+              fwrite(spec, sizeof(MachineSpec), 1, cache) == 1;
+    if (fflush(cache) != 0) ok = false;
+    if (fclose(cache) != 0) ok = false;
+
+    // Windows の rename は既存のファイルを上書きしない
+#ifdef _WIN32
+    if (ok) remove(cache_path);
+#endif
+    if (ok && rename(temp_path, cache_path) != 0) ok = false;
+    if (!ok) remove(temp_path);
+    return ok;
+}
+
+// --- 公開関数 ---
+
+void Spec_GetDefault(MachineSpec* spec) {
+    memset(spec, 0, sizeof(*spec));
+
+    // 小役抽選値 (分母 65536)
+    static const int normal[YAKU_COUNT] = {
+        [YAKU_OSHIJUN_BELL_LMR] = 5545, [YAKU_OSHIJUN_BELL_LRM] = 5545,
+        [YAKU_OSHIJUN_BELL_MLR] = 9449, [YAKU_OSHIJUN_BELL_MRL] = 9449,
+        [YAKU_OSHIJUN_BELL_RLM] = 9449, [YAKU_OSHIJUN_BELL_RML] = 9449,
+        [YAKU_REPLAY] = 8402, [YAKU_COMMON_BELL] = 4615, [YAKU_CHERRY] = 1280,
+        [YAKU_CHANCE_ME] = 200, [YAKU_FRANXX_ME] = 368, [YAKU_STRELITZIA_ME] = 28,
+        [YAKU_HAZURE] = 1757,
+    };
+    static const int franxx[YAKU_COUNT] = {
+        [YAKU_HP_REVERSE_FRANXX] = 4965, [YAKU_HP_REVERSE_STRONG_FRANXX] = 8,
+        [YAKU_HP_REVERSE_STRELITZIA] = 8, [YAKU_REPLAY] = 3421,
+        [YAKU_OSHIJUN_BELL_LMR] = 5545, [YAKU_OSHIJUN_BELL_LRM] = 5545,
+        [YAKU_OSHIJUN_BELL_MLR] = 9449, [YAKU_OSHIJUN_BELL_MRL] = 9449,
+        [YAKU_OSHIJUN_BELL_RLM] = 9449, [YAKU_OSHIJUN_BELL_RML] = 9449,
+        [YAKU_COMMON_BELL] = 4615, [YAKU_CHERRY] = 1280, [YAKU_CHANCE_ME] = 200,
+        [YAKU_FRANXX_ME] = 368, [YAKU_STRELITZIA_ME] = 28, [YAKU_HAZURE] = 1757,
+    };
+    memcpy(spec->lottery_weight[LOTTERY_TABLE_NORMAL], normal, sizeof(normal));
+    memcpy(spec->lottery_weight[LOTTERY_TABLE_FRANXX_HIGH_PROB], franxx, sizeof(franxx));
+
+    // 通常時 (レア役で CZ / AT直撃、天井 1000G で AT)
+    spec->normal_ceiling = NORMAL_CEILING_GAMES;
+    spec->normal_cz[YAKU_CHERRY] = 40;
+    spec->normal_cz[YAKU_CHANCE_ME] = 200;
+    spec->normal_cz[YAKU_FRANXX_ME] = 300;
+    spec->normal_at[YAKU_CHANCE_ME] = 20;
+    spec->normal_at[YAKU_FRANXX_ME] = 10;
+    spec->normal_at[YAKU_STRELITZIA_ME] = SPEC_RATE_DENOMINATOR;
+
+    // CZ (10G、高確役・レア役で AT)
+    spec->cz_games = CZ_GAMES;
+    spec->cz_at[YAKU_COMMON_BELL] = 20;
+    spec->cz_at[YAKU_CHERRY] = 400;
+    spec->cz_at[YAKU_HP_REVERSE_FRANXX] = 350;
+    spec->cz_at[YAKU_CHANCE_ME] = SPEC_RATE_DENOMINATOR;
+    spec->cz_at[YAKU_FRANXX_ME] = SPEC_RATE_DENOMINATOR;
+    spec->cz_at[YAKU_STRELITZIA_ME] = SPEC_RATE_DENOMINATOR;
+    spec->cz_at[YAKU_HP_REVERSE_STRONG_FRANXX] = SPEC_RATE_DENOMINATOR;
+    spec->cz_at[YAKU_HP_REVERSE_STRELITZIA] = SPEC_RATE_DENOMINATOR;
+
+    // 払い出し (押順ベルは押し順失敗で 0 枚)
+    for (int y = YAKU_OSHIJUN_BELL_LMR; y <= YAKU_OSHIJUN_BELL_RML; y++) spec->payout[y] = 10;
+    spec->payout[YAKU_REPLAY] = 3;
+    spec->payout[YAKU_COMMON_BELL] = 1;
+    spec->payout[YAKU_CHERRY] = 3;
+    spec->payout[YAKU_CHANCE_ME] = 3;
+    spec->payout[YAKU_FRANXX_ME] = 3;
+    spec->payout[YAKU_STRELITZIA_ME] = 3;
+    spec->payout[YAKU_HP_REVERSE_FRANXX] = 3;
+    spec->payout[YAKU_HP_REVERSE_STRONG_FRANXX] = 3;
+    spec->payout[YAKU_HP_REVERSE_STRELITZIA] = 3;
+    spec->payout[YAKU_FRANXX_SYMBOL] = 15;
+    for (int y = 0; y < YAKU_COUNT; y++) spec->payout_oshijun_fail[y] = spec->payout[y];
+    for (int y = YAKU_OSHIJUN_BELL_LMR; y <= YAKU_OSHIJUN_BELL_RML; y++) spec->payout_oshijun_fail[y] = 0;
+
+    // AT高確率中のボーナス抽選 (当否 / FB, DB, EX, EP)
+    spec->bonus_at[YAKU_REPLAY]      = (SpecBonusRate){ 318, 370, 500, 130, 0 };
+    spec->bonus_at[YAKU_COMMON_BELL] = (SpecBonusRate){ 379, 370, 500, 130, 0 };
+    spec->bonus_at[YAKU_CHANCE_ME]   = (SpecBonusRate){ 1000, 0, 800, 190, 10 };
+    spec->bonus_at[YAKU_CHERRY]      = (SpecBonusRate){ 1000, 500, 400, 90, 10 };
+    spec->bonus_at[YAKU_FRANXX_ME]   = (SpecBonusRate){ 1000, 250, 375, 365, 10 };
+    spec->bonus_at[YAKU_STRELITZIA_ME]            = (SpecBonusRate){ 1000, 0, 0, 950, 50 };
+    spec->bonus_at[YAKU_HP_REVERSE_STRONG_FRANXX] = (SpecBonusRate){ 1000, 0, 0, 950, 50 };
+    spec->bonus_at[YAKU_HP_REVERSE_STRELITZIA]    = (SpecBonusRate){ 1000, 0, 0, 950, 50 };
+    // レア役は 100% 当選だが振り分けなし (演出上は継続扱い)
+    spec->bonus_at[YAKU_HP_REVERSE_FRANXX]        = (SpecBonusRate){ 1000, 0, 0, 0, 0 };
+
+    // 目標差枚・G数
+    spec->target_bb_initial = PAYOUT_TARGET_BB_INITIAL;
+    spec->target_bb_high_prob = PAYOUT_TARGET_BB_HIGH_PROB;
+    spec->target_franxx_bonus = PAYOUT_TARGET_FRANXX_BONUS;
+    spec->target_bb_ex = PAYOUT_TARGET_BB_EX;
+    spec->target_ep_bonus = PAYOUT_TARGET_EP_BONUS;
+    spec->target_tsuredashi = PAYOUT_TARGET_TSUREDASHI;
+    spec->games_on_bb_initial_end = GAMES_ON_BB_INITIAL_END;
+    SET_RATES(&spec->bb_ex_continue_rate, {50, 95}, {80, 5});
+    SET_RATES(&spec->hiyoku_init_level, {HIYOKU_MAXX, 1}, {HIYOKU_LV2, 215}, {HIYOKU_LV1, 784});
+    spec->hiyoku_levelup[HIYOKU_LV1] = 215;
+    spec->hiyoku_levelup[HIYOKU_LV2] = 31;
+
+    // G数上乗せ (共通ベルのみ 6.1%、レア役は 100%)
+    spec->gcount_trigger[YAKU_COMMON_BELL] = 61;
+    spec->gcount_trigger[YAKU_CHERRY] = SPEC_RATE_DENOMINATOR;
+    spec->gcount_trigger[YAKU_CHANCE_ME] = SPEC_RATE_DENOMINATOR;
+    spec->gcount_trigger[YAKU_FRANXX_ME] = SPEC_RATE_DENOMINATOR;
+    SET_RATES(&spec->gcount[YAKU_COMMON_BELL], {1, 967}, {3, 33});
+    SET_RATES(&spec->gcount[YAKU_CHERRY], {1, 997}, {3, 2}, {5, 1});
+    SET_RATES(&spec->gcount[YAKU_CHANCE_ME], {1, 750}, {2, 232}, {3, 16}, {5, 2});
+    SET_RATES(&spec->gcount[YAKU_FRANXX_ME], {1, 875}, {2, 121}, {3, 2}, {5, 2});
+
+    // 差枚数上乗せ
+    for (int y = 0; y < YAKU_COUNT; y++) SET_RATES(&spec->payout_addon[y], {0, SPEC_RATE_DENOMINATOR});
+    SET_RATES(&spec->payout_addon[YAKU_COMMON_BELL], {0, 984}, {30, 8}, {50, 4}, {100, 4});
+    SET_RATES(&spec->payout_addon[YAKU_CHERRY], {10, 750}, {30, 242}, {50, 4}, {100, 4});
+    SET_RATES(&spec->payout_addon[YAKU_CHANCE_ME], {30, 750}, {50, 164}, {100, 78}, {500, 4}, {1000, 4});
+    SET_RATES(&spec->payout_addon[YAKU_FRANXX_ME], {30, 871}, {50, 125}, {100, 2}, {500, 1}, {1000, 1});
+    SET_RATES(&spec->payout_addon[YAKU_STRELITZIA_ME], {100, 844}, {500, 78}, {1000, 78});
+    SET_RATES(&spec->payout_addon[YAKU_HP_REVERSE_STRONG_FRANXX], {100, 844}, {500, 78}, {1000, 78});
+    SET_RATES(&spec->payout_addon[YAKU_HP_REVERSE_STRELITZIA], {100, 844}, {500, 78}, {1000, 78});
+
+    // BB EX ストック確定役
+    spec->ex_stock[YAKU_STRELITZIA_ME] = true;
+    spec->ex_stock[YAKU_HP_REVERSE_STRONG_FRANXX] = true;
+    spec->ex_stock[YAKU_HP_REVERSE_STRELITZIA] = true;
+
+    // 連れ出し率 (ストレリチア系は 100% + BB EX へ)
+    spec->tsuredashi[YAKU_CHERRY] = 78;
+    spec->tsuredashi[YAKU_CHANCE_ME] = 500;
+    spec->tsuredashi[YAKU_FRANXX_ME] = 250;
+    spec->tsuredashi[YAKU_STRELITZIA_ME] = SPEC_RATE_DENOMINATOR;
+    spec->tsuredashi[YAKU_HP_REVERSE_STRELITZIA] = SPEC_RATE_DENOMINATOR;
+    spec->tsuredashi[YAKU_HP_REVERSE_STRONG_FRANXX] = SPEC_RATE_DENOMINATOR;
+
+    // 比翼BEATS (上乗せ率 / ボーナス当選率 / EX 振り分け)
+    for (int y = YAKU_OSHIJUN_BELL_LMR; y <= YAKU_OSHIJUN_BELL_RML; y++) spec->hiyoku_add[y] = 350;
+    spec->hiyoku_add[YAKU_COMMON_BELL] = SPEC_RATE_DENOMINATOR;
+    spec->hiyoku_add[YAKU_REPLAY] = SPEC_RATE_DENOMINATOR;
+    for (int y = 0; y < YAKU_COUNT; y++) {
+        if (IsRareYaku((YakuType)y)) spec->hiyoku_add[y] = SPEC_RATE_DENOMINATOR;
+    }
+    spec->hiyoku_bonus[YAKU_CHANCE_ME] = SPEC_RATE_DENOMINATOR;
+    spec->hiyoku_bonus[YAKU_STRELITZIA_ME] = SPEC_RATE_DENOMINATOR;
+    spec->hiyoku_bonus[YAKU_HP_REVERSE_STRONG_FRANXX] = SPEC_RATE_DENOMINATOR;
+    spec->hiyoku_bonus[YAKU_FRANXX_ME] = 500;
+    spec->hiyoku_bonus[YAKU_CHERRY] = 125;
+    spec->hiyoku_ex[YAKU_CHANCE_ME] = 133;
+    spec->hiyoku_ex[YAKU_CHERRY] = 155;
+    spec->hiyoku_ex[YAKU_FRANXX_ME] = 141;
+    spec->hiyoku_ex[YAKU_STRELITZIA_ME] = SPEC_RATE_DENOMINATOR;
+    spec->hiyoku_ex[YAKU_HP_REVERSE_STRONG_FRANXX] = SPEC_RATE_DENOMINATOR;
+}
+
+bool Spec_Validate(const MachineSpec* spec, const char* source) {
+    const char* src = source ? source : "spec";
+    const int D = SPEC_RATE_DENOMINATOR;
+    char what[64];
+    bool ok = true;
+
+    for (int t = 0; t < LOTTERY_TABLE_COUNT; t++) {
+        long long total = 0;
+        for (int y = 0; y < YAKU_COUNT; y++) {
+            ok &= check_rate(src, "Lottery", (YakuType)y, spec->lottery_weight[t][y], LOTTERY_DENOMINATOR);
+            total += spec->lottery_weight[t][y];
+        }
+        if (total != LOTTERY_DENOMINATOR) {
+            fprintf(stderr, "Spec[%s]: 小役抽選テーブル %d の合計 %lld が %d ではありません\n",
+                    src, t, total, LOTTERY_DENOMINATOR);
+            ok = false;
+        }
+    }
+
+    if (spec->normal_ceiling <= 0 || spec->cz_games <= 0) {
+        fprintf(stderr, "Spec[%s]: Normal/CEILING と CZ/GAMES は 1 以上にしてください\n", src);
+        ok = false;
+    }
+
+    for (int y = 0; y < YAKU_COUNT; y++) {
+        YakuType yaku = (YakuType)y;
+        const SpecBonusRate* b = &spec->bonus_at[y];
+        ok &= check_rate(src, "Normal", yaku, spec->normal_cz[y], D);
+        ok &= check_rate(src, "Normal", yaku, spec->normal_at[y], D);
+        ok &= check_rate(src, "CZ", yaku, spec->cz_at[y], D);
+        if (spec->payout[y] < 0 || spec->payout_oshijun_fail[y] < 0) {
+            fprintf(stderr, "Spec[%s]: Payout/%s が負の値です\n", src, GetYakuKey(yaku));
+            ok = false;
+        }
+        ok &= check_rate(src, "BonusAT", yaku, b->success, D);
+        ok &= check_rate(src, "BonusAT", yaku, b->fb + b->db + b->ex + b->ep, D);
+        if (b->fb < 0 || b->db < 0 || b->ex < 0 || b->ep < 0) {
+            fprintf(stderr, "Spec[%s]: BonusAT/%s の振り分けが負の値です\n", src, GetYakuKey(yaku));
+            ok = false;
+        }
+        ok &= check_rate(src, "AT.GCount", yaku, spec->gcount_trigger[y], D);
+        snprintf(what, sizeof(what), "AT.GCount/%s", GetYakuKey(yaku));
+        if (spec->gcount_trigger[y] > 0 && !spec->ex_stock[y]) {
+            ok &= check_rate_list(src, what, &spec->gcount[y], D);
+        }
+        ok &= check_short_values(src, what, &spec->gcount[y]);
+        snprintf(what, sizeof(what), "AT.PayoutAddOn/%s", GetYakuKey(yaku));
+        ok &= check_rate_list(src, what, &spec->payout_addon[y], D);
+        ok &= check_short_values(src, what, &spec->payout_addon[y]);
+        ok &= check_rate(src, "AT.Tsuredashi", yaku, spec->tsuredashi[y], D);
+        ok &= check_rate(src, "AT.Hiyoku", yaku, spec->hiyoku_add[y], D);
+        ok &= check_rate(src, "AT.Hiyoku", yaku, spec->hiyoku_bonus[y], D);
+        ok &= check_rate(src, "AT.Hiyoku", yaku, spec->hiyoku_ex[y], D);
+    }
+
+    int targets[] = {
+        spec->target_bb_initial, spec->target_bb_high_prob, spec->target_franxx_bonus,
+        spec->target_bb_ex, spec->target_ep_bonus, spec->target_tsuredashi, spec->games_on_bb_initial_end,
+    };
+    for (int i = 0; i < (int)(sizeof(targets) / sizeof(targets[0])); i++) {
+        if (targets[i] <= 0) {
+            fprintf(stderr, "Spec[%s]: [AT] の目標差枚/G数は 1 以上にしてください\n", src);
+            ok = false;
+            break;
+        }
+    }
+
+    ok &= check_rate_list(src, "AT/BB_EX_CONTINUE_RATE", &spec->bb_ex_continue_rate, SPEC_BB_EX_RATE_DENOMINATOR);
+    for (int i = 0; i < spec->bb_ex_continue_rate.count; i++) {
+        int rate = spec->bb_ex_continue_rate.entries[i].value;
+        if (rate < 0 || rate >= SPEC_BB_EX_RATE_DENOMINATOR) {
+            fprintf(stderr, "Spec[%s]: BB EX 継続率 %d%% は 0〜99 にしてください\n", src, rate);
+            ok = false;
+        }
+    }
+    ok &= check_rate_list(src, "AT/HIYOKU_INIT_LEVEL", &spec->hiyoku_init_level, D);
+    for (int i = 0; i < spec->hiyoku_init_level.count; i++) {
+        int level = spec->hiyoku_init_level.entries[i].value;
+        if (level < HIYOKU_LV1 || level > HIYOKU_MAXX) {
+            fprintf(stderr, "Spec[%s]: 比翼BEATS レベル %d は 1〜3 にしてください\n", src, level);
+            ok = false;
+        }
+    }
+    for (int level = HIYOKU_LV1; level <= HIYOKU_MAXX; level++) {
+        if (spec->hiyoku_levelup[level] < 0 || spec->hiyoku_levelup[level] > D) {
+            fprintf(stderr, "Spec[%s]: HIYOKU_LEVELUP の値 %d が範囲外です\n", src, spec->hiyoku_levelup[level]);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+bool Spec_LoadFile(const char* path, MachineSpec* spec) {
+    size_t size = 0;
+    unsigned char* text = read_whole_file(path, &size);
+    if (!text) {
+        fprintf(stderr, "Failed to open spec file: %s\n", path);
+        return false;
+    }
+    Spec_GetDefault(spec);
+    bool ok = parse_spec_text((char*)text, path, spec);
+    free(text);
+    return ok && Spec_Validate(spec, path);
+}
+
+bool Spec_LoadCached(const char* path, const char* cache_path, MachineSpec* spec) {
+    char default_cache[SPEC_MAX_LINE_LEN];
+    if (!cache_path) {
+        snprintf(default_cache, sizeof(default_cache), "%s.bin", path);
+        cache_path = default_cache;
+    }
+
+    size_t size = 0;
+    unsigned char* text = read_whole_file(path, &size);
+    if (!text) {
+        fprintf(stderr, "Failed to open spec file: %s\n", path);
+        return false;
+    }
+    uint64_t hash = hash_bytes(text, size);
+    MachineSpec defaults;
+    Spec_GetDefault(&defaults);
+    uint64_t default_hash = Spec_GetHash(&defaults);
+
+    // キャッシュが一致すればそのまま使う (壊れた・古い内容を使わないよう検証はやり直す)
+    FILE* cache = fopen(cache_path, "rb");
+    if (cache) {
+        SpecCacheHeader header;
+        bool hit = fread(&header, sizeof(header), 1, cache) == 1 &&
+                   memcmp(header.magic, SPEC_CACHE_MAGIC, sizeof(header.magic)) == 0 &&
+                   header.version == SPEC_CACHE_VERSION &&
+                   header.spec_size == sizeof(MachineSpec) &&
+                   header.source_hash == hash &&
+                   header.default_hash == default_hash &&
+                   fread(spec, sizeof(MachineSpec), 1, cache) == 1;
+        fclose(cache);
+        if (hit && Spec_Validate(spec, cache_path)) {
+            free(text);
+            return true;
+        }
+    }
+
+    Spec_GetDefault(spec);
+    bool ok = parse_spec_text((char*)text, path, spec) && Spec_Validate(spec, path);
+    free(text);
+    if (!ok) return false;
+
+    SpecCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SPEC_CACHE_MAGIC, sizeof(header.magic));
+    header.version = SPEC_CACHE_VERSION;
+    header.spec_size = sizeof(MachineSpec);
+    header.source_hash = hash;
+    header.default_hash = default_hash;
+    if (!write_cache(cache_path, &header, spec)) {
+        fprintf(stderr, "Spec: キャッシュ %s を書き込めません (続行します)\n", cache_path);
+    }
+    return true;
+}
+
+void Spec_Print(FILE* out, const MachineSpec* spec) {
+    fprintf(out, "# ============================================\n");
+    fprintf(out, "# DARLING in the FRANXX シミュレータ 機種スペック定義\n");
+    fprintf(out, "# ============================================\n");
+
+    static const char* lottery_sections[LOTTERY_TABLE_COUNT] = {
+        "[Lottery.Normal]", "[Lottery.FranxxHighProb]"
+    };
+    for (int t = 0; t < LOTTERY_TABLE_COUNT; t++) {
+        fprintf(out, "\n%s\n# 小役抽選値 (合計 %d)\n", lottery_sections[t], LOTTERY_DENOMINATOR);
+        for (int y = 0; y < YAKU_COUNT; y++) {
+            if (spec->lottery_weight[t][y] > 0) {
+                fprintf(out, "%s = %d\n", GetYakuKey((YakuType)y), spec->lottery_weight[t][y]);
+            }
+        }
+    }
+
+    fprintf(out, "\n[Normal]\n# 天井 (前回AT終了からの通常時G数)\nCEILING = %d\n", spec->normal_ceiling);
+    fprintf(out, "# 役別 CZ当選率, AT直撃率 (千分率)\n");
+    for (int y = 0; y < YAKU_COUNT; y++) {
+        if (spec->normal_cz[y] == 0 && spec->normal_at[y] == 0) continue;
+        fprintf(out, "%s = %d, %d\n", GetYakuKey((YakuType)y), spec->normal_cz[y], spec->normal_at[y]);
+    }
+
+    fprintf(out, "\n[CZ]\n# CZ のゲーム数\nGAMES = %d\n# 役別 AT当選率 (千分率)\n", spec->cz_games);
+    for (int y = 0; y < YAKU_COUNT; y++) {
+        if (spec->cz_at[y] > 0) fprintf(out, "%s = %d\n", GetYakuKey((YakuType)y), spec->cz_at[y]);
+    }
+
+    fprintf(out, "\n[Payout]\n# 払い出し枚数 (押し順成功, 押し順失敗)\n");
+    for (int y = 0; y < YAKU_COUNT; y++) {
+        if (spec->payout[y] == 0 && spec->payout_oshijun_fail[y] == 0) continue;
+        if (spec->payout[y] == spec->payout_oshijun_fail[y]) {
+            fprintf(out, "%s = %d\n", GetYakuKey((YakuType)y), spec->payout[y]);
+        } else {
+            fprintf(out, "%s = %d, %d\n", GetYakuKey((YakuType)y), spec->payout[y], spec->payout_oshijun_fail[y]);
+        }
+    }
+
+    fprintf(out, "\n[BonusAT]\n# AT高確率中のボーナス当否, 振り分け FB, DB, EX, EP (千分率)\n");
+    for (int y = 0; y < YAKU_COUNT; y++) {
+        const SpecBonusRate* b = &spec->bonus_at[y];
+        if (b->success == 0) continue;
+        fprintf(out, "%s = %d, %d, %d, %d, %d\n", GetYakuKey((YakuType)y),
+                b->success, b->fb, b->db, b->ex, b->ep);
+    }
+
+    fprintf(out, "\n[AT]\n");
+    fprintf(out, "TARGET_BB_INITIAL = %d\n", spec->target_bb_initial);
+    fprintf(out, "TARGET_BB_HIGH_PROB = %d\n", spec->target_bb_high_prob);
+    fprintf(out, "TARGET_FRANXX_BONUS = %d\n", spec->target_franxx_bonus);
+    fprintf(out, "TARGET_BB_EX = %d\n", spec->target_bb_ex);
+    fprintf(out, "TARGET_EP_BONUS = %d\n", spec->target_ep_bonus);
+    fprintf(out, "TARGET_TSUREDASHI = %d\n", spec->target_tsuredashi);
+    fprintf(out, "GAMES_ON_BB_INITIAL_END = %d\n", spec->games_on_bb_initial_end);
+    fprintf(out, "# BB EX 継続率(%%):重み (合計 %d)\nBB_EX_CONTINUE_RATE = ", SPEC_BB_EX_RATE_DENOMINATOR);
+    print_rate_list(out, &spec->bb_ex_continue_rate);
+    fprintf(out, "\n# 比翼BEATS 初期レベル(1〜3):千分率\nHIYOKU_INIT_LEVEL = ");
+    print_rate_list(out, &spec->hiyoku_init_level);
+    fprintf(out, "\n# 比翼BEATS ボーナス当選時のレベルアップ率 (千分率)\n");
+    fprintf(out, "HIYOKU_LEVELUP_LV1 = %d\n", spec->hiyoku_levelup[HIYOKU_LV1]);
+    fprintf(out, "HIYOKU_LEVELUP_LV2 = %d\n", spec->hiyoku_levelup[HIYOKU_LV2]);
+    fprintf(out, "HIYOKU_LEVELUP_MAXX = %d\n", spec->hiyoku_levelup[HIYOKU_MAXX]);
+
+    fprintf(out, "\n[AT.GCount]\n# G数上乗せ 契機率 | 上乗せG数:千分率\n");
+    for (int y = 0; y < YAKU_COUNT; y++) {
+        if (spec->gcount_trigger[y] == 0) continue;
+        fprintf(out, "%s = %d | ", GetYakuKey((YakuType)y), spec->gcount_trigger[y]);
+        print_rate_list(out, &spec->gcount[y]);
+        fprintf(out, "\n");
+    }
+
+    fprintf(out, "\n[AT.PayoutAddOn]\n# 差枚数上乗せ 枚数:千分率 (記載のない役は上乗せなし)\n");
+    for (int y = 0; y < YAKU_COUNT; y++) {
+        const SpecRateList* list = &spec->payout_addon[y];
+        if (list->count == 1 && list->entries[0].value == 0) continue;
+        fprintf(out, "%s = ", GetYakuKey((YakuType)y));
+        print_rate_list(out, list);
+        fprintf(out, "\n");
+    }
+
+    fprintf(out, "\n[AT.ExStock]\n# G数上乗せの代わりに BB EX ストック (1 = 対象)\n");
+    for (int y = 0; y < YAKU_COUNT; y++) {
+        if (spec->ex_stock[y]) fprintf(out, "%s = 1\n", GetYakuKey((YakuType)y));
+    }
+
+    fprintf(out, "\n[AT.Tsuredashi]\n# フランクスボーナス中の連れ出し率 (千分率)\n");
+    for (int y = 0; y < YAKU_COUNT; y++) {
+        if (spec->tsuredashi[y] > 0) fprintf(out, "%s = %d\n", GetYakuKey((YakuType)y), spec->tsuredashi[y]);
+    }
+
+    fprintf(out, "\n[AT.Hiyoku]\n# 比翼BEATS 上乗せ率, ボーナス当選率, 当選時の BB EX 振り分け (千分率)\n");
+    for (int y = 0; y < YAKU_COUNT; y++) {
+        if (spec->hiyoku_add[y] == 0 && spec->hiyoku_bonus[y] == 0 && spec->hiyoku_ex[y] == 0) continue;
+        fprintf(out, "%s = %d, %d, %d\n", GetYakuKey((YakuType)y),
+                spec->hiyoku_add[y], spec->hiyoku_bonus[y], spec->hiyoku_ex[y]);
+    }
+}
+
+uint64_t Spec_GetHash(const MachineSpec* spec) {
+    // 構造体にはパディングがあるため、値を 1 つずつ (振り分けは要素数の分だけ) 混ぜる
+    uint64_t h = 0xCBF29CE484222325ULL;
+    h = hash_ints(h, &spec->normal_ceiling, 1);
+    h = hash_ints(h, spec->normal_cz, YAKU_COUNT);
+    h = hash_ints(h, spec->normal_at, YAKU_COUNT);
+    h = hash_ints(h, &spec->cz_games, 1);
+    h = hash_ints(h, spec->cz_at, YAKU_COUNT);
+    for (int t = 0; t < LOTTERY_TABLE_COUNT; t++) h = hash_ints(h, spec->lottery_weight[t], YAKU_COUNT);
+    h = hash_ints(h, spec->payout, YAKU_COUNT);
+    h = hash_ints(h, spec->payout_oshijun_fail, YAKU_COUNT);
+    for (int y = 0; y < YAKU_COUNT; y++) {
+        const SpecBonusRate* b = &spec->bonus_at[y];
+        int rate[] = { b->success, b->fb, b->db, b->ex, b->ep };
+        h = hash_ints(h, rate, 5);
+    }
+    int targets[] = {
+        spec->target_bb_initial, spec->target_bb_high_prob, spec->target_franxx_bonus,
+        spec->target_bb_ex, spec->target_ep_bonus, spec->target_tsuredashi, spec->games_on_bb_initial_end,
+    };
+    h = hash_ints(h, targets, (int)(sizeof(targets) / sizeof(targets[0])));
+    h = hash_rate_list(h, &spec->bb_ex_continue_rate);
+    h = hash_rate_list(h, &spec->hiyoku_init_level);
+    h = hash_ints(h, spec->hiyoku_levelup, HIYOKU_MAXX + 1);
+    h = hash_ints(h, spec->gcount_trigger, YAKU_COUNT);
+    for (int y = 0; y < YAKU_COUNT; y++) {
+        int ex_stock = spec->ex_stock[y] ? 1 : 0;
+        h = hash_rate_list(h, &spec->gcount[y]);
+        h = hash_rate_list(h, &spec->payout_addon[y]);
+        h = hash_ints(h, &ex_stock, 1);
+    }
+    h = hash_ints(h, spec->tsuredashi, YAKU_COUNT);
+    h = hash_ints(h, spec->hiyoku_add, YAKU_COUNT);
+    h = hash_ints(h, spec->hiyoku_bonus, YAKU_COUNT);
+    h = hash_ints(h, spec->hiyoku_ex, YAKU_COUNT);
+    return h;
+}
+
+bool Spec_GetParam(const MachineSpec* spec, const char* name, long long* value) {
+    SpecParamRef ref;
+    if (!resolve_param((MachineSpec*)spec, name, &ref)) return false;
+    if (ref.field) {
+        *value = *ref.field;
+    } else if (ref.list_value) {
+        *value = ref.list->entries[ref.index].value;
+    } else {
+        *value = (long long)ref.list->entries[ref.index].weight;
+    }
+    return true;
+}
+
+bool Spec_SetParam(MachineSpec* spec, const char* name, long long value) {
+    SpecParamRef ref;
+    if (!resolve_param(spec, name, &ref)) {
+        fprintf(stderr, "Spec: 不明なパラメータ %s\n", name);
+        return false;
+    }
+    if ((ref.field || ref.list_value) && (value < INT_MIN || value > INT_MAX)) {
+        fprintf(stderr, "Spec: %s = %lld は範囲外です\n", name, value);
+        return false;
+    }
+    if (ref.field) {
+        if (ref.balance) *ref.balance += *ref.field - (int)value;
+        *ref.field = (int)value;
+    } else if (ref.list_value) {
+        ref.list->entries[ref.index].value = (int)value;
+    } else {
+        // 合計を保つため、先頭 (先頭を変える場合は 2 番目) の要素で調整する
+        WeightedEntry* e = &ref.list->entries[ref.index];
+        if (ref.list->count > 1) {
+            WeightedEntry* other = &ref.list->entries[ref.index == 0 ? 1 : 0];
+            long long adjusted = (long long)other->weight + (long long)e->weight - value;
+            if (adjusted < 0 || value < 0) {
+                fprintf(stderr, "Spec: %s = %lld では振り分けの合計を保てません\n", name, value);
+                return false;
+            }
+            other->weight = (uint64_t)adjusted;
+        }
+        e->weight = (uint64_t)value;
+    }
+    return true;
+}
+
+void Spec_Set(const MachineSpec* spec) {
+    g_spec = *spec;
+    g_spec_ready = true;
+}
+
+const MachineSpec* Spec_Get(void) {
+    if (!g_spec_ready) {
+        Spec_GetDefault(&g_spec);
+        g_spec_ready = true;
+    }
+    return &g_spec;
+}
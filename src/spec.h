@@ -0,0 +1,160 @@
+#ifndef SPEC_H
+#define SPEC_H
+
+#include "common.h"
+#include "game_data.h"
+#include "lottery.h"
+#include "weighted_table.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// =================================================================
+// 機種スペック定義
+// -----------------------------------------------------------------
+// 抽選に使うすべての数値 (通常時・CZ・小役抽選値・払い出し・ボーナス振り分け・
+// 上乗せ・比翼BEATS・目標差枚) をまとめた構造体。
+// テキストの spec ファイル (media.cfg と同じ [Section] / KEY = VALUE 形式) から
+// 読み込んで検証し、Lottery_InitTables / AT_InitTables で抽選テーブルへ展開する。
+// 検証済みの構造体はバイナリキャッシュに保存し、次回はパースを省略する。
+// =================================================================
+#define SPEC_RATE_DENOMINATOR 1000  // 千分率
+#define SPEC_BB_EX_RATE_DENOMINATOR 100
+#define SPEC_MAX_CHOICES 8
+
+// {値, 重み} の振り分け (重みの合計は各分母)
+typedef struct {
+    int count;
+    WeightedEntry entries[SPEC_MAX_CHOICES];
+} SpecRateList;
+
+// AT高確率中のボーナス当否 (千分率) と種別振り分け (千分率)
+typedef struct {
+    int success;
+    int fb, db, ex, ep;
+} SpecBonusRate;
+
+typedef struct {
+    // [Normal] 通常時 (天井 / 役別の CZ 当選率・AT直撃率、千分率)
+    int normal_ceiling;              // 前回AT終了からの通常時G数がこの値に達すると AT
+    int normal_cz[YAKU_COUNT];
+    int normal_at[YAKU_COUNT];
+
+    // [CZ] CZ (ゲーム数 / 役別の AT 当選率、千分率)
+    int cz_games;
+    int cz_at[YAKU_COUNT];
+
+    // [Lottery.*] 小役抽選値 (分母 LOTTERY_DENOMINATOR)
+    int lottery_weight[LOTTERY_TABLE_COUNT][YAKU_COUNT];
+
+    // [Payout] 払い出し枚数 (押し順成功 / 失敗)
+    int payout[YAKU_COUNT];
+    int payout_oshijun_fail[YAKU_COUNT];
+
+    // [BonusAT] AT高確率中のボーナス抽選
+    SpecBonusRate bonus_at[YAKU_COUNT];
+
+    // [AT] 目標差枚・G数・振り分け
+    int target_bb_initial;
+    int target_bb_high_prob;
+    int target_franxx_bonus;
+    int target_bb_ex;          // BB EX (最低枚数)
+    int target_ep_bonus;
+    int target_tsuredashi;
+    int games_on_bb_initial_end;
+    SpecRateList bb_ex_continue_rate; // 値 = 継続率(%)、重みの分母 100
+    SpecRateList hiyoku_init_level;   // 値 = HiyokuLevel、千分率
+    int hiyoku_levelup[HIYOKU_MAXX + 1]; // レベル別 ボーナス当選時の昇格率 (千分率)
+
+    // [AT.GCount] G数上乗せ (契機率 + 上乗せG数振り分け)
+    int gcount_trigger[YAKU_COUNT];
+    SpecRateList gcount[YAKU_COUNT];
+
+    // [AT.PayoutAddOn] 差枚数上乗せ振り分け (値 0 は上乗せなし)
+    SpecRateList payout_addon[YAKU_COUNT];
+
+    // [AT.ExStock] G数上乗せの代わりに BB EX ストック (+連れ出し時は BB EX へ)
+    bool ex_stock[YAKU_COUNT];
+
+    // [AT.Tsuredashi] フランクスボーナス中の連れ出し率
+    int tsuredashi[YAKU_COUNT];
+
+    // [AT.Hiyoku] 比翼BEATS 上乗せ率 / ボーナス当選率 / 当選時の BB EX 振り分け
+    int hiyoku_add[YAKU_COUNT];
+    int hiyoku_bonus[YAKU_COUNT];
+    int hiyoku_ex[YAKU_COUNT];
+} MachineSpec;
+
+/**
+ * @brief 組み込みの既定スペック (本機の数値) を取得します。
+ */
+void Spec_GetDefault(MachineSpec* spec);
+
+/**
+ * @brief スペックの整合性 (各分母との一致・値の範囲) を検証します。
+ * @param source エラー表示用の名前 (NULL 可)
+ * @return 不正な値があれば false (内容は stderr に出力)
+ */
+bool Spec_Validate(const MachineSpec* spec, const char* source);
+
+/**
+ * @brief spec ファイルを読み込み、検証します。
+ * 記載のないセクションは既定スペックの値を使い、記載のあるセクションは
+ * そのセクションの内容だけで定義されます ([AT] は項目単位で上書き)。
+ * @return ファイルが開けない・書式や値が不正な場合は false
+ */
+bool Spec_LoadFile(const char* path, MachineSpec* spec);
+
+/**
+ * @brief spec ファイルを読み込みます (バイナリキャッシュ付き)。
+ * キャッシュが spec ファイルの内容と組み込みの既定スペックに一致すればパースを省略し (検証は行う)、
+ * 一致しなければ読み込み直してキャッシュを書き出します。
+ * @param cache_path キャッシュの保存先 (NULL の場合は "<path>.bin")
+ */
+bool Spec_LoadCached(const char* path, const char* cache_path, MachineSpec* spec);
+
+/**
+ * @brief スペックを spec ファイル形式で出力します (Spec_LoadFile で読み戻せる)。
+ */
+void Spec_Print(FILE* out, const MachineSpec* spec);
+
+/**
+ * @brief スペックの照合用ハッシュ (全項目の値の FNV-1a) を返します。
+ * 計算結果のファイル (価値表・チェックポイント) が同じスペックで作られたかの確認に使います。
+ */
+uint64_t Spec_GetHash(const MachineSpec* spec);
+
+/**
+ * @brief 名前で指定した数値パラメータを取得 / 設定します (スイープ・感度分析用)。
+ * 名前はセクションと項目を '.' でつないだもの:
+ *   Normal.CEILING / Normal.CHERRY.cz / Normal.CHERRY.at   通常時の天井 / CZ当選率 / AT直撃率
+ *   CZ.GAMES / CZ.CHERRY            CZ のゲーム数 / AT当選率
+ *   Lottery.Normal.REPLAY           小役抽選値 (設定時はハズレで合計を調整)
+ *   Payout.REPLAY                   払い出し (押し順成功時)
+ *   BonusAT.REPLAY.success          AT高確ボーナス当否 (fb / db / ex / ep も可)
+ *   AT.TARGET_BB_EX                 [AT] の整数項目
+ *   AT.BB_EX_CONTINUE_RATE.1        振り分け 1 番目の重み (設定時は他の要素で合計を調整)
+ *   AT.BB_EX_CONTINUE_RATE.1.value  振り分け 1 番目の値 (継続率など)
+ *   AT.GCount.CHERRY.trigger        G数上乗せ契機率 (AT.GCount.CHERRY.0 で振り分け)
+ *   AT.PayoutAddOn.CHERRY.0         差枚数上乗せ振り分け
+ *   AT.Tsuredashi.CHERRY            連れ出し率
+ *   AT.Hiyoku.CHERRY.add            比翼BEATS (bonus / ex も可)
+ * 設定後の整合性は Spec_Validate で確認してください。
+ * @return 名前が不正な場合は false
+ */
+bool Spec_GetParam(const MachineSpec* spec, const char* name, long long* value);
+bool Spec_SetParam(MachineSpec* spec, const char* name, long long value);
+
+/**
+ * @brief 抽選に使うスペックを設定します。
+ * 反映には Lottery_InitTables / AT_InitTables (または Sim_InitTables) の再呼び出しが必要です。
+ * 抽選中のスレッドがない状態で呼び出してください。
+ */
+void Spec_Set(const MachineSpec* spec);
+
+/**
+ * @brief 現在のスペックを取得します (未設定の場合は既定スペック)。
+ */
+const MachineSpec* Spec_Get(void);
+
+#endif // SPEC_H
@@ -0,0 +1,244 @@
+#include "sweep.h"
+#include "spec.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SWEEP_MAX_ROUNDS 8   // 座標降下の最大周回数
+#define SWEEP_Z95 1.96
+
+typedef struct {
+    long long values[SWEEP_MAX_PARAMS];
+    bool valid;              // スペックの検証に通ったか
+    EvalResult result;
+} SweepCandidate;
+
+typedef struct {
+    const SweepConfig* config;
+    MachineSpec base;
+    SweepCandidate* candidates;
+    int count;
+    FILE* out;
+} SweepState;
+
+// --- 内部ヘルパー関数 ---
+
+static double candidate_metric(const SweepConfig* config, const EvalResult* r, double* se) {
+    if (config->target_kind == SWEEP_TARGET_PAYOUT) {
+        *se = r->payout_se;
+        return r->mean_payout;
+    }
+    *se = r->rtp_se;
+    return r->rtp;
+}
+
+static double candidate_error(const SweepConfig* config, const SweepCandidate* c) {
+    if (!c->valid) return INFINITY;
+    double se;
+    return fabs(candidate_metric(config, &c->result, &se) - config->target);
+}
+
+static void print_values(FILE* out, const SweepConfig* config, const long long* values) {
+    for (int p = 0; p < config->param_count; p++) {
+        fprintf(out, "%s%s=%lld", p > 0 ? " " : "", config->params[p].name, values[p]);
+    }
+}
+
+static void print_candidate(FILE* out, const SweepConfig* config, const SweepCandidate* c) {
+    print_values(out, config, c->values);
+    if (!c->valid) {
+        fprintf(out, "  (スペック不正のため除外)\n");
+        return;
+    }
+    const EvalResult* r = &c->result;
+    double se;
+    double metric = candidate_metric(config, r, &se);
+    double lo = metric - SWEEP_Z95 * se;
+    double hi = metric + SWEEP_Z95 * se;
+    bool hit = lo <= config->target && config->target <= hi;
+    fprintf(out, "  平均 %.1f G / %.1f 枚  出玉率 %.2f%% (95%%CI %.2f〜%.2f%%)"
+                 "  差枚 %.1f (95%%CI %.1f〜%.1f)  1000枚以上 %.1f%%  中央値 %d  90%%点 %d%s\n",
+            r->mean_games, r->mean_payout,
+            100.0 * r->rtp, 100.0 * (r->rtp - SWEEP_Z95 * r->rtp_se), 100.0 * (r->rtp + SWEEP_Z95 * r->rtp_se),
+            r->mean_payout, r->mean_payout - SWEEP_Z95 * r->payout_se, r->mean_payout + SWEEP_Z95 * r->payout_se,
+            100.0 * r->p_over_1000, r->q50, r->q90, hit ? "  ○目標内" : "");
+}
+
+// 評価済みの候補を探し、なければ評価して追加する
+static const SweepCandidate* evaluate(SweepState* st, const long long* values) {
+    const SweepConfig* config = st->config;
+    for (int i = 0; i < st->count; i++) {
+        if (memcmp(st->candidates[i].values, values, sizeof(long long) * SWEEP_MAX_PARAMS) == 0) {
+            return &st->candidates[i];
+        }
+    }
+    if (st->count >= SWEEP_MAX_CANDIDATES) return NULL;
+
+    SweepCandidate* c = &st->candidates[st->count++];
+    memset(c, 0, sizeof(*c));
+    memcpy(c->values, values, sizeof(c->values));
+
+    MachineSpec spec = st->base;
+    c->valid = true;
+    for (int p = 0; p < config->param_count; p++) {
+        if (!Spec_SetParam(&spec, config->params[p].name, values[p])) c->valid = false;
+    }
+    if (c->valid && Spec_Validate(&spec, "sweep")) {
+        Spec_Set(&spec);
+        c->valid = Sim_InitTables() && SimEval_Run(&config->eval, &c->result);
+    } else {
+        c->valid = false;
+    }
+    print_candidate(st->out, config, c);
+    fflush(st->out);
+    return c;
+}
+
+static long long param_steps(const SweepParam* p) {
+    return (p->hi - p->lo) / p->step + 1;
+}
+
+static void run_grid(SweepState* st) {
+    const SweepConfig* config = st->config;
+    long long values[SWEEP_MAX_PARAMS] = {0};
+    long long index[SWEEP_MAX_PARAMS] = {0};
+    for (;;) {
+        for (int p = 0; p < config->param_count; p++) {
+            values[p] = config->params[p].lo + index[p] * config->params[p].step;
+        }
+        if (!evaluate(st, values)) return;
+
+        // 最後のパラメータから繰り上げる
+        int p = config->param_count - 1;
+        while (p >= 0 && ++index[p] >= param_steps(&config->params[p])) {
+            index[p--] = 0;
+        }
+        if (p < 0) return;
+    }
+}
+
+static void run_coordinate(SweepState* st) {
+    const SweepConfig* config = st->config;
+    long long current[SWEEP_MAX_PARAMS] = {0};
+
+    // 既定値 (範囲外なら下限) から開始する
+    for (int p = 0; p < config->param_count; p++) {
+        const SweepParam* sp = &config->params[p];
+        long long v = sp->lo;
+        if (Spec_GetParam(&st->base, sp->name, &v) && v >= sp->lo && v <= sp->hi) {
+            v = sp->lo + (v - sp->lo) / sp->step * sp->step;
+        } else {
+            v = sp->lo;
+        }
+        current[p] = v;
+    }
+    const SweepCandidate* best = evaluate(st, current);
+    if (!best) return;
+
+    for (int round = 0; round < SWEEP_MAX_ROUNDS; round++) {
+        bool moved = false;
+        for (int p = 0; p < config->param_count; p++) {
+            const SweepParam* sp = &config->params[p];
+            long long trial[SWEEP_MAX_PARAMS];
+            memcpy(trial, current, sizeof(trial));
+            for (long long v = sp->lo; v <= sp->hi; v += sp->step) {
+                trial[p] = v;
+                const SweepCandidate* c = evaluate(st, trial);
+                if (!c) return;
+                if (candidate_error(config, c) < candidate_error(config, best)) {
+                    best = c;
+                }
+            }
+            if (best->values[p] != current[p]) {
+                memcpy(current, best->values, sizeof(current));
+                moved = true;
+            }
+        }
+        if (!moved) break;
+    }
+}
+
+static int compare_by_error(const void* a, const void* b, const SweepConfig* config) {
+    double ea = candidate_error(config, (const SweepCandidate*)a);
+    double eb = candidate_error(config, (const SweepCandidate*)b);
+    return (ea > eb) - (ea < eb);
+}
+
+// --- 公開関数 ---
+
+bool Sweep_ParseParam(const char* text, SweepParam* param) {
+    memset(param, 0, sizeof(*param));
+    const char* eq = strchr(text, '=');
+    if (!eq || eq == text || (size_t)(eq - text) >= sizeof(param->name)) return false;
+    memcpy(param->name, text, (size_t)(eq - text));
+
+    char* end;
+    param->lo = strtoll(eq + 1, &end, 10);
+    if (*end != ':') return false;
+    param->hi = strtoll(end + 1, &end, 10);
+    param->step = 1;
+    if (*end == ':') param->step = strtoll(end + 1, &end, 10);
+    return *end == '\0' && param->step > 0 && param->lo <= param->hi;
+}
+
+bool Sweep_Run(const SweepConfig* config, FILE* out) {
+    SweepState st;
+    memset(&st, 0, sizeof(st));
+    st.config = config;
+    st.base = *Spec_Get();
+    st.out = out;
+
+    long long total = 1;
+    for (int p = 0; p < config->param_count; p++) {
+        long long dummy;
+        if (!Spec_GetParam(&st.base, config->params[p].name, &dummy)) {
+            fprintf(stderr, "Sweep: 不明なパラメータ %s\n", config->params[p].name);
+            return false;
+        }
+        total *= param_steps(&config->params[p]);
+        if (total > SWEEP_MAX_CANDIDATES) total = SWEEP_MAX_CANDIDATES + 1;
+    }
+    if (config->search == SWEEP_SEARCH_GRID && total > SWEEP_MAX_CANDIDATES) {
+        fprintf(stderr, "Sweep: 候補が多すぎます (最大 %d)。--search coord か step を使用してください\n",
+                SWEEP_MAX_CANDIDATES);
+        return false;
+    }
+
+    st.candidates = (SweepCandidate*)malloc(sizeof(SweepCandidate) * SWEEP_MAX_CANDIDATES);
+    if (!st.candidates) {
+        fprintf(stderr, "Sweep: メモリ確保に失敗しました\n");
+        return false;
+    }
+
+    if (config->search == SWEEP_SEARCH_COORD) run_coordinate(&st);
+    else run_grid(&st);
+
+    // 実行前のスペックへ戻す
+    Spec_Set(&st.base);
+    bool ok = Sim_InitTables();
+
+    // 目標との差が小さい順 (挿入ソート: 安定で候補数も少ない)
+    for (int i = 1; i < st.count; i++) {
+        SweepCandidate tmp = st.candidates[i];
+        int j = i - 1;
+        while (j >= 0 && compare_by_error(&st.candidates[j], &tmp, config) > 0) {
+            st.candidates[j + 1] = st.candidates[j];
+            j--;
+        }
+        st.candidates[j + 1] = tmp;
+    }
+
+    int report = config->report_count > 0 ? config->report_count : 5;
+    fprintf(out, "--- 目標 %s %.4g に近い設定 (%d 候補中、%lld AT / シード %llu) ---\n",
+            config->target_kind == SWEEP_TARGET_PAYOUT ? "平均獲得差枚" : "出玉率",
+            config->target_kind == SWEEP_TARGET_PAYOUT ? config->target : 100.0 * config->target,
+            st.count, config->eval.at_count, config->eval.seed);
+    for (int i = 0; i < st.count && i < report; i++) {
+        if (!st.candidates[i].valid) break;
+        fprintf(out, "%d. ", i + 1);
+        print_candidate(out, config, &st.candidates[i]);
+    }
+
+    free(st.candidates);
+    return ok;
+}
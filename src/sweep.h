@@ -0,0 +1,58 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include "sim_eval.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+// =================================================================
+// スペックパラメータのスイープ
+// -----------------------------------------------------------------
+// 指定したパラメータ (Spec_SetParam の名前) を範囲内で動かしながら
+// SimEval_Run で AT を評価し、目標の出玉率 / 平均獲得差枚に近い設定を
+// 信頼区間付きで報告する。候補は共通のシードで評価する (共通乱数)。
+// スペックと抽選テーブルはプロセス共通のため候補は順に評価し、
+// 各候補の評価を並列に行う。
+// =================================================================
+
+#define SWEEP_MAX_PARAMS 4
+#define SWEEP_MAX_CANDIDATES 4096
+
+typedef struct {
+    char name[64];
+    long long lo, hi, step;
+} SweepParam;
+
+typedef enum {
+    SWEEP_SEARCH_GRID,  // 全組み合わせ
+    SWEEP_SEARCH_COORD  // 座標降下 (1 パラメータずつ最良値へ移動)
+} SweepSearch;
+
+typedef enum {
+    SWEEP_TARGET_RTP,   // AT中の出玉率
+    SWEEP_TARGET_PAYOUT // ATあたりの平均獲得差枚
+} SweepTarget;
+
+typedef struct {
+    SweepParam params[SWEEP_MAX_PARAMS];
+    int param_count;
+    SweepSearch search;
+    SweepTarget target_kind;
+    double target;
+    int report_count;   // 報告する上位候補の数
+    EvalConfig eval;
+} SweepConfig;
+
+/**
+ * @brief "NAME=lo:hi:step" 形式 (step 省略時は 1) をパースします。
+ */
+bool Sweep_ParseParam(const char* text, SweepParam* param);
+
+/**
+ * @brief スイープを実行し、評価結果と上位候補を out に出力します。
+ * 終了時には実行前のスペックと抽選テーブルに戻します。
+ * @return パラメータ名が不正・評価に失敗した場合は false
+ */
+bool Sweep_Run(const SweepConfig* config, FILE* out);
+
+#endif // SWEEP_H
@@ -0,0 +1,279 @@
+#ifdef __linux__
+    #define _GNU_SOURCE // sched_setaffinity / CPU_SET
+#endif
+
+#include "thread_config.h"
+#include <SDL2/SDL.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+    #include <windows.h>
+#elif defined(__linux__)
+    #include <sched.h>
+#endif
+
+#define THREAD_CONFIG_MAX_LINE 256
+
+typedef struct {
+    int cpus[THREAD_CONFIG_MAX_CPUS];
+    int cpu_count;              // 0 = 明示していない
+    bool priority_set;
+    SDL_ThreadPriority priority;
+} ThreadRoleConfig;
+
+static const char* k_role_keys[THREAD_ROLE_COUNT] = { "SIM_WORKER", "EV_PREDICT", "VIDEO_DECODE" };
+
+static const struct {
+    const char* name;
+    SDL_ThreadPriority priority;
+} k_priority_names[] = {
+    { "low", SDL_THREAD_PRIORITY_LOW },
+    { "normal", SDL_THREAD_PRIORITY_NORMAL },
+    { "high", SDL_THREAD_PRIORITY_HIGH },
+    { "time_critical", SDL_THREAD_PRIORITY_TIME_CRITICAL },
+};
+
+// 推定ワーカーは描画ループより後回しにする (明示しない場合)
+static ThreadRoleConfig g_roles[THREAD_ROLE_COUNT] = {
+    [THREAD_ROLE_EV_PREDICT] = { .priority_set = true, .priority = SDL_THREAD_PRIORITY_LOW },
+};
+static bool g_isolate_decode = false;
+static SDL_atomic_t g_warned[THREAD_ROLE_COUNT]; // 失敗の表示は役割ごとに 1 回 (デコードは動画ごとに起動するため)
+
+// --- 内部ヘルパー関数 ---
+
+static char* trim(char* s) {
+    while (isspace((unsigned char)*s)) s++;
+    char* end = s + strlen(s);
+    while (end > s && isspace((unsigned char)end[-1])) end--;
+    *end = '\0';
+    return s;
+}
+
+// "0-3,6" を CPU 番号の配列にする
+static bool parse_cpu_list(const char* text, int* cpus, int* count) {
+    *count = 0;
+    const char* p = text;
+    while (*p) {
+        char* end;
+        long first = strtol(p, &end, 10);
+        if (end == p || first < 0) return false;
+        long last = first;
+        p = end;
+        if (*p == '-') {
+            p++;
+            last = strtol(p, &end, 10);
+            if (end == p || last < first) return false;
+            p = end;
+        }
+        for (long cpu = first; cpu <= last; cpu++) {
+            if (*count >= THREAD_CONFIG_MAX_CPUS) return false;
+            cpus[(*count)++] = (int)cpu;
+        }
+        while (isspace((unsigned char)*p)) p++;
+        if (*p == ',') p++;
+        else if (*p) return false;
+        while (isspace((unsigned char)*p)) p++;
+    }
+    return *count > 0;
+}
+
+// 役割に割り当てる CPU (明示していなければデコードの分離による既定値)
+static int resolve_cpus(ThreadRole role, int* cpus) {
+    const ThreadRoleConfig* c = &g_roles[role];
+    if (c->cpu_count > 0) {
+        memcpy(cpus, c->cpus, sizeof(int) * (size_t)c->cpu_count);
+        return c->cpu_count;
+    }
+    int n = SDL_GetCPUCount();
+    if (!g_isolate_decode || n < 2) return 0;
+    if (n > THREAD_CONFIG_MAX_CPUS) n = THREAD_CONFIG_MAX_CPUS;
+
+    // 最後の CPU をデコード専用にする
+    if (role == THREAD_ROLE_VIDEO_DECODE) {
+        cpus[0] = n - 1;
+        return 1;
+    }
+    for (int i = 0; i < n - 1; i++) cpus[i] = i;
+    return n - 1;
+}
+
+// previous が NULL でなければ、変更前の割り当てを保存する
+static bool set_affinity(const int* cpus, int count, ThreadAffinity* previous) {
+#ifdef _WIN32
+    DWORD_PTR mask = 0;
+    for (int i = 0; i < count; i++) {
+        if (cpus[i] >= (int)(sizeof(DWORD_PTR) * 8)) return false;
+        mask |= (DWORD_PTR)1 << cpus[i];
+    }
+    DWORD_PTR old = SetThreadAffinityMask(GetCurrentThread(), mask); // 変更前の割り当てを返す
+    if (old != 0 && previous) {
+        previous->saved = true;
+        previous->mask[0] = (uint64_t)old;
+    }
+    return old != 0;
+#elif defined(__linux__)
+    cpu_set_t set;
+    if (previous && sched_getaffinity(0, sizeof(set), &set) == 0) {
+        previous->saved = true;
+        for (int cpu = 0; cpu < CPU_SETSIZE && cpu < THREAD_AFFINITY_WORDS * 64; cpu++) {
+            if (CPU_ISSET(cpu, &set)) previous->mask[cpu / 64] |= 1ULL << (cpu % 64);
+        }
+    }
+    CPU_ZERO(&set);
+    for (int i = 0; i < count; i++) {
+        if (cpus[i] >= CPU_SETSIZE) return false;
+        CPU_SET(cpus[i], &set);
+    }
+    return sched_setaffinity(0, sizeof(set), &set) == 0; // 0 = 呼び出し元スレッド
+#else
+    (void)cpus;
+    (void)count;
+    (void)previous;
+    return true; // 未対応の環境では OS に任せる
+#endif
+}
+
+static void restore_affinity(const ThreadAffinity* previous) {
+#ifdef _WIN32
+    SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)previous->mask[0]);
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu = 0; cpu < CPU_SETSIZE && cpu < THREAD_AFFINITY_WORDS * 64; cpu++) {
+        if (previous->mask[cpu / 64] & (1ULL << (cpu % 64))) CPU_SET(cpu, &set);
+    }
+    sched_setaffinity(0, sizeof(set), &set);
+#else
+    (void)previous;
+#endif
+}
+
+// 役割の CPU に固定する (ワーカーは番号の CPU 1 つ、動画デコードはリスト全体)
+static void apply_affinity(ThreadRole role, int index, ThreadAffinity* previous) {
+    int cpus[THREAD_CONFIG_MAX_CPUS];
+    int count = resolve_cpus(role, cpus);
+    if (count <= 0) return;
+    bool ok = (role == THREAD_ROLE_VIDEO_DECODE)
+        ? set_affinity(cpus, count, previous)
+        : set_affinity(&cpus[(index >= 0 ? index : 0) % count], 1, previous);
+    if (!ok && SDL_AtomicCAS(&g_warned[role], 0, 1)) {
+        fprintf(stderr, "ThreadConfig: %s の CPU を固定できません\n", k_role_keys[role]);
+    }
+}
+
+// --- 公開関数 ---
+
+bool ThreadConfig_SetCpus(ThreadRole role, const char* cpus) {
+    if (role < 0 || role >= THREAD_ROLE_COUNT) return false;
+    ThreadRoleConfig* c = &g_roles[role];
+    if (!cpus || !*cpus) {
+        c->cpu_count = 0;
+        return true;
+    }
+    int list[THREAD_CONFIG_MAX_CPUS];
+    int count;
+    if (!parse_cpu_list(cpus, list, &count)) {
+        fprintf(stderr, "ThreadConfig: CPU リストが不正です: %s\n", cpus);
+        return false;
+    }
+    memcpy(c->cpus, list, sizeof(int) * (size_t)count);
+    c->cpu_count = count;
+    return true;
+}
+
+bool ThreadConfig_SetPriority(ThreadRole role, const char* priority) {
+    if (role < 0 || role >= THREAD_ROLE_COUNT) return false;
+    if (!priority || !*priority) return true;
+    for (size_t i = 0; i < sizeof(k_priority_names) / sizeof(k_priority_names[0]); i++) {
+        if (strcmp(priority, k_priority_names[i].name) == 0) {
+            g_roles[role].priority_set = true;
+            g_roles[role].priority = k_priority_names[i].priority;
+            return true;
+        }
+    }
+    fprintf(stderr, "ThreadConfig: 優先度が不正です: %s (low / normal / high / time_critical)\n", priority);
+    return false;
+}
+
+void ThreadConfig_SetDecodeIsolation(bool enabled) {
+    g_isolate_decode = enabled;
+}
+
+bool ThreadConfig_Load(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "ThreadConfig: %s を開けません\n", path);
+        return false;
+    }
+
+    g_isolate_decode = true;
+    bool ok = true;
+    bool in_section = false;
+    char line[THREAD_CONFIG_MAX_LINE];
+    while (fgets(line, sizeof(line), file)) {
+        char* s = trim(line);
+        if (s[0] == '#' || s[0] == '\0') continue;
+        if (s[0] == '[') {
+            in_section = strcmp(s, "[Threads]") == 0;
+            continue;
+        }
+        char* equals = strchr(s, '=');
+        if (!in_section || !equals) continue;
+        *equals = '\0';
+        char* key = trim(s);
+        char* value = trim(equals + 1);
+
+        if (strcmp(key, "ISOLATE_DECODE") == 0) {
+            g_isolate_decode = atoi(value) != 0;
+            continue;
+        }
+        bool known = false;
+        for (int r = 0; r < THREAD_ROLE_COUNT; r++) {
+            size_t len = strlen(k_role_keys[r]);
+            if (strncmp(key, k_role_keys[r], len) != 0 || key[len] != '_') continue;
+            if (strcmp(key + len + 1, "CPUS") == 0) {
+                known = true;
+                ok = ThreadConfig_SetCpus((ThreadRole)r, value) && ok;
+            } else if (strcmp(key + len + 1, "PRIORITY") == 0) {
+                known = true;
+                ok = ThreadConfig_SetPriority((ThreadRole)r, value) && ok;
+            }
+        }
+        if (!known) {
+            fprintf(stderr, "ThreadConfig: 不明なキーです: %s\n", key);
+            ok = false;
+        }
+    }
+    fclose(file);
+    return ok;
+}
+
+void ThreadConfig_Apply(ThreadRole role, int index) {
+    if (role < 0 || role >= THREAD_ROLE_COUNT) return;
+    const ThreadRoleConfig* c = &g_roles[role];
+    apply_affinity(role, index, NULL);
+    // 権限がなく上げられない場合もそのまま続ける
+    if (c->priority_set && SDL_SetThreadPriority(c->priority) != 0 && SDL_AtomicCAS(&g_warned[role], 0, 1)) {
+        fprintf(stderr, "ThreadConfig: %s の優先度を設定できません: %s\n", k_role_keys[role], SDL_GetError());
+    }
+}
+
+void ThreadConfig_ApplyAffinity(ThreadRole role, int index, ThreadAffinity* previous) {
+    memset(previous, 0, sizeof(*previous));
+    if (role < 0 || role >= THREAD_ROLE_COUNT) return;
+    apply_affinity(role, index, previous);
+}
+
+void ThreadConfig_RestoreAffinity(const ThreadAffinity* previous) {
+    if (previous->saved) restore_affinity(previous);
+}
+
+int ThreadConfig_GetCpuCount(ThreadRole role) {
+    if (role < 0 || role >= THREAD_ROLE_COUNT) return 0;
+    int cpus[THREAD_CONFIG_MAX_CPUS];
+    return resolve_cpus(role, cpus);
+}
@@ -0,0 +1,91 @@
+#ifndef THREAD_CONFIG_H
+#define THREAD_CONFIG_H
+
+#include <SDL2/SDL_thread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// =================================================================
+// スレッドの CPU 割り当て (アフィニティ) と優先度
+// -----------------------------------------------------------------
+// スレッドの役割ごとに CPU 番号のリストと優先度を持ち、各スレッドが
+// 起動直後に ThreadConfig_Apply で自分に適用する。ワーカーは番号順に
+// リストの CPU へ 1 つずつ固定し (コア間の移動を防ぐ)、動画デコードは
+// リスト全体に固定する。設定はスレッドを起動する前に行い、実行中は
+// 読み取りのみ行う。
+//
+// 本体 (UI) では ThreadConfig_Load が media.cfg の [Threads] を読み、
+// 明示しない限り動画デコードを最後の CPU に、シミュレーション系の
+// ワーカーを残りの CPU に分けて同じコアで競合しないようにする。
+// ワーカー 0 として働く Parallel_Run の呼び出し元スレッドは、実行中だけ
+// CPU を固定して終了後に元へ戻す (ThreadConfig_ApplyAffinity、優先度は変えない)。
+// アフィニティは Linux / Windows のみ対応 (他の環境では優先度だけ適用)。
+// =================================================================
+
+#define THREAD_CONFIG_MAX_CPUS 64
+#define THREAD_AFFINITY_WORDS 16 // 保存できる CPU 番号 (64 × 16 = 1024 個)
+
+typedef enum {
+    THREAD_ROLE_SIM_WORKER,    // Parallel_Run のワーカー (sim_worker)
+    THREAD_ROLE_EV_PREDICT,    // AT残り期待値の推定ワーカー (ev_predict)
+    THREAD_ROLE_VIDEO_DECODE,  // 動画デコード (video_decode)
+    THREAD_ROLE_COUNT
+} ThreadRole;
+
+// ThreadConfig_ApplyAffinity で保存した元の CPU 割り当て
+typedef struct {
+    bool saved;                          // false なら戻すものはない
+    uint64_t mask[THREAD_AFFINITY_WORDS]; // CPU 番号のビット
+} ThreadAffinity;
+
+/**
+ * @brief 役割の CPU リストを設定します。
+ * @param cpus "0-3,6" 形式。NULL または空文字列で OS に任せる
+ * @return 書式が不正な場合は false (設定は変更しない)
+ */
+bool ThreadConfig_SetCpus(ThreadRole role, const char* cpus);
+
+/**
+ * @brief 役割の優先度を設定します。
+ * @param priority "low" / "normal" / "high" / "time_critical"。NULL または空文字列で変更しない
+ * @return 名前が不正な場合は false
+ */
+bool ThreadConfig_SetPriority(ThreadRole role, const char* priority);
+
+/**
+ * @brief 動画デコードとシミュレーション系のワーカーの CPU を既定で分けるかを設定します
+ * (CPU リストを明示した役割には影響しません)。
+ */
+void ThreadConfig_SetDecodeIsolation(bool enabled);
+
+/**
+ * @brief 設定ファイルの [Threads] セクションを読み込みます (SIM_WORKER_CPUS / SIM_WORKER_PRIORITY /
+ * EV_PREDICT_* / VIDEO_DECODE_* / ISOLATE_DECODE)。デコードの分離は既定で有効になります。
+ * @return ファイルを開けない・値が不正な場合は false
+ */
+bool ThreadConfig_Load(const char* path);
+
+/**
+ * @brief 呼び出し元スレッドに役割の設定を適用します (スレッドの起動直後に呼ぶ)。
+ * @param index 同じ役割のスレッドの中での番号 (CPU リストの何番目に固定するか)
+ */
+void ThreadConfig_Apply(ThreadRole role, int index);
+
+/**
+ * @brief 呼び出し元スレッドを役割の CPU に一時的に固定します (優先度は変更しません)。
+ * 既存のスレッドに役割を貸す場合 (Parallel_Run の呼び出し元など) に使い、ThreadConfig_RestoreAffinity で戻します。
+ * @param previous 元の割り当ての保存先 (CPU を割り当てていない役割では saved = false)
+ */
+void ThreadConfig_ApplyAffinity(ThreadRole role, int index, ThreadAffinity* previous);
+
+/**
+ * @brief ThreadConfig_ApplyAffinity の前の CPU 割り当てに戻します。
+ */
+void ThreadConfig_RestoreAffinity(const ThreadAffinity* previous);
+
+/**
+ * @brief 役割に割り当てる CPU の数を返します (OS に任せる場合は 0)。
+ */
+int ThreadConfig_GetCpuCount(ThreadRole role);
+
+#endif // THREAD_CONFIG_H
@@ -1,4 +1,5 @@
 #include "video_internal.h"
+#include "thread_config.h"
 #include <libavformat/avformat.h>
 #include <libavcodec/avcodec.h>
 #include <libswscale/swscale.h>
@@ -145,6 +146,7 @@ static int run_decode_thread(void *arg) {
          goto end;
     }
     
+    ThreadConfig_Apply(THREAD_ROLE_VIDEO_DECODE, 0); // 既定ではシミュレーション系のワーカーと別の CPU
     printf("Decode Thread: [%p] 開始。\n", (void*)state);
     state->thread_started = true;
 
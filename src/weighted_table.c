@@ -0,0 +1,223 @@
+#include "weighted_table.h"
+#include "rng.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_REGISTERED_TABLES 512
+
+static const WeightedTable* g_registry[MAX_REGISTERED_TABLES];
+static int g_registry_count = 0;
+
+static _Thread_local WeightedSampleHook g_sample_hook = NULL;
+static _Thread_local void* g_sample_hook_user = NULL;
+
+// --- 内部ヘルパー関数 ---
+
+// 名前を複製する。収まらない場合は UTF-8 の文字の途中で切らないよう、文字の境界で切り詰める
+static void copy_name(char* dst, const char* src) {
+    size_t len = strlen(src);
+    if (len >= WEIGHTED_NAME_LEN) {
+        len = WEIGHTED_NAME_LEN - 1;
+        while (len > 0 && ((unsigned char)src[len] & 0xC0) == 0x80) len--; // 継続バイトの位置では切らない
+    }
+    memcpy(dst, src, len);
+    dst[len] = '\0';
+}
+
+static void register_table(const WeightedTable* t) {
+    if (g_registry_count < MAX_REGISTERED_TABLES) {
+        g_registry[g_registry_count++] = t;
+    }
+}
+
+static void unregister_table(const WeightedTable* t) {
+    for (int i = 0; i < g_registry_count; i++) {
+        if (g_registry[i] == t) {
+            g_registry[i] = g_registry[--g_registry_count];
+            return;
+        }
+    }
+}
+
+static bool build_lut(WeightedTable* t) {
+    t->lut = (int*)malloc(sizeof(int) * (size_t)t->denominator);
+    if (!t->lut) return false;
+
+    uint64_t pos = 0;
+    for (int i = 0; i < t->count; i++) {
+        for (uint64_t j = 0; j < t->entries[i].weight; j++) {
+            t->lut[pos++] = t->entries[i].value;
+        }
+    }
+    return true;
+}
+
+// Vose のエイリアス法 (整数版): 各枠の容量を denominator とし、
+// 重み × 要素数 を容量単位で配分する
+static bool build_alias(WeightedTable* t) {
+    int n = t->count;
+    t->alias_threshold = (uint64_t*)malloc(sizeof(uint64_t) * n);
+    t->alias_index = (int*)malloc(sizeof(int) * n);
+    uint64_t* scaled = (uint64_t*)malloc(sizeof(uint64_t) * n);
+    int* small = (int*)malloc(sizeof(int) * n);
+    int* large = (int*)malloc(sizeof(int) * n);
+    if (!t->alias_threshold || !t->alias_index || !scaled || !small || !large) {
+        free(scaled); free(small); free(large);
+        return false;
+    }
+
+    int ns = 0, nl = 0;
+    for (int i = 0; i < n; i++) {
+        scaled[i] = t->entries[i].weight * (uint64_t)n;
+        t->alias_index[i] = i;
+        if (scaled[i] < t->denominator) small[ns++] = i;
+        else large[nl++] = i;
+    }
+    while (ns > 0 && nl > 0) {
+        int s = small[--ns];
+        int l = large[--nl];
+        t->alias_threshold[s] = scaled[s];
+        t->alias_index[s] = l;
+        scaled[l] -= t->denominator - scaled[s];
+        if (scaled[l] < t->denominator) small[ns++] = l;
+        else large[nl++] = l;
+    }
+    while (nl > 0) t->alias_threshold[large[--nl]] = t->denominator;
+    while (ns > 0) t->alias_threshold[small[--ns]] = t->denominator;
+
+    free(scaled); free(small); free(large);
+    return true;
+}
+
+static int sample_direct(const WeightedTable* t) {
+    if (t->lut) {
+        return t->lut[Rng_Below((int)t->denominator)];
+    }
+    // 枠番号と枠内位置を 1 回の乱数から取り出す
+    uint64_t r = Rng_BelowU64(t->denominator * (uint64_t)t->count);
+    uint64_t slot = r / t->denominator;
+    uint64_t pos = r % t->denominator;
+    int i = (pos < t->alias_threshold[slot]) ? (int)slot : t->alias_index[slot];
+    return t->entries[i].value;
+}
+
+static int sample_hooked(const WeightedTable* t) {
+    if (g_sample_hook) {
+        return t->entries[g_sample_hook(t, g_sample_hook_user)].value;
+    }
+    return sample_direct(t);
+}
+
+// 差し替えを使う間 (sim value の列挙) だけ sample_hooked に切り替え、通常の抽選では確認しない
+static int (*g_sample_func)(const WeightedTable* t) = sample_direct;
+
+// --- 公開関数 ---
+
+bool WeightedTable_Init(WeightedTable* t, const char* name, const WeightedEntry* entries, int count, uint64_t denominator) {
+    memset(t, 0, sizeof(*t));
+    copy_name(t->name, name);
+
+    uint64_t total = 0;
+    for (int i = 0; i < count; i++) {
+        if (entries[i].weight > UINT64_MAX - total) {
+            fprintf(stderr, "WeightedTable[%s]: 重みの合計が 64bit を超えます\n", name);
+            return false;
+        }
+        total += entries[i].weight;
+    }
+
+    if (count <= 0 || total == 0) {
+        fprintf(stderr, "WeightedTable[%s]: 要素がありません\n", name);
+        return false;
+    }
+    if (total > WEIGHTED_LUT_MAX && total > UINT64_MAX / (uint64_t)count) {
+        // エイリアス法は 要素数 × 分母 の範囲で乱数を引くため
+        fprintf(stderr, "WeightedTable[%s]: 分母 × 要素数 が 64bit を超えます\n", name);
+        return false;
+    }
+    if (denominator != 0 && total != denominator) {
+        fprintf(stderr, "WeightedTable[%s]: 重みの合計 %llu が分母 %llu と一致しません\n",
+                name, (unsigned long long)total, (unsigned long long)denominator);
+        return false;
+    }
+
+    t->denominator = total;
+    t->count = count;
+    t->entries = (WeightedEntry*)malloc(sizeof(WeightedEntry) * count);
+    if (!t->entries) return false;
+    memcpy(t->entries, entries, sizeof(WeightedEntry) * count);
+
+    bool ok = (total <= WEIGHTED_LUT_MAX) ? build_lut(t) : build_alias(t);
+    if (!ok) {
+        fprintf(stderr, "WeightedTable[%s]: メモリ確保に失敗しました\n", name);
+        WeightedTable_Free(t);
+        return false;
+    }
+    register_table(t);
+    return true;
+}
+
+void WeightedTable_Free(WeightedTable* t) {
+    unregister_table(t);
+    free(t->entries);
+    free(t->lut);
+    free(t->alias_threshold);
+    free(t->alias_index);
+    t->entries = NULL;
+    t->lut = NULL;
+    t->alias_threshold = NULL;
+    t->alias_index = NULL;
+    t->count = 0;
+}
+
+int WeightedTable_Sample(const WeightedTable* t) {
+    return g_sample_func(t);
+}
+
+void WeightedTable_EnableSampleHooks(bool enable) {
+    g_sample_func = enable ? sample_hooked : sample_direct;
+}
+
+void WeightedTable_SetSampleHook(WeightedSampleHook hook, void* user) {
+    g_sample_hook = hook;
+    g_sample_hook_user = user;
+}
+
+int WeightedTable_Lookup(const WeightedTable* t, uint64_t r) {
+    if (t->lut) {
+        return t->lut[r];
+    }
+    uint64_t cumulative = 0;
+    for (int i = 0; i < t->count; i++) {
+        cumulative += t->entries[i].weight;
+        if (r < cumulative) return t->entries[i].value;
+    }
+    return t->entries[t->count - 1].value;
+}
+
+double WeightedTable_GetProbability(const WeightedTable* t, int value) {
+    uint64_t w = 0;
+    for (int i = 0; i < t->count; i++) {
+        if (t->entries[i].value == value) w += t->entries[i].weight;
+    }
+    return (double)w / (double)t->denominator;
+}
+
+void WeightedTable_Print(FILE* out, const WeightedTable* t) {
+    fprintf(out, "[%s] 分母 %llu (%s)\n", t->name, (unsigned long long)t->denominator,
+            t->lut ? "直接参照" : "エイリアス");
+    for (int i = 0; i < t->count; i++) {
+        fprintf(out, "  %6d : %12llu  (%.6f%%)\n", t->entries[i].value,
+                (unsigned long long)t->entries[i].weight,
+                100.0 * (double)t->entries[i].weight / (double)t->denominator);
+    }
+}
+
+int WeightedTable_GetRegisteredCount(void) {
+    return g_registry_count;
+}
+
+const WeightedTable* WeightedTable_GetRegistered(int index) {
+    if (index < 0 || index >= g_registry_count) return NULL;
+    return g_registry[index];
+}
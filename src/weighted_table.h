@@ -0,0 +1,93 @@
+#ifndef WEIGHTED_TABLE_H
+#define WEIGHTED_TABLE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// =================================================================
+// 重み付き抽選テーブル
+// -----------------------------------------------------------------
+// 宣言的な {値, 重み} 配列から構築し、O(1) で抽選する。
+//  - 分母が WEIGHTED_LUT_MAX 以下: 分母サイズの直接参照表 (乱数1回)
+//  - それより大きい分母: 整数エイリアス法 (乱数1回、誤差なし)
+// 構築したテーブルはすべて登録され、一覧表示できる。
+// =================================================================
+#define WEIGHTED_LUT_MAX 65536
+#define WEIGHTED_NAME_LEN 128 // 日本語の分類名/役名 (UTF-8) が収まる長さ
+
+typedef struct {
+    int value;       // 抽選結果の値
+    uint64_t weight; // 重み (分母に対する当選数)
+} WeightedEntry;
+
+typedef struct {
+    char name[WEIGHTED_NAME_LEN];
+    uint64_t denominator;    // 重みの合計
+    int count;
+    WeightedEntry* entries;  // 構築元の配列 (参照・表示用の複製)
+
+    int* lut;                   // 直接参照表 [denominator]
+    uint64_t* alias_threshold;  // エイリアス法: 各枠の自身の取り分
+    int* alias_index;           // エイリアス法: 残りの取り分の移譲先
+} WeightedTable;
+
+/**
+ * @brief テーブルを構築します。
+ * @param name 表示用の名前
+ * @param entries {値, 重み} 配列 (重み 0 の要素は許容)
+ * @param count 要素数
+ * @param denominator 期待する重みの合計 (0 の場合は検証しない)
+ * @return 重みの合計が分母と一致しない場合などは false
+ */
+bool WeightedTable_Init(WeightedTable* t, const char* name, const WeightedEntry* entries, int count, uint64_t denominator);
+
+/**
+ * @brief テーブルを解放します (登録も解除されます)。
+ */
+void WeightedTable_Free(WeightedTable* t);
+
+// 抽選の差し替え: 要素番号 (0 〜 count-1) を返す
+typedef int (*WeightedSampleHook)(const WeightedTable* t, void* user);
+
+/**
+ * @brief 1 回の乱数で値を抽選します。
+ */
+int WeightedTable_Sample(const WeightedTable* t);
+
+/**
+ * @brief WeightedTable_Sample の差し替え (WeightedTable_SetSampleHook) を有効 / 無効にします。
+ * 無効の間 (既定) は差し替えを確認せずに抽選します。抽選中のスレッドがないときに呼び出してください。
+ */
+void WeightedTable_EnableSampleHooks(bool enable);
+
+/**
+ * @brief このスレッドの WeightedTable_Sample を差し替えます (抽選結果の網羅的な列挙用)。
+ * WeightedTable_EnableSampleHooks(true) の間だけ使われます。
+ * @param hook NULL で解除
+ */
+void WeightedTable_SetSampleHook(WeightedSampleHook hook, void* user);
+
+/**
+ * @brief 抽選値から値を引きます (直接参照表モードのみ)。
+ * @param r 抽選値 (0 〜 denominator-1)
+ */
+int WeightedTable_Lookup(const WeightedTable* t, uint64_t r);
+
+/**
+ * @brief 値の当選確率を返します (同じ値の要素は合算)。
+ */
+double WeightedTable_GetProbability(const WeightedTable* t, int value);
+
+/**
+ * @brief テーブルの内容 (値・重み・確率) を出力します。
+ */
+void WeightedTable_Print(FILE* out, const WeightedTable* t);
+
+/**
+ * @brief 登録済みテーブルの数 / 取得。
+ */
+int WeightedTable_GetRegisteredCount(void);
+const WeightedTable* WeightedTable_GetRegistered(int index);
+
+#endif // WEIGHTED_TABLE_H
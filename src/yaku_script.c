@@ -0,0 +1,131 @@
+#include "yaku_script.h"
+#include "lottery.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define YAKU_SCRIPT_MAX_LINE_LEN 256
+
+static const struct {
+    const char* key;
+    AT_BonusResultType result;
+} k_bonus_keys[] = {
+    { "NONE", BONUS_NONE },
+    { "CONTINUE", BONUS_AT_CONTINUE },
+    { "DARLING", BONUS_DARLING },
+    { "FRANXX", BONUS_FRANXX },
+    { "BB_EX", BONUS_BB_EX },
+    { "EPISODE", BONUS_EPISODE },
+};
+
+static YakuScriptEntry* g_entries = NULL;
+static int g_count = 0;
+static int g_capacity = 0;
+static int g_position = 0;
+
+// --- 内部ヘルパー関数 ---
+
+static bool find_bonus_by_key(const char* key, AT_BonusResultType* result) {
+    for (size_t i = 0; i < sizeof(k_bonus_keys) / sizeof(k_bonus_keys[0]); i++) {
+        if (strcmp(key, k_bonus_keys[i].key) == 0) {
+            *result = k_bonus_keys[i].result;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool push_entry(const YakuScriptEntry* entry) {
+    if (g_count >= g_capacity) {
+        int capacity = g_capacity > 0 ? g_capacity * 2 : 64;
+        YakuScriptEntry* entries = (YakuScriptEntry*)realloc(g_entries, sizeof(YakuScriptEntry) * (size_t)capacity);
+        if (!entries) return false;
+        g_entries = entries;
+        g_capacity = capacity;
+    }
+    g_entries[g_count++] = *entry;
+    return true;
+}
+
+// 1 行をパースする (空行・コメント行は *has_entry = false)
+static bool parse_line(char* line, YakuScriptEntry* entry, bool* has_entry) {
+    char* comment = strchr(line, '#');
+    if (comment) *comment = '\0';
+
+    char* tok[3];
+    int n = 0;
+    for (char* t = strtok(line, " \t\r\n"); t; t = strtok(NULL, " \t\r\n")) {
+        if (n >= 3) return false;
+        tok[n++] = t;
+    }
+    *has_entry = n > 0;
+    if (n == 0) return true;
+
+    memset(entry, 0, sizeof(*entry));
+    if (strcmp(tok[0], "skip") == 0) {
+        char* end;
+        entry->op = YAKU_SCRIPT_SKIP;
+        entry->games = (n == 2) ? strtoll(tok[1], &end, 10) : 0;
+        return n == 2 && *end == '\0' && entry->games > 0;
+    }
+    if (strcmp(tok[0], "*") == 0) {
+        entry->op = YAKU_SCRIPT_RANDOM;
+        return n == 1;
+    }
+    entry->op = YAKU_SCRIPT_YAKU;
+    if (!FindYakuByKey(tok[0], &entry->yaku)) return false;
+    if (n == 2) {
+        entry->has_bonus = true;
+        return find_bonus_by_key(tok[1], &entry->bonus);
+    }
+    return n == 1;
+}
+
+// --- 公開関数 ---
+
+bool YakuScript_Load(const char* path) {
+    YakuScript_Free();
+
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "YakuScript: %s を開けません\n", path);
+        return false;
+    }
+    char line[YAKU_SCRIPT_MAX_LINE_LEN];
+    int line_no = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), file)) {
+        line_no++;
+        YakuScriptEntry entry;
+        bool has_entry;
+        if (!parse_line(line, &entry, &has_entry)) {
+            fprintf(stderr, "YakuScript[%s:%d]: 解釈できない行です\n", path, line_no);
+            ok = false;
+        } else if (has_entry) {
+            entry.line = line_no;
+            if (!push_entry(&entry)) {
+                fprintf(stderr, "YakuScript: メモリ確保に失敗しました\n");
+                ok = false;
+            }
+        }
+    }
+    fclose(file);
+    if (!ok) YakuScript_Free();
+    return ok;
+}
+
+const YakuScriptEntry* YakuScript_Peek(void) {
+    return g_position < g_count ? &g_entries[g_position] : NULL;
+}
+
+void YakuScript_Advance(void) {
+    if (g_position < g_count) g_position++;
+}
+
+void YakuScript_Free(void) {
+    free(g_entries);
+    g_entries = NULL;
+    g_count = 0;
+    g_capacity = 0;
+    g_position = 0;
+}
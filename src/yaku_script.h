@@ -0,0 +1,59 @@
+#ifndef YAKU_SCRIPT_H
+#define YAKU_SCRIPT_H
+
+#include "common.h"
+#include "game_data.h" // AT_BonusResultType のため
+#include <stdbool.h>
+
+// =================================================================
+// 成立役スクリプト (演出確認用)
+// -----------------------------------------------------------------
+// 小役抽選の代わりにファイルに書いた順で成立役を返し、AT高確中は
+// ボーナス抽選の結果も指定できる。1 行 1 ゲームで、次の形式:
+//
+//   STRELITZIA_ME              成立役 (spec.cfg と同じキー)
+//   CHANCE_ME BB_EX            成立役 + AT高確中のボーナス抽選結果
+//                              (NONE / CONTINUE / DARLING / FRANXX / BB_EX / EPISODE)
+//   *                          通常どおり抽選する
+//   skip 500                   500 ゲームをヘッドレス・エンジンで早送り
+//
+// '#' 以降はコメント。スクリプトを使い切った後は通常どおり抽選する。
+// =================================================================
+
+typedef enum {
+    YAKU_SCRIPT_YAKU,   // 成立役を指定
+    YAKU_SCRIPT_RANDOM, // 通常どおり抽選
+    YAKU_SCRIPT_SKIP    // 早送り
+} YakuScriptOp;
+
+typedef struct {
+    YakuScriptOp op;
+    YakuType yaku;
+    bool has_bonus;
+    AT_BonusResultType bonus;
+    long long games;    // YAKU_SCRIPT_SKIP のゲーム数
+    int line;           // ファイルの行番号
+} YakuScriptEntry;
+
+/**
+ * @brief スクリプトを読み込みます (読み込み済みのものは破棄)。
+ * @return ファイルが開けない・解釈できない行がある場合は false
+ */
+bool YakuScript_Load(const char* path);
+
+/**
+ * @brief 次の項目を返します (残っていなければ NULL)。
+ */
+const YakuScriptEntry* YakuScript_Peek(void);
+
+/**
+ * @brief 次の項目へ進めます。
+ */
+void YakuScript_Advance(void);
+
+/**
+ * @brief スクリプトを破棄します。
+ */
+void YakuScript_Free(void);
+
+#endif // YAKU_SCRIPT_H